@@ -0,0 +1,134 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+// Benchmark of the frustum culling of 100k instances with GLC_Octree and GLC_LinearOctree
+
+#include <QApplication>
+#include <QTime>
+#include <QtDebug>
+
+#include <cmath>
+
+#include <GLC_3DViewCollection>
+#include <GLC_3DViewInstance>
+#include <GLC_3DRep>
+#include <GLC_Box>
+#include <GLC_Octree>
+#include <GLC_LinearOctree>
+#include <GLC_Frustum>
+#include <GLC_Matrix4x4>
+
+// Number of instances along each axis of the grid
+static const int gridSize= 47;
+
+// Number of culled frames
+static const int frameCount= 100;
+
+// Return the composition matrix of a perspective camera at the center of the grid
+// looking along the Z axis turned by the given angle
+static GLC_Matrix4x4 compositionMatrix(double angle)
+{
+	const double nearDistance= 1.0;
+	const double farDistance= 1000.0;
+	const double f= 1.0 / tan(35.0 * glc::PI / 360.0);
+	double projection[16]= {0.0};
+	projection[0]= f / (4.0 / 3.0);
+	projection[5]= f;
+	projection[10]= (farDistance + nearDistance) / (nearDistance - farDistance);
+	projection[11]= -1.0;
+	projection[14]= (2.0 * farDistance * nearDistance) / (nearDistance - farDistance);
+
+	return GLC_Matrix4x4(projection) * GLC_Matrix4x4(glc::Y_AXIS, angle);
+}
+
+// Fill the given collection with a grid of boxes sharing one representation
+static void fillCollection(GLC_3DViewCollection* pCollection)
+{
+	const GLC_3DRep rep(new GLC_Box(1.0, 1.0, 1.0));
+	const double half= gridSize * 2.0;
+	for (int i= 0; i < gridSize; ++i)
+	{
+		for (int j= 0; j < gridSize; ++j)
+		{
+			for (int k= 0; k < gridSize; ++k)
+			{
+				GLC_3DViewInstance instance(rep);
+				instance.setMatrix(GLC_Matrix4x4(i * 4.0 - half, j * 4.0 - half, k * 4.0 - half));
+				pCollection->add(instance);
+			}
+		}
+	}
+}
+
+// Return the number of viewable instances of the given collection
+static int viewableCount(GLC_3DViewCollection* pCollection)
+{
+	int count= 0;
+	const int size= pCollection->size();
+	for (int i= 0; i < size; ++i)
+	{
+		if (pCollection->instanceHandleAt(i)->viewableFlag() != GLC_3DViewInstance::NoViewable) ++count;
+	}
+	return count;
+}
+
+// Bind the given space partitioning to the given collection, cull frames and print timings
+static void benchmark(const char* name, GLC_3DViewCollection* pCollection, GLC_SpacePartitioning* pSpacePartitioning)
+{
+	pCollection->bindSpacePartitioning(pSpacePartitioning);
+	pCollection->setSpacePartitionningUsage(true);
+
+	QTime time;
+	time.start();
+	pSpacePartitioning->updateSpacePartitioning();
+	const int buildTime= time.elapsed();
+
+	GLC_Frustum frustum;
+	int viewable= 0;
+	time.start();
+	for (int i= 0; i < frameCount; ++i)
+	{
+		frustum.update(compositionMatrix((2.0 * glc::PI * i) / frameCount));
+		pCollection->updateInstanceViewableState(frustum);
+		if (0 == i) viewable= viewableCount(pCollection);
+	}
+	const int cullTime= time.elapsed();
+
+	qDebug() << name << ": build" << buildTime << "ms, cull" << static_cast<double>(cullTime) / frameCount
+			<< "ms per frame," << viewable << "viewable instances at the first frame";
+
+	pCollection->unbindSpacePartitioning();
+}
+
+int main(int argc, char **argv)
+{
+	QApplication app(argc, argv);
+
+	GLC_3DViewCollection collection;
+	fillCollection(&collection);
+	qDebug() << "Frustum culling of" << collection.size() << "instances," << frameCount << "frames";
+
+	benchmark("GLC_Octree", &collection, new GLC_Octree(&collection));
+	benchmark("GLC_LinearOctree", &collection, new GLC_LinearOctree(&collection));
+
+	return 0;
+}
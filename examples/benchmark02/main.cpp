@@ -0,0 +1,117 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+// Benchmark of the serial and the parallel frustum culling of 200k instances of a collection
+
+#include <QApplication>
+#include <QTime>
+#include <QtDebug>
+
+#include <cmath>
+
+#include <GLC_3DViewCollection>
+#include <GLC_3DViewInstance>
+#include <GLC_3DRep>
+#include <GLC_Box>
+#include <GLC_Frustum>
+#include <GLC_Matrix4x4>
+#include <GLC_State>
+
+// Number of instances along each axis of the grid
+static const int gridSize= 59;
+
+// Number of culled frames
+static const int frameCount= 100;
+
+// Return the composition matrix of a perspective camera at the center of the grid
+// looking along the Z axis turned by the given angle
+static GLC_Matrix4x4 compositionMatrix(double angle)
+{
+	const double nearDistance= 1.0;
+	const double farDistance= 1000.0;
+	const double f= 1.0 / tan(35.0 * glc::PI / 360.0);
+	double projection[16]= {0.0};
+	projection[0]= f / (4.0 / 3.0);
+	projection[5]= f;
+	projection[10]= (farDistance + nearDistance) / (nearDistance - farDistance);
+	projection[11]= -1.0;
+	projection[14]= (2.0 * farDistance * nearDistance) / (nearDistance - farDistance);
+
+	return GLC_Matrix4x4(projection) * GLC_Matrix4x4(glc::Y_AXIS, angle);
+}
+
+// Fill the given collection with a grid of boxes sharing one representation
+static void fillCollection(GLC_3DViewCollection* pCollection)
+{
+	const GLC_3DRep rep(new GLC_Box(1.0, 1.0, 1.0));
+	const double half= gridSize * 2.0;
+	for (int i= 0; i < gridSize; ++i)
+	{
+		for (int j= 0; j < gridSize; ++j)
+		{
+			for (int k= 0; k < gridSize; ++k)
+			{
+				GLC_3DViewInstance instance(rep);
+				instance.setMatrix(GLC_Matrix4x4(i * 4.0 - half, j * 4.0 - half, k * 4.0 - half));
+				pCollection->add(instance);
+			}
+		}
+	}
+}
+
+// Cull frames of the given collection and print timings
+static void benchmark(const char* name, GLC_3DViewCollection* pCollection, bool parallel)
+{
+	GLC_State::setParallelCullingUsage(parallel);
+
+	// The first culling computes the instances bounding boxes
+	GLC_Frustum frustum;
+	frustum.update(compositionMatrix(0.0));
+	pCollection->updateInstanceViewableState(frustum);
+
+	QTime time;
+	time.start();
+	for (int i= 0; i < frameCount; ++i)
+	{
+		frustum.update(compositionMatrix((2.0 * glc::PI * i) / frameCount));
+		pCollection->updateInstanceViewableState(frustum);
+	}
+	const int cullTime= time.elapsed();
+
+	qDebug() << name << ":" << static_cast<double>(cullTime) / frameCount << "ms per frame";
+}
+
+int main(int argc, char **argv)
+{
+	QApplication app(argc, argv);
+
+	GLC_3DViewCollection collection;
+	fillCollection(&collection);
+	qDebug() << "Frustum culling and draw lists of" << collection.size() << "instances," << frameCount << "frames";
+
+	GLC_State::setFrustumCullingUsage(true);
+	GLC_State::setOcclusionCullingUsage(false);
+	benchmark("Serial culling", &collection, false);
+	benchmark("Parallel culling", &collection, true);
+
+	return 0;
+}
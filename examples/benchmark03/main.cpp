@@ -0,0 +1,140 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+// Benchmark of the occlusion culling of 48k small instances hidden behind a wall of large instances
+
+#include <QApplication>
+#include <QTime>
+#include <QtDebug>
+
+#include <cmath>
+
+#include <GLC_3DViewCollection>
+#include <GLC_3DViewInstance>
+#include <GLC_3DRep>
+#include <GLC_Box>
+#include <GLC_Frustum>
+#include <GLC_Matrix4x4>
+
+#include "sceneGraph/glc_frustumculler.h"
+#include "sceneGraph/glc_occlusionculler.h"
+
+// Number of culled frames
+static const int frameCount= 100;
+
+// Return the composition matrix of a perspective camera at the origin looking along the Z axis
+static GLC_Matrix4x4 compositionMatrix()
+{
+	const double nearDistance= 1.0;
+	const double farDistance= 1000.0;
+	const double f= 1.0 / tan(35.0 * glc::PI / 360.0);
+	double projection[16]= {0.0};
+	projection[0]= f / (4.0 / 3.0);
+	projection[5]= f;
+	projection[10]= (farDistance + nearDistance) / (nearDistance - farDistance);
+	projection[11]= -1.0;
+	projection[14]= (2.0 * farDistance * nearDistance) / (nearDistance - farDistance);
+
+	return GLC_Matrix4x4(projection);
+}
+
+// Fill the given collection with a wall of large boxes in front of a grid of small boxes
+static void fillCollection(GLC_3DViewCollection* pCollection)
+{
+	// The wall covers the field of view at 30 units of the camera
+	const GLC_3DRep wallRep(new GLC_Box(4.0, 4.0, 1.0));
+	for (int i= 0; i < 8; ++i)
+	{
+		for (int j= 0; j < 6; ++j)
+		{
+			GLC_3DViewInstance instance(wallRep);
+			instance.setMatrix(GLC_Matrix4x4(i * 4.0 - 14.0, j * 4.0 - 10.0, -30.0));
+			pCollection->add(instance);
+		}
+	}
+
+	const GLC_3DRep smallRep(new GLC_Box(0.2, 0.2, 0.2));
+	for (int i= 0; i < 40; ++i)
+	{
+		for (int j= 0; j < 30; ++j)
+		{
+			for (int k= 0; k < 40; ++k)
+			{
+				GLC_3DViewInstance instance(smallRep);
+				instance.setMatrix(GLC_Matrix4x4(i * 0.6 - 12.0, j * 0.6 - 9.0, -40.0 - k * 4.0));
+				pCollection->add(instance);
+			}
+		}
+	}
+}
+
+// Cull frames with the given culler and print timings and culled counts
+static void benchmark(const char* name, GLC_FrustumCuller* pFrustumCuller, bool parallel)
+{
+	const GLC_Matrix4x4 matrix(compositionMatrix());
+	GLC_Frustum frustum;
+	frustum.update(matrix);
+	GLC_OcclusionCuller occlusionCuller;
+	occlusionCuller.setMaximumOccluderCount(64);
+
+	int frustumTime= 0;
+	int occlusionTime= 0;
+	int occlusionCulled= 0;
+	QTime time;
+	for (int i= 0; i < frameCount; ++i)
+	{
+		time.start();
+		pFrustumCuller->cull(frustum, parallel);
+		frustumTime+= time.elapsed();
+
+		time.start();
+		occlusionCulled= occlusionCuller.cull(pFrustumCuller, matrix, true, parallel);
+		occlusionTime+= time.elapsed();
+	}
+
+	qDebug() << name << ": frustum culling" << static_cast<double>(frustumTime) / frameCount << "ms, occlusion culling"
+			<< static_cast<double>(occlusionTime) / frameCount << "ms per frame," << pFrustumCuller->viewableBits().count()
+			<< "viewable instances," << occlusionCulled << "occlusion culled instances," << occlusionCuller.occluderCount() << "occluders";
+}
+
+int main(int argc, char **argv)
+{
+	QApplication app(argc, argv);
+
+	GLC_3DViewCollection collection;
+	fillCollection(&collection);
+
+	QVector<GLC_3DViewInstance*> instances;
+	const int size= collection.size();
+	for (int i= 0; i < size; ++i)
+	{
+		instances.append(collection.instanceHandleAt(i));
+	}
+	GLC_FrustumCuller frustumCuller;
+	frustumCuller.setInstances(instances);
+	qDebug() << "Occlusion culling of" << size << "instances," << frameCount << "frames";
+
+	benchmark("Serial culling", &frustumCuller, false);
+	benchmark("Parallel culling", &frustumCuller, true);
+
+	return 0;
+}
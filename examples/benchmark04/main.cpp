@@ -0,0 +1,186 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+// Benchmark of the memory footprint and of the traversals of a world of 1M occurrences
+
+#include <QApplication>
+#include <QFile>
+#include <QTime>
+#include <QtDebug>
+
+#include <GLC_World>
+#include <GLC_StructOccurence>
+#include <GLC_StructInstance>
+#include <GLC_StructReference>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+// The tree has 100 assemblies of 100 sub assemblies of 100 parts
+static const int assemblyCount= 100;
+static const int subAssemblyCount= 100;
+static const int partCount= 100;
+
+// Number of repetitions of each traversal
+static const int traversalCount= 10;
+
+// Return the resident memory of the process in bytes, -1 if it is unknown
+static qint64 residentMemory()
+{
+#if defined(Q_OS_LINUX)
+	QFile file("/proc/self/statm");
+	if (file.open(QIODevice::ReadOnly))
+	{
+		const QList<QByteArray> fields(file.readAll().split(' '));
+		if (fields.size() > 1)
+		{
+			return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+		}
+	}
+#endif
+	return -1;
+}
+
+// Fill the given world with the synthetic tree, the parts share the same reference
+static void fillWorld(GLC_World* pWorld)
+{
+	// The parts have no representation, only the structure is measured
+	GLC_StructReference* pPartRef= new GLC_StructReference("Part");
+	GLC_StructReference* pSubAssemblyRef= new GLC_StructReference("SubAssembly");
+	GLC_StructReference* pAssemblyRef= new GLC_StructReference("Assembly");
+
+	GLC_StructOccurence* pRoot= pWorld->rootOccurence();
+	for (int i= 0; i < assemblyCount; ++i)
+	{
+		GLC_StructInstance* pAssemblyInstance= new GLC_StructInstance(pAssemblyRef);
+		pAssemblyInstance->translate(i * 10.0, 0.0, 0.0);
+		GLC_StructOccurence* pAssembly= pRoot->addChild(pAssemblyInstance);
+		for (int j= 0; j < subAssemblyCount; ++j)
+		{
+			GLC_StructInstance* pSubAssemblyInstance= new GLC_StructInstance(pSubAssemblyRef);
+			pSubAssemblyInstance->translate(0.0, j * 10.0, 0.0);
+			GLC_StructOccurence* pSubAssembly= pAssembly->addChild(pSubAssemblyInstance);
+			for (int k= 0; k < partCount; ++k)
+			{
+				GLC_StructInstance* pPartInstance= new GLC_StructInstance(pPartRef);
+				pPartInstance->translate(0.0, 0.0, k * 10.0);
+				pSubAssembly->addChild(pPartInstance);
+			}
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	QApplication app(argc, argv);
+
+	qDebug() << "sizeof(GLC_StructOccurence)" << sizeof(GLC_StructOccurence) << "bytes, sizeof(GLC_StructInstance)"
+			<< sizeof(GLC_StructInstance) << "bytes";
+
+	QTime time;
+	const qint64 initialMemory= residentMemory();
+	GLC_World world;
+
+	time.start();
+	fillWorld(&world);
+	const int occurenceCount= world.numberOfOccurence();
+	qDebug() << "Tree of" << occurenceCount << "occurrences built in" << time.elapsed() << "ms";
+
+	time.start();
+	world.updateAbsoluteMatrices();
+	qDebug() << "First absolute matrices update :" << time.elapsed() << "ms";
+
+	const qint64 treeMemory= residentMemory() - initialMemory;
+	if (initialMemory >= 0)
+	{
+		qDebug() << "Resident memory of the tree :" << treeMemory / (1024 * 1024) << "MB,"
+				<< static_cast<double>(treeMemory) / occurenceCount << "bytes per occurrence";
+	}
+	else
+	{
+		qDebug() << "Resident memory of the tree : unknown on this system";
+	}
+
+	// Move all the assemblies, all the absolute matrices have to be updated
+	GLC_StructOccurence* pRoot= world.rootOccurence();
+	time.start();
+	for (int i= 0; i < traversalCount; ++i)
+	{
+		const int childCount= pRoot->childCount();
+		for (int j= 0; j < childCount; ++j)
+		{
+			pRoot->child(j)->structInstance()->translate(1.0, 0.0, 0.0);
+			pRoot->child(j)->updateChildrenAbsoluteMatrix();
+		}
+		world.updateAbsoluteMatrices();
+	}
+	qDebug() << "Absolute matrices update of all occurrences :" << static_cast<double>(time.elapsed()) / traversalCount << "ms";
+
+	// Move one assembly, only its branch has to be updated
+	time.start();
+	for (int i= 0; i < traversalCount; ++i)
+	{
+		pRoot->child(0)->structInstance()->translate(1.0, 0.0, 0.0);
+		pRoot->child(0)->updateChildrenAbsoluteMatrix();
+		world.updateAbsoluteMatrices();
+	}
+	qDebug() << "Absolute matrices update of one assembly :" << static_cast<double>(time.elapsed()) / traversalCount << "ms";
+
+	unsigned int nodeCount= 0;
+	time.start();
+	for (int i= 0; i < traversalCount; ++i)
+	{
+		nodeCount= pRoot->nodeCount();
+	}
+	qDebug() << "nodeCount() :" << static_cast<double>(time.elapsed()) / traversalCount << "ms," << nodeCount << "nodes";
+
+	int subOccurenceCount= 0;
+	time.start();
+	for (int i= 0; i < traversalCount; ++i)
+	{
+		subOccurenceCount= pRoot->subOccurenceList().size();
+	}
+	qDebug() << "subOccurenceList() :" << static_cast<double>(time.elapsed()) / traversalCount << "ms," << subOccurenceCount << "occurrences";
+
+	unsigned int faceCount= 0;
+	time.start();
+	for (int i= 0; i < traversalCount; ++i)
+	{
+		faceCount= pRoot->numberOfFaces();
+	}
+	qDebug() << "numberOfFaces() :" << static_cast<double>(time.elapsed()) / traversalCount << "ms," << faceCount << "faces";
+
+	int materialCount= 0;
+	time.start();
+	for (int i= 0; i < traversalCount; ++i)
+	{
+		materialCount= pRoot->materialSet().size();
+	}
+	qDebug() << "materialSet() :" << static_cast<double>(time.elapsed()) / traversalCount << "ms," << materialCount << "materials";
+
+	time.start();
+	world.clear();
+	qDebug() << "Tree destroyed in" << time.elapsed() << "ms";
+
+	return 0;
+}
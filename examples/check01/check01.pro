@@ -0,0 +1,23 @@
+TARGET = check01
+TEMPLATE = app
+QT += opengl
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG += warn_on console
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./Build
+MOC_DIR = ./Build
+UI_DIR = ./Build
+RCC_DIR = ./Build
+
+include(../examples.pri)
+
+
+# Input
+SOURCES += main.cpp
+
+include(../../install.pri)
+
+target.path = $${GLC_LIB_DIR}/examples
+INSTALLS += target
@@ -0,0 +1,161 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+// Check of the instanced rendering of a collection against the rendering of each instance
+/* Can be run offscreen on Mesa llvmpipe with :
+ * QT_QPA_PLATFORM=offscreen LIBGL_ALWAYS_SOFTWARE=1 ./check01
+ * The exit code is not null if the two renderings differ*/
+
+#include <QApplication>
+#include <QGLWidget>
+#include <QGLFramebufferObject>
+#include <QImage>
+#include <QtDebug>
+
+#include <cstdlib>
+
+#include <GLC_Context>
+#include <GLC_State>
+#include <GLC_RenderStatistics>
+#include <GLC_3DViewCollection>
+#include <GLC_3DViewInstance>
+#include <GLC_3DRep>
+#include <GLC_Box>
+#include <GLC_Material>
+#include <GLC_Light>
+#include <GLC_Viewport>
+
+// Size of the rendered image
+static const int imageSize= 256;
+
+// Number of instances along each axis of the grid
+static const int gridSize= 6;
+
+// Maximum difference of a color component of two matching pixels
+static const int colorTolerance= 3;
+
+// Fill the given collection with a grid of boxes sharing one representation
+static void fillCollection(GLC_3DViewCollection* pCollection)
+{
+	GLC_Box* pBox= new GLC_Box(1.0, 1.0, 1.0);
+	pBox->addMaterial(new GLC_Material(QColor(200, 120, 40)));
+	const GLC_3DRep rep(pBox);
+	const double half= gridSize;
+	for (int i= 0; i < gridSize; ++i)
+	{
+		for (int j= 0; j < gridSize; ++j)
+		{
+			for (int k= 0; k < gridSize; ++k)
+			{
+				GLC_3DViewInstance instance(rep);
+				instance.setMatrix(GLC_Matrix4x4(i * 2.0 - half, j * 2.0 - half, k * 2.0 - half));
+				pCollection->add(instance);
+			}
+		}
+	}
+}
+
+// Render the given collection in an image with or without instanced rendering
+static QImage render(GLC_3DViewCollection* pCollection, GLC_Viewport* pViewport, GLC_Light* pLight, bool useInstancing)
+{
+	GLC_State::setInstancedRenderingUsage(useInstancing);
+	GLC_RenderStatistics::reset();
+
+	QGLFramebufferObject frameBuffer(imageSize, imageSize, QGLFramebufferObject::Depth);
+	frameBuffer.bind();
+	glViewport(0, 0, imageSize, imageSize);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	GLC_Context::current()->glcLoadIdentity();
+	pViewport->setDistMinAndMax(pCollection->boundingBox());
+	pLight->glExecute();
+	pViewport->glExecuteCam();
+	pCollection->render(0, glc::ShadingFlag);
+	glFinish();
+	frameBuffer.release();
+
+	qDebug() << (useInstancing ? "Instanced" : "Not instanced") << "draw calls :" << GLC_RenderStatistics::drawCallCount();
+	return frameBuffer.toImage();
+}
+
+// Return the number of pixels of the given images which differ
+static int differentPixelCount(const QImage& image1, const QImage& image2)
+{
+	int result= 0;
+	for (int y= 0; y < image1.height(); ++y)
+	{
+		for (int x= 0; x < image1.width(); ++x)
+		{
+			const QRgb pixel1= image1.pixel(x, y);
+			const QRgb pixel2= image2.pixel(x, y);
+			if ((qAbs(qRed(pixel1) - qRed(pixel2)) > colorTolerance) || (qAbs(qGreen(pixel1) - qGreen(pixel2)) > colorTolerance)
+					|| (qAbs(qBlue(pixel1) - qBlue(pixel2)) > colorTolerance))
+			{
+				++result;
+			}
+		}
+	}
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	QApplication app(argc, argv);
+
+	QGLWidget widget(new GLC_Context(QGLFormat()));
+	widget.resize(imageSize, imageSize);
+	widget.show();
+	widget.makeCurrent();
+
+	GLC_Viewport viewport;
+	viewport.initGl();
+	viewport.setWinGLSize(imageSize, imageSize);
+	GLC_Light light;
+
+	GLC_State::setVboUsage(true);
+	GLC_RenderStatistics::setActivationFlag(true);
+
+	GLC_3DViewCollection collection;
+	fillCollection(&collection);
+	viewport.cameraHandle()->setIsoView();
+	viewport.reframe(collection.boundingBox());
+
+	qDebug() << "OpenGL renderer :" << GLC_State::renderer();
+	GLC_State::setInstancedRenderingUsage(true);
+	if (!GLC_InstancedRenderer::isUsable())
+	{
+		qDebug() << "Instanced rendering is not supported";
+		return EXIT_SUCCESS;
+	}
+
+	const QImage reference(render(&collection, &viewport, &light, false));
+	const unsigned int referenceDrawCalls= GLC_RenderStatistics::drawCallCount();
+	const QImage instanced(render(&collection, &viewport, &light, true));
+	const unsigned int instancedDrawCalls= GLC_RenderStatistics::drawCallCount();
+
+	const int differentPixels= differentPixelCount(reference, instanced);
+	qDebug() << "Different pixels :" << differentPixels;
+
+	// Edges rasterized by the shader may differ from the fixed pipeline by a few pixels
+	const bool isValid= (instancedDrawCalls < referenceDrawCalls) && (differentPixels <= (imageSize * imageSize / 200));
+	qDebug() << (isValid ? "Instanced rendering is valid" : "Instanced rendering differs");
+	return isValid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
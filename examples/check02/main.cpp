@@ -0,0 +1,167 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+// Check of the visibility and selection bit sets of a collection
+/* Does not need an OpenGL context, the exit code is not null if a check fails*/
+
+#include <QApplication>
+#include <QtDebug>
+
+#include <cstdlib>
+
+#include <GLC_BitSet>
+#include <GLC_3DViewCollection>
+#include <GLC_3DViewInstance>
+#include <GLC_3DRep>
+#include <GLC_Box>
+
+// Number of instances of the collection, not a multiple of the bit set word size
+static const int instanceCount= 100;
+
+// Number of failed checks
+static int failureCount= 0;
+
+// Print the result of the given check
+static void check(bool condition, const char* description)
+{
+	if (!condition) ++failureCount;
+	qDebug() << (condition ? "Passed :" : "FAILED :") << description;
+}
+
+// Return true if the visibility bits of the given collection match the visibility of its instances
+static bool visibleBitsMatchInstances(const GLC_3DViewCollection& collection)
+{
+	bool subject= collection.visibleBits().size() == collection.size();
+	const int size= collection.size();
+	for (int i= 0; subject && (i < size); ++i)
+	{
+		subject= collection.visibleBits().testBit(i) == collection.instanceHandleAt(i)->isVisible();
+	}
+	return subject;
+}
+
+// Check the bit set operations
+static void checkBitSet()
+{
+	GLC_BitSet bitSet(instanceCount);
+	check(!bitSet.hasSetBit() && (bitSet.count() == 0), "A new bit set has no set bit");
+
+	bitSet.setBit(3);
+	bitSet.setBit(64);
+	bitSet.setBit(instanceCount - 1);
+	check(bitSet.count() == 3, "count() returns the number of set bits");
+	check((bitSet.nextSetBit(0) == 3) && (bitSet.nextSetBit(4) == 64) && (bitSet.nextSetBit(65) == instanceCount - 1)
+			&& (bitSet.nextSetBit(instanceCount) == -1), "nextSetBit() iterates over the set bits");
+
+	const GLC_BitSet inverted(~bitSet);
+	check(inverted.count() == instanceCount - 3, "The unused bits of the last word stay null after an inversion");
+
+	GLC_BitSet other(instanceCount);
+	other.setBit(64);
+	other.setBit(65);
+	GLC_BitSet result(bitSet);
+	result&= other;
+	check((result.count() == 1) && result.testBit(64), "operator&= keeps the common bits");
+	result= bitSet;
+	result|= other;
+	check(result.count() == 4, "operator|= merges the bits");
+	result= bitSet;
+	result.subtract(other);
+	check((result.count() == 2) && !result.testBit(64), "subtract() clears the bits of the other bit set");
+
+	GLC_BitSet filled(instanceCount, true);
+	filled.resize(40);
+	filled.resize(instanceCount);
+	check(filled.count() == 40, "The bits added by resize() are not set");
+}
+
+// Check the bit sets of a collection
+static void checkCollection()
+{
+	GLC_3DViewCollection collection;
+	const GLC_3DRep rep(new GLC_Box(1.0, 1.0, 1.0));
+	QList<GLC_uint> ids;
+	for (int i= 0; i < instanceCount; ++i)
+	{
+		GLC_3DViewInstance instance(rep);
+		ids.append(instance.id());
+		collection.add(instance);
+	}
+	check(collection.visibleBits().count() == instanceCount, "All added instances are visible");
+
+	// Visibility changed on the instance, not through the collection
+	collection.instanceHandle(ids.at(10))->setVisibility(false);
+	collection.instanceHandle(ids.at(70))->setVisibility(false);
+	check(visibleBitsMatchInstances(collection), "GLC_3DViewInstance::setVisibility() updates the visibility bits");
+	check(collection.drawableObjectsSize() == instanceCount - 2, "Hidden instances are not drawable");
+	check(!collection.visibleInstancesHandle().contains(collection.instanceHandle(ids.at(10))), "A hidden instance is not in the visible instances");
+
+	// The last instance takes the index of a removed instance
+	collection.remove(ids.at(20));
+	collection.instanceHandle(ids.last())->setVisibility(false);
+	check(visibleBitsMatchInstances(collection), "The visibility bit of a moved instance follows its new index");
+
+	collection.swapShowState();
+	check(collection.viewableBits().count() == 3, "In the no show state the hidden instances are viewable");
+	collection.swapShowState();
+
+	collection.showAll();
+	check((collection.visibleBits().count() == instanceCount - 1) && visibleBitsMatchInstances(collection), "showAll() shows all instances");
+	collection.hideAll();
+	check(!collection.visibleBits().hasSetBit() && visibleBitsMatchInstances(collection), "hideAll() hides all instances");
+	collection.showAll();
+
+	// The selection hash table is kept up to date
+	PointerViewInstanceHash* pSelection= collection.selection();
+	collection.select(ids.at(1));
+	collection.select(ids.at(2));
+	check((pSelection->size() == 2) && pSelection->contains(ids.at(1)) && (collection.selectionSize() == 2),
+			"A selection hash table already returned contains the new selected instances");
+	collection.unselect(ids.at(1));
+	check((pSelection->size() == 1) && !pSelection->contains(ids.at(1)), "A selection hash table already returned loses the unselected instances");
+
+	collection.setSelectedVisibility(false);
+	check(!collection.instanceHandle(ids.at(2))->isVisible() && visibleBitsMatchInstances(collection), "setSelectedVisibility() hides the selected instances");
+	collection.swapSelectedVisibility();
+	check(collection.instanceHandle(ids.at(2))->isVisible() && visibleBitsMatchInstances(collection), "swapSelectedVisibility() shows the hidden selected instances");
+
+	collection.selectAll();
+	check((pSelection->size() == instanceCount - 1) && (collection.selectedBits().count() == instanceCount - 1), "selectAll() selects all viewable instances");
+	collection.unselectAll();
+	check(pSelection->isEmpty() && !collection.selectedBits().hasSetBit(), "unselectAll() empties the selection");
+
+	// An instance copied out of the collection does not change the collection
+	GLC_3DViewInstance copy(*collection.instanceHandle(ids.at(3)));
+	copy.setVisibility(false);
+	check(collection.instanceHandle(ids.at(3))->isVisible() && visibleBitsMatchInstances(collection), "A copy of an instance is not in the collection");
+}
+
+int main(int argc, char **argv)
+{
+	QApplication app(argc, argv);
+
+	checkBitSet();
+	checkCollection();
+
+	qDebug() << failureCount << "failed checks";
+	return (0 == failureCount) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -10,7 +10,13 @@ SUBDIRS +=  example01 \
             example08 \
             example09 \
             example10 \
-            example11
+            example11 \
+            benchmark01 \
+            benchmark02 \
+            benchmark03 \
+            benchmark04 \
+            check01 \
+            check02
 }
 
 
@@ -102,7 +102,7 @@ void GLC_3DWidget::setVisible(bool visible)
 		const int instanceCount= m_InstanceIdList.size();
 		for (int i= 0; i < instanceCount; ++i)
 		{
-			m_pWidgetManagerHandle->instanceHandle(m_InstanceIdList.at(i))->setVisibility(visible);
+			m_pWidgetManagerHandle->set3DViewInstanceVisibility(m_InstanceIdList.at(i), visible);
 		}
 		resetViewState();
 	}
@@ -165,7 +165,7 @@ void GLC_3DWidget::remove3DViewInstance()
 
 void GLC_3DWidget::set3DViewInstanceVisibility(int index, bool visibility)
 {
-	m_pWidgetManagerHandle->instanceHandle(m_InstanceIdList[index])->setVisibility(visibility);
+	m_pWidgetManagerHandle->set3DViewInstanceVisibility(m_InstanceIdList[index], visibility);
 }
 
 
@@ -133,6 +133,10 @@ public:
 	//! Set the visibility of the given 3D widget id
 	void setWidgetVisible(GLC_uint id, bool visible);
 
+	//! Set the visibility of the 3D view instance with the given id
+	inline void set3DViewInstanceVisibility(GLC_uint id, bool visible)
+	{m_Collection.setVisibility(id, visible);}
+
 //@}
 //////////////////////////////////////////////////////////////////////
 /*! \name Interaction Functions*/
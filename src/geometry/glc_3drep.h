@@ -24,8 +24,11 @@
 #ifndef GLC_3DREP_H_
 #define GLC_3DREP_H_
 
+#include <QSharedPointer>
+
 #include "glc_geometry.h"
 #include "glc_rep.h"
+#include "glc_mappedbuffer.h"
 
 #include "../glc_config.h"
 
@@ -176,6 +179,21 @@ public:
 
 //@}
 
+//////////////////////////////////////////////////////////////////////
+/*! \name Binary serialisation Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Save this 3DRep to the given data stream
+	/*! If the given bulk device is not NULL, meshes bulk data are written aligned in this device*/
+	void saveToDataStream(QDataStream& stream, QIODevice* pBulkDevice= NULL) const;
+
+	//! Load this empty 3DRep from the given data stream
+	/*! If the given mapped buffer is not null, meshes bulk data are referenced from it*/
+	void loadFromDataStream(QDataStream& stream, const QSharedPointer<GLC_MappedBuffer>& mappedBuffer= QSharedPointer<GLC_MappedBuffer>());
+
+//@}
+
 //////////////////////////////////////////////////////////////////////
 // private services functions
 //////////////////////////////////////////////////////////////////////
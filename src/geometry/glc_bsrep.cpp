@@ -21,7 +21,11 @@
  *****************************************************************************/
 //! \file glc_bsrep.cpp implementation for the GLC_BSRep class.
 
+#include <QBuffer>
+#include <QSysInfo>
+
 #include "glc_bsrep.h"
+#include "glc_mappedbuffer.h"
 #include "../glc_fileformatexception.h"
 #include "../glc_tracelog.h"
 
@@ -32,7 +36,7 @@ const QString GLC_BSRep::m_Suffix("BSRep");
 const QUuid GLC_BSRep::m_Uuid("{d6f97789-36a9-4c2e-b667-0e66c27f839f}");
 
 // The binary rep version
-const quint32 GLC_BSRep::m_Version= 103;
+const quint32 GLC_BSRep::m_Version= 105;
 
 // Mutex used by compression
 QMutex GLC_BSRep::m_CompressionMutex;
@@ -44,6 +48,7 @@ GLC_BSRep::GLC_BSRep(const QString& fileName, bool useCompression)
 , m_DataStream()
 , m_UseCompression(useCompression)
 , m_CompressionLevel(-1)
+, m_UseMappedStorage(false)
 {
 	setAbsoluteFileName(fileName);
 	m_DataStream.setVersion(QDataStream::Qt_4_6);
@@ -57,6 +62,7 @@ GLC_BSRep::GLC_BSRep(const GLC_BSRep& binaryRep)
 , m_DataStream()
 , m_UseCompression(binaryRep.m_UseCompression)
 , m_CompressionLevel(binaryRep.m_CompressionLevel)
+, m_UseMappedStorage(binaryRep.m_UseMappedStorage)
 {
 	m_DataStream.setVersion(QDataStream::Qt_4_6);
 	m_DataStream.setFloatingPointPrecision(binaryRep.m_DataStream.floatingPointPrecision());
@@ -76,6 +82,7 @@ bool GLC_BSRep::isUsable(const QDateTime& timeStamp)
 		if (headerIsOk())
 		{
 			isUpToDate= timeStampOk(timeStamp);
+			isUpToDate= isUpToDate && storageIsOk();
 			isUpToDate= isUpToDate && close();
 		}
 	}
@@ -111,9 +118,10 @@ GLC_3DRep GLC_BSRep::loadRep(QFile *pFile)
 			timeStampOk(QDateTime());
 			GLC_BoundingBox boundingBox;
 			m_DataStream >> boundingBox;
-			bool useCompression;
-			m_DataStream >> useCompression;
-			if (useCompression)
+			// Storage is saved as a boolean (Compressed or not) before version 104
+			quint8 storage;
+			m_DataStream >> storage;
+			if (storage == CompressedStorage)
 			{
 				QByteArray CompresseBuffer;
 				m_DataStream >> CompresseBuffer;
@@ -124,6 +132,28 @@ GLC_3DRep GLC_BSRep::loadRep(QFile *pFile)
 				QDataStream bufferStream(uncompressedBuffer);
 				bufferStream >> loadedRep;
 			}
+			else if (storage == MappedStorage)
+			{
+				quint8 byteOrder;
+				m_DataStream >> byteOrder;
+				qint64 bulkOffset;
+				m_DataStream >> bulkOffset;
+
+				// Bulk data are shared with the meshes, the file is unmapped with the last mesh data
+				QSharedPointer<GLC_MappedBuffer> mappedBuffer;
+				if ((byteOrder == QSysInfo::ByteOrder) && (bulkOffset <= m_pFile->size()))
+				{
+					mappedBuffer= QSharedPointer<GLC_MappedBuffer>(new GLC_MappedBuffer(m_pFile->fileName(), bulkOffset, m_pFile->size() - bulkOffset));
+				}
+				if (mappedBuffer.isNull() || !mappedBuffer->isValid())
+				{
+					QString message(QString("GLC_BSRep::loadRep Unable to map the file ") + m_FileInfo.fileName());
+					GLC_FileFormatException fileFormatException(message, m_FileInfo.fileName(), GLC_FileFormatException::FileNotSupported);
+					close();
+					throw(fileFormatException);
+				}
+				loadedRep.loadFromDataStream(m_DataStream, mappedBuffer);
+			}
 			else
 			{
 				m_DataStream >> loadedRep;
@@ -213,11 +243,31 @@ bool GLC_BSRep::save(const GLC_3DRep& rep)
 		// Representation Bounding Box
 		m_DataStream << rep.boundingBox();
 
-		// Compression usage
-
-		if (m_UseCompression && (rep.faceCount() < 1000000))
+		// Storage of the representation
+		if (m_UseMappedStorage)
 		{
-			m_DataStream << true;
+			m_DataStream << static_cast<quint8>(MappedStorage);
+			m_DataStream << static_cast<quint8>(QSysInfo::ByteOrder);
+			const qint64 bulkOffsetPos= m_pFile->pos();
+			m_DataStream << static_cast<qint64>(0);
+
+			// Representation structure, bulk data are written in a separate buffer
+			QBuffer bulkBuffer;
+			bulkBuffer.open(QIODevice::WriteOnly);
+			rep.saveToDataStream(m_DataStream, &bulkBuffer);
+			bulkBuffer.close();
+
+			// Aligned bulk data at the end of the file
+			GLC_MappedBuffer::padDevice(m_pFile);
+			const qint64 bulkOffset= m_pFile->pos();
+			m_pFile->write(bulkBuffer.data());
+
+			m_pFile->seek(bulkOffsetPos);
+			m_DataStream << bulkOffset;
+		}
+		else if (m_UseCompression && (rep.faceCount() < 1000000))
+		{
+			m_DataStream << static_cast<quint8>(CompressedStorage);
 			QByteArray uncompressedBuffer;
 			{
 				QBuffer buffer(&uncompressedBuffer);
@@ -229,7 +279,7 @@ bool GLC_BSRep::save(const GLC_3DRep& rep)
 		}
 		else
 		{
-			m_DataStream << false;
+			m_DataStream << static_cast<quint8>(StreamStorage);
 			// Binary representation geometry
 			// Add the rep
 			m_DataStream << rep;
@@ -353,3 +403,25 @@ bool GLC_BSRep::timeStampOk(const QDateTime& timeStamp)
 	return timeStampOk;
 }
 
+// Check the storage of the representation
+bool GLC_BSRep::storageIsOk()
+{
+	Q_ASSERT(m_pFile != NULL);
+	Q_ASSERT(m_DataStream.device() != NULL);
+	Q_ASSERT(m_pFile->openMode() == QIODevice::ReadOnly);
+
+	GLC_BoundingBox boundingBox;
+	m_DataStream >> boundingBox;
+	quint8 storage;
+	m_DataStream >> storage;
+
+	bool storageOk= (storage <= MappedStorage);
+	if (storage == MappedStorage)
+	{
+		// A mapped representation is only usable with the same byte order
+		quint8 byteOrder;
+		m_DataStream >> byteOrder;
+		storageOk= (byteOrder == QSysInfo::ByteOrder);
+	}
+	return storageOk;
+}
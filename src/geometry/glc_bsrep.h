@@ -78,6 +78,10 @@ public:
 
 	//! Return bsrep version
 	static quint32 version();
+
+	//! Return true if bulk data are saved aligned in order to be memory mapped
+	inline bool mappedStorageIsUsed() const
+	{return m_UseMappedStorage;}
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -99,6 +103,13 @@ public:
 	inline void setCompressionLevel(int level)
 	{m_CompressionLevel= level;}
 
+	//! Set the mapped storage usage for saving a 3DRep in binary format
+	/*! With mapped storage, bulk data are saved uncompressed and aligned after the
+	 *  representation structure. On loading, the file is memory mapped and bulk data
+	 *  are only read when they are used. Mapped storage takes precedence over compression.*/
+	inline void setMappedStorageUsage(bool usage)
+	{m_UseMappedStorage= usage;}
+
 //@}
 
 private:
@@ -121,10 +132,21 @@ private:
 	//! Check the time Stamp
 	bool timeStampOk(const QDateTime&);
 
+	//! Check the storage of the representation
+	bool storageIsOk();
+
 //////////////////////////////////////////////////////////////////////
 // Private members
 //////////////////////////////////////////////////////////////////////
 private:
+	//! Storage of the representation
+	enum Storage
+	{
+		StreamStorage= 0,
+		CompressedStorage= 1,
+		MappedStorage= 2
+	};
+
 	//! The binary rep suffix
 	static const QString m_Suffix;
 
@@ -149,6 +171,9 @@ private:
 	//! The compression level
 	int m_CompressionLevel;
 
+	//! Save bulk data aligned in order to be memory mapped
+	bool m_UseMappedStorage;
+
 	//! Compression Mutex
 	static QMutex m_CompressionMutex;
 
@@ -168,7 +168,7 @@ void GLC_ExtrudedMesh::createMesh()
         vertices+= face1Vertices;
         normals+= face1Normals;
         Q_ASSERT(vertices.size() == normals.size());
-        glc::triangulatePolygon(&face1Index, vertices.toList());
+        glc::triangulatePolygon(&face1Index, vertices.constData());
         addTriangles(pMaterial, face1Index);
     }
 
@@ -186,7 +186,7 @@ void GLC_ExtrudedMesh::createMesh()
         vertices+= face2Vertices;
         normals+= face2Normals;
         Q_ASSERT(vertices.size() == normals.size());
-        glc::triangulatePolygon(&face2Index, vertices.toList());
+        glc::triangulatePolygon(&face2Index, vertices.constData());
         addTriangles(pMaterial, face2Index);
     }
 
@@ -143,6 +143,16 @@ double GLC_Geometry::volume()
 	return 0.0;
 }
 
+bool GLC_Geometry::intersect(const GLC_Line3d&, double*, GLC_uint*)
+{
+	return false;
+}
+
+QVector<GLfloat> GLC_Geometry::triangleVertices()
+{
+	return QVector<GLfloat>();
+}
+
 /////////////////////////////////////////////////////////////////////
 // Set Functions
 //////////////////////////////////////////////////////////////////////
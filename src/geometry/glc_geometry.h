@@ -56,6 +56,8 @@ typedef QHash<GLC_uint, GLC_uint> MaterialHashMap;
  *      - Empty virtual method for setting the current level of detail (between 0 and 100)    : GLC_Geometry::setCurrentLod()
  *      - Empty virtual method to get the number of vertex                                    : GLC_Geometry::numberOfVertex()
  *      - Empty virtual method to get the number of faces                                     : GLC_Geoetry::numberOfFaces()
+ *      - Empty virtual method to intersect the geometry with a ray                           : GLC_Geometry::intersect()
+ *      - Empty virtual method to get the vertices of the geometry triangles                  : GLC_Geometry::triangleVertices()
  *
  */
 //////////////////////////////////////////////////////////////////////
@@ -194,6 +196,15 @@ public:
 	//! Return the volume of this geometry
 	virtual double volume();
 
+	//! Return true if the given ray intersect this geometry
+	/*! If the ray intersect, the parameter of the nearest intersection on the ray
+	 *  and the id of the intersected primitive are set. This implementation return false.*/
+	virtual bool intersect(const GLC_Line3d& ray, double* pParameter, GLC_uint* pPrimitiveId);
+
+	//! Return the 9 coordinates of each triangle of this geometry
+	/*! Used by CPU occlusion culling, this implementation return an empty vector*/
+	virtual QVector<GLfloat> triangleVertices();
+
 	//! Return true if this geometry will try to use VBO
 	inline bool vboIsUsed() const
 	{return m_UseVbo;}
@@ -35,6 +35,10 @@ GLC_Lod::GLC_Lod()
 , m_IndexVector()
 , m_IndexSize(0)
 , m_TrianglesCount(0)
+, m_MappedBuffer()
+, m_MappedOffset(0)
+, m_MappedSize(0)
+, m_IndexType(GL_UNSIGNED_INT)
 {
 
 }
@@ -46,6 +50,10 @@ GLC_Lod::GLC_Lod(double accuracy)
 , m_IndexVector()
 , m_IndexSize(0)
 , m_TrianglesCount(0)
+, m_MappedBuffer()
+, m_MappedOffset(0)
+, m_MappedSize(0)
+, m_IndexType(GL_UNSIGNED_INT)
 {
 
 }
@@ -57,6 +65,10 @@ GLC_Lod::GLC_Lod(const GLC_Lod& lod)
 , m_IndexVector(lod.indexVector())
 , m_IndexSize(lod.m_IndexSize)
 , m_TrianglesCount(lod.m_TrianglesCount)
+, m_MappedBuffer()
+, m_MappedOffset(0)
+, m_MappedSize(0)
+, m_IndexType(lod.m_IndexType)
 {
 
 
@@ -70,8 +82,10 @@ GLC_Lod& GLC_Lod::operator=(const GLC_Lod& lod)
 		m_Accuracy= lod.m_Accuracy;
 		m_IndexBuffer.destroy();
 		m_IndexVector= lod.indexVector();
+		releaseMappedIndex();
 		m_IndexSize= lod.m_IndexSize;
 		m_TrianglesCount= lod.m_TrianglesCount;
+		m_IndexType= lod.m_IndexType;
 	}
 
 	return *this;
@@ -103,11 +117,26 @@ QVector<GLuint> GLC_Lod::indexVector() const
 
 		const_cast<QGLBuffer&>(m_IndexBuffer).bind();
 		GLvoid* pIbo = const_cast<QGLBuffer&>(m_IndexBuffer).map(QGLBuffer::ReadOnly);
-		memcpy(indexVector.data(), pIbo, dataSize);
+		if (m_IndexType == GL_UNSIGNED_SHORT)
+		{
+			const GLushort* pShortIndex= static_cast<const GLushort*>(pIbo);
+			for (int i= 0; i < sizeOfIbo; ++i)
+			{
+				indexVector[i]= pShortIndex[i];
+			}
+		}
+		else
+		{
+			memcpy(indexVector.data(), pIbo, dataSize);
+		}
 		const_cast<QGLBuffer&>(m_IndexBuffer).unmap();
 		const_cast<QGLBuffer&>(m_IndexBuffer).release();
 		return indexVector;
 	}
+	else if (0 != m_MappedSize)
+	{
+		return m_MappedBuffer->uintVector(m_MappedOffset, m_MappedSize);
+	}
 	else
 	{
 		return m_IndexVector;
@@ -126,39 +155,28 @@ void GLC_Lod::copyIboToClientSide()
 
 void GLC_Lod::releaseIboClientSide(bool update)
 {
-	if(m_IndexBuffer.isCreated() && !m_IndexVector.isEmpty())
+	if(m_IndexBuffer.isCreated() && (!m_IndexVector.isEmpty() || (0 != m_MappedSize)))
 	{
 		if (update)
 		{
-			// Copy index from client side to serveur
-			m_IndexBuffer.bind();
-
-			const GLsizei indexNbr= static_cast<GLsizei>(m_IndexVector.size());
-			const GLsizeiptr indexSize = indexNbr * sizeof(GLuint);
-			m_IndexBuffer.allocate(m_IndexVector.data(), indexSize);
-			m_IndexBuffer.release();
+			uploadIndexToIbo();
 		}
-		m_IndexSize= m_IndexVector.size();
+		m_IndexSize= indexVectorSize();
 		m_IndexVector.clear();
+		releaseMappedIndex();
 	}
 }
 
 void GLC_Lod::setIboUsage(bool usage)
 {
-	if (usage && !m_IndexVector.isEmpty())
+	if (usage && (!m_IndexVector.isEmpty() || (0 != m_MappedSize)))
 	{
 		createIBO();
-		// Copy index from client side to serveur
-		m_IndexBuffer.bind();
+		uploadIndexToIbo();
 
-		const GLsizei indexNbr= static_cast<GLsizei>(m_IndexVector.size());
-		const GLsizeiptr indexSize = indexNbr * sizeof(GLuint);
-		m_IndexBuffer.allocate(m_IndexVector.data(), indexSize);
-		m_IndexBuffer.release();
-
-		m_IndexSize= m_IndexVector.size();
+		m_IndexSize= indexVectorSize();
 		m_IndexVector.clear();
-
+		releaseMappedIndex();
 	}
 	else if (!usage && m_IndexBuffer.isCreated())
 	{
@@ -177,6 +195,101 @@ void GLC_Lod::useIBO() const
 	}
 }
 
+//////////////////////////////////////////////////////////////////////
+// Mapped serialisation Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_Lod::saveToMappedStream(QDataStream& stream, QIODevice* pBulkDevice) const
+{
+	quint32 chunckId= m_ChunkId;
+	stream << chunckId;
+
+	stream << m_Accuracy;
+	stream << m_TrianglesCount;
+
+	const QVector<GLuint> index(indexVector());
+	const qint64 offset= GLC_MappedBuffer::appendAligned(pBulkDevice, index.constData(), index.size() * sizeof(GLuint));
+	stream << offset;
+	stream << static_cast<qint32>(index.size());
+}
+
+void GLC_Lod::loadFromMappedStream(QDataStream& stream, const QSharedPointer<GLC_MappedBuffer>& mappedBuffer)
+{
+	quint32 chunckId;
+	stream >> chunckId;
+	Q_ASSERT(chunckId == m_ChunkId);
+
+	stream >> m_Accuracy;
+	stream >> m_TrianglesCount;
+
+	qint32 size;
+	stream >> m_MappedOffset;
+	stream >> size;
+
+	m_IndexVector.clear();
+	m_MappedSize= size;
+	if (0 != m_MappedSize)
+	{
+		m_MappedBuffer= mappedBuffer;
+	}
+	else
+	{
+		releaseMappedIndex();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_Lod::faultInMappedIndex()
+{
+	Q_ASSERT(!m_MappedBuffer.isNull());
+	Q_ASSERT(m_IndexVector.isEmpty());
+	m_IndexVector= m_MappedBuffer->uintVector(m_MappedOffset, m_MappedSize);
+	releaseMappedIndex();
+}
+
+void GLC_Lod::uploadIndexToIbo()
+{
+	// Copy index from client side to serveur
+	m_IndexBuffer.bind();
+
+	const GLsizei indexNbr= static_cast<GLsizei>(indexVectorSize());
+	const GLsizeiptr indexSize = indexNbr * sizeof(GLuint);
+	if (m_IndexType == GL_UNSIGNED_SHORT)
+	{
+		// Index are narrowed to 16 bits
+		const GLuintVector index(m_IndexVector.isEmpty() ? m_MappedBuffer->uintVector(m_MappedOffset, m_MappedSize) : m_IndexVector);
+		QVector<GLushort> shortIndex(indexNbr);
+		int i= 0;
+		while ((i < indexNbr) && (index.at(i) <= 0xFFFF))
+		{
+			shortIndex[i]= static_cast<GLushort>(index.at(i));
+			++i;
+		}
+		if (i == indexNbr)
+		{
+			m_IndexBuffer.allocate(shortIndex.constData(), indexNbr * sizeof(GLushort));
+		}
+		else
+		{
+			// An index doesn't fit in 16 bits : fall back to 32 bits index
+			m_IndexType= GL_UNSIGNED_INT;
+			m_IndexBuffer.allocate(index.constData(), indexSize);
+		}
+	}
+	else if (m_IndexVector.isEmpty())
+	{
+		// Upload directly from the mapped file
+		m_IndexBuffer.allocate(m_MappedBuffer->constData(m_MappedOffset), indexSize);
+	}
+	else
+	{
+		m_IndexBuffer.allocate(m_IndexVector.data(), indexSize);
+	}
+	m_IndexBuffer.release();
+}
 
 QDataStream &operator<<(QDataStream &stream, const GLC_Lod &lod)
 {
@@ -195,6 +308,7 @@ QDataStream &operator>>(QDataStream &stream, GLC_Lod &lod)
 	stream >> chunckId;
 	Q_ASSERT(chunckId == GLC_Lod::m_ChunkId);
 
+	lod.releaseMappedIndex();
 	stream >> lod.m_Accuracy;
 	stream >> lod.m_IndexVector;
 	stream >> lod.m_TrianglesCount;
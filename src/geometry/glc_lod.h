@@ -27,8 +27,10 @@
 
 #include <QVector>
 #include <QGLBuffer>
+#include <QSharedPointer>
 
 #include "../glc_ext.h"
+#include "glc_mappedbuffer.h"
 
 #include "../glc_config.h"
 
@@ -90,16 +92,27 @@ public:
 	 * - Triangles Fans index
 	 */
 	inline QVector<GLuint>* indexVectorHandle()
-	{return &m_IndexVector;}
+	{
+		if (0 != m_MappedSize) faultInMappedIndex();
+		return &m_IndexVector;
+	}
 
 	//! Return the size of the index Vector
 	inline int indexVectorSize() const
-	{return m_IndexVector.size();}
+	{return m_IndexVector.size() + m_MappedSize;}
+
+	//! Return true if the index of this LOD are still in a mapped buffer
+	inline bool indexIsMapped() const
+	{return 0 != m_MappedSize;}
 
 	//! Return this lod triangle count
 	inline unsigned int trianglesCount() const
 	{return m_TrianglesCount;}
 
+	//! Return the type of the index in the IBO, GL_UNSIGNED_INT or GL_UNSIGNED_SHORT
+	inline GLenum indexType() const
+	{return m_IndexType;}
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -126,6 +139,16 @@ public:
 	//! Set IBO usage
 	void setIboUsage(bool usage);
 
+	//! Set the type of the index in the IBO, GL_UNSIGNED_INT or GL_UNSIGNED_SHORT
+	/*! The type is used when the IBO is filled, the client side index are always GLuint.
+	 *  If an index doesn't fit in 16 bits, the IBO is filled with GL_UNSIGNED_INT index
+	 *  and the type of this LOD is changed accordingly*/
+	inline void setIndexType(GLenum type)
+	{
+		Q_ASSERT((type == GL_UNSIGNED_INT) || (type == GL_UNSIGNED_SHORT));
+		m_IndexType= type;
+	}
+
 
 //@}
 
@@ -137,7 +160,7 @@ public:
 	//! IBO creation
 	inline void createIBO()
 	{
-		if (!m_IndexBuffer.isCreated() && !m_IndexVector.isEmpty())
+		if (!m_IndexBuffer.isCreated() && (!m_IndexVector.isEmpty() || (0 != m_MappedSize)))
 		{
 			m_IndexBuffer.create();
 		}
@@ -152,6 +175,37 @@ public:
 
 //@}
 
+//////////////////////////////////////////////////////////////////////
+/*! \name Mapped serialisation Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Save this LOD in the given stream, index are appended to the given bulk device
+	void saveToMappedStream(QDataStream& stream, QIODevice* pBulkDevice) const;
+
+	//! Load this LOD from the given stream, index are referenced in the given mapped buffer
+	void loadFromMappedStream(QDataStream& stream, const QSharedPointer<GLC_MappedBuffer>& mappedBuffer);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Copy index from the mapped buffer to the index vector
+	void faultInMappedIndex();
+
+	//! Upload client side index (Vector or mapped buffer) to the IBO
+	void uploadIndexToIbo();
+
+	//! Release the mapped buffer
+	inline void releaseMappedIndex()
+	{
+		m_MappedBuffer.clear();
+		m_MappedOffset= 0;
+		m_MappedSize= 0;
+	}
+
 //////////////////////////////////////////////////////////////////////
 // Private members
 //////////////////////////////////////////////////////////////////////
@@ -172,6 +226,18 @@ private:
 	//! Lod number of faces
 	unsigned int m_TrianglesCount;
 
+	//! The mapped buffer which contains the index not yet fault in
+	QSharedPointer<GLC_MappedBuffer> m_MappedBuffer;
+
+	//! The offset of the index in the mapped buffer
+	qint64 m_MappedOffset;
+
+	//! The number of index in the mapped buffer
+	int m_MappedSize;
+
+	//! The type of the index in the IBO
+	GLenum m_IndexType;
+
 	//! Class chunk id
 	static quint32 m_ChunkId;
 
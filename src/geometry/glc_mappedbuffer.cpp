@@ -0,0 +1,122 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_mappedbuffer.cpp implementation for the GLC_MappedBuffer class.
+
+#include "glc_mappedbuffer.h"
+#include "../glc_tracelog.h"
+
+GLC_MappedBuffer::GLC_MappedBuffer(const QString& fileName, qint64 offset, qint64 size)
+: m_File(fileName)
+, m_pMap(NULL)
+, m_Buffer()
+, m_pData(NULL)
+, m_Size(0)
+{
+	if (m_File.open(QIODevice::ReadOnly) && ((offset + size) <= m_File.size()))
+	{
+		m_pMap= m_File.map(offset, size);
+		if (NULL != m_pMap)
+		{
+			m_pData= m_pMap;
+			m_Size= size;
+		}
+		else if (m_File.seek(offset))
+		{
+			// The file cannot be mapped, read the region in memory
+			if (GLC_TraceLog::isEnable())
+			{
+				QStringList stringList("GLC_MappedBuffer::GLC_MappedBuffer");
+				stringList.append("File " + fileName + " cannot be mapped : " + m_File.errorString());
+				GLC_TraceLog::addTrace(stringList);
+			}
+			m_Buffer= m_File.read(size);
+			if (m_Buffer.size() == size)
+			{
+				m_pData= reinterpret_cast<const uchar*>(m_Buffer.constData());
+				m_Size= size;
+			}
+			m_File.close();
+		}
+	}
+}
+
+GLC_MappedBuffer::~GLC_MappedBuffer()
+{
+	if (NULL != m_pMap)
+	{
+		m_File.unmap(m_pMap);
+	}
+	m_File.close();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+GLfloatVector GLC_MappedBuffer::floatVector(qint64 offset, int count) const
+{
+	Q_ASSERT((offset + count * sizeof(GLfloat)) <= static_cast<quint64>(m_Size));
+	GLfloatVector subject(count);
+	memcpy(subject.data(), constData(offset), count * sizeof(GLfloat));
+
+	return subject;
+}
+
+GLuintVector GLC_MappedBuffer::uintVector(qint64 offset, int count) const
+{
+	Q_ASSERT((offset + count * sizeof(GLuint)) <= static_cast<quint64>(m_Size));
+	GLuintVector subject(count);
+	memcpy(subject.data(), constData(offset), count * sizeof(GLuint));
+
+	return subject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Tools Functions
+//////////////////////////////////////////////////////////////////////
+
+int GLC_MappedBuffer::alignment()
+{
+	// Enough for SSE/AVX loads and for the OpenGL buffer upload
+	return 32;
+}
+
+qint64 GLC_MappedBuffer::appendAligned(QIODevice* pDevice, const void* pData, qint64 size)
+{
+	padDevice(pDevice);
+	const qint64 offset= pDevice->pos();
+	if (size > 0)
+	{
+		pDevice->write(reinterpret_cast<const char*>(pData), size);
+	}
+	return offset;
+}
+
+void GLC_MappedBuffer::padDevice(QIODevice* pDevice)
+{
+	const qint64 remainder= pDevice->pos() % alignment();
+	if (remainder != 0)
+	{
+		const QByteArray padding(static_cast<int>(alignment() - remainder), '\0');
+		pDevice->write(padding);
+	}
+}
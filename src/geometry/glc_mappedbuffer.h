@@ -0,0 +1,129 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_mappedbuffer.h Interface for the GLC_MappedBuffer class.
+
+#ifndef GLC_MAPPEDBUFFER_H_
+#define GLC_MAPPEDBUFFER_H_
+
+#include <QFile>
+#include <QByteArray>
+#include <QSharedPointer>
+
+#include "../glc_global.h"
+
+#include "../glc_config.h"
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_MappedBuffer
+/*! \brief GLC_MappedBuffer : A read only memory mapped region of a file*/
+
+/*! GLC_MappedBuffer is used to reference bulk data of a mapped binary
+ *  representation (See GLC_BSRep) without copying them.
+ *  Pages of the file are only loaded by the system when they are touched.
+ *  If the file cannot be mapped, the region is read in memory.
+ *  GLC_MappedBuffer is shared between mesh data and LOD with a QSharedPointer,
+ *  the file is unmapped when the last reference is released.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_MappedBuffer
+{
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Map the region of the given size at the given offset of the given file
+	GLC_MappedBuffer(const QString& fileName, qint64 offset, qint64 size);
+
+	//! Destructor
+	~GLC_MappedBuffer();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return true if this mapped buffer is valid
+	inline bool isValid() const
+	{return NULL != m_pData;}
+
+	//! Return true if the file is really mapped (Not read in memory)
+	inline bool isMapped() const
+	{return NULL != m_pMap;}
+
+	//! Return the size of this buffer
+	inline qint64 size() const
+	{return m_Size;}
+
+	//! Return a pointer on the data at the given offset
+	inline const void* constData(qint64 offset) const
+	{
+		Q_ASSERT(offset <= m_Size);
+		return m_pData + offset;
+	}
+
+	//! Return a copy of the given count of GLfloat at the given offset
+	GLfloatVector floatVector(qint64 offset, int count) const;
+
+	//! Return a copy of the given count of GLuint at the given offset
+	GLuintVector uintVector(qint64 offset, int count) const;
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Tools Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return the alignment of data in a mapped buffer
+	static int alignment();
+
+	//! Append the given data to the given device at an aligned position and return this position
+	static qint64 appendAligned(QIODevice* pDevice, const void* pData, qint64 size);
+
+	//! Pad the given device with zero until its position is aligned
+	static void padDevice(QIODevice* pDevice);
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	Q_DISABLE_COPY(GLC_MappedBuffer)
+
+	//! The mapped file
+	QFile m_File;
+
+	//! The mapped memory
+	uchar* m_pMap;
+
+	//! The memory buffer used if the file cannot be mapped
+	QByteArray m_Buffer;
+
+	//! The data pointer
+	const uchar* m_pData;
+
+	//! The size of the buffer
+	qint64 m_Size;
+};
+
+#endif /* GLC_MAPPEDBUFFER_H_ */
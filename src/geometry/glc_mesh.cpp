@@ -23,12 +23,46 @@
 //! \file glc_mesh.cpp Implementation for the GLC_Mesh class.
 
 #include "glc_mesh.h"
+#include "glc_meshbvh.h"
+#include "glc_vertexcacheoptimizer.h"
+#include "../maths/glc_line3d.h"
+#include "../maths/glc_batchtransform.h"
 #include "../glc_renderstatistics.h"
 #include "../glc_context.h"
+#include "../glc_ext.h"
 
 // Class chunk id
 quint32 GLC_Mesh::m_ChunkId= 0xA701;
 
+// Return the given index renumbered with the given new index of each vertex
+static IndexList renumberedIndex(const IndexList& index, const QVector<int>& newIndex)
+{
+	IndexList subject;
+	subject.reserve(index.size());
+	const int size= index.size();
+	for (int i= 0; i < size; ++i)
+	{
+		subject.append(static_cast<GLuint>(newIndex.at(index.at(i))));
+	}
+	return subject;
+}
+
+// Move the vertices of the given vector of the given dimension to their new index
+static void moveVertices(GLfloatVector* pVector, int dimension, const QVector<int>& newIndex)
+{
+	if (pVector->isEmpty()) return;
+	const GLfloatVector source(*pVector);
+	const int vertexCount= newIndex.size();
+	for (int i= 0; i < vertexCount; ++i)
+	{
+		const int target= newIndex.at(i) * dimension;
+		for (int j= 0; j < dimension; ++j)
+		{
+			(*pVector)[target + j]= source.at(i * dimension + j);
+		}
+	}
+}
+
 GLC_Mesh::GLC_Mesh()
 :GLC_Geometry("Mesh", false)
 , m_NextPrimitiveLocalId(1)
@@ -39,6 +73,10 @@ GLC_Mesh::GLC_Mesh()
 , m_ColorPearVertex(false)
 , m_MeshData()
 , m_CurrentLod(0)
+, m_pBvh(NULL)
+, m_AcmrBeforeOptimization(-1.0)
+, m_AcmrAfterOptimization(-1.0)
+, m_NormalizeWasEnabled(false)
 {
 
 }
@@ -53,6 +91,10 @@ GLC_Mesh::GLC_Mesh(const GLC_Mesh& mesh)
 , m_ColorPearVertex(mesh.m_ColorPearVertex)
 , m_MeshData(mesh.m_MeshData)
 , m_CurrentLod(0)
+, m_pBvh(NULL)
+, m_AcmrBeforeOptimization(mesh.m_AcmrBeforeOptimization)
+, m_AcmrAfterOptimization(mesh.m_AcmrAfterOptimization)
+, m_NormalizeWasEnabled(false)
 {
 	// Make a copy of m_PrimitiveGroups with new material id
 	PrimitiveGroupsHash::const_iterator iPrimitiveGroups= mesh.m_PrimitiveGroups.constBegin();
@@ -95,6 +137,8 @@ GLC_Mesh& GLC_Mesh::operator=(const GLC_Mesh& mesh)
 		m_ColorPearVertex= mesh.m_ColorPearVertex;
 		m_MeshData= mesh.m_MeshData;
 		m_CurrentLod= 0;
+		m_AcmrBeforeOptimization= mesh.m_AcmrBeforeOptimization;
+		m_AcmrAfterOptimization= mesh.m_AcmrAfterOptimization;
 
 		// Make a copy of m_PrimitiveGroups with new material id
 		PrimitiveGroupsHash::const_iterator iPrimitiveGroups= mesh.m_PrimitiveGroups.constBegin();
@@ -122,6 +166,8 @@ GLC_Mesh& GLC_Mesh::operator=(const GLC_Mesh& mesh)
 // Destructor
 GLC_Mesh::~GLC_Mesh()
 {
+	delete m_pBvh;
+
 	PrimitiveGroupsHash::iterator iGroups= m_PrimitiveGroups.begin();
 	while (iGroups != m_PrimitiveGroups.constEnd())
 	{
@@ -166,13 +212,20 @@ const GLC_BoundingBox& GLC_Mesh::boundingBox()
 		//qDebug() << "GLC_Mesh2::boundingBox create boundingBox";
 		m_pBoundingBox= new GLC_BoundingBox();
 
-		if (m_MeshData.positionVectorHandle()->isEmpty())
+		// Packed positions are decoded in a copy to keep the mesh packed
+		GLfloatVector packedPositions;
+		if (m_MeshData.isPacked())
+		{
+			packedPositions= m_MeshData.positionVector();
+		}
+		const GLfloatVector* pVertexVector= m_MeshData.isPacked() ? &packedPositions : m_MeshData.positionVectorHandle();
+
+		if (pVertexVector->isEmpty())
 		{
 			qDebug() << "GLC_Mesh::boundingBox empty m_Positions";
 		}
 		else
 		{
-			GLfloatVector* pVertexVector= m_MeshData.positionVectorHandle();
 			const int max= pVertexVector->size();
 			for (int i= 0; i < max; i= i + 3)
 			{
@@ -213,7 +266,7 @@ QVector<GLuint> GLC_Mesh::getTrianglesIndex(int lod, GLC_uint materialId) const
 	int offset= 0;
 	if (vboIsUsed())
 	{
-		offset= static_cast<int>(reinterpret_cast<GLsizeiptr>(pPrimitiveGroup->trianglesIndexOffset()) / sizeof(GLuint));
+		offset= static_cast<int>(reinterpret_cast<GLsizeiptr>(pPrimitiveGroup->trianglesIndexOffset()) / m_MeshData.indexSize());
 	}
 	else
 	{
@@ -287,7 +340,7 @@ QList<QVector<GLuint> > GLC_Mesh::getStripsIndex(int lod, GLC_uint materialId) c
 		stripsCount= pPrimitiveGroup->stripsOffset().size();
 		for (int i= 0; i < stripsCount; ++i)
 		{
-			offsets.append(static_cast<int>(reinterpret_cast<GLsizeiptr>(pPrimitiveGroup->stripsOffset().at(i)) / sizeof(GLuint)));
+			offsets.append(static_cast<int>(reinterpret_cast<GLsizeiptr>(pPrimitiveGroup->stripsOffset().at(i)) / m_MeshData.indexSize()));
 			sizes.append(static_cast<int>(pPrimitiveGroup->stripsSizes().at(i)));
 		}
 	}
@@ -392,7 +445,7 @@ QList<QVector<GLuint> > GLC_Mesh::getFansIndex(int lod, GLC_uint materialId) con
 		fansCount= pPrimitiveGroup->fansOffset().size();
 		for (int i= 0; i < fansCount; ++i)
 		{
-			offsets.append(static_cast<int>(reinterpret_cast<GLsizeiptr>(pPrimitiveGroup->fansOffset().at(i)) / sizeof(GLuint)));
+			offsets.append(static_cast<int>(reinterpret_cast<GLsizeiptr>(pPrimitiveGroup->fansOffset().at(i)) / m_MeshData.indexSize()));
 			sizes.append(static_cast<int>(pPrimitiveGroup->fansSizes().at(i)));
 		}
 	}
@@ -505,26 +558,15 @@ GLC_Mesh& GLC_Mesh::transformVertice(const GLC_Matrix4x4& matrix)
 	{
 		delete m_pBoundingBox;
 		m_pBoundingBox= NULL;
+		clearBvh();
 		copyVboToClientSide();
 		const int stride= 3;
 		GLfloatVector* pVectPos= m_MeshData.positionVectorHandle();
+		glc::transformPoints(matrix.getData(), pVectPos->data(), pVectPos->size() / stride);
+
 		const GLC_Matrix4x4 rotationMatrix= matrix.rotationMatrix();
 		GLfloatVector* pVectNormal= m_MeshData.normalVectorHandle();
-		const int verticeCount= pVectPos->size() / stride;
-		for (int i= 0; i < verticeCount; ++i)
-		{
-			GLC_Vector3d newPos(pVectPos->at(stride * i), pVectPos->at(stride * i + 1), pVectPos->at(stride * i + 2));
-			newPos= matrix * newPos;
-			pVectPos->operator[](stride * i)= static_cast<GLfloat>(newPos.x());
-			pVectPos->operator[](stride * i + 1)= static_cast<GLfloat>(newPos.y());
-			pVectPos->operator[](stride * i + 2)= static_cast<GLfloat>(newPos.z());
-
-			GLC_Vector3d newNormal(pVectNormal->at(stride * i), pVectNormal->at(stride * i + 1), pVectNormal->at(stride * i + 2));
-			newNormal= rotationMatrix * newNormal;
-			pVectNormal->operator[](stride * i)= static_cast<GLfloat>(newNormal.x());
-			pVectNormal->operator[](stride * i + 1)= static_cast<GLfloat>(newNormal.y());
-			pVectNormal->operator[](stride * i + 2)= static_cast<GLfloat>(newNormal.z());
-		}
+		glc::transformVectors(rotationMatrix.getData(), pVectNormal->data(), pVectNormal->size() / stride);
 		releaseVboClientSide(true);
 	}
 
@@ -584,6 +626,123 @@ double GLC_Mesh::volume()
 	return resultVolume;
 }
 
+bool GLC_Mesh::intersect(const GLC_Line3d& ray, double* pParameter, GLC_uint* pPrimitiveId)
+{
+	if (m_MeshData.isEmpty() || !boundingBox().intersect(ray)) return false;
+
+	if (NULL == m_pBvh)
+	{
+		m_pBvh= createBvh();
+	}
+
+	return m_pBvh->intersect(ray, pParameter, pPrimitiveId);
+}
+
+QVector<GLfloat> GLC_Mesh::triangleVertices()
+{
+	if (m_MeshData.isEmpty()) return QVector<GLfloat>();
+
+	if (NULL == m_pBvh)
+	{
+		m_pBvh= createBvh();
+	}
+
+	return m_pBvh->vertices();
+}
+
+// Get the triangles of the given LOD with their primitive id and their material id
+void GLC_Mesh::lodTriangles(int lod, GLuintVector* pTriangles, QVector<GLC_uint>* pPrimitiveIds, QVector<GLC_uint>* pMaterialIds) const
+{
+	Q_ASSERT((NULL != pTriangles) && (NULL != pPrimitiveIds));
+
+	LodPrimitiveGroups* pGroups= m_PrimitiveGroups.value(lod);
+	if ((NULL == pGroups) || (lod >= m_MeshData.lodCount())) return;
+
+	const GLuintVector index= m_MeshData.indexVector(lod);
+	const int indexSize= index.size();
+
+	LodPrimitiveGroups::const_iterator iGroup= pGroups->constBegin();
+	while (pGroups->constEnd() != iGroup)
+	{
+		GLC_PrimitiveGroup* pCurrentGroup= iGroup.value();
+		const int firstTriangle= pPrimitiveIds->size();
+		// Index of a group are in the LOD index vector when the mesh is finished
+		if (pCurrentGroup->isFinished())
+		{
+			// Triangles
+			if (pCurrentGroup->containsTrianglesGroupId())
+			{
+				const int trianglesGroupCount= pCurrentGroup->trianglesGroupOffseti().size();
+				for (int i= 0; i < trianglesGroupCount; ++i)
+				{
+					const int offset= static_cast<int>(pCurrentGroup->trianglesGroupOffseti().at(i));
+					const int size= pCurrentGroup->trianglesIndexSizes().at(i);
+					if ((offset + size) > indexSize) continue;
+					const GLC_uint id= pCurrentGroup->triangleGroupId(i);
+					for (int j= 0; (j + 2) < size; j+= 3)
+					{
+						(*pTriangles) << index.at(offset + j) << index.at(offset + j + 1) << index.at(offset + j + 2);
+						pPrimitiveIds->append(id);
+					}
+				}
+			}
+
+			// Triangles strips, odd triangles are reversed to keep the strip orientation
+			if (pCurrentGroup->containsStripGroupId())
+			{
+				const int stripsCount= pCurrentGroup->stripsOffseti().size();
+				for (int i= 0; i < stripsCount; ++i)
+				{
+					const int offset= static_cast<int>(pCurrentGroup->stripsOffseti().at(i));
+					const int size= pCurrentGroup->stripsSizes().at(i);
+					if ((offset + size) > indexSize) continue;
+					const GLC_uint id= pCurrentGroup->stripGroupId(i);
+					for (int j= 2; j < size; ++j)
+					{
+						if (0 == (j % 2))
+						{
+							(*pTriangles) << index.at(offset + j - 2) << index.at(offset + j - 1) << index.at(offset + j);
+						}
+						else
+						{
+							(*pTriangles) << index.at(offset + j - 1) << index.at(offset + j - 2) << index.at(offset + j);
+						}
+						pPrimitiveIds->append(id);
+					}
+				}
+			}
+
+			// Triangles fans
+			if (pCurrentGroup->containsFanGroupId())
+			{
+				const int fansCount= pCurrentGroup->fansOffseti().size();
+				for (int i= 0; i < fansCount; ++i)
+				{
+					const int offset= static_cast<int>(pCurrentGroup->fansOffseti().at(i));
+					const int size= pCurrentGroup->fansSizes().at(i);
+					if ((offset + size) > indexSize) continue;
+					const GLC_uint id= pCurrentGroup->fanGroupId(i);
+					for (int j= 2; j < size; ++j)
+					{
+						(*pTriangles) << index.at(offset) << index.at(offset + j - 1) << index.at(offset + j);
+						pPrimitiveIds->append(id);
+					}
+				}
+			}
+		}
+
+		if (NULL != pMaterialIds)
+		{
+			const int triangleCount= pPrimitiveIds->size() - firstTriangle;
+			for (int i= 0; i < triangleCount; ++i)
+			{
+				pMaterialIds->append(iGroup.key());
+			}
+		}
+		++iGroup;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////
 // Set Functions
 //////////////////////////////////////////////////////////////////////
@@ -629,6 +788,9 @@ void GLC_Mesh::clearMeshWireAndBoundingBox()
 	// Clear data of the mesh
 	m_MeshData.clear();
 	m_CurrentLod= 0;
+	clearBvh();
+	m_AcmrBeforeOptimization= -1.0;
+	m_AcmrAfterOptimization= -1.0;
 
 	GLC_Geometry::clearWireAndBoundingBox();
 }
@@ -700,6 +862,13 @@ GLC_uint GLC_Mesh::addTrianglesFan(GLC_Material* pMaterial, const IndexList& ind
 // Reverse mesh normal
 void GLC_Mesh::reverseNormals()
 {
+	// Packed normals are interleaved in the vertex VBO which is packed again
+	const bool packedVboIsUsed= m_MeshData.isPacked() && vboIsUsed();
+	if (packedVboIsUsed)
+	{
+		m_MeshData.copyVboToClientSide();
+	}
+
 	GLfloatVector* pNormalVector= m_MeshData.normalVectorHandle();
 	if (pNormalVector->isEmpty())
 	{
@@ -710,7 +879,11 @@ void GLC_Mesh::reverseNormals()
 	{
 		(*pNormalVector)[i]= - pNormalVector->at(i);
 	}
-	if (vboIsUsed())
+	if (packedVboIsUsed)
+	{
+		m_MeshData.releaseVboClientSide(true);
+	}
+	else if (vboIsUsed())
 	{
 		m_MeshData.fillVbo(GLC_MeshData::GLC_Normal);
 		m_MeshData.useVBO(false, GLC_MeshData::GLC_Normal);
@@ -723,9 +896,20 @@ void GLC_Mesh::finish()
 	if (m_MeshData.lodCount() > 0)
 	{
 		boundingBox();
+		clearBvh();
 
 		m_MeshData.finishLod();
 
+		if (GLC_State::isStripAndFanConversionUsed())
+		{
+			convertStripsAndFansToTriangles();
+		}
+		if (GLC_State::isVertexCacheOptimizationUsed() && !m_MeshData.positionSizeIsSet() && !m_MeshData.isPacked())
+		{
+			optimizeVertexCache();
+		}
+		m_MeshData.updateIndexType();
+
 		moveIndexToMeshDataLod();
 	}
 	else
@@ -736,6 +920,64 @@ void GLC_Mesh::finish()
 	//qDebug() << "Mesh mem size= " << memmorySize();
 }
 
+// Append a LOD of the given accuracy to this finished mesh
+int GLC_Mesh::appendLod(double accuracy, const GLuintVector& triangles, const QVector<GLC_uint>& primitiveIds, const QVector<GLC_uint>& materialIds)
+{
+	Q_ASSERT((triangles.size() == (primitiveIds.size() * 3)) && (primitiveIds.size() == materialIds.size()));
+
+	// The index of the LOD of a drawn mesh can be only in its IBO
+	if (m_MeshData.positionSizeIsSet() || m_MeshData.isEmpty()) return -1;
+
+	const int lod= m_MeshData.lodCount();
+	Q_ASSERT(!m_PrimitiveGroups.contains(lod));
+	m_MeshData.appendLod(accuracy);
+
+	LodPrimitiveGroups* pGroups= new LodPrimitiveGroups();
+	m_PrimitiveGroups.insert(lod, pGroups);
+
+	// Triangles are added by runs of the same primitive id to keep primitive ids
+	const int triangleCount= primitiveIds.size();
+	int first= 0;
+	while (first < triangleCount)
+	{
+		const GLC_uint materialId= materialIds.at(first);
+		const GLC_uint primitiveId= primitiveIds.at(first);
+		int last= first + 1;
+		while ((last < triangleCount) && (materialIds.at(last) == materialId) && (primitiveIds.at(last) == primitiveId)) ++last;
+
+		GLuintVector runTriangles(triangles.mid(first * 3, (last - first) * 3));
+		if (GLC_State::isVertexCacheOptimizationUsed())
+		{
+			GLC_VertexCacheOptimizer::optimizeTriangles(runTriangles.data(), last - first);
+		}
+		const IndexList run(runTriangles.toList());
+
+		GLC_PrimitiveGroup* pGroup= pGroups->value(materialId);
+		if (NULL == pGroup)
+		{
+			pGroup= new GLC_PrimitiveGroup(materialId);
+			pGroups->insert(materialId, pGroup);
+		}
+		pGroup->addTriangles(run, primitiveId);
+		first= last;
+	}
+
+	LodPrimitiveGroups::iterator iGroup= pGroups->begin();
+	while (pGroups->constEnd() != iGroup)
+	{
+		iGroup.value()->setTrianglesOffseti(m_MeshData.indexVectorSize(lod));
+		(*m_MeshData.indexVectorHandle(lod))+= iGroup.value()->trianglesIndex().toVector();
+		iGroup.value()->computeVboOffset(m_MeshData.indexSize());
+		iGroup.value()->finish();
+		++iGroup;
+	}
+	m_MeshData.getLod(lod)->trianglesAdded(triangleCount);
+
+	m_GeometryIsValid= false;
+
+	return lod;
+}
+
 
 // Set the lod Index
 void GLC_Mesh::setCurrentLod(const int value)
@@ -831,12 +1073,18 @@ void GLC_Mesh::setVboUsage(bool usage)
 	if (!isEmpty())
 	{
 		GLC_Geometry::setVboUsage(usage);
+		const int indexSize= m_MeshData.indexSize();
 		m_MeshData.setVboUsage(usage);
+		if (indexSize != m_MeshData.indexSize())
+		{
+			updateVboOffsets();
+		}
 	}
 }
 
 // Load the mesh from binary data stream
-void GLC_Mesh::loadFromDataStream(QDataStream& stream, const MaterialHash& materialHash, const QHash<GLC_uint, GLC_uint>& materialIdMap)
+void GLC_Mesh::loadFromDataStream(QDataStream& stream, const MaterialHash& materialHash, const QHash<GLC_uint, GLC_uint>& materialIdMap
+		, const QSharedPointer<GLC_MappedBuffer>& mappedBuffer)
 {
 	quint32 chunckId;
 	stream >> chunckId;
@@ -856,7 +1104,19 @@ void GLC_Mesh::loadFromDataStream(QDataStream& stream, const MaterialHash& mater
 	setNextPrimitiveLocalId(localId);
 
 	// Retrieve geom mesh data
-	stream >> m_MeshData;
+	if (mappedBuffer.isNull())
+	{
+		stream >> m_MeshData;
+	}
+	else
+	{
+		m_MeshData.loadFromMappedStream(stream, mappedBuffer);
+
+		// The bounding box is stored to avoid loading of mapped positions
+		delete m_pBoundingBox;
+		m_pBoundingBox= new GLC_BoundingBox();
+		stream >> *m_pBoundingBox;
+	}
 
 	// Retrieve primitiveGroupLodList
 	QList<int> primitiveGroupLodList;
@@ -895,7 +1155,7 @@ void GLC_Mesh::loadFromDataStream(QDataStream& stream, const MaterialHash& mater
 }
 
 // Save the mesh to binary data stream
-void GLC_Mesh::saveToDataStream(QDataStream& stream) const
+void GLC_Mesh::saveToDataStream(QDataStream& stream, QIODevice* pBulkDevice) const
 {
 	quint32 chunckId= m_ChunkId;
 	stream << chunckId;
@@ -910,7 +1170,15 @@ void GLC_Mesh::saveToDataStream(QDataStream& stream) const
 	stream << nextPrimitiveLocalId();
 
 	// Mesh data serialisation
-	stream << m_MeshData;
+	if (NULL == pBulkDevice)
+	{
+		stream << m_MeshData;
+	}
+	else
+	{
+		m_MeshData.saveToMappedStream(stream, pBulkDevice);
+		stream << const_cast<GLC_Mesh*>(this)->boundingBox();
+	}
 
 	// Primitive groups serialisation
 	QList<int> primitiveGroupLodList;
@@ -955,6 +1223,12 @@ void GLC_Mesh::glDraw(const GLC_RenderProperties& renderProperties)
 		m_CurrentLod= 0;
 	}
 
+	// Pack vertices before they are copied to VBO or used as vertex array
+	if (!m_GeometryIsValid && !m_MeshData.positionSizeIsSet())
+	{
+		m_MeshData.pack();
+	}
+
 	if (vboIsUsed)
 	{
 		m_MeshData.createVBOs();
@@ -1061,6 +1335,11 @@ void GLC_Mesh::glDraw(const GLC_RenderProperties& renderProperties)
 	glDisableClientState(GL_NORMAL_ARRAY);
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 
+	if (m_MeshData.isPacked())
+	{
+		popPackedMatrices();
+	}
+
 	if (vboIsUsed)
 	{
 		QGLBuffer::release(QGLBuffer::IndexBuffer);
@@ -1094,6 +1373,63 @@ void GLC_Mesh::glDraw(const GLC_RenderProperties& renderProperties)
 	GLC_RenderStatistics::addTriangles(m_MeshData.trianglesCount(m_CurrentLod));
 }
 
+// Draw the given number of instances of the current LOD with instanced draw calls
+void GLC_Mesh::glDrawInstanced(int instanceCount)
+{
+	Q_ASSERT(m_GeometryIsValid && GLC_Geometry::vboIsUsed() && !m_MeshData.isPacked());
+	Q_ASSERT(GLC_State::instancingSupported());
+
+#if !defined(Q_OS_MAC)
+	activateVboAndIbo();
+
+	const bool selectionMode= GLC_State::isInSelectionMode();
+	const GLenum indexType= m_MeshData.indexType();
+	LodPrimitiveGroups::iterator iGroup= m_PrimitiveGroups.value(m_CurrentLod)->begin();
+	while (iGroup != m_PrimitiveGroups.value(m_CurrentLod)->constEnd())
+	{
+		GLC_PrimitiveGroup* pCurrentGroup= iGroup.value();
+		if (!selectionMode)
+		{
+			m_MaterialHash.value(pCurrentGroup->id())->glExecute();
+		}
+
+		if (pCurrentGroup->containsTriangles())
+		{
+			glDrawElementsInstanced(GL_TRIANGLES, pCurrentGroup->trianglesIndexSize(), indexType, pCurrentGroup->trianglesIndexOffset(), instanceCount);
+			GLC_RenderStatistics::addDrawCalls(1);
+		}
+		if (pCurrentGroup->containsStrip())
+		{
+			const GLsizei stripsCount= static_cast<GLsizei>(pCurrentGroup->stripsOffset().size());
+			for (GLint i= 0; i < stripsCount; ++i)
+			{
+				glDrawElementsInstanced(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), indexType, pCurrentGroup->stripsOffset().at(i), instanceCount);
+				GLC_RenderStatistics::addDrawCalls(1);
+			}
+		}
+		if (pCurrentGroup->containsFan())
+		{
+			const GLsizei fansCount= static_cast<GLsizei>(pCurrentGroup->fansOffset().size());
+			for (GLint i= 0; i < fansCount; ++i)
+			{
+				glDrawElementsInstanced(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), indexType, pCurrentGroup->fansOffset().at(i), instanceCount);
+				GLC_RenderStatistics::addDrawCalls(1);
+			}
+		}
+		++iGroup;
+	}
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_NORMAL_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	QGLBuffer::release(QGLBuffer::IndexBuffer);
+	QGLBuffer::release(QGLBuffer::VertexBuffer);
+
+	GLC_RenderStatistics::addBodies(instanceCount);
+	GLC_RenderStatistics::addTriangles(m_MeshData.trianglesCount(m_CurrentLod) * instanceCount);
+#endif
+}
+
 //////////////////////////////////////////////////////////////////////
 // Private services Functions
 //////////////////////////////////////////////////////////////////////
@@ -1168,24 +1504,93 @@ void GLC_Mesh::fillVbosAndIbos()
 	m_MeshData.fillVbo(GLC_MeshData::GLC_Color);
 
 	// Fill a lod IBO
+	const int indexSize= m_MeshData.indexSize();
 	m_MeshData.fillLodIbo();
+	if (indexSize != m_MeshData.indexSize())
+	{
+		updateVboOffsets();
+	}
+
+}
+
+// Push the matrices which decode packed vertices
+void GLC_Mesh::pushPackedMatrices()
+{
+	const GLC_PackedVertices& packedVertices= m_MeshData.packedVertices();
+	GLC_Context::current()->glcPushMatrix();
+	GLC_Context::current()->glcMultMatrix(packedVertices.positionMatrix());
+
+	// Normals are scaled by the inverse of the position matrix
+	m_NormalizeWasEnabled= (GL_TRUE == glIsEnabled(GL_NORMALIZE));
+	glEnable(GL_NORMALIZE);
+
+	if (packedVertices.hasTexels())
+	{
+		glMatrixMode(GL_TEXTURE);
+		glPushMatrix();
+		glMultMatrixd(packedVertices.texelMatrix().getData());
+		glMatrixMode(GL_MODELVIEW);
+	}
+}
 
+// Pop the matrices which decode packed vertices
+void GLC_Mesh::popPackedMatrices()
+{
+	if (m_MeshData.packedVertices().hasTexels())
+	{
+		glMatrixMode(GL_TEXTURE);
+		glPopMatrix();
+		glMatrixMode(GL_MODELVIEW);
+	}
+
+	if (!m_NormalizeWasEnabled)
+	{
+		glDisable(GL_NORMALIZE);
+	}
+	GLC_Context::current()->glcPopMatrix();
 }
 // set primitive group offset
 void GLC_Mesh::finishSerialized()
 {
+	clearBvh();
+	m_MeshData.updateIndexType();
+	updateVboOffsets();
+}
+
+// Set the IBO offsets of the primitive groups from the mesh data index size
+void GLC_Mesh::updateVboOffsets()
+{
+	const int indexSize= m_MeshData.indexSize();
 	PrimitiveGroupsHash::iterator iGroups= m_PrimitiveGroups.begin();
 	while (iGroups != m_PrimitiveGroups.constEnd())
 	{
 		LodPrimitiveGroups::iterator iGroup= iGroups.value()->begin();
 		while (iGroup != iGroups.value()->constEnd())
 		{
-			iGroup.value()->computeVboOffset();
+			iGroup.value()->computeVboOffset(indexSize);
 			++iGroup;
 		}
 		++iGroups;
 	}
 }
+
+// Create the triangles BVH of the first LOD
+GLC_MeshBvh* GLC_Mesh::createBvh() const
+{
+	GLuintVector triangles;
+	QVector<GLC_uint> primitiveIds;
+	lodTriangles(0, &triangles, &primitiveIds, NULL);
+
+	return new GLC_MeshBvh(m_MeshData.positionVector(), triangles, primitiveIds);
+}
+
+// Delete the triangles BVH
+void GLC_Mesh::clearBvh()
+{
+	delete m_pBvh;
+	m_pBvh= NULL;
+}
+
 /*
 // Move Indexs from the primitive groups to the mesh Data LOD and Set IBOs offsets
 void GLC_Mesh::finishVbo()
@@ -1259,7 +1664,7 @@ void GLC_Mesh::moveIndexToMeshDataLod()
 				(*m_MeshData.indexVectorHandle(currentLod))+= iGroup.value()->fansIndex().toVector();
 			}
 
-			iGroup.value()->computeVboOffset();
+			iGroup.value()->computeVboOffset(m_MeshData.indexSize());
 			iGroup.value()->finish();
 			++iGroup;
 		}
@@ -1267,6 +1672,149 @@ void GLC_Mesh::moveIndexToMeshDataLod()
 	}
 }
 
+// Convert strips and fans of the primitive groups into triangles
+void GLC_Mesh::convertStripsAndFansToTriangles()
+{
+	PrimitiveGroupsHash::iterator iGroups= m_PrimitiveGroups.begin();
+	while (iGroups != m_PrimitiveGroups.constEnd())
+	{
+		LodPrimitiveGroups::iterator iGroup= iGroups.value()->begin();
+		while (iGroup != iGroups.value()->constEnd())
+		{
+			if (iGroup.value()->containsStrip() || iGroup.value()->containsFan())
+			{
+				iGroup.value()->convertStripsAndFansToTriangles();
+			}
+			++iGroup;
+		}
+		++iGroups;
+	}
+}
+
+// Reorder the triangles of each primitive of the primitive groups for the vertex cache
+void GLC_Mesh::optimizeVertexCache()
+{
+	GLuintVector firstLodTriangles;
+	GLuintVector firstLodOptimizedTriangles;
+	PrimitiveGroupsHash::iterator iGroups= m_PrimitiveGroups.begin();
+	while (iGroups != m_PrimitiveGroups.constEnd())
+	{
+		const bool isFirstLod= (0 == iGroups.key());
+		LodPrimitiveGroups::iterator iGroup= iGroups.value()->begin();
+		while (iGroup != iGroups.value()->constEnd())
+		{
+			GLC_PrimitiveGroup* pGroup= iGroup.value();
+			if (pGroup->containsTriangles())
+			{
+				GLuintVector triangles(pGroup->trianglesIndex().toVector());
+				if (isFirstLod) firstLodTriangles+= triangles;
+
+				// Triangles are not moved from a primitive to another to keep primitive selection
+				const IndexSizes& sizes= pGroup->trianglesIndexSizes();
+				const int primitiveCount= sizes.size();
+				int offset= 0;
+				for (int i= 0; i < primitiveCount; ++i)
+				{
+					GLC_VertexCacheOptimizer::optimizeTriangles(triangles.data() + offset, sizes.at(i) / 3);
+					offset+= sizes.at(i);
+				}
+
+				if (isFirstLod) firstLodOptimizedTriangles+= triangles;
+				pGroup->replaceIndex(triangles.toList(), pGroup->stripsIndex(), pGroup->fansIndex());
+			}
+			++iGroup;
+		}
+		++iGroups;
+	}
+
+	// The ACMR doesn't depend on the numbering of vertices
+	m_AcmrBeforeOptimization= GLC_VertexCacheOptimizer::acmr(firstLodTriangles.constData(), firstLodTriangles.size() / 3);
+	m_AcmrAfterOptimization= GLC_VertexCacheOptimizer::acmr(firstLodOptimizedTriangles.constData(), firstLodOptimizedTriangles.size() / 3);
+
+	reorderVertices();
+}
+
+// Renumber vertices in the order of their first use by the first LOD
+void GLC_Mesh::reorderVertices()
+{
+	const int vertexCount= m_MeshData.vertexCount();
+	GLfloatVector* pPositions= m_MeshData.positionVectorHandle();
+	GLfloatVector* pNormals= m_MeshData.normalVectorHandle();
+	GLfloatVector* pTexels= m_MeshData.texelVectorHandle();
+	GLfloatVector* pColors= m_MeshData.colorVectorHandle();
+
+	// Vertices are moved only if each vertex has all its attributes
+	bool isValid= (0 != vertexCount) && (pPositions->size() == (vertexCount * 3)) && (pNormals->size() == (vertexCount * 3));
+	isValid= isValid && (pTexels->isEmpty() || (pTexels->size() == (vertexCount * 2)));
+	isValid= isValid && (pColors->isEmpty() || (pColors->size() == (vertexCount * 4)));
+	if (!isValid) return;
+
+	// Check index of all LOD before any modification
+	PrimitiveGroupsHash::const_iterator iGroups= m_PrimitiveGroups.constBegin();
+	while (iGroups != m_PrimitiveGroups.constEnd())
+	{
+		LodPrimitiveGroups::const_iterator iGroup= iGroups.value()->constBegin();
+		while (iGroup != iGroups.value()->constEnd())
+		{
+			const GLC_PrimitiveGroup* pGroup= iGroup.value();
+			const IndexList index(pGroup->trianglesIndex() + pGroup->stripsIndex() + pGroup->fansIndex());
+			const int size= index.size();
+			for (int i= 0; i < size; ++i)
+			{
+				if (index.at(i) >= static_cast<GLuint>(vertexCount)) return;
+			}
+			++iGroup;
+		}
+		++iGroups;
+	}
+
+	QVector<int> newIndex(vertexCount, -1);
+	int nextIndex= 0;
+	LodPrimitiveGroups* pFirstLodGroups= m_PrimitiveGroups.value(0);
+	if (NULL != pFirstLodGroups)
+	{
+		LodPrimitiveGroups::const_iterator iGroup= pFirstLodGroups->constBegin();
+		while (iGroup != pFirstLodGroups->constEnd())
+		{
+			const GLC_PrimitiveGroup* pGroup= iGroup.value();
+			const IndexList index(pGroup->trianglesIndex() + pGroup->stripsIndex() + pGroup->fansIndex());
+			const int size= index.size();
+			for (int i= 0; i < size; ++i)
+			{
+				const GLuint vertex= index.at(i);
+				if (newIndex.at(vertex) < 0) newIndex[vertex]= nextIndex++;
+			}
+			++iGroup;
+		}
+	}
+	if (0 == nextIndex) return;
+
+	// Vertices not used by the first LOD keep their order after the used ones
+	for (int i= 0; i < vertexCount; ++i)
+	{
+		if (newIndex.at(i) < 0) newIndex[i]= nextIndex++;
+	}
+
+	moveVertices(pPositions, 3, newIndex);
+	moveVertices(pNormals, 3, newIndex);
+	moveVertices(pTexels, 2, newIndex);
+	moveVertices(pColors, 4, newIndex);
+
+	iGroups= m_PrimitiveGroups.constBegin();
+	while (iGroups != m_PrimitiveGroups.constEnd())
+	{
+		LodPrimitiveGroups::iterator iGroup= iGroups.value()->begin();
+		while (iGroup != iGroups.value()->constEnd())
+		{
+			GLC_PrimitiveGroup* pGroup= iGroup.value();
+			pGroup->replaceIndex(renumberedIndex(pGroup->trianglesIndex(), newIndex)
+					, renumberedIndex(pGroup->stripsIndex(), newIndex), renumberedIndex(pGroup->fansIndex(), newIndex));
+			++iGroup;
+		}
+		++iGroups;
+	}
+}
+
 // The normal display loop
 void GLC_Mesh::normalRenderLoop(const GLC_RenderProperties& renderProperties, bool vboIsUsed)
 {
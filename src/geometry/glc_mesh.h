@@ -35,10 +35,13 @@
 #include "glc_geometry.h"
 #include "glc_primitivegroup.h"
 #include "../glc_state.h"
+#include "../glc_renderstatistics.h"
 #include "../shading/glc_selectionmaterial.h"
 
 #include "../glc_config.h"
 
+class GLC_MeshBvh;
+
 //////////////////////////////////////////////////////////////////////
 //! \class GLC_Mesh
 /*! \brief GLC_Mesh : OpenGL 3D Mesh*/
@@ -182,6 +185,25 @@ public:
 	inline bool isEmpty() const
 	{return m_MeshData.isEmpty();}
 
+	//! Return true if the mesh vertices are packed (See GLC_PackedVertices)
+	inline bool isPacked() const
+	{return m_MeshData.isPacked();}
+
+	//! Return true if the mesh vertices are packed when the mesh is drawn for the first time
+	inline bool packedVertexIsUsed() const
+	{return m_MeshData.packedVertexIsUsed();}
+
+	//! Return the ACMR of the first LOD triangles before the vertex cache optimization
+	/*! Return -1.0 if the vertex cache optimization has not been done by finish()
+	 *  \see GLC_VertexCacheOptimizer*/
+	inline double acmrBeforeOptimization() const
+	{return m_AcmrBeforeOptimization;}
+
+	//! Return the ACMR of the first LOD triangles after the vertex cache optimization
+	/*! Return -1.0 if the vertex cache optimization has not been done by finish()*/
+	inline double acmrAfterOptimization() const
+	{return m_AcmrAfterOptimization;}
+
 	//! Return the mesh wire color
 	inline QColor wireColor() const
 	{return m_WireColor;}
@@ -198,6 +220,20 @@ public:
 	//! Return the volume of this mesh
 	virtual double volume();
 
+	//! Return true if the given ray intersect the triangles of this mesh first LOD
+	/*! The triangles BVH is built on the first call which intersect the mesh bounding box.
+	 *  If mesh data are only stored in VBO, this first call needs the OpenGL context.*/
+	virtual bool intersect(const GLC_Line3d& ray, double* pParameter, GLC_uint* pPrimitiveId);
+
+	//! Return the 9 coordinates of each triangle of this mesh first LOD
+	/*! The triangles are shared with the triangles BVH which is built on the first call*/
+	virtual QVector<GLfloat> triangleVertices();
+
+	//! Get the triangles of the given LOD with their primitive id and their material id
+	/*! Strips and fans are converted to triangles, the mesh must be finished.
+	 *  The given material id vector can be NULL*/
+	void lodTriangles(int lod, GLuintVector* pTriangles, QVector<GLC_uint>* pPrimitiveIds, QVector<GLC_uint>* pMaterialIds) const;
+
 //@}
 //////////////////////////////////////////////////////////////////////
 /*! \name Set Functions*/
@@ -250,8 +286,16 @@ public:
 	{m_ColorPearVertex= flag;}
 
 	//! Copy vertex list in a vector list for Vertex Array Use
+	/*! If GLC_State::isStripAndFanConversionUsed(), strips and fans are converted into triangles.
+	 *  If GLC_State::isVertexCacheOptimizationUsed(), triangles and vertices are reordered
+	 *  for the vertex cache before the index are moved to the mesh data*/
 	void finish();
 
+	//! Append a LOD of the given accuracy to this finished mesh and return its index
+	/*! The given triangles index the mesh vertices, each triangle has a primitive id
+	 *  and a material id of this mesh. Return -1 if the mesh has already been drawn.*/
+	int appendLod(double accuracy, const GLuintVector& triangles, const QVector<GLC_uint>& primitiveIds, const QVector<GLC_uint>& materialIds);
+
 	//! Set the lod Index
 	virtual void setCurrentLod(const int);
 
@@ -278,6 +322,11 @@ public:
 	//! Set VBO usage
 	virtual void setVboUsage(bool usage);
 
+	//! Set packed vertex usage, the default usage is given by GLC_State::isPackedVertexUsed()
+	/*! Vertices are packed when the mesh is drawn for the first time*/
+	inline void setPackedVertexUsage(bool usage)
+	{m_MeshData.setPackedVertexUsage(usage);}
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -289,17 +338,28 @@ public:
 	/*! The MaterialHash contains a hash table of GLC_Material that the mesh can use
 	 *  The QHash<GLC_uint, GLC_uint> is used to map serialised material ID to the new
 	 *  constructed materials
+	 *  If the given mapped buffer is not null, bulk data are referenced from it
+	 *  and only loaded when they are needed
 	 */
-	void loadFromDataStream(QDataStream&, const MaterialHash&, const QHash<GLC_uint, GLC_uint>&);
+	void loadFromDataStream(QDataStream&, const MaterialHash&, const QHash<GLC_uint, GLC_uint>&
+			, const QSharedPointer<GLC_MappedBuffer>& mappedBuffer= QSharedPointer<GLC_MappedBuffer>());
 
 	//! Save the mesh to binary data stream
-	void saveToDataStream(QDataStream&) const;
+	/*! If the given bulk device is not NULL, bulk data are written aligned in this device*/
+	void saveToDataStream(QDataStream&, QIODevice* pBulkDevice= NULL) const;
 
 //@}
 //////////////////////////////////////////////////////////////////////
 /*! \name OpenGL Functions*/
 //@{
 //////////////////////////////////////////////////////////////////////
+public:
+	//! Draw the given number of instances of the current LOD with instanced draw calls
+	/*! The mesh must have been rendered with VBO, without packed vertices. The caller
+	 *  binds the shader which reads the per instance attributes. Materials are not
+	 *  executed in selection mode*/
+	void glDrawInstanced(int instanceCount);
+
 protected:
 
 	//! Virtual interface for OpenGL Geometry set up.
@@ -322,12 +382,30 @@ private:
 	//! Set primitive group offset after loading mesh from binary
 	void finishSerialized();
 
+	//! Set the IBO offsets of the primitive groups from the mesh data index size
+	void updateVboOffsets();
+
+	//! Create the triangles BVH of the first LOD
+	GLC_MeshBvh* createBvh() const;
+
+	//! Delete the triangles BVH
+	void clearBvh();
+
 	//! Move Indexs from the primitive groups to the mesh Data LOD and Set IBOs offsets
 	//void finishVbo();
 
 	//! Move Indexs from the primitive groups to the mesh Data LOD and Set Index offsets
 	void moveIndexToMeshDataLod();
 
+	//! Convert strips and fans of the primitive groups into triangles
+	void convertStripsAndFansToTriangles();
+
+	//! Reorder the triangles of each primitive of the primitive groups for the vertex cache
+	void optimizeVertexCache();
+
+	//! Renumber vertices in the order of their first use by the first LOD
+	void reorderVertices();
+
 	//! Use VBO to Draw primitives from the specified GLC_PrimitiveGroup
 	inline void vboDrawPrimitivesOf(GLC_PrimitiveGroup*);
 
@@ -358,6 +436,15 @@ private:
 	//! Activate vertex Array
 	inline void activateVertexArray();
 
+	//! Activate packed vertices at the given address, NULL for the vertex VBO
+	inline void activatePackedVertices(const char* pData);
+
+	//! Push the matrices which decode packed vertices
+	void pushPackedMatrices();
+
+	//! Pop the matrices which decode packed vertices
+	void popPackedMatrices();
+
 	//! The normal display loop
 	void normalRenderLoop(const GLC_RenderProperties&, bool);
 
@@ -429,6 +516,18 @@ private:
 	//! The current LOD index
 	int m_CurrentLod;
 
+	//! The triangles BVH used for ray intersection (NULL until needed)
+	GLC_MeshBvh* m_pBvh;
+
+	//! The ACMR of the first LOD triangles before the vertex cache optimization
+	double m_AcmrBeforeOptimization;
+
+	//! The ACMR of the first LOD triangles after the vertex cache optimization
+	double m_AcmrAfterOptimization;
+
+	//! True if GL_NORMALIZE was enabled before the packed matrices were pushed
+	bool m_NormalizeWasEnabled;
+
 	//! Class chunk id
 	static quint32 m_ChunkId;
 
@@ -442,7 +541,8 @@ void GLC_Mesh::vboDrawPrimitivesOf(GLC_PrimitiveGroup* pCurrentGroup)
 	// Draw triangles
 	if (pCurrentGroup->containsTriangles())
 	{
-		glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSize(), GL_UNSIGNED_INT, pCurrentGroup->trianglesIndexOffset());
+		glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSize(), m_MeshData.indexType(), pCurrentGroup->trianglesIndexOffset());
+		GLC_RenderStatistics::addDrawCalls(1);
 	}
 
 	// Draw Triangles strip
@@ -451,7 +551,8 @@ void GLC_Mesh::vboDrawPrimitivesOf(GLC_PrimitiveGroup* pCurrentGroup)
 		const GLsizei stripsCount= static_cast<GLsizei>(pCurrentGroup->stripsOffset().size());
 		for (GLint i= 0; i < stripsCount; ++i)
 		{
-			glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->stripsOffset().at(i));
+			glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), m_MeshData.indexType(), pCurrentGroup->stripsOffset().at(i));
+			GLC_RenderStatistics::addDrawCalls(1);
 		}
 	}
 
@@ -461,7 +562,8 @@ void GLC_Mesh::vboDrawPrimitivesOf(GLC_PrimitiveGroup* pCurrentGroup)
 		const GLsizei fansCount= static_cast<GLsizei>(pCurrentGroup->fansOffset().size());
 		for (GLint i= 0; i < fansCount; ++i)
 		{
-			glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->fansOffset().at(i));
+			glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), m_MeshData.indexType(), pCurrentGroup->fansOffset().at(i));
+			GLC_RenderStatistics::addDrawCalls(1);
 		}
 	}
 }
@@ -473,6 +575,7 @@ void GLC_Mesh::vertexArrayDrawPrimitivesOf(GLC_PrimitiveGroup* pCurrentGroup)
 	{
 		GLvoid* pOffset= &(m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->trianglesIndexOffseti()]);
 		glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSize(), GL_UNSIGNED_INT, pOffset);
+		GLC_RenderStatistics::addDrawCalls(1);
 	}
 
 	// Draw Triangles strip
@@ -483,6 +586,7 @@ void GLC_Mesh::vertexArrayDrawPrimitivesOf(GLC_PrimitiveGroup* pCurrentGroup)
 		{
 			GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->stripsOffseti().at(i)];
 			glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), GL_UNSIGNED_INT, pOffset);
+			GLC_RenderStatistics::addDrawCalls(1);
 		}
 	}
 
@@ -494,6 +598,7 @@ void GLC_Mesh::vertexArrayDrawPrimitivesOf(GLC_PrimitiveGroup* pCurrentGroup)
 		{
 			GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->fansOffseti().at(i)];
 			glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), GL_UNSIGNED_INT, pOffset);
+			GLC_RenderStatistics::addDrawCalls(1);
 		}
 	}
 }
@@ -510,7 +615,8 @@ void GLC_Mesh::vboDrawInSelectionModePrimitivesOf(GLC_PrimitiveGroup* pCurrentGr
 		{
 			glc::encodeRgbId(pCurrentGroup->triangleGroupId(i), colorId);
 			glColor3ubv(colorId);
-			glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->trianglesGroupOffset().at(i));
+			glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), m_MeshData.indexType(), pCurrentGroup->trianglesGroupOffset().at(i));
+			GLC_RenderStatistics::addDrawCalls(1);
 		}
 	}
 
@@ -522,7 +628,8 @@ void GLC_Mesh::vboDrawInSelectionModePrimitivesOf(GLC_PrimitiveGroup* pCurrentGr
 		{
 			glc::encodeRgbId(pCurrentGroup->stripGroupId(i), colorId);
 			glColor3ubv(colorId);
-			glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->stripsOffset().at(i));
+			glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), m_MeshData.indexType(), pCurrentGroup->stripsOffset().at(i));
+			GLC_RenderStatistics::addDrawCalls(1);
 		}
 	}
 
@@ -535,7 +642,8 @@ void GLC_Mesh::vboDrawInSelectionModePrimitivesOf(GLC_PrimitiveGroup* pCurrentGr
 			glc::encodeRgbId(pCurrentGroup->fanGroupId(i), colorId);
 			glColor3ubv(colorId);
 
-			glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->fansOffset().at(i));
+			glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), m_MeshData.indexType(), pCurrentGroup->fansOffset().at(i));
+			GLC_RenderStatistics::addDrawCalls(1);
 		}
 	}
 
@@ -556,10 +664,12 @@ void GLC_Mesh::vertexArrayDrawInSelectionModePrimitivesOf(GLC_PrimitiveGroup* pC
 
 			GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->trianglesGroupOffseti().at(i)];
 			glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), GL_UNSIGNED_INT, pOffset);
+			GLC_RenderStatistics::addDrawCalls(1);
 		}
 
 		GLvoid* pOffset= &(m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->trianglesIndexOffseti()]);
 		glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSize(), GL_UNSIGNED_INT, pOffset);
+		GLC_RenderStatistics::addDrawCalls(1);
 	}
 
 	// Draw Triangles strip
@@ -573,6 +683,7 @@ void GLC_Mesh::vertexArrayDrawInSelectionModePrimitivesOf(GLC_PrimitiveGroup* pC
 
 			GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->stripsOffseti().at(i)];
 			glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), GL_UNSIGNED_INT, pOffset);
+			GLC_RenderStatistics::addDrawCalls(1);
 		}
 	}
 
@@ -587,6 +698,7 @@ void GLC_Mesh::vertexArrayDrawInSelectionModePrimitivesOf(GLC_PrimitiveGroup* pC
 
 			GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->fansOffseti().at(i)];
 			glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), GL_UNSIGNED_INT, pOffset);
+			GLC_RenderStatistics::addDrawCalls(1);
 		}
 	}
 }
@@ -619,7 +731,8 @@ void GLC_Mesh::vboDrawPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGroup, GLC_M
 			}
 			if (pCurrentLocalMaterial->isTransparent() == isTransparent)
 			{
-				glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->trianglesGroupOffset().at(i));
+				glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), m_MeshData.indexType(), pCurrentGroup->trianglesGroupOffset().at(i));
+				GLC_RenderStatistics::addDrawCalls(1);
 			}
 		}
 	}
@@ -647,7 +760,8 @@ void GLC_Mesh::vboDrawPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGroup, GLC_M
 			}
 			if (pCurrentLocalMaterial->isTransparent() == isTransparent)
 			{
-				glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->stripsOffset().at(i));
+				glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), m_MeshData.indexType(), pCurrentGroup->stripsOffset().at(i));
+				GLC_RenderStatistics::addDrawCalls(1);
 			}
 		}
 	}
@@ -675,7 +789,8 @@ void GLC_Mesh::vboDrawPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGroup, GLC_M
 			}
 			if (pCurrentLocalMaterial->isTransparent() == isTransparent)
 			{
-				glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->fansOffset().at(i));
+				glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), m_MeshData.indexType(), pCurrentGroup->fansOffset().at(i));
+				GLC_RenderStatistics::addDrawCalls(1);
 			}
 		}
 	}
@@ -712,6 +827,7 @@ void GLC_Mesh::vertexArrayDrawPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGrou
 			{
 				GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->trianglesGroupOffseti().at(i)];
 				glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), GL_UNSIGNED_INT, pOffset);
+				GLC_RenderStatistics::addDrawCalls(1);
 			}
 		}
 	}
@@ -741,6 +857,7 @@ void GLC_Mesh::vertexArrayDrawPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGrou
 			{
 				GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->stripsOffseti().at(i)];
 				glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), GL_UNSIGNED_INT, pOffset);
+				GLC_RenderStatistics::addDrawCalls(1);
 			}
 		}
 	}
@@ -770,6 +887,7 @@ void GLC_Mesh::vertexArrayDrawPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGrou
 			{
 				GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->fansOffseti().at(i)];
 				glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), GL_UNSIGNED_INT, pOffset);
+				GLC_RenderStatistics::addDrawCalls(1);
 			}
 		}
 	}
@@ -804,7 +922,8 @@ void GLC_Mesh::vboDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGrou
 				{
 					GLC_SelectionMaterial::glExecute();
 					pCurrentLocalMaterial= NULL;
-					glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->trianglesGroupOffset().at(i));
+					glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), m_MeshData.indexType(), pCurrentGroup->trianglesGroupOffset().at(i));
+					GLC_RenderStatistics::addDrawCalls(1);
 				}
 			}
 			else if ((NULL != pMaterialHash) && pMaterialHash->contains(currentPrimitiveId))
@@ -817,7 +936,8 @@ void GLC_Mesh::vboDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGrou
 						pCurrentLocalMaterial= pMat;
 						pCurrentLocalMaterial->glExecute();
 					}
-					glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->trianglesGroupOffset().at(i));
+					glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), m_MeshData.indexType(), pCurrentGroup->trianglesGroupOffset().at(i));
+					GLC_RenderStatistics::addDrawCalls(1);
 				}
 
 			}
@@ -828,7 +948,8 @@ void GLC_Mesh::vboDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGrou
 					pCurrentLocalMaterial= pCurrentMaterial;
 					pCurrentLocalMaterial->glExecute();
 				}
-				glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->trianglesGroupOffset().at(i));
+				glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), m_MeshData.indexType(), pCurrentGroup->trianglesGroupOffset().at(i));
+				GLC_RenderStatistics::addDrawCalls(1);
 			}
 		}
 	}
@@ -847,7 +968,8 @@ void GLC_Mesh::vboDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGrou
 				{
 					GLC_SelectionMaterial::glExecute();
 					pCurrentLocalMaterial= NULL;
-					glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->stripsOffset().at(i));
+					glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), m_MeshData.indexType(), pCurrentGroup->stripsOffset().at(i));
+					GLC_RenderStatistics::addDrawCalls(1);
 				}
 			}
 			else if ((NULL != pMaterialHash) && pMaterialHash->contains(currentPrimitiveId))
@@ -860,7 +982,8 @@ void GLC_Mesh::vboDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGrou
 						pCurrentLocalMaterial= pMat;
 						pCurrentLocalMaterial->glExecute();
 					}
-					glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->stripsOffset().at(i));
+					glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), m_MeshData.indexType(), pCurrentGroup->stripsOffset().at(i));
+					GLC_RenderStatistics::addDrawCalls(1);
 				}
 
 			}
@@ -871,7 +994,8 @@ void GLC_Mesh::vboDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGrou
 					pCurrentLocalMaterial= pCurrentMaterial;
 					pCurrentLocalMaterial->glExecute();
 				}
-				glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->stripsOffset().at(i));
+				glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), m_MeshData.indexType(), pCurrentGroup->stripsOffset().at(i));
+				GLC_RenderStatistics::addDrawCalls(1);
 			}
 		}
 	}
@@ -890,7 +1014,8 @@ void GLC_Mesh::vboDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGrou
 				{
 					GLC_SelectionMaterial::glExecute();
 					pCurrentLocalMaterial= NULL;
-					glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->fansOffset().at(i));
+					glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), m_MeshData.indexType(), pCurrentGroup->fansOffset().at(i));
+					GLC_RenderStatistics::addDrawCalls(1);
 				}
 			}
 			else if ((NULL != pMaterialHash) && pMaterialHash->contains(currentPrimitiveId))
@@ -903,7 +1028,8 @@ void GLC_Mesh::vboDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGrou
 						pCurrentLocalMaterial= pMat;
 						pCurrentLocalMaterial->glExecute();
 					}
-					glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->fansOffset().at(i));
+					glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), m_MeshData.indexType(), pCurrentGroup->fansOffset().at(i));
+					GLC_RenderStatistics::addDrawCalls(1);
 				}
 
 			}
@@ -914,7 +1040,8 @@ void GLC_Mesh::vboDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCurrentGrou
 					pCurrentLocalMaterial= pCurrentMaterial;
 					pCurrentLocalMaterial->glExecute();
 				}
-				glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), GL_UNSIGNED_INT, pCurrentGroup->fansOffset().at(i));
+				glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), m_MeshData.indexType(), pCurrentGroup->fansOffset().at(i));
+				GLC_RenderStatistics::addDrawCalls(1);
 			}
 		}
 	}
@@ -951,6 +1078,7 @@ void GLC_Mesh::vertexArrayDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCur
 					pCurrentLocalMaterial= NULL;
 					GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->trianglesGroupOffseti().at(i)];
 					glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), GL_UNSIGNED_INT, pOffset);
+					GLC_RenderStatistics::addDrawCalls(1);
 				}
 			}
 			else if ((NULL != pMaterialHash) && pMaterialHash->contains(currentPrimitiveId))
@@ -965,6 +1093,7 @@ void GLC_Mesh::vertexArrayDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCur
 					}
 					GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->trianglesGroupOffseti().at(i)];
 					glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), GL_UNSIGNED_INT, pOffset);
+					GLC_RenderStatistics::addDrawCalls(1);
 				}
 
 			}
@@ -977,6 +1106,7 @@ void GLC_Mesh::vertexArrayDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCur
 				}
 				GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->trianglesGroupOffseti().at(i)];
 				glDrawElements(GL_TRIANGLES, pCurrentGroup->trianglesIndexSizes().at(i), GL_UNSIGNED_INT, pOffset);
+				GLC_RenderStatistics::addDrawCalls(1);
 			}
 		}
 	}
@@ -997,6 +1127,7 @@ void GLC_Mesh::vertexArrayDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCur
 					pCurrentLocalMaterial= NULL;
 					GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->stripsOffseti().at(i)];
 					glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), GL_UNSIGNED_INT, pOffset);
+					GLC_RenderStatistics::addDrawCalls(1);
 				}
 			}
 			else if ((NULL != pMaterialHash) && pMaterialHash->contains(currentPrimitiveId))
@@ -1011,6 +1142,7 @@ void GLC_Mesh::vertexArrayDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCur
 					}
 					GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->stripsOffseti().at(i)];
 					glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), GL_UNSIGNED_INT, pOffset);
+					GLC_RenderStatistics::addDrawCalls(1);
 				}
 
 			}
@@ -1023,6 +1155,7 @@ void GLC_Mesh::vertexArrayDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCur
 				}
 				GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->stripsOffseti().at(i)];
 				glDrawElements(GL_TRIANGLE_STRIP, pCurrentGroup->stripsSizes().at(i), GL_UNSIGNED_INT, pOffset);
+				GLC_RenderStatistics::addDrawCalls(1);
 			}
 		}
 	}
@@ -1043,6 +1176,7 @@ void GLC_Mesh::vertexArrayDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCur
 					pCurrentLocalMaterial= NULL;
 					GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->fansOffseti().at(i)];
 					glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), GL_UNSIGNED_INT, pOffset);
+					GLC_RenderStatistics::addDrawCalls(1);
 				}
 			}
 			else if ((NULL != pMaterialHash) && pMaterialHash->contains(currentPrimitiveId))
@@ -1057,6 +1191,7 @@ void GLC_Mesh::vertexArrayDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCur
 					}
 					GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->fansOffseti().at(i)];
 					glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), GL_UNSIGNED_INT, pOffset);
+					GLC_RenderStatistics::addDrawCalls(1);
 				}
 
 			}
@@ -1069,6 +1204,7 @@ void GLC_Mesh::vertexArrayDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCur
 				}
 				GLvoid* pOffset= &m_MeshData.indexVectorHandle(m_CurrentLod)->data()[pCurrentGroup->fansOffseti().at(i)];
 				glDrawElements(GL_TRIANGLE_FAN, pCurrentGroup->fansSizes().at(i), GL_UNSIGNED_INT, pOffset);
+				GLC_RenderStatistics::addDrawCalls(1);
 			}
 		}
 	}
@@ -1078,6 +1214,15 @@ void GLC_Mesh::vertexArrayDrawSelectedPrimitivesGroupOf(GLC_PrimitiveGroup* pCur
 // Activate mesh VBOs and IBO of the current LOD
 void GLC_Mesh::activateVboAndIbo()
 {
+	if (m_MeshData.isPacked())
+	{
+		// Activate the interleaved vertices VBO
+		m_MeshData.useVBO(true, GLC_MeshData::GLC_Vertex);
+		activatePackedVertices(NULL);
+		m_MeshData.useIBO(true, m_CurrentLod);
+		return;
+	}
+
 	// Activate Vertices VBO
 	m_MeshData.useVBO(true, GLC_MeshData::GLC_Vertex);
 	glVertexPointer(3, GL_FLOAT, 0, 0);
@@ -1110,6 +1255,12 @@ void GLC_Mesh::activateVboAndIbo()
 // Activate vertex Array
 void GLC_Mesh::activateVertexArray()
 {
+	if (m_MeshData.isPacked())
+	{
+		activatePackedVertices(m_MeshData.packedData());
+		return;
+	}
+
 	// Use Vertex Array
 	glVertexPointer(3, GL_FLOAT, 0, m_MeshData.positionVectorHandle()->data());
 	glEnableClientState(GL_VERTEX_ARRAY);
@@ -1134,6 +1285,37 @@ void GLC_Mesh::activateVertexArray()
 	}
 }
 
+// Activate packed vertices at the given address, NULL for the vertex VBO
+void GLC_Mesh::activatePackedVertices(const char* pData)
+{
+	const GLC_PackedVertices& packedVertices= m_MeshData.packedVertices();
+	const GLsizei stride= packedVertices.stride();
+
+	glVertexPointer(3, GL_SHORT, stride, pData);
+	glEnableClientState(GL_VERTEX_ARRAY);
+
+	glNormalPointer(GL_BYTE, stride, pData + packedVertices.normalOffset());
+	glEnableClientState(GL_NORMAL_ARRAY);
+
+	// Activate texel if needed
+	if (packedVertices.hasTexels())
+	{
+		glTexCoordPointer(2, GL_SHORT, stride, pData + packedVertices.texelOffset());
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	}
+
+	// Activate Color array if needed
+	if ((m_ColorPearVertex && !m_IsSelected && !GLC_State::isInSelectionMode()) && packedVertices.hasColors())
+	{
+		glEnable(GL_COLOR_MATERIAL);
+		glColorMaterial(GL_FRONT_AND_BACK, GL_DIFFUSE);
+		glColorPointer(4, GL_UNSIGNED_BYTE, stride, pData + packedVertices.colorOffset());
+		glEnableClientState(GL_COLOR_ARRAY);
+	}
+
+	pushPackedMatrices();
+}
+
 
 
 #endif /* GLC_MESH_H_ */
@@ -0,0 +1,277 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_meshbvh.cpp implementation for the GLC_MeshBvh class.
+
+#include "glc_meshbvh.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+// Maximum number of triangles of a leaf
+static const int leafSize= 4;
+
+// Maximum depth of the BVH traversal stack (Median split depth is lower than 32)
+static const int stackSize= 64;
+
+// Compare triangles centroids along an axis
+class GLC_MeshBvh::CentroidLessThan
+{
+public:
+	CentroidLessThan(const QVector<GLfloat>& centroids, int axis)
+	: m_pCentroids(centroids.constData() + axis)
+	{}
+
+	inline bool operator()(int triangle1, int triangle2) const
+	{return m_pCentroids[3 * triangle1] < m_pCentroids[3 * triangle2];}
+
+private:
+	const GLfloat* m_pCentroids;
+};
+
+GLC_MeshBvh::GLC_MeshBvh(const GLfloatVector& positions, const GLuintVector& triangles, const QVector<GLC_uint>& primitiveIds)
+: m_Nodes()
+, m_Vertices()
+, m_PrimitiveIds()
+{
+	Q_ASSERT((triangles.size() / 3) == primitiveIds.size());
+	const int vertexCount= positions.size() / 3;
+	const GLfloat* pPositions= positions.constData();
+
+	// Copy triangles vertices and compute their centroids, skip triangles with invalid index
+	QVector<GLfloat> centroids;
+	QVector<GLC_uint> validPrimitiveIds;
+	const int triangleCount= primitiveIds.size();
+	m_Vertices.reserve(triangleCount * 9);
+	centroids.reserve(triangleCount * 3);
+	validPrimitiveIds.reserve(triangleCount);
+	for (int i= 0; i < triangleCount; ++i)
+	{
+		const GLuint* pIndex= triangles.constData() + 3 * i;
+		if ((pIndex[0] < static_cast<GLuint>(vertexCount)) && (pIndex[1] < static_cast<GLuint>(vertexCount)) && (pIndex[2] < static_cast<GLuint>(vertexCount)))
+		{
+			for (int coord= 0; coord < 3; ++coord)
+			{
+				const GLfloat value0= pPositions[3 * pIndex[0] + coord];
+				const GLfloat value1= pPositions[3 * pIndex[1] + coord];
+				const GLfloat value2= pPositions[3 * pIndex[2] + coord];
+				centroids.append((value0 + value1 + value2) / 3.0f);
+			}
+			for (int corner= 0; corner < 3; ++corner)
+			{
+				const GLfloat* pVertex= pPositions + 3 * pIndex[corner];
+				m_Vertices << pVertex[0] << pVertex[1] << pVertex[2];
+			}
+			validPrimitiveIds.append(primitiveIds.at(i));
+		}
+	}
+
+	const int validCount= validPrimitiveIds.size();
+	if (validCount == 0) return;
+
+	QVector<int> order(validCount);
+	for (int i= 0; i < validCount; ++i)
+	{
+		order[i]= i;
+	}
+
+	m_Nodes.reserve(2 * (validCount / leafSize) + 1);
+	m_Nodes.append(Node());
+	buildNode(0, 0, validCount, &order, centroids);
+
+	// Store triangles in leaf order
+	QVector<GLfloat> vertices(validCount * 9);
+	m_PrimitiveIds.resize(validCount);
+	for (int i= 0; i < validCount; ++i)
+	{
+		memcpy(vertices.data() + 9 * i, m_Vertices.constData() + 9 * order.at(i), 9 * sizeof(GLfloat));
+		m_PrimitiveIds[i]= validPrimitiveIds.at(order.at(i));
+	}
+	m_Vertices= vertices;
+	m_Nodes.squeeze();
+}
+
+GLC_MeshBvh::~GLC_MeshBvh()
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+bool GLC_MeshBvh::intersect(const GLC_Line3d& ray, double* pParameter, GLC_uint* pPrimitiveId) const
+{
+	if (m_Nodes.isEmpty()) return false;
+
+	const GLC_Point3d origin(ray.startingPoint());
+	const GLC_Vector3d direction(ray.direction());
+	const double originData[3]= {origin.x(), origin.y(), origin.z()};
+	const double directionData[3]= {direction.x(), direction.y(), direction.z()};
+	double inverseDirection[3];
+	for (int i= 0; i < 3; ++i)
+	{
+		inverseDirection[i]= (directionData[i] != 0.0) ? (1.0 / directionData[i]) : std::numeric_limits<double>::max();
+	}
+
+	double nearestParameter= std::numeric_limits<double>::max();
+	int nearestTriangle= -1;
+
+	int stack[stackSize];
+	int stackCount= 0;
+	stack[stackCount++]= 0;
+	while (stackCount > 0)
+	{
+		const Node& node= m_Nodes.at(stack[--stackCount]);
+
+		// Slab test of the node box
+		double entry= 0.0;
+		double exit= nearestParameter;
+		for (int i= 0; (i < 3) && (entry <= exit); ++i)
+		{
+			double parameter1= (static_cast<double>(node.m_Lower[i]) - originData[i]) * inverseDirection[i];
+			double parameter2= (static_cast<double>(node.m_Upper[i]) - originData[i]) * inverseDirection[i];
+			if (parameter1 > parameter2) qSwap(parameter1, parameter2);
+			entry= qMax(entry, parameter1);
+			exit= qMin(exit, parameter2);
+		}
+		if (entry > exit) continue;
+
+		if (node.m_Count != 0)
+		{
+			const int last= node.m_First + node.m_Count;
+			for (int triangle= node.m_First; triangle < last; ++triangle)
+			{
+				const double parameter= intersectTriangle(originData, directionData, triangle);
+				if ((parameter >= 0.0) && (parameter < nearestParameter))
+				{
+					nearestParameter= parameter;
+					nearestTriangle= triangle;
+				}
+			}
+		}
+		else
+		{
+			Q_ASSERT((stackCount + 2) <= stackSize);
+			const int leftChild= static_cast<int>(&node - m_Nodes.constData()) + 1;
+			stack[stackCount++]= node.m_First;
+			stack[stackCount++]= leftChild;
+		}
+	}
+
+	if (nearestTriangle != -1)
+	{
+		*pParameter= nearestParameter;
+		*pPrimitiveId= m_PrimitiveIds.at(nearestTriangle);
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_MeshBvh::buildNode(int nodeIndex, int first, int last, QVector<int>* pOrder, const QVector<GLfloat>& centroids)
+{
+	// Compute the node box and the centroids box
+	GLfloat lower[3]= {std::numeric_limits<GLfloat>::max(), std::numeric_limits<GLfloat>::max(), std::numeric_limits<GLfloat>::max()};
+	GLfloat upper[3]= {-lower[0], -lower[1], -lower[2]};
+	GLfloat centroidLower[3]= {lower[0], lower[1], lower[2]};
+	GLfloat centroidUpper[3]= {upper[0], upper[1], upper[2]};
+	for (int i= first; i < last; ++i)
+	{
+		const int triangle= pOrder->at(i);
+		const GLfloat* pVertex= m_Vertices.constData() + 9 * triangle;
+		const GLfloat* pCentroid= centroids.constData() + 3 * triangle;
+		for (int coord= 0; coord < 3; ++coord)
+		{
+			lower[coord]= qMin(lower[coord], qMin(pVertex[coord], qMin(pVertex[3 + coord], pVertex[6 + coord])));
+			upper[coord]= qMax(upper[coord], qMax(pVertex[coord], qMax(pVertex[3 + coord], pVertex[6 + coord])));
+			centroidLower[coord]= qMin(centroidLower[coord], pCentroid[coord]);
+			centroidUpper[coord]= qMax(centroidUpper[coord], pCentroid[coord]);
+		}
+	}
+
+	Node& node= m_Nodes[nodeIndex];
+	memcpy(node.m_Lower, lower, sizeof(lower));
+	memcpy(node.m_Upper, upper, sizeof(upper));
+
+	const int count= last - first;
+	if (count <= leafSize)
+	{
+		node.m_First= first;
+		node.m_Count= count;
+		return;
+	}
+	node.m_Count= 0;
+
+	// Split at the median of the centroids along the largest axis
+	int axis= 0;
+	for (int coord= 1; coord < 3; ++coord)
+	{
+		if ((centroidUpper[coord] - centroidLower[coord]) > (centroidUpper[axis] - centroidLower[axis])) axis= coord;
+	}
+	const int middle= first + count / 2;
+	int* pFirst= pOrder->data() + first;
+	std::nth_element(pFirst, pFirst + (middle - first), pFirst + count, CentroidLessThan(centroids, axis));
+
+	// The left child follows this node
+	const int leftChild= m_Nodes.size();
+	m_Nodes.append(Node());
+	buildNode(leftChild, first, middle, pOrder, centroids);
+
+	const int rightChild= m_Nodes.size();
+	m_Nodes.append(Node());
+	m_Nodes[nodeIndex].m_First= rightChild;
+	buildNode(rightChild, middle, last, pOrder, centroids);
+}
+
+double GLC_MeshBvh::intersectTriangle(const double* pOrigin, const double* pDirection, int triangle) const
+{
+	// Moller-Trumbore intersection
+	const GLfloat* pVertex= m_Vertices.constData() + 9 * triangle;
+	const double edge1[3]= {pVertex[3] - pVertex[0], pVertex[4] - pVertex[1], pVertex[5] - pVertex[2]};
+	const double edge2[3]= {pVertex[6] - pVertex[0], pVertex[7] - pVertex[1], pVertex[8] - pVertex[2]};
+
+	const double p[3]= {pDirection[1] * edge2[2] - pDirection[2] * edge2[1]
+			, pDirection[2] * edge2[0] - pDirection[0] * edge2[2]
+			, pDirection[0] * edge2[1] - pDirection[1] * edge2[0]};
+	const double determinant= edge1[0] * p[0] + edge1[1] * p[1] + edge1[2] * p[2];
+	if (determinant == 0.0) return -1.0;
+	const double inverseDeterminant= 1.0 / determinant;
+
+	const double t[3]= {pOrigin[0] - pVertex[0], pOrigin[1] - pVertex[1], pOrigin[2] - pVertex[2]};
+	const double u= (t[0] * p[0] + t[1] * p[1] + t[2] * p[2]) * inverseDeterminant;
+	if ((u < 0.0) || (u > 1.0)) return -1.0;
+
+	const double q[3]= {t[1] * edge1[2] - t[2] * edge1[1]
+			, t[2] * edge1[0] - t[0] * edge1[2]
+			, t[0] * edge1[1] - t[1] * edge1[0]};
+	const double v= (pDirection[0] * q[0] + pDirection[1] * q[1] + pDirection[2] * q[2]) * inverseDeterminant;
+	if ((v < 0.0) || ((u + v) > 1.0)) return -1.0;
+
+	return (edge2[0] * q[0] + edge2[1] * q[1] + edge2[2] * q[2]) * inverseDeterminant;
+}
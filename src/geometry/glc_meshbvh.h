@@ -0,0 +1,120 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_meshbvh.h Interface for the GLC_MeshBvh class.
+
+#ifndef GLC_MESHBVH_H_
+#define GLC_MESHBVH_H_
+
+#include <QVector>
+
+#include "../glc_global.h"
+#include "../maths/glc_line3d.h"
+
+#include "../glc_config.h"
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_MeshBvh
+/*! \brief GLC_MeshBvh : Bounding volume hierarchy of mesh triangles*/
+
+/*! GLC_MeshBvh is used by GLC_Mesh to intersect a ray with its triangles
+ *  without OpenGL. Triangles are recursively split at the median of their
+ *  centroids along the largest axis, leaves contain a few triangles whose
+ *  vertices are copied in leaf order.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_MeshBvh
+{
+	class CentroidLessThan;
+
+	//! A node of the BVH, a leaf if the count of triangles is not 0
+	struct Node
+	{
+		GLfloat m_Lower[3];
+		GLfloat m_Upper[3];
+		//! First triangle of a leaf or index of the right child of an inner node
+		int m_First;
+		int m_Count;
+	};
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Construct the BVH of the given triangles
+	/*! The positions vector contains vertices coordinates, the triangles vector
+	 *  contains 3 vertex index per triangle and the primitive id vector contains
+	 *  the primitive id of each triangle*/
+	GLC_MeshBvh(const GLfloatVector& positions, const GLuintVector& triangles, const QVector<GLC_uint>& primitiveIds);
+
+	//! Destructor
+	~GLC_MeshBvh();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return the number of triangles of this BVH
+	inline int triangleCount() const
+	{return m_PrimitiveIds.size();}
+
+	//! Return the number of nodes of this BVH
+	inline int nodeCount() const
+	{return m_Nodes.size();}
+
+	//! Return the 9 coordinates of each triangle of this BVH in leaf order
+	inline const QVector<GLfloat>& vertices() const
+	{return m_Vertices;}
+
+	//! Return true if the given ray intersect a triangle of this BVH
+	/*! If the ray intersect, the parameter of the nearest intersection on the ray and the
+	 *  primitive id of the intersected triangle are set. Triangles are two sided.*/
+	bool intersect(const GLC_Line3d& ray, double* pParameter, GLC_uint* pPrimitiveId) const;
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Build the node at the given index from the given range of triangle order
+	void buildNode(int nodeIndex, int first, int last, QVector<int>* pOrder, const QVector<GLfloat>& centroids);
+
+	//! Return the parameter of the intersection of the given ray with the given triangle, negative if none
+	double intersectTriangle(const double* pOrigin, const double* pDirection, int triangle) const;
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	Q_DISABLE_COPY(GLC_MeshBvh)
+
+	//! The nodes of the BVH, the left child of an inner node follows it
+	QVector<Node> m_Nodes;
+
+	//! The 9 coordinates of each triangle in leaf order
+	QVector<GLfloat> m_Vertices;
+
+	//! The primitive id of each triangle in leaf order
+	QVector<GLC_uint> m_PrimitiveIds;
+};
+
+#endif /* GLC_MESHBVH_H_ */
@@ -29,6 +29,9 @@
 // Class chunk id
 quint32 GLC_MeshData::m_ChunkId= 0xA704;
 
+// Chunk id of mesh data with packed vertices
+quint32 GLC_MeshData::m_PackedChunkId= 0xA713;
+
 // Default constructor
 GLC_MeshData::GLC_MeshData()
 : m_VertexBuffer()
@@ -44,17 +47,21 @@ GLC_MeshData::GLC_MeshData()
 , m_TexelsSize(-1)
 , m_ColorSize(-1)
 , m_UseVbo(false)
+, m_MappedBuffer()
+, m_UsePackedVertex(GLC_State::isPackedVertexUsed())
+, m_PackedVertices()
+, m_IndexType(GL_UNSIGNED_INT)
 {
-
+	releaseAllMappedData();
 }
 
 // Copy constructor
 GLC_MeshData::GLC_MeshData(const GLC_MeshData& meshData)
 : m_VertexBuffer()
-, m_Positions(meshData.positionVector())
-, m_Normals(meshData.normalVector())
-, m_Texels(meshData.texelVector())
-, m_Colors(meshData.colorVector())
+, m_Positions()
+, m_Normals()
+, m_Texels()
+, m_Colors()
 , m_NormalBuffer()
 , m_TexelBuffer()
 , m_ColorBuffer()
@@ -63,7 +70,15 @@ GLC_MeshData::GLC_MeshData(const GLC_MeshData& meshData)
 , m_TexelsSize(meshData.m_TexelsSize)
 , m_ColorSize(meshData.m_ColorSize)
 , m_UseVbo(meshData.m_UseVbo)
+, m_MappedBuffer()
+, m_UsePackedVertex(meshData.m_UsePackedVertex)
+, m_PackedVertices()
+, m_IndexType(meshData.m_IndexType)
 {
+	// Mapped data are copied by copyVertices
+	releaseAllMappedData();
+	copyVertices(meshData);
+
 	// Copy meshData LOD list
 	const int size= meshData.m_LodList.size();
 	for (int i= 0; i < size; ++i)
@@ -81,14 +96,13 @@ GLC_MeshData& GLC_MeshData::operator=(const GLC_MeshData& meshData)
 		clear();
 
 		// Copy mesh Data members
-		m_Positions= meshData.positionVector();
-		m_Normals= meshData.normalVector();
-		m_Texels= meshData.texelVector();
-		m_Colors= meshData.colorVector();
+		copyVertices(meshData);
+		m_UsePackedVertex= meshData.m_UsePackedVertex;
 		m_PositionSize= meshData.m_PositionSize;
 		m_TexelsSize= meshData.m_TexelsSize;
 		m_ColorSize= meshData.m_ColorSize;
 		m_UseVbo= meshData.m_UseVbo;
+		m_IndexType= meshData.m_IndexType;
 
 		// Copy meshData LOD list
 		const int size= meshData.m_LodList.size();
@@ -113,10 +127,32 @@ quint32 GLC_MeshData::chunckID()
 	return m_ChunkId;
 }
 
+int GLC_MeshData::vertexCount() const
+{
+	int subject;
+	if (isPacked())
+	{
+		subject= m_PackedVertices.vertexCount();
+	}
+	else if (positionSizeIsSet())
+	{
+		subject= m_PositionSize / 3;
+	}
+	else
+	{
+		subject= (m_Positions.size() + mappedSize(GLC_MeshData::GLC_Vertex)) / 3;
+	}
+	return subject;
+}
+
 // Return the Position Vector
 GLfloatVector GLC_MeshData::positionVector() const
 {
-	if (m_VertexBuffer.isCreated())
+	if (isPacked())
+	{
+		return clientPackedVertices().positions();
+	}
+	else if (m_VertexBuffer.isCreated())
 	{
 		// VBO created get data from VBO
 		const int sizeOfVbo= m_PositionSize;
@@ -134,6 +170,10 @@ GLfloatVector GLC_MeshData::positionVector() const
 		const_cast<QGLBuffer&>(m_VertexBuffer).release();
 		return positionVector;
 	}
+	else if (0 != mappedSize(GLC_MeshData::GLC_Vertex))
+	{
+		return m_MappedBuffer->floatVector(m_MappedOffset[GLC_MeshData::GLC_Vertex - GLC_MeshData::GLC_Vertex], mappedSize(GLC_MeshData::GLC_Vertex));
+	}
 	else
 	{
 		return m_Positions;
@@ -143,7 +183,11 @@ GLfloatVector GLC_MeshData::positionVector() const
 // Return the normal Vector
 GLfloatVector GLC_MeshData::normalVector() const
 {
-	if (m_NormalBuffer.isCreated())
+	if (isPacked())
+	{
+		return clientPackedVertices().normals();
+	}
+	else if (m_NormalBuffer.isCreated())
 	{
 		// VBO created get data from VBO
 		const int sizeOfVbo= m_PositionSize;
@@ -157,6 +201,10 @@ GLfloatVector GLC_MeshData::normalVector() const
 		const_cast<QGLBuffer&>(m_NormalBuffer).release();
 		return normalVector;
 	}
+	else if (0 != mappedSize(GLC_MeshData::GLC_Normal))
+	{
+		return m_MappedBuffer->floatVector(m_MappedOffset[GLC_MeshData::GLC_Normal - GLC_MeshData::GLC_Vertex], mappedSize(GLC_MeshData::GLC_Normal));
+	}
 	else
 	{
 		return m_Normals;
@@ -166,7 +214,11 @@ GLfloatVector GLC_MeshData::normalVector() const
 // Return the texel Vector
 GLfloatVector GLC_MeshData::texelVector() const
 {
-	if (m_TexelBuffer.isCreated())
+	if (isPacked())
+	{
+		return clientPackedVertices().texels();
+	}
+	else if (m_TexelBuffer.isCreated())
 	{
 		// VBO created get data from VBO
 		const int sizeOfVbo= m_TexelsSize;
@@ -180,6 +232,10 @@ GLfloatVector GLC_MeshData::texelVector() const
 		const_cast<QGLBuffer&>(m_TexelBuffer).release();
 		return texelVector;
 	}
+	else if (0 != mappedSize(GLC_MeshData::GLC_Texel))
+	{
+		return m_MappedBuffer->floatVector(m_MappedOffset[GLC_MeshData::GLC_Texel - GLC_MeshData::GLC_Vertex], mappedSize(GLC_MeshData::GLC_Texel));
+	}
 	else
 	{
 		return m_Texels;
@@ -189,7 +245,11 @@ GLfloatVector GLC_MeshData::texelVector() const
 // Return the color Vector
 GLfloatVector GLC_MeshData::colorVector() const
 {
-	if (m_ColorBuffer.isCreated())
+	if (isPacked())
+	{
+		return clientPackedVertices().colors();
+	}
+	else if (m_ColorBuffer.isCreated())
 	{
 		// VBO created get data from VBO
 		const int sizeOfVbo= m_ColorSize;
@@ -203,6 +263,10 @@ GLfloatVector GLC_MeshData::colorVector() const
 		const_cast<QGLBuffer&>(m_ColorBuffer).release();
 		return normalVector;
 	}
+	else if (0 != mappedSize(GLC_MeshData::GLC_Color))
+	{
+		return m_MappedBuffer->floatVector(m_MappedOffset[GLC_MeshData::GLC_Color - GLC_MeshData::GLC_Vertex], mappedSize(GLC_MeshData::GLC_Color));
+	}
 	else
 	{
 		return m_Colors;
@@ -236,6 +300,9 @@ void GLC_MeshData::clear()
 	m_PositionSize= -1;
 	m_TexelsSize= -1;
 	m_ColorSize= -1;
+	releaseAllMappedData();
+	m_PackedVertices.clear();
+	m_IndexType= GL_UNSIGNED_INT;
 
 	// Delete Main Vbo ID
 	if (m_VertexBuffer.isCreated())
@@ -271,7 +338,16 @@ void GLC_MeshData::clear()
 void GLC_MeshData::copyVboToClientSide()
 {
 
-	if (m_VertexBuffer.isCreated() && m_Positions.isEmpty())
+	if (m_VertexBuffer.isCreated() && m_Positions.isEmpty() && isPacked())
+	{
+		// Packed vertices are decoded, they are packed again by releaseVboClientSide
+		const GLC_PackedVertices packedVertices= clientPackedVertices();
+		m_Positions= packedVertices.positions();
+		m_Normals= packedVertices.normals();
+		m_Texels= packedVertices.texels();
+		m_Colors= packedVertices.colors();
+	}
+	else if (m_VertexBuffer.isCreated() && m_Positions.isEmpty())
 	{
 		Q_ASSERT(m_NormalBuffer.isCreated());
 		m_Positions= positionVector();
@@ -289,7 +365,20 @@ void GLC_MeshData::copyVboToClientSide()
 
 void GLC_MeshData::releaseVboClientSide(bool update)
 {
-	if (m_VertexBuffer.isCreated() && !m_Positions.isEmpty())
+	if (m_VertexBuffer.isCreated() && !m_Positions.isEmpty() && isPacked())
+	{
+		if (update)
+		{
+			m_PackedVertices= GLC_PackedVertices(m_Positions, m_Normals, m_Texels, m_Colors);
+			fillVbo(GLC_MeshData::GLC_Vertex);
+			useVBO(false, GLC_MeshData::GLC_Vertex);
+		}
+		m_Positions.clear();
+		m_Normals.clear();
+		m_Texels.clear();
+		m_Colors.clear();
+	}
+	else if (m_VertexBuffer.isCreated() && !m_Positions.isEmpty())
 	{
 		if (update)
 		{
@@ -311,7 +400,7 @@ void GLC_MeshData::releaseVboClientSide(bool update)
 
 void GLC_MeshData::setVboUsage(bool usage)
 {
-	if (usage && (m_PositionSize != -1) && (!m_Positions.isEmpty()) && (!m_VertexBuffer.isCreated()))
+	if (usage && (m_PositionSize != -1) && (!m_Positions.isEmpty() || m_PackedVertices.hasData()) && (!m_VertexBuffer.isCreated()))
 	{
 		createVBOs();
 
@@ -324,9 +413,21 @@ void GLC_MeshData::setVboUsage(bool usage)
 		const int lodCount= m_LodList.count();
 		for (int i= 0; i < lodCount; ++i)
 		{
+			m_LodList.at(i)->setIndexType(m_IndexType);
 			m_LodList.at(i)->setIboUsage(usage);
 		}
+		updateIndexTypeFromLod();
+	}
+	else if (!usage && m_VertexBuffer.isCreated() && isPacked())
+	{
+		m_PackedVertices= clientPackedVertices();
+		m_VertexBuffer.destroy();
 
+		const int lodCount= m_LodList.count();
+		for (int i= 0; i < lodCount; ++i)
+		{
+			m_LodList.at(i)->setIboUsage(usage);
+		}
 	}
 	else if (!usage && m_VertexBuffer.isCreated())
 	{
@@ -360,6 +461,30 @@ void GLC_MeshData::setVboUsage(bool usage)
 
 }
 
+void GLC_MeshData::updateIndexType()
+{
+	// Index of 16 bits halve the size of IBO and the index fetch bandwidth
+	m_IndexType= (vertexCount() <= 0x10000) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+void GLC_MeshData::pack()
+{
+	if (m_UsePackedVertex && !isPacked() && !m_VertexBuffer.isCreated())
+	{
+		const GLfloatVector positions= positionVector();
+		const GLfloatVector normals= normalVector();
+		if (!positions.isEmpty() && (normals.size() == positions.size()))
+		{
+			m_PackedVertices= GLC_PackedVertices(positions, normals, texelVector(), colorVector());
+			m_Positions.clear();
+			m_Normals.clear();
+			m_Texels.clear();
+			m_Colors.clear();
+			releaseAllMappedData();
+		}
+	}
+}
+
 //////////////////////////////////////////////////////////////////////
 // OpenGL Functions
 //////////////////////////////////////////////////////////////////////
@@ -373,16 +498,21 @@ void GLC_MeshData::createVBOs()
 		Q_ASSERT((NULL != QGLContext::currentContext()) &&  QGLContext::currentContext()->isValid());
 
 		m_VertexBuffer.create();
-		m_NormalBuffer.create();
+
+		// Packed normals are interleaved in the vertex VBO
+		if (!isPacked())
+		{
+			m_NormalBuffer.create();
+		}
 
 		// Create Texel VBO
-		if (!m_TexelBuffer.isCreated() && !m_Texels.isEmpty())
+		if (!m_TexelBuffer.isCreated() && (!m_Texels.isEmpty() || (0 != mappedSize(GLC_MeshData::GLC_Texel))))
 		{
 			m_TexelBuffer.create();
 		}
 
 		// Create Color VBO
-		if (!m_ColorBuffer.isCreated() && !m_Colors.isEmpty())
+		if (!m_ColorBuffer.isCreated() && (!m_Colors.isEmpty() || (0 != mappedSize(GLC_MeshData::GLC_Color))))
 		{
 			m_ColorBuffer.create();
 		}
@@ -402,7 +532,19 @@ bool GLC_MeshData::useVBO(bool use, GLC_MeshData::VboType type)
 	if (use)
 	{
 		// Chose the right VBO
-		if (type == GLC_MeshData::GLC_Vertex)
+		if (isPacked())
+		{
+			// All packed vertices attributes are in the vertex VBO
+			result= (type == GLC_MeshData::GLC_Vertex) || (type == GLC_MeshData::GLC_Normal)
+					|| ((type == GLC_MeshData::GLC_Texel) && m_PackedVertices.hasTexels())
+					|| ((type == GLC_MeshData::GLC_Color) && m_PackedVertices.hasColors());
+			if (result && !m_VertexBuffer.bind())
+			{
+				GLC_Exception exception("GLC_MeshData::useVBO  Failed to bind packed vertex buffer");
+				throw(exception);
+			}
+		}
+		else if (type == GLC_MeshData::GLC_Vertex)
 		{
 			if (!m_VertexBuffer.bind())
 			{
@@ -448,44 +590,46 @@ bool GLC_MeshData::useVBO(bool use, GLC_MeshData::VboType type)
 void GLC_MeshData::fillVbo(GLC_MeshData::VboType type)
 {
 	// Chose the right VBO
-	if (type == GLC_MeshData::GLC_Vertex)
+	if (isPacked())
+	{
+		// Packed vertices attributes are all uploaded with the vertex VBO
+		if (type == GLC_MeshData::GLC_Vertex)
+		{
+			useVBO(true, type);
+			m_PositionSize= m_PackedVertices.vertexCount() * 3;
+			if (m_PackedVertices.hasData())
+			{
+				m_VertexBuffer.allocate(m_PackedVertices.data().constData(), m_PackedVertices.dataSize());
+				m_PackedVertices.releaseData();
+			}
+			else
+			{
+				allocateBuffer(m_VertexBuffer, type);
+			}
+		}
+	}
+	else if (type == GLC_MeshData::GLC_Vertex)
 	{
 		useVBO(true, type);
-		const GLsizei dataNbr= static_cast<GLsizei>(m_Positions.size());
-		const GLsizeiptr dataSize= dataNbr * sizeof(GLfloat);
-		m_VertexBuffer.allocate(m_Positions.data(), dataSize);
-
-		m_PositionSize= m_Positions.size();
-		m_Positions.clear();
+		m_PositionSize= m_Positions.size() + mappedSize(type);
+		allocateBuffer(m_VertexBuffer, type);
 	}
 	else if (type == GLC_MeshData::GLC_Normal)
 	{
 		useVBO(true, type);
-		const GLsizei dataNbr= static_cast<GLsizei>(m_Normals.size());
-		const GLsizeiptr dataSize= dataNbr * sizeof(GLfloat);
-		m_NormalBuffer.allocate(m_Normals.data(), dataSize);
-
-		m_Normals.clear();
+		allocateBuffer(m_NormalBuffer, type);
 	}
 	else if ((type == GLC_MeshData::GLC_Texel) && m_TexelBuffer.isCreated())
 	{
 		useVBO(true, type);
-		const GLsizei dataNbr= static_cast<GLsizei>(m_Texels.size());
-		const GLsizeiptr dataSize= dataNbr * sizeof(GLfloat);
-		m_TexelBuffer.allocate(m_Texels.data(), dataSize);
-
-		m_TexelsSize= m_Texels.size();
-		m_Texels.clear();
+		m_TexelsSize= m_Texels.size() + mappedSize(type);
+		allocateBuffer(m_TexelBuffer, type);
 	}
 	else if ((type == GLC_MeshData::GLC_Color) && m_ColorBuffer.isCreated())
 	{
 		useVBO(true, type);
-		const GLsizei dataNbr= static_cast<GLsizei>(m_Colors.size());
-		const GLsizeiptr dataSize= dataNbr * sizeof(GLfloat);
-		m_ColorBuffer.allocate(m_Colors.data(), dataSize);
-
-		m_ColorSize= m_Colors.size();
-		m_Colors.clear();
+		m_ColorSize= m_Colors.size() + mappedSize(type);
+		allocateBuffer(m_ColorBuffer, type);
 	}
 }
 
@@ -494,20 +638,287 @@ void GLC_MeshData::fillLodIbo()
 	const int lodCount= m_LodList.count();
 	for (int i= 0; i < lodCount; ++i)
 	{
+		m_LodList.at(i)->setIndexType(m_IndexType);
 		m_LodList.at(i)->fillIbo();
 	}
+	updateIndexTypeFromLod();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Mapped serialisation Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_MeshData::saveToMappedStream(QDataStream& stream, QIODevice* pBulkDevice) const
+{
+	if (isPacked())
+	{
+		stream << m_PackedChunkId;
+		m_PackedVertices.saveLayout(stream);
+
+		// Packed data are stored in the position slot as 32 bits words
+		const QByteArray data= clientPackedVertices().data();
+		const qint64 offset= GLC_MappedBuffer::appendAligned(pBulkDevice, data.constData(), data.size());
+		stream << offset;
+		stream << static_cast<qint32>(data.size() / sizeof(GLfloat));
+	}
+	else
+	{
+		stream << m_ChunkId;
+
+		// Bulk data are stored aligned and uncompressed in the bulk device
+		QList<GLfloatVector> bulkData;
+		bulkData << positionVector() << normalVector() << texelVector() << colorVector();
+		const int bulkDataCount= bulkData.size();
+		for (int i= 0; i < bulkDataCount; ++i)
+		{
+			const GLfloatVector& data= bulkData.at(i);
+			const qint64 offset= GLC_MappedBuffer::appendAligned(pBulkDevice, data.constData(), data.size() * sizeof(GLfloat));
+			stream << offset;
+			stream << static_cast<qint32>(data.size());
+		}
+	}
+
+	// List of lod serialisation
+	const qint32 lodCount= m_LodList.size();
+	stream << lodCount;
+	for (int i= 0; i < lodCount; ++i)
+	{
+		m_LodList.at(i)->saveToMappedStream(stream, pBulkDevice);
+	}
+}
+
+void GLC_MeshData::loadFromMappedStream(QDataStream& stream, const QSharedPointer<GLC_MappedBuffer>& mappedBuffer)
+{
+	quint32 chunckId;
+	stream >> chunckId;
+	Q_ASSERT((chunckId == m_ChunkId) || (chunckId == m_PackedChunkId));
+
+	clear();
+
+	// Packed data are in the position slot
+	const int slotCount= (chunckId == m_PackedChunkId) ? 1 : 4;
+	if (chunckId == m_PackedChunkId)
+	{
+		m_PackedVertices.loadLayout(stream);
+	}
+
+	bool isMapped= false;
+	for (int i= 0; i < slotCount; ++i)
+	{
+		qint32 size;
+		stream >> m_MappedOffset[i];
+		stream >> size;
+		m_MappedSize[i]= size;
+		isMapped= isMapped || (0 != size);
+	}
+	if (isMapped)
+	{
+		m_MappedBuffer= mappedBuffer;
+	}
+
+	// List of lod serialisation
+	qint32 lodCount;
+	stream >> lodCount;
+	for (int i= 0; i < lodCount; ++i)
+	{
+		GLC_Lod* pLod= new GLC_Lod();
+		pLod->loadFromMappedStream(stream, mappedBuffer);
+		m_LodList.append(pLod);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+GLfloatVector* GLC_MeshData::clientVector(GLC_MeshData::VboType type)
+{
+	GLfloatVector* pSubject= NULL;
+	switch (type)
+	{
+	case GLC_MeshData::GLC_Vertex:
+		pSubject= &m_Positions;
+		break;
+	case GLC_MeshData::GLC_Normal:
+		pSubject= &m_Normals;
+		break;
+	case GLC_MeshData::GLC_Texel:
+		pSubject= &m_Texels;
+		break;
+	case GLC_MeshData::GLC_Color:
+		pSubject= &m_Colors;
+		break;
+	}
+	Q_ASSERT(NULL != pSubject);
+
+	return pSubject;
+}
+
+void GLC_MeshData::updateIndexTypeFromLod()
+{
+	if (m_IndexType == GL_UNSIGNED_INT) return;
+
+	const int lodCount= m_LodList.count();
+	bool indexAreNarrowed= true;
+	for (int i= 0; indexAreNarrowed && (i < lodCount); ++i)
+	{
+		indexAreNarrowed= (m_LodList.at(i)->indexType() == GL_UNSIGNED_SHORT);
+	}
+
+	if (!indexAreNarrowed)
+	{
+		// A LOD index doesn't fit in 16 bits, all LOD IBO are filled with 32 bits index
+		m_IndexType= GL_UNSIGNED_INT;
+		for (int i= 0; i < lodCount; ++i)
+		{
+			GLC_Lod* pLod= m_LodList.at(i);
+			if (pLod->indexType() == GL_UNSIGNED_SHORT)
+			{
+				pLod->copyIboToClientSide();
+				pLod->setIndexType(GL_UNSIGNED_INT);
+				pLod->releaseIboClientSide(true);
+			}
+		}
+	}
+}
+
+void GLC_MeshData::faultInMappedData(GLC_MeshData::VboType type)
+{
+	Q_ASSERT(!m_MappedBuffer.isNull());
+	if (isPacked())
+	{
+		Q_ASSERT(type == GLC_MeshData::GLC_Vertex);
+		const char* pData= static_cast<const char*>(m_MappedBuffer->constData(m_MappedOffset[0]));
+		m_PackedVertices.setData(QByteArray(pData, mappedSize(type) * sizeof(GLfloat)));
+		releaseMappedData(type);
+		return;
+	}
+	GLfloatVector* pVector= clientVector(type);
+	Q_ASSERT(pVector->isEmpty());
+	(*pVector)= m_MappedBuffer->floatVector(m_MappedOffset[type - GLC_MeshData::GLC_Vertex], mappedSize(type));
+	releaseMappedData(type);
 }
+
+void GLC_MeshData::releaseMappedData(GLC_MeshData::VboType type)
+{
+	const int index= type - GLC_MeshData::GLC_Vertex;
+	m_MappedOffset[index]= 0;
+	m_MappedSize[index]= 0;
+
+	bool isMapped= false;
+	for (int i= 0; i < 4; ++i)
+	{
+		isMapped= isMapped || (0 != m_MappedSize[i]);
+	}
+	if (!isMapped)
+	{
+		m_MappedBuffer.clear();
+	}
+}
+
+void GLC_MeshData::releaseAllMappedData()
+{
+	for (int i= 0; i < 4; ++i)
+	{
+		m_MappedOffset[i]= 0;
+		m_MappedSize[i]= 0;
+	}
+	m_MappedBuffer.clear();
+}
+
+void GLC_MeshData::allocateBuffer(QGLBuffer& buffer, GLC_MeshData::VboType type)
+{
+	GLfloatVector* pVector= clientVector(type);
+	const int mappedDataNbr= mappedSize(type);
+	if (pVector->isEmpty() && (0 != mappedDataNbr))
+	{
+		// Upload directly from the mapped file : only touched pages are loaded
+		const GLsizeiptr dataSize= mappedDataNbr * sizeof(GLfloat);
+		buffer.allocate(m_MappedBuffer->constData(m_MappedOffset[type - GLC_MeshData::GLC_Vertex]), dataSize);
+		releaseMappedData(type);
+	}
+	else
+	{
+		const GLsizei dataNbr= static_cast<GLsizei>(pVector->size());
+		const GLsizeiptr dataSize= dataNbr * sizeof(GLfloat);
+		buffer.allocate(pVector->data(), dataSize);
+		pVector->clear();
+	}
+}
+
+GLC_PackedVertices GLC_MeshData::clientPackedVertices() const
+{
+	GLC_PackedVertices subject(m_PackedVertices);
+	if (m_VertexBuffer.isCreated())
+	{
+		// VBO created get data from VBO
+		QByteArray data(m_PackedVertices.dataSize(), 0);
+		if (!const_cast<QGLBuffer&>(m_VertexBuffer).bind())
+		{
+			GLC_Exception exception("GLC_MeshData::clientPackedVertices()  Failed to bind vertex buffer");
+			throw(exception);
+		}
+		GLvoid* pVbo = const_cast<QGLBuffer&>(m_VertexBuffer).map(QGLBuffer::ReadOnly);
+		memcpy(data.data(), pVbo, data.size());
+		const_cast<QGLBuffer&>(m_VertexBuffer).unmap();
+		const_cast<QGLBuffer&>(m_VertexBuffer).release();
+		subject.setData(data);
+	}
+	else if (0 != mappedSize(GLC_MeshData::GLC_Vertex))
+	{
+		const char* pData= static_cast<const char*>(m_MappedBuffer->constData(m_MappedOffset[0]));
+		subject.setData(QByteArray(pData, mappedSize(GLC_MeshData::GLC_Vertex) * sizeof(GLfloat)));
+	}
+	return subject;
+}
+
+void GLC_MeshData::unpack()
+{
+	if (isPacked() && !m_VertexBuffer.isCreated())
+	{
+		const GLC_PackedVertices packedVertices= clientPackedVertices();
+		m_PackedVertices.clear();
+		releaseAllMappedData();
+		m_Positions= packedVertices.positions();
+		m_Normals= packedVertices.normals();
+		m_Texels= packedVertices.texels();
+		m_Colors= packedVertices.colors();
+	}
+}
+
+void GLC_MeshData::copyVertices(const GLC_MeshData& meshData)
+{
+	if (meshData.isPacked())
+	{
+		m_PackedVertices= meshData.clientPackedVertices();
+	}
+	else
+	{
+		m_Positions= meshData.positionVector();
+		m_Normals= meshData.normalVector();
+		m_Texels= meshData.texelVector();
+		m_Colors= meshData.colorVector();
+	}
+}
+
 // Non Member methods
 // Non-member stream operator
 QDataStream &operator<<(QDataStream &stream, const GLC_MeshData &meshData)
 {
-	quint32 chunckId= GLC_MeshData::m_ChunkId;
-	stream << chunckId;
+	if (meshData.isPacked())
+	{
+		stream << GLC_MeshData::m_PackedChunkId;
+		stream << meshData.clientPackedVertices();
+	}
+	else
+	{
+		stream << GLC_MeshData::m_ChunkId;
 
-	stream << meshData.positionVector();
-	stream << meshData.normalVector();
-	stream << meshData.texelVector();
-	stream << meshData.colorVector();
+		stream << meshData.positionVector();
+		stream << meshData.normalVector();
+		stream << meshData.texelVector();
+		stream << meshData.colorVector();
+	}
 
 	// List of lod serialisation
 	const int lodCount= meshData.m_LodList.size();
@@ -525,16 +936,23 @@ QDataStream &operator>>(QDataStream &stream, GLC_MeshData &meshData)
 {
 	quint32 chunckId;
 	stream >> chunckId;
-	Q_ASSERT(chunckId == GLC_MeshData::m_ChunkId);
+	Q_ASSERT((chunckId == GLC_MeshData::m_ChunkId) || (chunckId == GLC_MeshData::m_PackedChunkId));
 
 	meshData.clear();
 
 	GLfloatVector position, normal, texel, color;
 
-	stream >> meshData.m_Positions;
-	stream >> meshData.m_Normals;
-	stream >> meshData.m_Texels;
-	stream >> meshData.m_Colors;
+	if (chunckId == GLC_MeshData::m_PackedChunkId)
+	{
+		stream >> meshData.m_PackedVertices;
+	}
+	else
+	{
+		stream >> meshData.m_Positions;
+		stream >> meshData.m_Normals;
+		stream >> meshData.m_Texels;
+		stream >> meshData.m_Colors;
+	}
 
 	// List of lod serialisation
 	QList<GLC_Lod> lodsList;
@@ -27,8 +27,11 @@
 
 #include <QVector>
 #include <QGLBuffer>
+#include <QSharedPointer>
 
 #include "glc_lod.h"
+#include "glc_mappedbuffer.h"
+#include "glc_packedvertices.h"
 #include "../glc_global.h"
 
 #include "../glc_config.h"
@@ -99,19 +102,56 @@ public:
 
 	//! Return the Position Vector handle
 	inline GLfloatVector* positionVectorHandle()
-	{ return &m_Positions;}
+	{
+		faultIn(GLC_MeshData::GLC_Vertex);
+		return &m_Positions;
+	}
 
 	//! Return the Normal Vector handle
 	inline GLfloatVector* normalVectorHandle()
-	{ return &m_Normals;}
+	{
+		faultIn(GLC_MeshData::GLC_Normal);
+		return &m_Normals;
+	}
 
 	//! Return the Texel Vector handle
 	inline GLfloatVector* texelVectorHandle()
-	{ return &m_Texels;}
+	{
+		faultIn(GLC_MeshData::GLC_Texel);
+		return &m_Texels;
+	}
 
 	//! Return the Color Vector handle
 	inline GLfloatVector* colorVectorHandle()
-	{ return &m_Colors;}
+	{
+		faultIn(GLC_MeshData::GLC_Color);
+		return &m_Colors;
+	}
+
+	//! Return true if some bulk data are still in a mapped buffer
+	inline bool isMapped() const
+	{return !m_MappedBuffer.isNull();}
+
+	//! Return true if vertices are packed (See GLC_PackedVertices)
+	inline bool isPacked() const
+	{return !m_PackedVertices.isEmpty();}
+
+	//! Return true if vertices are packed when they are drawn for the first time
+	inline bool packedVertexIsUsed() const
+	{return m_UsePackedVertex;}
+
+	//! Return the packed vertices layout and quantization
+	/*! Packed data are released when they have been copied to the VBO*/
+	inline const GLC_PackedVertices& packedVertices() const
+	{return m_PackedVertices;}
+
+	//! Return the packed data on client side, fault in from the mapped buffer if needed
+	inline const char* packedData()
+	{
+		Q_ASSERT(isPacked());
+		if (0 != mappedSize(GLC_MeshData::GLC_Vertex)) faultInMappedData(GLC_MeshData::GLC_Vertex);
+		return m_PackedVertices.data().constData();
+	}
 
 	//! Return the Index Vector of the specified LOD
 	inline GLuintVector indexVector(const int i= 0) const
@@ -141,7 +181,7 @@ public:
 
 	//! Return true if the mesh data doesn't contains vertice
 	inline bool isEmpty() const
-	{return (1 > m_PositionSize) && (0 == m_Positions.size());}
+	{return (1 > m_PositionSize) && (0 == m_Positions.size()) && (0 == mappedSize(GLC_MeshData::GLC_Vertex)) && m_PackedVertices.isEmpty();}
 
 	//! Return the number of triangle from the given lod index
 	inline unsigned int trianglesCount(int lod) const
@@ -159,6 +199,17 @@ public:
 	inline bool positionSizeIsSet() const
 	{return m_PositionSize != -1;}
 
+	//! Return the number of vertices
+	int vertexCount() const;
+
+	//! Return the type of the index in IBO, GL_UNSIGNED_SHORT if there is less than 65536 vertices
+	inline GLenum indexType() const
+	{return m_IndexType;}
+
+	//! Return the size in bytes of an index in IBO
+	inline int indexSize() const
+	{return (m_IndexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);}
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -195,7 +246,19 @@ public:
 
 	//! Init the position size
 	inline void initPositionSize()
-	{m_PositionSize= m_Positions.size();}
+	{m_PositionSize= isPacked() ? (m_PackedVertices.vertexCount() * 3) : m_Positions.size();}
+
+	//! Set packed vertex usage
+	/*! Vertices are packed by pack(), already packed vertices stay packed*/
+	inline void setPackedVertexUsage(bool usage)
+	{m_UsePackedVertex= usage;}
+
+	//! Pack vertices if packed vertex is used and if vertices are not in VBO
+	void pack();
+
+	//! Update the type of the index in IBO from the number of vertices
+	/*! Must be called before IBO are filled*/
+	void updateIndexType();
 
 //@}
 
@@ -225,6 +288,64 @@ public:
 
 //@}
 
+//////////////////////////////////////////////////////////////////////
+/*! \name Mapped serialisation Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Save this mesh data in the given stream, bulk data are appended to the given bulk device
+	void saveToMappedStream(QDataStream& stream, QIODevice* pBulkDevice) const;
+
+	//! Load this mesh data from the given stream, bulk data are referenced in the given mapped buffer
+	/*! Bulk data are copied from the mapped buffer only when they are accessed on client side,
+	 *  VBO are filled directly from the mapped buffer*/
+	void loadFromMappedStream(QDataStream& stream, const QSharedPointer<GLC_MappedBuffer>& mappedBuffer);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Return the client side vector of the given type
+	GLfloatVector* clientVector(GLC_MeshData::VboType type);
+
+	//! Return the size of the given type data which are still in the mapped buffer
+	inline int mappedSize(GLC_MeshData::VboType type) const
+	{return m_MappedSize[type - GLC_MeshData::GLC_Vertex];}
+
+	//! Copy the given type data from the mapped buffer to client side if needed
+	/*! Packed vertices on client side are unpacked*/
+	inline void faultIn(GLC_MeshData::VboType type)
+	{
+		if (isPacked()) unpack();
+		else if (0 != mappedSize(type)) faultInMappedData(type);
+	}
+
+	//! Use 32 bits index in all LOD IBO if the index of a LOD have not been narrowed to 16 bits
+	void updateIndexTypeFromLod();
+
+	//! Copy the given type data from the mapped buffer to client side
+	void faultInMappedData(GLC_MeshData::VboType type);
+
+	//! Forget the mapped data of the given type and release the mapped buffer if it's not used anymore
+	void releaseMappedData(GLC_MeshData::VboType type);
+
+	//! Forget all the mapped data
+	void releaseAllMappedData();
+
+	//! Allocate the given buffer with the client side data (Vector or mapped buffer) of the given type
+	void allocateBuffer(QGLBuffer& buffer, GLC_MeshData::VboType type);
+
+	//! Return a copy of the packed vertices with their data read from the VBO or the mapped buffer if needed
+	GLC_PackedVertices clientPackedVertices() const;
+
+	//! Replace packed vertices by float vectors if packed data are not in VBO
+	void unpack();
+
+	//! Copy the vertices of the given mesh data
+	void copyVertices(const GLC_MeshData& meshData);
+
 //////////////////////////////////////////////////////////////////////
 // Private members
 //////////////////////////////////////////////////////////////////////
@@ -269,8 +390,30 @@ private:
 	//! Use VBO
 	bool m_UseVbo;
 
+	//! The mapped buffer which contains bulk data not yet fault in
+	QSharedPointer<GLC_MappedBuffer> m_MappedBuffer;
+
+	//! Offset of position, normal, texel and color data in the mapped buffer
+	qint64 m_MappedOffset[4];
+
+	//! Size of position, normal, texel and color data in the mapped buffer
+	/*! If vertices are packed, the position slot references the packed data and its size is a number of 32 bits words*/
+	int m_MappedSize[4];
+
+	//! True if vertices are packed when they are drawn for the first time
+	bool m_UsePackedVertex;
+
+	//! The packed vertices
+	GLC_PackedVertices m_PackedVertices;
+
+	//! The type of the index in IBO
+	GLenum m_IndexType;
+
 	//! Class chunk id
 	static quint32 m_ChunkId;
+
+	//! Chunk id of mesh data with packed vertices
+	static quint32 m_PackedChunkId;
 };
 
 //! Non-member stream operator
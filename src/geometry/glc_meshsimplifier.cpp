@@ -0,0 +1,790 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_meshsimplifier.cpp implementation for the GLC_MeshSimplifier class.
+
+#include "glc_meshsimplifier.h"
+#include "glc_mesh.h"
+#include "glc_3drep.h"
+#include "../sceneGraph/glc_world.h"
+#include "../sceneGraph/glc_structreference.h"
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QRunnable>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+
+// Weight of the quadrics of planes orthogonal to feature edges
+static const double featureWeight= 100.0;
+
+// Minimum cosine between the normals of a triangle before and after a collapse
+static const double minimumNormalCosine= 0.2;
+
+// Minimum ratio of triangles removed by a LOD from the previous one
+static const double minimumReduction= 0.05;
+
+// Minimum number of triangles of a simplified mesh
+static const int minimumTriangleCount= 8;
+
+// The edges collapse of one mesh
+class GLC_MeshSimplifier::Decimation
+{
+	//! A symmetric 4x4 quadric, upper triangle stored row by row
+	struct Quadric
+	{
+		double m_Coefficients[10];
+	};
+
+	//! A triangle of the mesh
+	struct Triangle
+	{
+		//! The welded vertices
+		int m_Vertices[3];
+		//! The index of the mesh vertices
+		GLuint m_Corners[3];
+		GLC_uint m_PrimitiveId;
+		GLC_uint m_MaterialId;
+		bool m_IsRemoved;
+	};
+
+	//! The collapse of a welded vertex onto another one
+	struct Collapse
+	{
+		double m_Cost;
+		int m_From;
+		int m_To;
+		int m_FromVersion;
+		int m_ToVersion;
+
+		//! The collapse of lowest cost is on top of the priority queue
+		inline bool operator<(const Collapse& other) const
+		{return m_Cost > other.m_Cost;}
+	};
+
+	//! An edge between welded vertices
+	struct Edge
+	{
+		int m_Triangle;
+		int m_Count;
+		bool m_IsFeature;
+	};
+
+	//! Compare vertices positions
+	class PositionLessThan
+	{
+	public:
+		PositionLessThan(const GLfloat* pPositions)
+		: m_pPositions(pPositions)
+		{}
+
+		inline bool operator()(GLuint index1, GLuint index2) const
+		{
+			const GLfloat* p1= m_pPositions + 3 * index1;
+			const GLfloat* p2= m_pPositions + 3 * index2;
+			if (p1[0] != p2[0]) return p1[0] < p2[0];
+			if (p1[1] != p2[1]) return p1[1] < p2[1];
+			return p1[2] < p2[2];
+		}
+
+	private:
+		const GLfloat* m_pPositions;
+	};
+
+public:
+	//! Construct the decimation of the given triangles
+	Decimation(const GLfloatVector& positions, const GLuintVector& triangles, const QVector<GLC_uint>& primitiveIds, const QVector<GLC_uint>& materialIds);
+
+	//! Return the number of triangles not removed
+	inline int triangleCount() const
+	{return m_TriangleCount;}
+
+	//! Collapse edges until the collapse error reaches the given distance
+	void collapse(double maximumError);
+
+	//! Get the triangles not removed with their primitive id and their material id
+	void triangles(GLuintVector* pTriangles, QVector<GLC_uint>* pPrimitiveIds, QVector<GLC_uint>* pMaterialIds) const;
+
+private:
+	//! Add the given plane to the given quadric
+	static void addPlane(Quadric* pQuadric, const double* pNormal, double d, double weight);
+
+	//! Return the error of the sum of the given quadrics at the given position
+	static double error(const Quadric& quadric1, const Quadric& quadric2, const double* pPosition);
+
+	//! Compute the normal of the given triangle with the given vertex moved at the position of another one
+	void normal(const Triangle& triangle, int vertex, int newVertex, double* pNormal) const;
+
+	//! Return the key of the edge between the given vertices
+	static inline quint64 edgeKey(int vertex1, int vertex2)
+	{return (static_cast<quint64>(qMin(vertex1, vertex2)) << 32) | static_cast<quint64>(qMax(vertex1, vertex2));}
+
+	//! Return the corner of the given welded vertex in the given triangle or -1
+	static inline int corner(const Triangle& triangle, int vertex)
+	{
+		if (triangle.m_Vertices[0] == vertex) return 0;
+		if (triangle.m_Vertices[1] == vertex) return 1;
+		if (triangle.m_Vertices[2] == vertex) return 2;
+		return -1;
+	}
+
+	//! Push the collapse of the given vertices
+	void pushCollapse(int from, int to);
+
+	//! Push the collapses of the edges of the given vertex
+	void pushCollapses(int vertex);
+
+	//! Remove the removed triangles of the given vertex
+	void compactTriangles(int vertex);
+
+	//! Collapse if the given collapse is valid, return false if it is not
+	bool collapseIfValid(const Collapse& collapse);
+
+private:
+	//! The welded vertices coordinates
+	QVector<double> m_Positions;
+
+	//! The welded vertices quadrics
+	QVector<Quadric> m_Quadrics;
+
+	//! The version of welded vertices, -1 if the vertex is removed
+	QVector<int> m_Versions;
+
+	//! The triangles of each welded vertex
+	QVector<QVector<int> > m_VertexTriangles;
+
+	//! The triangles
+	QVector<Triangle> m_Triangles;
+
+	//! The number of triangles not removed
+	int m_TriangleCount;
+
+	//! The collapses sorted by cost
+	std::priority_queue<Collapse> m_Collapses;
+
+	//! The valid collapses which have been rejected
+	QVector<Collapse> m_RejectedCollapses;
+
+	//! Marks of welded vertices
+	QVector<int> m_Marks;
+
+	//! The current mark
+	int m_Mark;
+};
+
+GLC_MeshSimplifier::Decimation::Decimation(const GLfloatVector& positions, const GLuintVector& triangles, const QVector<GLC_uint>& primitiveIds, const QVector<GLC_uint>& materialIds)
+: m_Positions()
+, m_Quadrics()
+, m_Versions()
+, m_VertexTriangles()
+, m_Triangles()
+, m_TriangleCount(0)
+, m_Collapses()
+, m_RejectedCollapses()
+, m_Marks()
+, m_Mark(0)
+{
+	const GLuint vertexCount= static_cast<GLuint>(positions.size() / 3);
+	const GLfloat* pPositions= positions.constData();
+
+	// Weld vertices of the same position, normal and texel seams are split vertices
+	QVector<GLuint> usedIndex;
+	const int indexSize= triangles.size();
+	for (int i= 0; i < indexSize; ++i)
+	{
+		if (triangles.at(i) < vertexCount) usedIndex.append(triangles.at(i));
+	}
+	std::sort(usedIndex.begin(), usedIndex.end());
+	usedIndex.erase(std::unique(usedIndex.begin(), usedIndex.end()), usedIndex.end());
+	std::sort(usedIndex.begin(), usedIndex.end(), PositionLessThan(pPositions));
+
+	QHash<GLuint, int> weldedVertex;
+	const PositionLessThan lessThan(pPositions);
+	const int usedCount= usedIndex.size();
+	for (int i= 0; i < usedCount; ++i)
+	{
+		const GLuint index= usedIndex.at(i);
+		if ((0 == i) || lessThan(usedIndex.at(i - 1), index))
+		{
+			m_Positions << pPositions[3 * index] << pPositions[3 * index + 1] << pPositions[3 * index + 2];
+		}
+		weldedVertex.insert(index, (m_Positions.size() / 3) - 1);
+	}
+	const int weldedCount= m_Positions.size() / 3;
+
+	Quadric nullQuadric;
+	memset(nullQuadric.m_Coefficients, 0, sizeof(nullQuadric.m_Coefficients));
+	m_Quadrics.fill(nullQuadric, weldedCount);
+	m_Versions.fill(0, weldedCount);
+	m_VertexTriangles.resize(weldedCount);
+	m_Marks.fill(0, weldedCount);
+
+	// Triangles with invalid index or less than 3 welded vertices are removed
+	const int inputTriangleCount= primitiveIds.size();
+	for (int i= 0; i < inputTriangleCount; ++i)
+	{
+		Triangle triangle;
+		bool isValid= true;
+		for (int j= 0; j < 3; ++j)
+		{
+			triangle.m_Corners[j]= triangles.at(3 * i + j);
+			isValid= isValid && (triangle.m_Corners[j] < vertexCount);
+			triangle.m_Vertices[j]= isValid ? weldedVertex.value(triangle.m_Corners[j]) : -1;
+		}
+		isValid= isValid && (triangle.m_Vertices[0] != triangle.m_Vertices[1])
+				&& (triangle.m_Vertices[1] != triangle.m_Vertices[2]) && (triangle.m_Vertices[0] != triangle.m_Vertices[2]);
+		if (isValid)
+		{
+			triangle.m_PrimitiveId= primitiveIds.at(i);
+			triangle.m_MaterialId= materialIds.at(i);
+			triangle.m_IsRemoved= false;
+			m_Triangles.append(triangle);
+		}
+	}
+	m_TriangleCount= m_Triangles.size();
+
+	// Quadrics of triangles planes
+	QVector<double> normals(3 * m_TriangleCount, 0.0);
+	for (int i= 0; i < m_TriangleCount; ++i)
+	{
+		const Triangle& triangle= m_Triangles.at(i);
+		double* pNormal= normals.data() + 3 * i;
+		normal(triangle, -1, -1, pNormal);
+		const double length= sqrt(pNormal[0] * pNormal[0] + pNormal[1] * pNormal[1] + pNormal[2] * pNormal[2]);
+		if (length > 0.0)
+		{
+			pNormal[0]/= length;
+			pNormal[1]/= length;
+			pNormal[2]/= length;
+			const double* pPosition= m_Positions.constData() + 3 * triangle.m_Vertices[0];
+			const double d= -(pNormal[0] * pPosition[0] + pNormal[1] * pPosition[1] + pNormal[2] * pPosition[2]);
+			for (int j= 0; j < 3; ++j)
+			{
+				addPlane(&(m_Quadrics[triangle.m_Vertices[j]]), pNormal, d, 1.0);
+			}
+		}
+		for (int j= 0; j < 3; ++j)
+		{
+			m_VertexTriangles[triangle.m_Vertices[j]].append(i);
+		}
+	}
+
+	// Find feature edges : boundaries, non manifold edges, seams and material or primitive changes
+	QHash<quint64, Edge> edges;
+	for (int i= 0; i < m_TriangleCount; ++i)
+	{
+		const Triangle& triangle= m_Triangles.at(i);
+		for (int j= 0; j < 3; ++j)
+		{
+			const int vertex1= triangle.m_Vertices[j];
+			const int vertex2= triangle.m_Vertices[(j + 1) % 3];
+			const quint64 key= edgeKey(vertex1, vertex2);
+			QHash<quint64, Edge>::iterator iEdge= edges.find(key);
+			if (edges.end() == iEdge)
+			{
+				Edge edge;
+				edge.m_Triangle= i;
+				edge.m_Count= 1;
+				edge.m_IsFeature= false;
+				edges.insert(key, edge);
+			}
+			else
+			{
+				Edge& edge= iEdge.value();
+				++edge.m_Count;
+				const Triangle& other= m_Triangles.at(edge.m_Triangle);
+				const int corner1= corner(other, vertex1);
+				const int corner2= corner(other, vertex2);
+				// The other triangle of a consistently oriented edge has the edge in the reverse order
+				const bool isReversed= (((corner2 + 1) % 3) == corner1);
+				edge.m_IsFeature= edge.m_IsFeature || (edge.m_Count > 2) || !isReversed
+						|| (other.m_MaterialId != triangle.m_MaterialId) || (other.m_PrimitiveId != triangle.m_PrimitiveId)
+						|| (other.m_Corners[corner1] != triangle.m_Corners[j]) || (other.m_Corners[corner2] != triangle.m_Corners[(j + 1) % 3]);
+			}
+		}
+	}
+
+	// Quadrics of planes orthogonal to feature edges
+	for (int i= 0; i < m_TriangleCount; ++i)
+	{
+		const Triangle& triangle= m_Triangles.at(i);
+		const double* pNormal= normals.constData() + 3 * i;
+		for (int j= 0; j < 3; ++j)
+		{
+			const int vertex1= triangle.m_Vertices[j];
+			const int vertex2= triangle.m_Vertices[(j + 1) % 3];
+			const Edge edge= edges.value(edgeKey(vertex1, vertex2));
+			if (edge.m_IsFeature || (1 == edge.m_Count))
+			{
+				const double* pPosition1= m_Positions.constData() + 3 * vertex1;
+				const double* pPosition2= m_Positions.constData() + 3 * vertex2;
+				const double e[3]= {pPosition2[0] - pPosition1[0], pPosition2[1] - pPosition1[1], pPosition2[2] - pPosition1[2]};
+				double planeNormal[3]= {e[1] * pNormal[2] - e[2] * pNormal[1], e[2] * pNormal[0] - e[0] * pNormal[2], e[0] * pNormal[1] - e[1] * pNormal[0]};
+				const double length= sqrt(planeNormal[0] * planeNormal[0] + planeNormal[1] * planeNormal[1] + planeNormal[2] * planeNormal[2]);
+				if (length > 0.0)
+				{
+					planeNormal[0]/= length;
+					planeNormal[1]/= length;
+					planeNormal[2]/= length;
+					const double d= -(planeNormal[0] * pPosition1[0] + planeNormal[1] * pPosition1[1] + planeNormal[2] * pPosition1[2]);
+					addPlane(&(m_Quadrics[vertex1]), planeNormal, d, featureWeight);
+					addPlane(&(m_Quadrics[vertex2]), planeNormal, d, featureWeight);
+				}
+			}
+		}
+	}
+
+	// Initial collapses of both directions of each edge
+	QHash<quint64, Edge>::const_iterator iEdge= edges.constBegin();
+	while (edges.constEnd() != iEdge)
+	{
+		const int vertex1= static_cast<int>(iEdge.key() >> 32);
+		const int vertex2= static_cast<int>(iEdge.key() & 0xFFFFFFFF);
+		pushCollapse(vertex1, vertex2);
+		pushCollapse(vertex2, vertex1);
+		++iEdge;
+	}
+}
+
+void GLC_MeshSimplifier::Decimation::collapse(double maximumError)
+{
+	// Collapses rejected with a lower error may be valid now
+	const int rejectedCount= m_RejectedCollapses.size();
+	for (int i= 0; i < rejectedCount; ++i)
+	{
+		m_Collapses.push(m_RejectedCollapses.at(i));
+	}
+	m_RejectedCollapses.clear();
+
+	const double maximumCost= maximumError * maximumError;
+	while (!m_Collapses.empty() && (m_Collapses.top().m_Cost <= maximumCost))
+	{
+		const Collapse collapse= m_Collapses.top();
+		m_Collapses.pop();
+
+		// Skip collapses of vertices which have been modified since the push
+		if ((m_Versions.at(collapse.m_From) != collapse.m_FromVersion) || (m_Versions.at(collapse.m_To) != collapse.m_ToVersion)) continue;
+
+		if (!collapseIfValid(collapse))
+		{
+			m_RejectedCollapses.append(collapse);
+		}
+	}
+}
+
+void GLC_MeshSimplifier::Decimation::triangles(GLuintVector* pTriangles, QVector<GLC_uint>* pPrimitiveIds, QVector<GLC_uint>* pMaterialIds) const
+{
+	pTriangles->clear();
+	pPrimitiveIds->clear();
+	pMaterialIds->clear();
+
+	const int size= m_Triangles.size();
+	for (int i= 0; i < size; ++i)
+	{
+		const Triangle& triangle= m_Triangles.at(i);
+		if (!triangle.m_IsRemoved)
+		{
+			(*pTriangles) << triangle.m_Corners[0] << triangle.m_Corners[1] << triangle.m_Corners[2];
+			pPrimitiveIds->append(triangle.m_PrimitiveId);
+			pMaterialIds->append(triangle.m_MaterialId);
+		}
+	}
+}
+
+void GLC_MeshSimplifier::Decimation::addPlane(Quadric* pQuadric, const double* pNormal, double d, double weight)
+{
+	const double a= pNormal[0];
+	const double b= pNormal[1];
+	const double c= pNormal[2];
+	double* pCoefficients= pQuadric->m_Coefficients;
+	pCoefficients[0]+= weight * a * a;
+	pCoefficients[1]+= weight * a * b;
+	pCoefficients[2]+= weight * a * c;
+	pCoefficients[3]+= weight * a * d;
+	pCoefficients[4]+= weight * b * b;
+	pCoefficients[5]+= weight * b * c;
+	pCoefficients[6]+= weight * b * d;
+	pCoefficients[7]+= weight * c * c;
+	pCoefficients[8]+= weight * c * d;
+	pCoefficients[9]+= weight * d * d;
+}
+
+double GLC_MeshSimplifier::Decimation::error(const Quadric& quadric1, const Quadric& quadric2, const double* pPosition)
+{
+	double q[10];
+	for (int i= 0; i < 10; ++i)
+	{
+		q[i]= quadric1.m_Coefficients[i] + quadric2.m_Coefficients[i];
+	}
+	const double x= pPosition[0];
+	const double y= pPosition[1];
+	const double z= pPosition[2];
+	const double subject= q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z + 2.0 * q[3] * x
+						+ q[4] * y * y + 2.0 * q[5] * y * z + 2.0 * q[6] * y
+						+ q[7] * z * z + 2.0 * q[8] * z + q[9];
+
+	return qMax(subject, 0.0);
+}
+
+void GLC_MeshSimplifier::Decimation::normal(const Triangle& triangle, int vertex, int newVertex, double* pNormal) const
+{
+	const double* p[3];
+	for (int i= 0; i < 3; ++i)
+	{
+		const int currentVertex= (triangle.m_Vertices[i] == vertex) ? newVertex : triangle.m_Vertices[i];
+		p[i]= m_Positions.constData() + 3 * currentVertex;
+	}
+	const double u[3]= {p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2]};
+	const double v[3]= {p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2]};
+	pNormal[0]= u[1] * v[2] - u[2] * v[1];
+	pNormal[1]= u[2] * v[0] - u[0] * v[2];
+	pNormal[2]= u[0] * v[1] - u[1] * v[0];
+}
+
+void GLC_MeshSimplifier::Decimation::pushCollapse(int from, int to)
+{
+	Collapse collapse;
+	collapse.m_Cost= error(m_Quadrics.at(from), m_Quadrics.at(to), m_Positions.constData() + 3 * to);
+	collapse.m_From= from;
+	collapse.m_To= to;
+	collapse.m_FromVersion= m_Versions.at(from);
+	collapse.m_ToVersion= m_Versions.at(to);
+	m_Collapses.push(collapse);
+}
+
+void GLC_MeshSimplifier::Decimation::pushCollapses(int vertex)
+{
+	++m_Mark;
+	m_Marks[vertex]= m_Mark;
+	const QVector<int>& vertexTriangles= m_VertexTriangles.at(vertex);
+	const int size= vertexTriangles.size();
+	for (int i= 0; i < size; ++i)
+	{
+		const Triangle& triangle= m_Triangles.at(vertexTriangles.at(i));
+		for (int j= 0; j < 3; ++j)
+		{
+			const int neighbour= triangle.m_Vertices[j];
+			if (m_Marks.at(neighbour) != m_Mark)
+			{
+				m_Marks[neighbour]= m_Mark;
+				pushCollapse(vertex, neighbour);
+				pushCollapse(neighbour, vertex);
+			}
+		}
+	}
+}
+
+void GLC_MeshSimplifier::Decimation::compactTriangles(int vertex)
+{
+	QVector<int>& vertexTriangles= m_VertexTriangles[vertex];
+	int last= 0;
+	const int size= vertexTriangles.size();
+	for (int i= 0; i < size; ++i)
+	{
+		if (!m_Triangles.at(vertexTriangles.at(i)).m_IsRemoved)
+		{
+			vertexTriangles[last++]= vertexTriangles.at(i);
+		}
+	}
+	vertexTriangles.resize(last);
+}
+
+bool GLC_MeshSimplifier::Decimation::collapseIfValid(const Collapse& collapse)
+{
+	const int from= collapse.m_From;
+	const int to= collapse.m_To;
+	compactTriangles(from);
+	compactTriangles(to);
+	const QVector<int> fromTriangles= m_VertexTriangles.at(from);
+	const int fromTriangleCount= fromTriangles.size();
+
+	// Mark the neighbours of the destination vertex
+	++m_Mark;
+	const QVector<int>& toTriangles= m_VertexTriangles.at(to);
+	const int toTriangleCount= toTriangles.size();
+	for (int i= 0; i < toTriangleCount; ++i)
+	{
+		const Triangle& triangle= m_Triangles.at(toTriangles.at(i));
+		for (int j= 0; j < 3; ++j) m_Marks[triangle.m_Vertices[j]]= m_Mark;
+	}
+
+	// The index of the source vertex are replaced by the index of the destination vertex of the same side of seams
+	QVector<QPair<GLuint, GLuint> > cornerMap;
+	int sharedCount= 0;
+	for (int i= 0; i < fromTriangleCount; ++i)
+	{
+		const Triangle& triangle= m_Triangles.at(fromTriangles.at(i));
+		const int toCorner= corner(triangle, to);
+		if (-1 != toCorner)
+		{
+			++sharedCount;
+			const GLuint fromIndex= triangle.m_Corners[corner(triangle, from)];
+			const GLuint toIndex= triangle.m_Corners[toCorner];
+			for (int j= 0; j < cornerMap.size(); ++j)
+			{
+				if ((cornerMap.at(j).first == fromIndex) && (cornerMap.at(j).second != toIndex)) return false;
+			}
+			cornerMap.append(qMakePair(fromIndex, toIndex));
+		}
+	}
+	// The edge does not exist anymore
+	if (0 == sharedCount) return true;
+
+	// Link condition : the common neighbours are the opposite vertices of the edge triangles
+	int commonCount= 0;
+	const int mark= m_Mark;
+	++m_Mark;
+	for (int i= 0; i < fromTriangleCount; ++i)
+	{
+		const Triangle& triangle= m_Triangles.at(fromTriangles.at(i));
+		for (int j= 0; j < 3; ++j)
+		{
+			const int neighbour= triangle.m_Vertices[j];
+			if ((neighbour != from) && (neighbour != to) && (m_Marks.at(neighbour) == mark))
+			{
+				m_Marks[neighbour]= m_Mark;
+				++commonCount;
+			}
+		}
+	}
+	if (commonCount != sharedCount) return false;
+
+	// Check the index mapping and the orientation of moved triangles
+	for (int i= 0; i < fromTriangleCount; ++i)
+	{
+		const Triangle& triangle= m_Triangles.at(fromTriangles.at(i));
+		if (-1 != corner(triangle, to)) continue;
+
+		const GLuint fromIndex= triangle.m_Corners[corner(triangle, from)];
+		bool isMapped= false;
+		for (int j= 0; !isMapped && (j < cornerMap.size()); ++j)
+		{
+			isMapped= (cornerMap.at(j).first == fromIndex);
+		}
+		if (!isMapped) return false;
+
+		double normal0[3];
+		double normal1[3];
+		normal(triangle, -1, -1, normal0);
+		normal(triangle, from, to, normal1);
+		const double length0= sqrt(normal0[0] * normal0[0] + normal0[1] * normal0[1] + normal0[2] * normal0[2]);
+		const double length1= sqrt(normal1[0] * normal1[0] + normal1[1] * normal1[1] + normal1[2] * normal1[2]);
+		if (length1 <= 0.0) return false;
+		const double dot= normal0[0] * normal1[0] + normal0[1] * normal1[1] + normal0[2] * normal1[2];
+		if ((length0 > 0.0) && (dot < (minimumNormalCosine * length0 * length1))) return false;
+	}
+
+	// Collapse
+	for (int i= 0; i < fromTriangleCount; ++i)
+	{
+		const int triangleIndex= fromTriangles.at(i);
+		Triangle& triangle= m_Triangles[triangleIndex];
+		if (-1 != corner(triangle, to))
+		{
+			triangle.m_IsRemoved= true;
+			--m_TriangleCount;
+		}
+		else
+		{
+			const int fromCorner= corner(triangle, from);
+			const GLuint fromIndex= triangle.m_Corners[fromCorner];
+			for (int j= 0; j < cornerMap.size(); ++j)
+			{
+				if (cornerMap.at(j).first == fromIndex)
+				{
+					triangle.m_Corners[fromCorner]= cornerMap.at(j).second;
+					break;
+				}
+			}
+			triangle.m_Vertices[fromCorner]= to;
+			m_VertexTriangles[to].append(triangleIndex);
+		}
+	}
+	for (int i= 0; i < 10; ++i)
+	{
+		m_Quadrics[to].m_Coefficients[i]+= m_Quadrics.at(from).m_Coefficients[i];
+	}
+	m_VertexTriangles[from].clear();
+	m_Versions[from]= -1;
+	++m_Versions[to];
+	compactTriangles(to);
+	pushCollapses(to);
+
+	return true;
+}
+
+// Runnable which simplifies meshes of a list
+class GLC_MeshSimplifier::MeshRunner : public QRunnable
+{
+public:
+	inline MeshRunner(const GLC_MeshSimplifier* pSimplifier, const QList<GLC_Mesh*>& meshes, QAtomicInt* pNextMesh)
+	: QRunnable()
+	, m_pSimplifier(pSimplifier)
+	, m_Meshes(meshes)
+	, m_pNextMesh(pNextMesh)
+	{}
+
+	//! Simplify the next meshes until all meshes are taken
+	virtual void run()
+	{
+		const int meshCount= m_Meshes.size();
+		int meshIndex= m_pNextMesh->fetchAndAddOrdered(1);
+		while (meshIndex < meshCount)
+		{
+			m_pSimplifier->appendLods(m_Meshes.at(meshIndex));
+			meshIndex= m_pNextMesh->fetchAndAddOrdered(1);
+		}
+	}
+
+private:
+	//! The simplifier
+	const GLC_MeshSimplifier* m_pSimplifier;
+	//! The meshes to simplify
+	QList<GLC_Mesh*> m_Meshes;
+	//! The index of the next mesh to simplify
+	QAtomicInt* m_pNextMesh;
+};
+
+GLC_MeshSimplifier::GLC_MeshSimplifier(const QList<double>& accuracies)
+: m_Accuracies()
+{
+	setAccuracies(accuracies);
+}
+
+GLC_MeshSimplifier::~GLC_MeshSimplifier()
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_MeshSimplifier::setAccuracies(const QList<double>& accuracies)
+{
+	m_Accuracies.clear();
+	const int size= accuracies.size();
+	for (int i= 0; i < size; ++i)
+	{
+		if (accuracies.at(i) > 0.0) m_Accuracies.append(accuracies.at(i));
+	}
+	qSort(m_Accuracies);
+}
+
+int GLC_MeshSimplifier::appendLods(GLC_Mesh* pMesh) const
+{
+	if ((NULL == pMesh) || m_Accuracies.isEmpty() || pMesh->isEmpty() || (pMesh->lodCount() != 1)) return 0;
+
+	GLuintVector triangles;
+	QVector<GLC_uint> primitiveIds;
+	QVector<GLC_uint> materialIds;
+	pMesh->lodTriangles(0, &triangles, &primitiveIds, &materialIds);
+	if (primitiveIds.size() < minimumTriangleCount) return 0;
+
+	const GLC_BoundingBox& boundingBox= pMesh->boundingBox();
+	const double diagonal= (boundingBox.upperCorner() - boundingBox.lowerCorner()).length();
+	if (diagonal <= 0.0) return 0;
+
+	Decimation decimation(pMesh->positionVector(), triangles, primitiveIds, materialIds);
+	int previousTriangleCount= decimation.triangleCount();
+	int lodCount= 0;
+	const int accuracyCount= m_Accuracies.size();
+	for (int i= 0; i < accuracyCount; ++i)
+	{
+		decimation.collapse(m_Accuracies.at(i) * diagonal);
+
+		// A LOD must remove enough triangles of the previous one
+		const int triangleCount= decimation.triangleCount();
+		if (0 == triangleCount) break;
+		if (triangleCount > static_cast<int>(previousTriangleCount * (1.0 - minimumReduction))) continue;
+
+		decimation.triangles(&triangles, &primitiveIds, &materialIds);
+		if (-1 == pMesh->appendLod(m_Accuracies.at(i), triangles, primitiveIds, materialIds)) break;
+		previousTriangleCount= triangleCount;
+		++lodCount;
+	}
+
+	return lodCount;
+}
+
+void GLC_MeshSimplifier::appendLods(const GLC_3DRep& rep) const
+{
+	const int bodyCount= rep.numberOfBody();
+	for (int i= 0; i < bodyCount; ++i)
+	{
+		appendLods(dynamic_cast<GLC_Mesh*>(rep.geomAt(i)));
+	}
+}
+
+void GLC_MeshSimplifier::appendLods(const QList<GLC_Mesh*>& meshes, bool parallel) const
+{
+	const int meshCount= meshes.size();
+	if (m_Accuracies.isEmpty() || (0 == meshCount)) return;
+
+	QAtomicInt nextMesh(0);
+	const int threadCount= parallel ? qBound(1, QThread::idealThreadCount(), meshCount) : 1;
+	QThreadPool threadPool;
+	threadPool.setMaxThreadCount(threadCount);
+	for (int i= 1; i < threadCount; ++i)
+	{
+		threadPool.start(new MeshRunner(this, meshes, &nextMesh));
+	}
+
+	// The calling thread simplifies meshes too
+	MeshRunner runner(this, meshes, &nextMesh);
+	runner.run();
+	threadPool.waitForDone();
+}
+
+void GLC_MeshSimplifier::appendLods(const GLC_World& world, bool parallel) const
+{
+	if (m_Accuracies.isEmpty()) return;
+
+	// Meshes can be shared by references representations
+	QSet<GLC_Mesh*> meshes;
+	const QList<GLC_StructReference*> references= world.references();
+	const int referenceCount= references.size();
+	for (int i= 0; i < referenceCount; ++i)
+	{
+		GLC_StructReference* pReference= references.at(i);
+		if (pReference->hasRepresentation())
+		{
+			GLC_3DRep* pRep= dynamic_cast<GLC_3DRep*>(pReference->representationHandle());
+			if (NULL != pRep)
+			{
+				const int bodyCount= pRep->numberOfBody();
+				for (int j= 0; j < bodyCount; ++j)
+				{
+					GLC_Mesh* pMesh= dynamic_cast<GLC_Mesh*>(pRep->geomAt(j));
+					if (NULL != pMesh) meshes.insert(pMesh);
+				}
+			}
+		}
+	}
+
+	appendLods(meshes.toList(), parallel);
+}
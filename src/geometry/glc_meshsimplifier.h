@@ -0,0 +1,115 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_meshsimplifier.h Interface for the GLC_MeshSimplifier class.
+
+#ifndef GLC_MESHSIMPLIFIER_H_
+#define GLC_MESHSIMPLIFIER_H_
+
+#include <QList>
+
+#include "../glc_config.h"
+
+class GLC_Mesh;
+class GLC_3DRep;
+class GLC_World;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_MeshSimplifier
+/*! \brief GLC_MeshSimplifier : Build decimated LODs of meshes with quadric error metrics*/
+
+/*! Edges of the first LOD of a mesh are collapsed onto one of their vertices in
+ *  the order of the quadric error of the collapse. A LOD is appended to the mesh each
+ *  time the error reaches an accuracy, accuracies are relative to the mesh bounding box
+ *  diagonal. Open boundaries, material boundaries, primitive boundaries and normal or
+ *  texel seams are kept by the quadrics of planes orthogonal to their edges.
+ *  LODs only contain index of the mesh vertices, so mesh data are not duplicated.
+ *  Only finished meshes with one LOD which have not been drawn are simplified, so
+ *  LODs loaded from a GLC_BSRep are not computed again.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_MeshSimplifier
+{
+	//! \class Decimation
+	/*! \brief Decimation : The edges collapse of one mesh */
+	class Decimation;
+
+	//! \class MeshRunner
+	/*! \brief MeshRunner : Runnable which simplifies meshes of a list */
+	class MeshRunner;
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Construct a mesh simplifier of the given relative accuracies
+	GLC_MeshSimplifier(const QList<double>& accuracies= QList<double>());
+
+	//! Destructor
+	~GLC_MeshSimplifier();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return the relative accuracies of LODs in increasing order
+	inline QList<double> accuracies() const
+	{return m_Accuracies;}
+
+	//! Return true if this simplifier builds no LOD
+	inline bool isEmpty() const
+	{return m_Accuracies.isEmpty();}
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Set the relative accuracies of LODs
+	/*! Accuracies which are not strictly positive are ignored*/
+	void setAccuracies(const QList<double>& accuracies);
+
+	//! Append LODs to the given mesh and return the number of appended LODs
+	int appendLods(GLC_Mesh* pMesh) const;
+
+	//! Append LODs to the meshes of the given 3D representation
+	void appendLods(const GLC_3DRep& rep) const;
+
+	//! Append LODs to the given meshes, on worker threads if the given flag is true
+	void appendLods(const QList<GLC_Mesh*>& meshes, bool parallel) const;
+
+	//! Append LODs to the meshes of the given world, on worker threads if the given flag is true
+	void appendLods(const GLC_World& world, bool parallel) const;
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	//! The relative accuracies of LODs in increasing order
+	QList<double> m_Accuracies;
+};
+
+#endif /* GLC_MESHSIMPLIFIER_H_ */
@@ -0,0 +1,338 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_packedvertices.cpp Implementation for the GLC_PackedVertices class.
+
+#include "glc_packedvertices.h"
+
+#include <cmath>
+#include <cstring>
+
+// The maximum value of a quantized position or texel
+static const double maxQuantizedValue= 32767.0;
+
+// Compute the center and the scale of the given float vector of the given dimension
+static void computeQuantization(const GLfloatVector& values, int dimension, double* pCenter, double* pScale)
+{
+	const int count= values.size() / dimension;
+	for (int axis= 0; axis < dimension; ++axis)
+	{
+		double minValue= values.at(axis);
+		double maxValue= minValue;
+		for (int i= 1; i < count; ++i)
+		{
+			const double value= values.at(i * dimension + axis);
+			minValue= qMin(minValue, value);
+			maxValue= qMax(maxValue, value);
+		}
+		pCenter[axis]= 0.5 * (minValue + maxValue);
+		const double halfExtent= 0.5 * (maxValue - minValue);
+		// A flat axis keeps a non null scale to keep the matrix invertible
+		pScale[axis]= (halfExtent > 0.0) ? (halfExtent / maxQuantizedValue) : 1.0;
+	}
+}
+
+// Return the given value quantized with the given center and scale
+static inline qint16 quantize(double value, double center, double scale)
+{
+	const double quantized= qBound(-maxQuantizedValue, (value - center) / scale, maxQuantizedValue);
+	return static_cast<qint16>(qRound(quantized));
+}
+
+// Return the given value in [-1.0, 1.0] as a signed byte
+static inline qint8 packNormal(float value)
+{
+	return static_cast<qint8>(qRound(qBound(-1.0f, value, 1.0f) * 127.0f));
+}
+
+// Pack the given normal so that it is restored by the inverse transpose of the given scale
+static inline void packNormal(const float* pNormal, const double* pScale, qint8* pPacked)
+{
+	double scaled[3];
+	double length= 0.0;
+	for (int axis= 0; axis < 3; ++axis)
+	{
+		scaled[axis]= pNormal[axis] * pScale[axis];
+		length+= scaled[axis] * scaled[axis];
+	}
+	length= sqrt(length);
+	for (int axis= 0; axis < 3; ++axis)
+	{
+		const float value= (length > 0.0) ? static_cast<float>(scaled[axis] / length) : 0.0f;
+		pPacked[axis]= packNormal(value);
+	}
+}
+
+// Return the given value in [0.0, 1.0] as an unsigned byte
+static inline quint8 packColor(float value)
+{
+	return static_cast<quint8>(qRound(qBound(0.0f, value, 1.0f) * 255.0f));
+}
+
+GLC_PackedVertices::GLC_PackedVertices()
+: m_Data()
+, m_VertexCount(0)
+, m_HasTexels(false)
+, m_HasColors(false)
+{
+	clear();
+}
+
+GLC_PackedVertices::GLC_PackedVertices(const GLfloatVector& positions, const GLfloatVector& normals, const GLfloatVector& texels, const GLfloatVector& colors)
+: m_Data()
+, m_VertexCount(0)
+, m_HasTexels(false)
+, m_HasColors(false)
+{
+	clear();
+	const int vertexCount= positions.size() / 3;
+	Q_ASSERT(normals.size() == positions.size());
+	if (0 == vertexCount) return;
+
+	m_VertexCount= vertexCount;
+	m_HasTexels= (texels.size() == (vertexCount * 2));
+	m_HasColors= (colors.size() == (vertexCount * 4));
+
+	computeQuantization(positions, 3, m_PositionCenter, m_PositionScale);
+	if (m_HasTexels)
+	{
+		computeQuantization(texels, 2, m_TexelCenter, m_TexelScale);
+	}
+
+	const int recordSize= stride();
+	m_Data.fill(0, vertexCount * recordSize);
+	char* pRecord= m_Data.data();
+	for (int i= 0; i < vertexCount; ++i)
+	{
+		qint16 position[4];
+		qint8 normal[4];
+		for (int axis= 0; axis < 3; ++axis)
+		{
+			position[axis]= quantize(positions.at(i * 3 + axis), m_PositionCenter[axis], m_PositionScale[axis]);
+		}
+		packNormal(normals.constData() + i * 3, m_PositionScale, normal);
+		position[3]= 0;
+		normal[3]= 0;
+		memcpy(pRecord, position, sizeof(position));
+		memcpy(pRecord + normalOffset(), normal, sizeof(normal));
+
+		if (m_HasTexels)
+		{
+			qint16 texel[2];
+			texel[0]= quantize(texels.at(i * 2), m_TexelCenter[0], m_TexelScale[0]);
+			texel[1]= quantize(texels.at(i * 2 + 1), m_TexelCenter[1], m_TexelScale[1]);
+			memcpy(pRecord + texelOffset(), texel, sizeof(texel));
+		}
+		if (m_HasColors)
+		{
+			quint8 color[4];
+			for (int component= 0; component < 4; ++component)
+			{
+				color[component]= packColor(colors.at(i * 4 + component));
+			}
+			memcpy(pRecord + colorOffset(), color, sizeof(color));
+		}
+		pRecord+= recordSize;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+GLC_Matrix4x4 GLC_PackedVertices::positionMatrix() const
+{
+	GLC_Matrix4x4 scaling;
+	scaling.setMatScaling(m_PositionScale[0], m_PositionScale[1], m_PositionScale[2]);
+	return GLC_Matrix4x4(m_PositionCenter[0], m_PositionCenter[1], m_PositionCenter[2]) * scaling;
+}
+
+GLC_Matrix4x4 GLC_PackedVertices::texelMatrix() const
+{
+	GLC_Matrix4x4 scaling;
+	scaling.setMatScaling(m_TexelScale[0], m_TexelScale[1], 1.0);
+	return GLC_Matrix4x4(m_TexelCenter[0], m_TexelCenter[1], 0.0) * scaling;
+}
+
+GLfloatVector GLC_PackedVertices::positions() const
+{
+	Q_ASSERT(hasData() || isEmpty());
+	GLfloatVector subject(m_VertexCount * 3);
+	const int recordSize= stride();
+	const char* pRecord= m_Data.constData();
+	for (int i= 0; i < m_VertexCount; ++i)
+	{
+		qint16 position[3];
+		memcpy(position, pRecord, sizeof(position));
+		for (int axis= 0; axis < 3; ++axis)
+		{
+			subject[i * 3 + axis]= static_cast<GLfloat>(m_PositionCenter[axis] + position[axis] * m_PositionScale[axis]);
+		}
+		pRecord+= recordSize;
+	}
+	return subject;
+}
+
+GLfloatVector GLC_PackedVertices::normals() const
+{
+	Q_ASSERT(hasData() || isEmpty());
+	GLfloatVector subject(m_VertexCount * 3);
+	const int recordSize= stride();
+	const char* pRecord= m_Data.constData() + normalOffset();
+	for (int i= 0; i < m_VertexCount; ++i)
+	{
+		qint8 normal[3];
+		memcpy(normal, pRecord, sizeof(normal));
+		double unscaled[3];
+		double length= 0.0;
+		for (int axis= 0; axis < 3; ++axis)
+		{
+			unscaled[axis]= (static_cast<double>(normal[axis]) / 127.0) / m_PositionScale[axis];
+			length+= unscaled[axis] * unscaled[axis];
+		}
+		length= sqrt(length);
+		for (int axis= 0; axis < 3; ++axis)
+		{
+			subject[i * 3 + axis]= (length > 0.0) ? static_cast<GLfloat>(unscaled[axis] / length) : 0.0f;
+		}
+		pRecord+= recordSize;
+	}
+	return subject;
+}
+
+GLfloatVector GLC_PackedVertices::texels() const
+{
+	GLfloatVector subject;
+	if (m_HasTexels)
+	{
+		Q_ASSERT(hasData());
+		subject.resize(m_VertexCount * 2);
+		const int recordSize= stride();
+		const char* pRecord= m_Data.constData() + texelOffset();
+		for (int i= 0; i < m_VertexCount; ++i)
+		{
+			qint16 texel[2];
+			memcpy(texel, pRecord, sizeof(texel));
+			subject[i * 2]= static_cast<GLfloat>(m_TexelCenter[0] + texel[0] * m_TexelScale[0]);
+			subject[i * 2 + 1]= static_cast<GLfloat>(m_TexelCenter[1] + texel[1] * m_TexelScale[1]);
+			pRecord+= recordSize;
+		}
+	}
+	return subject;
+}
+
+GLfloatVector GLC_PackedVertices::colors() const
+{
+	GLfloatVector subject;
+	if (m_HasColors)
+	{
+		Q_ASSERT(hasData());
+		subject.resize(m_VertexCount * 4);
+		const int recordSize= stride();
+		const char* pRecord= m_Data.constData() + colorOffset();
+		for (int i= 0; i < m_VertexCount; ++i)
+		{
+			quint8 color[4];
+			memcpy(color, pRecord, sizeof(color));
+			for (int component= 0; component < 4; ++component)
+			{
+				subject[i * 4 + component]= static_cast<GLfloat>(color[component]) / 255.0f;
+			}
+			pRecord+= recordSize;
+		}
+	}
+	return subject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_PackedVertices::clear()
+{
+	m_Data.clear();
+	m_VertexCount= 0;
+	m_HasTexels= false;
+	m_HasColors= false;
+	for (int i= 0; i < 3; ++i)
+	{
+		m_PositionCenter[i]= 0.0;
+		m_PositionScale[i]= 1.0;
+	}
+	for (int i= 0; i < 2; ++i)
+	{
+		m_TexelCenter[i]= 0.0;
+		m_TexelScale[i]= 1.0;
+	}
+}
+
+void GLC_PackedVertices::saveLayout(QDataStream& stream) const
+{
+	stream << static_cast<qint32>(m_VertexCount);
+	stream << m_HasTexels;
+	stream << m_HasColors;
+	for (int i= 0; i < 3; ++i)
+	{
+		stream << m_PositionCenter[i] << m_PositionScale[i];
+	}
+	for (int i= 0; i < 2; ++i)
+	{
+		stream << m_TexelCenter[i] << m_TexelScale[i];
+	}
+}
+
+void GLC_PackedVertices::loadLayout(QDataStream& stream)
+{
+	clear();
+	qint32 vertexCount;
+	stream >> vertexCount;
+	m_VertexCount= vertexCount;
+	stream >> m_HasTexels;
+	stream >> m_HasColors;
+	for (int i= 0; i < 3; ++i)
+	{
+		stream >> m_PositionCenter[i] >> m_PositionScale[i];
+	}
+	for (int i= 0; i < 2; ++i)
+	{
+		stream >> m_TexelCenter[i] >> m_TexelScale[i];
+	}
+}
+
+// Non Member methods
+// Non-member stream operator
+QDataStream &operator<<(QDataStream &stream, const GLC_PackedVertices &packedVertices)
+{
+	packedVertices.saveLayout(stream);
+	stream << packedVertices.m_Data;
+
+	return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, GLC_PackedVertices &packedVertices)
+{
+	packedVertices.loadLayout(stream);
+	stream >> packedVertices.m_Data;
+	Q_ASSERT(packedVertices.m_Data.size() == packedVertices.dataSize());
+
+	return stream;
+}
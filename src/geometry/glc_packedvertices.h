@@ -0,0 +1,202 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_packedvertices.h Interface for the GLC_PackedVertices class.
+
+#ifndef GLC_PACKEDVERTICES_H_
+#define GLC_PACKEDVERTICES_H_
+
+#include <QByteArray>
+#include <QDataStream>
+
+#include "../glc_global.h"
+#include "../maths/glc_matrix4x4.h"
+
+#include "../glc_config.h"
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_PackedVertices
+/*! \brief GLC_PackedVertices : Interleaved and quantized vertices of a mesh*/
+
+/*! Each vertex is stored in one interleaved record :
+ *  - position : 3 signed 16 bits integers and 16 bits of padding,
+ *  quantized in the bounding box of the positions
+ *  - normal : 3 signed bytes and 1 byte of padding
+ *  - texel (optional) : 2 signed 16 bits integers, quantized in the bounding
+ *  rectangle of the texels
+ *  - color (optional) : 4 unsigned bytes
+ *
+ *  The record is 12, 16 or 20 bytes long instead of 24 to 48 bytes for the float
+ *  vectors of GLC_MeshData. Quantized positions and texels are decoded by the
+ *  position matrix and the texel matrix. Normals are multiplied by the position
+ *  scale before packing, so that the inverse transpose of the position matrix
+ *  applied by OpenGL restores their direction.
+ *  Data are stored in the byte order of the host.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_PackedVertices
+{
+	friend GLC_LIB_EXPORT QDataStream &operator<<(QDataStream &, const GLC_PackedVertices &);
+	friend GLC_LIB_EXPORT QDataStream &operator>>(QDataStream &, GLC_PackedVertices &);
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Construct empty packed vertices
+	GLC_PackedVertices();
+
+	//! Pack the given positions, normals, texels and colors
+	/*! Texels and colors can be empty*/
+	GLC_PackedVertices(const GLfloatVector& positions, const GLfloatVector& normals, const GLfloatVector& texels, const GLfloatVector& colors);
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return true if there is no vertex
+	inline bool isEmpty() const
+	{return 0 == m_VertexCount;}
+
+	//! Return the number of vertices
+	inline int vertexCount() const
+	{return m_VertexCount;}
+
+	//! Return true if vertices have texel
+	inline bool hasTexels() const
+	{return m_HasTexels;}
+
+	//! Return true if vertices have color
+	inline bool hasColors() const
+	{return m_HasColors;}
+
+	//! Return true if the packed data are on client side
+	inline bool hasData() const
+	{return !m_Data.isEmpty();}
+
+	//! Return the packed data
+	inline const QByteArray& data() const
+	{return m_Data;}
+
+	//! Return the size in bytes of the packed data
+	inline int dataSize() const
+	{return m_VertexCount * stride();}
+
+	//! Return the size in bytes of a vertex record
+	inline int stride() const
+	{return 12 + (m_HasTexels ? 4 : 0) + (m_HasColors ? 4 : 0);}
+
+	//! Return the offset of the normal in a vertex record
+	inline int normalOffset() const
+	{return 8;}
+
+	//! Return the offset of the texel in a vertex record
+	inline int texelOffset() const
+	{return 12;}
+
+	//! Return the offset of the color in a vertex record
+	inline int colorOffset() const
+	{return m_HasTexels ? 16 : 12;}
+
+	//! Return the matrix which transforms quantized positions into positions
+	GLC_Matrix4x4 positionMatrix() const;
+
+	//! Return the matrix which transforms quantized texels into texels
+	GLC_Matrix4x4 texelMatrix() const;
+
+	//! Return the decoded positions
+	GLfloatVector positions() const;
+
+	//! Return the decoded normals
+	GLfloatVector normals() const;
+
+	//! Return the decoded texels, empty if vertices have no texel
+	GLfloatVector texels() const;
+
+	//! Return the decoded colors, empty if vertices have no color
+	GLfloatVector colors() const;
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Set the packed data, read back from a VBO or a mapped buffer
+	inline void setData(const QByteArray& data)
+	{
+		Q_ASSERT(data.size() == dataSize());
+		m_Data= data;
+	}
+
+	//! Release the packed data and keep the vertices layout and quantization
+	inline void releaseData()
+	{m_Data.clear();}
+
+	//! Clear the packed vertices and makes them empty
+	void clear();
+
+	//! Save the vertices layout and quantization in the given stream, without the packed data
+	void saveLayout(QDataStream& stream) const;
+
+	//! Load the vertices layout and quantization from the given stream, without the packed data
+	void loadLayout(QDataStream& stream);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	//! The interleaved packed data
+	QByteArray m_Data;
+
+	//! The number of vertices
+	int m_VertexCount;
+
+	//! True if vertices have texel
+	bool m_HasTexels;
+
+	//! True if vertices have color
+	bool m_HasColors;
+
+	//! The center of the positions bounding box
+	double m_PositionCenter[3];
+
+	//! The position scale of each axis
+	double m_PositionScale[3];
+
+	//! The center of the texels bounding rectangle
+	double m_TexelCenter[2];
+
+	//! The texel scale of each axis
+	double m_TexelScale[2];
+};
+
+//! Non-member stream operator
+GLC_LIB_EXPORT QDataStream &operator<<(QDataStream &, const GLC_PackedVertices &);
+GLC_LIB_EXPORT QDataStream &operator>>(QDataStream &, GLC_PackedVertices &);
+
+#endif /* GLC_PACKEDVERTICES_H_ */
@@ -274,28 +274,100 @@ void GLC_PrimitiveGroup::setBaseTrianglesFanOffseti(int offset)
 	}
 }
 
+// Convert strips and fans into triangles
+void GLC_PrimitiveGroup::convertStripsAndFansToTriangles()
+{
+	Q_ASSERT(!m_IsFinished);
+	const IndexList stripsIndex(m_StripsIndex);
+	const IndexSizes stripsSizes(m_StripIndexSizes);
+	const QList<GLC_uint> stripsId(m_StripsId);
+	const IndexList fansIndex(m_FansIndex);
+	const IndexSizes fansSizes(m_FansIndexSizes);
+	const QList<GLC_uint> fansId(m_FansId);
+
+	m_StripsIndex.clear();
+	m_StripIndexSizes.clear();
+	m_StripIndexOffset.clear();
+	m_StripIndexOffseti.clear();
+	m_StripsId.clear();
+	m_TrianglesStripSize= 0;
+	m_FansIndex.clear();
+	m_FansIndexSizes.clear();
+	m_FanIndexOffset.clear();
+	m_FanIndexOffseti.clear();
+	m_FansId.clear();
+	m_TrianglesFanSize= 0;
+
+	int offset= 0;
+	const int stripCount= stripsSizes.size();
+	for (int i= 0; i < stripCount; ++i)
+	{
+		IndexList triangles;
+		const int size= stripsSizes.at(i);
+		for (int j= 2; j < size; ++j)
+		{
+			const GLuint first= stripsIndex.at(offset + j - 2);
+			const GLuint second= stripsIndex.at(offset + j - 1);
+			const GLuint third= stripsIndex.at(offset + j);
+			if ((first == second) || (second == third) || (first == third)) continue;
+
+			// Odd triangles of a strip have the reverse order
+			if ((j % 2) == 0) triangles << first << second << third;
+			else triangles << second << first << third;
+		}
+		addTriangles(triangles, stripsId.value(i));
+		offset+= size;
+	}
+
+	offset= 0;
+	const int fanCount= fansSizes.size();
+	for (int i= 0; i < fanCount; ++i)
+	{
+		IndexList triangles;
+		const int size= fansSizes.at(i);
+		for (int j= 2; j < size; ++j)
+		{
+			triangles << fansIndex.at(offset) << fansIndex.at(offset + j - 1) << fansIndex.at(offset + j);
+		}
+		addTriangles(triangles, fansId.value(i));
+		offset+= size;
+	}
+}
+
+// Replace the triangles, strips and fans index
+void GLC_PrimitiveGroup::replaceIndex(const IndexList& triangles, const IndexList& strips, const IndexList& fans)
+{
+	Q_ASSERT(!m_IsFinished);
+	Q_ASSERT(triangles.size() == m_TrianglesIndex.size());
+	Q_ASSERT(strips.size() == m_StripsIndex.size());
+	Q_ASSERT(fans.size() == m_FansIndex.size());
+	m_TrianglesIndex= triangles;
+	m_StripsIndex= strips;
+	m_FansIndex= fans;
+}
+
 // Change index to VBO mode
-void GLC_PrimitiveGroup::computeVboOffset()
+void GLC_PrimitiveGroup::computeVboOffset(int indexSize)
 {
 	m_TrianglesGroupOffset.clear();
 	const int triangleOffsetSize= m_TrianglesGroupOffseti.size();
 	for (int i= 0; i < triangleOffsetSize; ++i)
 	{
-		m_TrianglesGroupOffset.append(BUFFER_OFFSET(static_cast<GLsizei>(m_TrianglesGroupOffseti.at(i)) * sizeof(GLuint)));
+		m_TrianglesGroupOffset.append(BUFFER_OFFSET(static_cast<GLsizei>(m_TrianglesGroupOffseti.at(i)) * indexSize));
 	}
 
 	m_StripIndexOffset.clear();
 	const int stripOffsetSize= m_StripIndexOffseti.size();
 	for (int i= 0; i < stripOffsetSize; ++i)
 	{
-		m_StripIndexOffset.append(BUFFER_OFFSET(static_cast<GLsizei>(m_StripIndexOffseti.at(i)) * sizeof(GLuint)));
+		m_StripIndexOffset.append(BUFFER_OFFSET(static_cast<GLsizei>(m_StripIndexOffseti.at(i)) * indexSize));
 	}
 
 	m_FanIndexOffset.clear();
 	const int fanOffsetSize= m_FanIndexOffseti.size();
 	for (int i= 0; i < fanOffsetSize; ++i)
 	{
-		m_FanIndexOffset.append(BUFFER_OFFSET(static_cast<GLsizei>(m_FanIndexOffseti.at(i)) * sizeof(GLuint)));
+		m_FanIndexOffset.append(BUFFER_OFFSET(static_cast<GLsizei>(m_FanIndexOffseti.at(i)) * indexSize));
 	}
 }
 
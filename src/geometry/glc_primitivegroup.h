@@ -243,8 +243,16 @@ public:
 	//! Set base triangle fan offset
 	void setBaseTrianglesFanOffseti(int);
 
-	//! Compute VBO offset
-	void computeVboOffset();
+	//! Convert strips and fans into triangles, each strip and fan keeps its id
+	/*! Degenerate triangles of strips are removed. The group must not be finished*/
+	void convertStripsAndFansToTriangles();
+
+	//! Replace the triangles, strips and fans index by index of the same sizes
+	/*! Used to reorder triangles and to renumber vertices before the mesh is finished*/
+	void replaceIndex(const IndexList& triangles, const IndexList& strips, const IndexList& fans);
+
+	//! Compute VBO offset with the given size in bytes of an index in IBO
+	void computeVboOffset(int indexSize= sizeof(GLuint));
 
 	//! The mesh wich use this group is finished
 	inline void finish()
@@ -0,0 +1,250 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_vertexcacheoptimizer.cpp Implementation for the GLC_VertexCacheOptimizer class.
+
+#include "glc_vertexcacheoptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Size of the simulated LRU cache used to score vertices
+static const int lruCacheSize= 32;
+
+// Score of the vertices of the last added triangle
+static const float lastTriangleScore= 0.75f;
+
+// Decay of the score with the position in the cache
+static const float cacheDecayPower= 1.5f;
+
+// Scale of the score of vertices with few remaining triangles
+static const float valenceBoostScale= 2.0f;
+
+// Power of the score of vertices with few remaining triangles
+static const float valenceBoostPower= 0.5f;
+
+// Return the score of a vertex at the given cache position (-1 if not in cache) with the given count of remaining triangles
+static float vertexScore(int cachePosition, int remainingTriangles)
+{
+	if (0 == remainingTriangles) return -1.0f;
+
+	float score= 0.0f;
+	if (cachePosition >= 0)
+	{
+		if (cachePosition < 3)
+		{
+			score= lastTriangleScore;
+		}
+		else
+		{
+			const float scaler= 1.0f / static_cast<float>(lruCacheSize - 3);
+			score= std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, cacheDecayPower);
+		}
+	}
+	score+= valenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -valenceBoostPower);
+
+	return score;
+}
+
+GLC_VertexCacheOptimizer::GLC_VertexCacheOptimizer()
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+int GLC_VertexCacheOptimizer::fifoCacheSize()
+{
+	return 16;
+}
+
+double GLC_VertexCacheOptimizer::acmr(const GLuint* pTriangles, int triangleCount, int cacheSize)
+{
+	if (0 == triangleCount) return 0.0;
+	Q_ASSERT(cacheSize > 0);
+
+	QVector<GLuint> fifo(cacheSize);
+	int next= 0;
+	int filled= 0;
+	int missCount= 0;
+	const int indexCount= triangleCount * 3;
+	for (int i= 0; i < indexCount; ++i)
+	{
+		const GLuint index= pTriangles[i];
+		bool isInCache= false;
+		for (int j= 0; (j < filled) && !isInCache; ++j)
+		{
+			isInCache= (fifo.at(j) == index);
+		}
+		if (!isInCache)
+		{
+			++missCount;
+			fifo[next]= index;
+			next= (next + 1) % cacheSize;
+			filled= qMin(filled + 1, cacheSize);
+		}
+	}
+
+	return static_cast<double>(missCount) / static_cast<double>(triangleCount);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_VertexCacheOptimizer::optimizeTriangles(GLuint* pTriangles, int triangleCount)
+{
+	if (triangleCount < 2) return;
+	const int indexCount= triangleCount * 3;
+
+	// Vertices are numbered locally to the given triangles
+	QVector<GLuint> vertices(indexCount);
+	std::copy(pTriangles, pTriangles + indexCount, vertices.begin());
+	std::sort(vertices.begin(), vertices.end());
+	const int vertexCount= static_cast<int>(std::unique(vertices.begin(), vertices.end()) - vertices.begin());
+
+	QVector<int> localIndex(indexCount);
+	for (int i= 0; i < indexCount; ++i)
+	{
+		localIndex[i]= static_cast<int>(std::lower_bound(vertices.constBegin(), vertices.constBegin() + vertexCount, pTriangles[i]) - vertices.constBegin());
+	}
+
+	// The remaining triangles of each vertex are at the beginning of its range
+	QVector<int> remainingCount(vertexCount, 0);
+	for (int i= 0; i < indexCount; ++i)
+	{
+		++remainingCount[localIndex.at(i)];
+	}
+	QVector<int> trianglesOffset(vertexCount + 1, 0);
+	for (int i= 0; i < vertexCount; ++i)
+	{
+		trianglesOffset[i + 1]= trianglesOffset.at(i) + remainingCount.at(i);
+	}
+	QVector<int> vertexTriangles(indexCount);
+	{
+		QVector<int> cursor(trianglesOffset);
+		for (int i= 0; i < indexCount; ++i)
+		{
+			vertexTriangles[cursor[localIndex.at(i)]++]= i / 3;
+		}
+	}
+
+	QVector<int> cachePosition(vertexCount, -1);
+	QVector<float> scoreOfVertex(vertexCount);
+	for (int i= 0; i < vertexCount; ++i)
+	{
+		scoreOfVertex[i]= vertexScore(-1, remainingCount.at(i));
+	}
+
+	int bestTriangle= 0;
+	float bestScore= -1.0f;
+	for (int i= 0; i < triangleCount; ++i)
+	{
+		const float score= scoreOfVertex.at(localIndex.at(3 * i)) + scoreOfVertex.at(localIndex.at(3 * i + 1)) + scoreOfVertex.at(localIndex.at(3 * i + 2));
+		if (score > bestScore)
+		{
+			bestScore= score;
+			bestTriangle= i;
+		}
+	}
+
+	QVector<bool> isAdded(triangleCount, false);
+	QVector<GLuint> result(indexCount);
+	int cache[lruCacheSize + 3];
+	int cacheCount= 0;
+	int nextTriangle= 0;
+	for (int output= 0; output < triangleCount; ++output)
+	{
+		// Without candidate in cache, the next triangle in the input order is taken
+		if (bestTriangle < 0)
+		{
+			while (isAdded.at(nextTriangle)) ++nextTriangle;
+			bestTriangle= nextTriangle;
+		}
+		isAdded[bestTriangle]= true;
+		std::copy(pTriangles + 3 * bestTriangle, pTriangles + 3 * bestTriangle + 3, result.begin() + 3 * output);
+
+		// Remove the triangle from its vertices and move them at the front of the cache
+		int newCache[lruCacheSize + 3];
+		int newCacheCount= 0;
+		for (int k= 0; k < 3; ++k)
+		{
+			const int vertex= localIndex.at(3 * bestTriangle + k);
+			int* pFirst= vertexTriangles.data() + trianglesOffset.at(vertex);
+			int* pLast= pFirst + remainingCount.at(vertex) - 1;
+			int* pTriangle= std::find(pFirst, pLast + 1, bestTriangle);
+			Q_ASSERT(pTriangle <= pLast);
+			std::swap(*pTriangle, *pLast);
+			--remainingCount[vertex];
+
+			if (std::find(newCache, newCache + newCacheCount, vertex) == (newCache + newCacheCount))
+			{
+				newCache[newCacheCount++]= vertex;
+			}
+		}
+		const int triangleVertexCount= newCacheCount;
+		for (int i= 0; i < cacheCount; ++i)
+		{
+			const int vertex= cache[i];
+			if (std::find(newCache, newCache + triangleVertexCount, vertex) == (newCache + triangleVertexCount))
+			{
+				newCache[newCacheCount++]= vertex;
+			}
+		}
+
+		// Update the score of the vertices of the cache, including the ones pushed out of the cache
+		for (int i= 0; i < newCacheCount; ++i)
+		{
+			const int vertex= newCache[i];
+			cachePosition[vertex]= (i < lruCacheSize) ? i : -1;
+			scoreOfVertex[vertex]= vertexScore(cachePosition.at(vertex), remainingCount.at(vertex));
+		}
+
+		// Update the score of their remaining triangles and select the best one
+		bestTriangle= -1;
+		bestScore= -1.0f;
+		for (int i= 0; i < newCacheCount; ++i)
+		{
+			const int vertex= newCache[i];
+			const int first= trianglesOffset.at(vertex);
+			const int last= first + remainingCount.at(vertex);
+			for (int j= first; j < last; ++j)
+			{
+				const int triangle= vertexTriangles.at(j);
+				const float score= scoreOfVertex.at(localIndex.at(3 * triangle)) + scoreOfVertex.at(localIndex.at(3 * triangle + 1))
+						+ scoreOfVertex.at(localIndex.at(3 * triangle + 2));
+				if (score > bestScore)
+				{
+					bestScore= score;
+					bestTriangle= triangle;
+				}
+			}
+		}
+
+		cacheCount= qMin(newCacheCount, lruCacheSize);
+		std::copy(newCache, newCache + cacheCount, cache);
+	}
+
+	std::copy(result.constBegin(), result.constEnd(), pTriangles);
+}
@@ -0,0 +1,80 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_vertexcacheoptimizer.h Interface for the GLC_VertexCacheOptimizer class.
+
+#ifndef GLC_VERTEXCACHEOPTIMIZER_H_
+#define GLC_VERTEXCACHEOPTIMIZER_H_
+
+#include "../glc_global.h"
+
+#include "../glc_config.h"
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_VertexCacheOptimizer
+/*! \brief GLC_VertexCacheOptimizer : Triangles ordering for the post-transform vertex cache*/
+
+/*! Triangles are reordered with the linear speed algorithm of Tom Forsyth : the next
+ *  triangle is the one of highest score among the triangles of the vertices in a
+ *  simulated LRU cache. A vertex score grows with its position in the cache and with
+ *  the inverse of its count of remaining triangles.
+ *  The quality of an order is measured by the ACMR (Average Cache Miss Ratio), the
+ *  number of vertices transformed per triangle with a FIFO cache.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_VertexCacheOptimizer
+{
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Private constructor. This class is static only
+	GLC_VertexCacheOptimizer();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return the size of the FIFO cache used to compute ACMR
+	static int fifoCacheSize();
+
+	//! Return the ACMR of the given count of triangles with a FIFO cache of the given size
+	/*! Return 0.0 if there is no triangle*/
+	static double acmr(const GLuint* pTriangles, int triangleCount, int cacheSize= fifoCacheSize());
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Reorder in place the given count of triangles for the post-transform vertex cache
+	/*! The orientation of triangles is kept*/
+	static void optimizeTriangles(GLuint* pTriangles, int triangleCount);
+
+//@}
+};
+
+#endif /* GLC_VERTEXCACHEOPTIMIZER_H_ */
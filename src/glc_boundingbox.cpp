@@ -24,6 +24,10 @@
 
 #include "glc_boundingbox.h"
 #include "maths/glc_matrix4x4.h"
+#include "maths/glc_line3d.h"
+#include "maths/glc_batchtransform.h"
+
+#include <limits>
 
 quint32 GLC_BoundingBox::m_ChunkId= 0xA707;
 
@@ -91,6 +95,44 @@ bool GLC_BoundingBox::intersectBoundingSphere(const GLC_BoundingBox& boundingSph
 	return distance < (boundingSphereRadius() + boundingSphere.boundingSphereRadius());
 }
 
+bool GLC_BoundingBox::intersect(const GLC_Line3d& ray, double* pEntryParameter) const
+{
+	if (m_IsEmpty) return false;
+
+	const GLC_Point3d origin(ray.startingPoint());
+	const GLC_Vector3d direction(ray.direction());
+
+	// Slab test
+	double entry= 0.0;
+	double exit= std::numeric_limits<double>::max();
+	for (int i= 0; i < 3; ++i)
+	{
+		const double originValue= origin.data()[i];
+		const double directionValue= direction.data()[i];
+		const double lowerValue= m_Lower.data()[i];
+		const double upperValue= m_Upper.data()[i];
+		if (directionValue == 0.0)
+		{
+			if ((originValue < lowerValue) || (originValue > upperValue)) return false;
+		}
+		else
+		{
+			double parameter1= (lowerValue - originValue) / directionValue;
+			double parameter2= (upperValue - originValue) / directionValue;
+			if (parameter1 > parameter2) qSwap(parameter1, parameter2);
+			entry= qMax(entry, parameter1);
+			exit= qMin(exit, parameter2);
+			if (entry > exit) return false;
+		}
+	}
+
+	if (NULL != pEntryParameter)
+	{
+		*pEntryParameter= entry;
+	}
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Set Functions
 //////////////////////////////////////////////////////////////////////
@@ -170,38 +212,14 @@ GLC_BoundingBox& GLC_BoundingBox::transform(const GLC_Matrix4x4& matrix)
 {
 	if (!m_IsEmpty)
 	{
-		// Compute Transformed BoundingBox Corner
-		GLC_Point3d corner1(m_Lower);
-		GLC_Point3d corner7(m_Upper);
-		GLC_Point3d corner2(corner7.x(), corner1.y(), corner1.z());
-		GLC_Point3d corner3(corner7.x(), corner7.y(), corner1.z());
-		GLC_Point3d corner4(corner1.x(), corner7.y(), corner1.z());
-		GLC_Point3d corner5(corner1.x(), corner1.y(), corner7.z());
-		GLC_Point3d corner6(corner7.x(), corner1.y(), corner7.z());
-		GLC_Point3d corner8(corner1.x(), corner7.y(), corner7.z());
-
-		corner1 = (matrix * corner1);
-		corner2 = (matrix * corner2);
-		corner3 = (matrix * corner3);
-		corner4 = (matrix * corner4);
-		corner5 = (matrix * corner5);
-		corner6 = (matrix * corner6);
-		corner7 = (matrix * corner7);
-		corner8 = (matrix * corner8);
-
-		// Compute the new BoundingBox
-		GLC_BoundingBox boundingBox;
-		boundingBox.combine(corner1);
-		boundingBox.combine(corner2);
-		boundingBox.combine(corner3);
-		boundingBox.combine(corner4);
-		boundingBox.combine(corner5);
-		boundingBox.combine(corner6);
-		boundingBox.combine(corner7);
-		boundingBox.combine(corner8);
-
-		m_Lower= boundingBox.m_Lower;
-		m_Upper= boundingBox.m_Upper;
+		const double lower[3]= {m_Lower.x(), m_Lower.y(), m_Lower.z()};
+		const double upper[3]= {m_Upper.x(), m_Upper.y(), m_Upper.z()};
+		double newLower[3];
+		double newUpper[3];
+		glc::transformBox(matrix.getData(), lower, upper, newLower, newUpper);
+
+		m_Lower.setVect(newLower[0], newLower[1], newLower[2]);
+		m_Upper.setVect(newUpper[0], newUpper[1], newUpper[2]);
 	}
 
 	return *this;
@@ -31,6 +31,8 @@
 #include <QtDebug>
 #include "glc_config.h"
 
+class GLC_Line3d;
+
 //////////////////////////////////////////////////////////////////////
 //! \class GLC_BoundingBox
 /*! \brief GLC_BoundingBox : Geometry bounding box*/
@@ -86,6 +88,11 @@ public:
 	//! Return true if the given bounding sphere of bounding box intersect the bounding sphere of box bounding box
 	bool intersectBoundingSphere(const GLC_BoundingBox&) const;
 
+	//! Return true if the given ray intersect this bounding box
+	/*! The ray starts at the line starting point, if the given pointer is not NULL
+	 *  it is set to the parameter of the ray entry in this bounding box*/
+	bool intersect(const GLC_Line3d& ray, double* pEntryParameter= NULL) const;
+
 	//! Return the lower corner of this bounding box
 	inline const GLC_Point3d& lowerCorner() const
 	{return m_Lower;}
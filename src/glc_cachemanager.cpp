@@ -29,6 +29,7 @@ GLC_CacheManager::GLC_CacheManager(const QString& path)
 : m_Dir()
 , m_UseCompression(true)
 , m_CompressionLevel(-1)
+, m_UseMappedStorage(false)
 {
 	if (! path.isEmpty())
 	{
@@ -45,6 +46,7 @@ GLC_CacheManager::GLC_CacheManager(const GLC_CacheManager& cacheManager)
 :m_Dir(cacheManager.m_Dir)
 , m_UseCompression(cacheManager.m_UseCompression)
 , m_CompressionLevel(cacheManager.m_CompressionLevel)
+, m_UseMappedStorage(cacheManager.m_UseMappedStorage)
 {
 
 }
@@ -55,6 +57,7 @@ GLC_CacheManager& GLC_CacheManager::operator=(const GLC_CacheManager& cacheManag
 	m_Dir= cacheManager.m_Dir;
 	m_UseCompression= cacheManager.m_UseCompression;
 	m_CompressionLevel= cacheManager.m_CompressionLevel;
+	m_UseMappedStorage= cacheManager.m_UseMappedStorage;
 
 	return *this;
 }
@@ -156,6 +159,7 @@ bool GLC_CacheManager::addToCache(const QString& context, const GLC_3DRep& rep)
 			const QString binaryFileName= contextCacheInfo.filePath() + QDir::separator() + repFileName;
 			GLC_BSRep binariRep(binaryFileName, m_UseCompression);
 			binariRep.setCompressionLevel(m_CompressionLevel);
+			binariRep.setMappedStorageUsage(m_UseMappedStorage);
 			addedToCache= binariRep.save(rep);
 		}
 	}
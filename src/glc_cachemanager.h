@@ -98,6 +98,10 @@ public:
 	inline int compressionLevel() const
 	{return m_CompressionLevel;}
 
+	//! Return true if the memory mapped storage is used
+	inline bool mappedStorageIsUsed() const
+	{return m_UseMappedStorage;}
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -116,6 +120,11 @@ public:
 	//! Set the cache compression level
 	inline void setCompressionLevel(int level)
 	{m_CompressionLevel= level;}
+
+	//! Set the cache memory mapped storage usage
+	/*! Cached representations are then loaded lazily from memory mapped files*/
+	inline void setMappedStorageUsage(bool use)
+	{m_UseMappedStorage= use;}
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -131,6 +140,9 @@ private:
 
 	//! The compression level
 	int m_CompressionLevel;
+
+	//! Use memory mapped storage
+	bool m_UseMappedStorage;
 };
 
 #endif /* GLC_CACHEMANAGER_H_ */
@@ -34,6 +34,10 @@
 PFNGLPOINTPARAMETERFARBPROC			glPointParameterf		= NULL;
 PFNGLPOINTPARAMETERFVARBPROC		glPointParameterfv		= NULL;
 
+// GL_ARB_draw_instanced and GL_ARB_instanced_arrays
+PFNGLDRAWELEMENTSINSTANCEDARBPROC	glDrawElementsInstanced	= NULL;
+PFNGLVERTEXATTRIBDIVISORPROC		glVertexAttribDivisor	= NULL;
+
 #endif
 
 
@@ -76,3 +80,20 @@ bool glc::loadPointSpriteExtension()
     return result;
 }
 
+
+// Load instanced drawing and instanced arrays extensions
+bool glc::loadInstancingExtension()
+{
+	bool result= false;
+#if !defined(Q_OS_MAC)
+	const QGLContext* pContext= QGLContext::currentContext();
+	glDrawElementsInstanced			= (PFNGLDRAWELEMENTSINSTANCEDARBPROC)pContext->getProcAddress(QLatin1String("glDrawElementsInstancedARB"));
+	if (!glDrawElementsInstanced) qDebug() << "not glDrawElementsInstanced";
+	glVertexAttribDivisor			= (PFNGLVERTEXATTRIBDIVISORPROC)pContext->getProcAddress(QLatin1String("glVertexAttribDivisorARB"));
+	if (!glVertexAttribDivisor) qDebug() << "not glVertexAttribDivisor";
+
+	result= glDrawElementsInstanced && glVertexAttribDivisor;
+
+#endif
+    return result;
+}
@@ -67,6 +67,9 @@ GLC_Factory* GLC_Factory::instance()
 
 // Protected constructor
 GLC_Factory::GLC_Factory()
+: m_LodAccuracies()
+, m_UseStlVertexWelding(true)
+, m_ComputeStlNormals(false)
 {
 	loadPlugins();
 }
@@ -252,6 +255,7 @@ GLC_3DRep GLC_Factory::create3DRepFromFile(const QString& fileName) const
 	{
 		GLC_3dxmlToWorld d3dxmlToWorld;
 		connect(&d3dxmlToWorld, SIGNAL(currentQuantum(int)), this, SIGNAL(currentQuantum(int)));
+		d3dxmlToWorld.setLodAccuracies(m_LodAccuracies);
 		rep= d3dxmlToWorld.create3DrepFrom3dxmlRep(fileName);
 	}
 
@@ -261,7 +265,20 @@ GLC_3DRep GLC_Factory::create3DRepFromFile(const QString& fileName) const
 
 GLC_FileLoader* GLC_Factory::createFileLoader() const
 {
-    return new GLC_FileLoader;
+	GLC_FileLoader* pLoader= new GLC_FileLoader;
+	pLoader->setLodAccuracies(m_LodAccuracies);
+	pLoader->setStlVertexWeldingUsage(m_UseStlVertexWelding);
+	pLoader->setStlNormalsComputingUsage(m_ComputeStlNormals);
+	return pLoader;
+}
+
+GLC_WorldLoader* GLC_Factory::createWorldLoader() const
+{
+	GLC_WorldLoader* pLoader= new GLC_WorldLoader;
+	pLoader->setLodAccuracies(m_LodAccuracies);
+	pLoader->setStlVertexWeldingUsage(m_UseStlVertexWelding);
+	pLoader->setStlNormalsComputingUsage(m_ComputeStlNormals);
+	return pLoader;
 }
 
 GLC_Material* GLC_Factory::createMaterial() const
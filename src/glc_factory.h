@@ -51,6 +51,7 @@
 #include "viewport/glc_movercontroller.h"
 #include "viewport/glc_viewport.h"
 #include "io/glc_fileloader.h"
+#include "io/glc_worldloader.h"
 
 // end of class to built
 
@@ -141,6 +142,9 @@ public:
 	//! Create a GLC_FileLoader
 	GLC_FileLoader* createFileLoader() const;
 
+	//! Create a GLC_WorldLoader which loads worlds on a worker thread
+	GLC_WorldLoader* createWorldLoader() const;
+
 	//! Create default material
 	GLC_Material* createMaterial() const;
 
@@ -177,6 +181,38 @@ public:
 	//! Return an handle to the plugin tu use for the given file
 	static GLC_WorldReaderHandler* loadingHandler(const QString& fileName);
 
+	//! Return the relative accuracies of the LODs built for meshes loaded from files
+	inline QList<double> lodAccuracies() const
+	{return m_LodAccuracies;}
+
+	//! Return true if duplicate vertices of loaded STL files are welded
+	inline bool stlVertexWeldingIsUsed() const
+	{return m_UseStlVertexWelding;}
+
+	//! Return true if smooth normals of loaded STL files are computed
+	inline bool stlNormalsComputingIsUsed() const
+	{return m_ComputeStlNormals;}
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Set the relative accuracies of the LODs built for meshes loaded from files
+	/*! An empty list, the default, disables LODs building \see GLC_MeshSimplifier*/
+	inline void setLodAccuracies(const QList<double>& accuracies)
+	{m_LodAccuracies= accuracies;}
+
+	//! Set the vertex welding usage of loaded STL files (Default true) \see GLC_StlToWorld
+	inline void setStlVertexWeldingUsage(bool usage)
+	{m_UseStlVertexWelding= usage;}
+
+	//! Set the smooth normals computing usage of loaded STL files (Default false) \see GLC_StlToWorld
+	inline void setStlNormalsComputingUsage(bool usage)
+	{m_ComputeStlNormals= usage;}
+
 //@}
 
 signals:
@@ -204,6 +240,15 @@ private:
 	//! The supported extension set
 	static QSet<QString> m_SupportedExtensionSet;
 
+	//! The relative accuracies of the LODs built for meshes loaded from files
+	QList<double> m_LodAccuracies;
+
+	//! Vertex welding usage of loaded STL files
+	bool m_UseStlVertexWelding;
+
+	//! Smooth normals computing usage of loaded STL files
+	bool m_ComputeStlNormals;
+
 };
 
 #endif /*GLC_FACTORY_*/
@@ -34,45 +34,45 @@ GLC_uint glc::GLC_GenID(void)
 {
 	static GLC_uint Id= 0;
 	glc::iDMutex.lock();
-	Id++;
+	const GLC_uint result= ++Id;
 	glc::iDMutex.unlock();
-	return Id;
+	return result;
 }
 
 GLC_uint glc::GLC_GenGeomID(void)
 {
 	static GLC_uint Id= 0;
 	glc::geomIdMutex.lock();
-	Id++;
+	const GLC_uint result= ++Id;
 	glc::geomIdMutex.unlock();
-	return Id;
+	return result;
 }
 
 GLC_uint glc::GLC_GenUserID(void)
 {
 	static GLC_uint Id= 0;
 	glc::userIdMutex.lock();
-	Id++;
+	const GLC_uint result= ++Id;
 	glc::userIdMutex.unlock();
-	return Id;
+	return result;
 }
 
 GLC_uint glc::GLC_Gen3DWidgetID(void)
 {
 	static GLC_uint Id= 0;
 	glc::widget3dIdMutex.lock();
-	Id++;
+	const GLC_uint result= ++Id;
 	glc::widget3dIdMutex.unlock();
-	return Id;
+	return result;
 }
 
 GLC_uint glc::GLC_GenShaderGroupID()
 {
 	static GLC_uint Id= 1;
 	glc::shadingGroupIdMutex.lock();
-	Id++;
+	const GLC_uint result= ++Id;
 	glc::shadingGroupIdMutex.unlock();
-	return Id;
+	return result;
 }
 
 const QString glc::archivePrefix()
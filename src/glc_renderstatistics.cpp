@@ -27,6 +27,9 @@
 bool GLC_RenderStatistics::m_IsActivated= false;
 unsigned int GLC_RenderStatistics::m_LastRenderGeometryCount= 0;
 unsigned long GLC_RenderStatistics::m_LastRenderPolygonCount= 0;
+unsigned int GLC_RenderStatistics::m_LastFrustumCulledCount= 0;
+unsigned int GLC_RenderStatistics::m_LastOcclusionCulledCount= 0;
+unsigned int GLC_RenderStatistics::m_LastDrawCallCount= 0;
 
 GLC_RenderStatistics::GLC_RenderStatistics()
 {
@@ -57,6 +60,21 @@ unsigned long GLC_RenderStatistics::triangleCount()
 	return m_LastRenderPolygonCount;
 }
 
+unsigned int GLC_RenderStatistics::frustumCulledCount()
+{
+	return m_LastFrustumCulledCount;
+}
+
+unsigned int GLC_RenderStatistics::occlusionCulledCount()
+{
+	return m_LastOcclusionCulledCount;
+}
+
+unsigned int GLC_RenderStatistics::drawCallCount()
+{
+	return m_LastDrawCallCount;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Set methods
 //////////////////////////////////////////////////////////////////////
@@ -69,6 +87,9 @@ void GLC_RenderStatistics::reset()
 {
 	m_LastRenderGeometryCount= 0;
 	m_LastRenderPolygonCount= 0;
+	m_LastFrustumCulledCount= 0;
+	m_LastOcclusionCulledCount= 0;
+	m_LastDrawCallCount= 0;
 }
 
 void GLC_RenderStatistics::addBodies(unsigned int bodies)
@@ -86,3 +107,27 @@ void GLC_RenderStatistics::addTriangles(unsigned int triangles)
 		m_LastRenderPolygonCount+= triangles;
 	}
 }
+
+void GLC_RenderStatistics::addFrustumCulledInstances(unsigned int instances)
+{
+	if (m_IsActivated)
+	{
+		m_LastFrustumCulledCount+= instances;
+	}
+}
+
+void GLC_RenderStatistics::addOcclusionCulledInstances(unsigned int instances)
+{
+	if (m_IsActivated)
+	{
+		m_LastOcclusionCulledCount+= instances;
+	}
+}
+
+void GLC_RenderStatistics::addDrawCalls(unsigned int drawCalls)
+{
+	if (m_IsActivated)
+	{
+		m_LastDrawCallCount+= drawCalls;
+	}
+}
@@ -55,6 +55,15 @@ public:
 
 	//! Return current triangles count
 	static unsigned long triangleCount();
+
+	//! Return current count of instances culled by the frustum
+	static unsigned int frustumCulledCount();
+
+	//! Return current count of instances culled by occlusion
+	static unsigned int occlusionCulledCount();
+
+	//! Return current count of mesh draw calls
+	static unsigned int drawCallCount();
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -74,6 +83,15 @@ public:
 	//! Add Triangles to the current tringle count
 	static void addTriangles(unsigned int triangles);
 
+	//! Add instances to the current frustum culled count
+	static void addFrustumCulledInstances(unsigned int instances);
+
+	//! Add instances to the current occlusion culled count
+	static void addOcclusionCulledInstances(unsigned int instances);
+
+	//! Add draw calls to the current draw call count
+	static void addDrawCalls(unsigned int drawCalls);
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -89,6 +107,15 @@ private:
 
 	//! Last render polygon count
 	static unsigned long m_LastRenderPolygonCount;
+
+	//! Last render frustum culled instance count
+	static unsigned int m_LastFrustumCulledCount;
+
+	//! Last render occlusion culled instance count
+	static unsigned int m_LastOcclusionCulledCount;
+
+	//! Last render draw call count
+	static unsigned int m_LastDrawCallCount;
 };
 
 #endif /* GLC_RENDERSTATISTICS_H_ */
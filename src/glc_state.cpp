@@ -32,6 +32,7 @@ bool GLC_State::m_VboSupported= false;
 bool GLC_State::m_UseVbo= true;
 bool GLC_State::m_GlslSupported= false;
 bool GLC_State::m_PointSpriteSupported= false;
+bool GLC_State::m_InstancingSupported= false;
 bool GLC_State::m_UseShader= true;
 bool GLC_State::m_UseSelectionShader= false;
 bool GLC_State::m_IsInSelectionMode= false;
@@ -49,6 +50,13 @@ GLC_CacheManager GLC_State::m_CacheManager;
 
 bool GLC_State::m_IsSpacePartitionningActivated= false;
 bool GLC_State::m_IsFrustumCullingActivated= false;
+bool GLC_State::m_IsOcclusionCullingActivated= false;
+bool GLC_State::m_IsParallelLoadingActivated= false;
+bool GLC_State::m_IsParallelCullingActivated= false;
+bool GLC_State::m_UsePackedVertex= false;
+bool GLC_State::m_UseVertexCacheOptimization= false;
+bool GLC_State::m_UseStripAndFanConversion= false;
+bool GLC_State::m_UseInstancedRendering= false;
 bool GLC_State::m_IsValid= false;
 
 GLC_State::~GLC_State()
@@ -90,6 +98,11 @@ bool GLC_State::pointSpriteSupported()
 	return m_PointSpriteSupported;
 }
 
+bool GLC_State::instancingSupported()
+{
+	return m_InstancingSupported;
+}
+
 bool GLC_State::selectionShaderUsed()
 {
 	return m_UseSelectionShader;
@@ -150,6 +163,41 @@ bool GLC_State::isFrustumCullingActivated()
 	return m_IsFrustumCullingActivated;
 }
 
+bool GLC_State::isOcclusionCullingActivated()
+{
+	return m_IsOcclusionCullingActivated;
+}
+
+bool GLC_State::isParallelLoadingActivated()
+{
+	return m_IsParallelLoadingActivated;
+}
+
+bool GLC_State::isParallelCullingActivated()
+{
+	return m_IsParallelCullingActivated;
+}
+
+bool GLC_State::isPackedVertexUsed()
+{
+	return m_UsePackedVertex;
+}
+
+bool GLC_State::isVertexCacheOptimizationUsed()
+{
+	return m_UseVertexCacheOptimization;
+}
+
+bool GLC_State::isStripAndFanConversionUsed()
+{
+	return m_UseStripAndFanConversion;
+}
+
+bool GLC_State::isInstancedRenderingUsed()
+{
+	return m_UseInstancedRendering;
+}
+
 void GLC_State::init()
 {
 	if (!m_IsValid)
@@ -158,6 +206,7 @@ void GLC_State::init()
 		setVboSupport();
 		setGlslSupport();
 		setPointSpriteSupport();
+		setInstancingSupport();
 		setFrameBufferSupport();
 		m_Version= (char *) glGetString(GL_VERSION);
 		m_Vendor= (char *) glGetString(GL_VENDOR);
@@ -194,6 +243,12 @@ void GLC_State::setPointSpriteSupport()
 	m_PointSpriteSupported= glc::extensionIsSupported("GL_ARB_point_parameters") && glc::loadPointSpriteExtension();
 }
 
+void GLC_State::setInstancingSupport()
+{
+	m_InstancingSupported= glc::extensionIsSupported("GL_ARB_draw_instanced") && glc::extensionIsSupported("GL_ARB_instanced_arrays")
+			&& glc::loadInstancingExtension();
+}
+
 void GLC_State::setFrameBufferSupport()
 {
     m_IsFrameBufferSupported= QGLFramebufferObject::hasOpenGLFramebufferObjects();
@@ -248,3 +303,38 @@ void GLC_State::setFrustumCullingUsage(bool usage)
 {
 	m_IsFrustumCullingActivated= usage;
 }
+
+void GLC_State::setOcclusionCullingUsage(bool usage)
+{
+	m_IsOcclusionCullingActivated= usage;
+}
+
+void GLC_State::setParallelLoadingUsage(bool usage)
+{
+	m_IsParallelLoadingActivated= usage;
+}
+
+void GLC_State::setParallelCullingUsage(bool usage)
+{
+	m_IsParallelCullingActivated= usage;
+}
+
+void GLC_State::setPackedVertexUsage(bool usage)
+{
+	m_UsePackedVertex= usage;
+}
+
+void GLC_State::setVertexCacheOptimizationUsage(bool usage)
+{
+	m_UseVertexCacheOptimization= usage;
+}
+
+void GLC_State::setStripAndFanConversionUsage(bool usage)
+{
+	m_UseStripAndFanConversion= usage;
+}
+
+void GLC_State::setInstancedRenderingUsage(bool usage)
+{
+	m_UseInstancedRendering= usage;
+}
@@ -71,6 +71,9 @@ public:
 	//! Return true if Point Sprite is supported
 	static bool pointSpriteSupported();
 
+	//! Return true if instanced drawing and instanced arrays are supported
+	static bool instancingSupported();
+
 	//! Return true if selection shader is used
 	static bool selectionShaderUsed();
 
@@ -107,6 +110,27 @@ public:
 	//! Return true if frustum culling is activated
 	static bool isFrustumCullingActivated();
 
+	//! Return true if occlusion culling is activated
+	static bool isOcclusionCullingActivated();
+
+	//! Return true if representations are loaded in parallel
+	static bool isParallelLoadingActivated();
+
+	//! Return true if frustum culling of instances is done in parallel
+	static bool isParallelCullingActivated();
+
+	//! Return true if new meshes use the packed vertex format
+	static bool isPackedVertexUsed();
+
+	//! Return true if triangles of finished meshes are reordered for the vertex cache
+	static bool isVertexCacheOptimizationUsed();
+
+	//! Return true if strips and fans of finished meshes are converted into triangles
+	static bool isStripAndFanConversionUsed();
+
+	//! Return true if instanced rendering is used
+	static bool isInstancedRenderingUsed();
+
 	//! Return true valid
 	static bool isValid();
 //@}
@@ -131,6 +155,9 @@ public:
 	//! Set Point Sprite support
 	static void setPointSpriteSupport();
 
+	//! Set instancing support
+	static void setInstancingSupport();
+
 	//! Set the frame buffer support
 	static void setFrameBufferSupport();
 
@@ -164,6 +191,42 @@ public:
 	//! Set the frustum culling usage
 	static void setFrustumCullingUsage(bool);
 
+	//! Set the occlusion culling usage
+	/*! If occlusion culling is used, instances viewable after frustum culling are
+	 *  tested against a CPU depth buffer of the largest instances*/
+	static void setOcclusionCullingUsage(bool);
+
+	//! Set the parallel loading usage
+	/*! If parallel loading is used, loaders decode representations on a pool of worker threads*/
+	static void setParallelLoadingUsage(bool);
+
+	//! Set the parallel culling usage
+	/*! If parallel culling is used, frustum culling of collection instances is done on a pool of worker threads*/
+	static void setParallelCullingUsage(bool);
+
+	//! Set the packed vertex format usage of new meshes
+	/*! Packed vertices are interleaved with 16 bits positions and texels and 8 bits normals and colors.
+	 *  \see GLC_PackedVertices*/
+	static void setPackedVertexUsage(bool);
+
+	//! Set the vertex cache optimization usage
+	/*! If used, triangles and vertices of meshes are reordered for the post-transform vertex cache
+	 *  when meshes are finished, so vertex index of finished meshes differ from the given ones.
+	 *  Not used by default. \see GLC_VertexCacheOptimizer*/
+	static void setVertexCacheOptimizationUsage(bool);
+
+	//! Set the strip and fan conversion usage
+	/*! If used, strips and fans of meshes are converted into triangles when meshes are finished,
+	 *  so each primitive group is drawn with one draw call instead of one per strip and fan.
+	 *  Not used by default*/
+	static void setStripAndFanConversionUsage(bool);
+
+	//! Set the instanced rendering usage
+	/*! If used and supported, viewable instances of the main group which share the same
+	 *  representation are drawn with one instanced draw call by body and material.
+	 *  Not used by default*/
+	static void setInstancedRenderingUsage(bool);
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -182,6 +245,9 @@ private:
 	//! Point Sprite supported flag
 	static bool m_PointSpriteSupported;
 
+	//! Instancing supported flag
+	static bool m_InstancingSupported;
+
 	//! Use shader
 	static bool m_UseShader;
 
@@ -215,6 +281,27 @@ private:
 	//! Frustum culling activated
 	static bool m_IsFrustumCullingActivated;
 
+	//! Occlusion culling activated
+	static bool m_IsOcclusionCullingActivated;
+
+	//! Parallel loading activated
+	static bool m_IsParallelLoadingActivated;
+
+	//! Parallel culling activated
+	static bool m_IsParallelCullingActivated;
+
+	//! Packed vertex format used by new meshes
+	static bool m_UsePackedVertex;
+
+	//! Vertex cache optimization used by finished meshes
+	static bool m_UseVertexCacheOptimization;
+
+	//! Strip and fan conversion used by finished meshes
+	static bool m_UseStripAndFanConversion;
+
+	//! Instanced rendering usage
+	static bool m_UseInstancedRendering;
+
 	//! Frame buffer supported
 	static bool m_IsFrameBufferSupported;
 
@@ -38,6 +38,10 @@
 #include <QFileInfo>
 #include <QSet>
 #include <QMutexLocker>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
 
 //using namespace glcXmlUtil;
 
@@ -45,6 +49,106 @@ QMutex GLC_3dxmlToWorld::m_ZipMutex;
 
 static qint64 chunckSize= 10000000;
 
+// Extern representation loaded by a worker
+struct GLC_3dxmlToWorld::ExtRepResult
+{
+	inline ExtRepResult()
+	: m_Rep()
+	, m_IsLoaded(false)
+	, m_pWorker(NULL)
+	, m_ColorMaterialKeys()
+	, m_pException(NULL)
+	{}
+
+	//! The loaded representation
+	GLC_3DRep m_Rep;
+	//! Flag to know if the representation is loaded
+	bool m_IsLoaded;
+	//! The worker which have loaded the representation
+	GLC_3dxmlToWorld* m_pWorker;
+	//! Keys of the worker color materials used by the representation
+	QStringList m_ColorMaterialKeys;
+	//! The exception thrown by the worker
+	GLC_FileFormatException* m_pException;
+};
+
+// Runnable which loads extern representations with a worker loader
+class GLC_3dxmlToWorld::RepLoader : public QRunnable
+{
+public:
+	inline RepLoader(GLC_3dxmlToWorld* pWorker, const QStringList& fileNames, ExtRepResult* pResults, QAtomicInt* pNextIndex, QAtomicInt* pAbort)
+	: QRunnable()
+	, m_pWorker(pWorker)
+	, m_FileNames(fileNames)
+	, m_pResults(pResults)
+	, m_pNextIndex(pNextIndex)
+	, m_pAbort(pAbort)
+	{}
+
+	//! Load the next representations until all representations are taken or loading is aborted
+	virtual void run()
+	{
+		const int size= m_FileNames.size();
+		int index= m_pNextIndex->fetchAndAddOrdered(1);
+		while ((index < size) && (0 == m_pAbort->fetchAndAddOrdered(0)))
+		{
+			ExtRepResult* pResult= &(m_pResults[index]);
+			pResult->m_pWorker= m_pWorker;
+			m_pWorker->m_ColorMaterialKeys.clear();
+			try
+			{
+				pResult->m_IsLoaded= m_pWorker->loadExternRepresentation(m_FileNames.at(index), &(pResult->m_Rep));
+				pResult->m_ColorMaterialKeys= m_pWorker->m_ColorMaterialKeys;
+			}
+			catch (GLC_FileFormatException& e)
+			{
+				pResult->m_pException= new GLC_FileFormatException(e);
+				m_pAbort->fetchAndStoreOrdered(1);
+			}
+			catch (GLC_Exception& e)
+			{
+				pResult->m_pException= new GLC_FileFormatException(e.what(), m_FileNames.at(index), GLC_FileFormatException::WrongFileFormat);
+				m_pAbort->fetchAndStoreOrdered(1);
+			}
+			catch (...)
+			{
+				// No exception may escape a thread of the pool
+				QString message(QString("GLC_3dxmlToWorld::RepLoader Unexpected error while loading ") + m_FileNames.at(index));
+				pResult->m_pException= new GLC_FileFormatException(message, m_FileNames.at(index), GLC_FileFormatException::WrongFileFormat);
+				m_pAbort->fetchAndStoreOrdered(1);
+			}
+			index= m_pNextIndex->fetchAndAddOrdered(1);
+		}
+	}
+
+private:
+	//! The worker loader
+	GLC_3dxmlToWorld* m_pWorker;
+	//! The file names of the representations to load
+	const QStringList m_FileNames;
+	//! The results array
+	ExtRepResult* m_pResults;
+	//! The index of the next representation to load
+	QAtomicInt* m_pNextIndex;
+	//! Abort flag
+	QAtomicInt* m_pAbort;
+};
+
+// List of worker loaders which deletes its workers when it goes out of scope
+class GLC_3dxmlToWorld::WorkerList : public QList<GLC_3dxmlToWorld*>
+{
+public:
+	inline WorkerList()
+	: QList<GLC_3dxmlToWorld*>()
+	{}
+
+	inline ~WorkerList()
+	{qDeleteAll(*this);}
+
+private:
+	Q_DISABLE_COPY(WorkerList)
+};
+
 GLC_3dxmlToWorld::GLC_3dxmlToWorld()
 : QObject()
 , m_pStreamReader(NULL)
@@ -76,6 +180,9 @@ GLC_3dxmlToWorld::GLC_3dxmlToWorld()
 , m_GetExternalRef3DName(false)
 , m_ByteArrayList()
 , m_IsVersion3(false)
+, m_IsWorker(false)
+, m_ColorMaterialKeys()
+, m_MeshSimplifier()
 {
 
 }
@@ -976,6 +1083,7 @@ GLC_StructReference* GLC_3dxmlToWorld::createReferenceRep(QString repId, GLC_3DR
 			{
 				pMesh->finish();
 				currentMesh3DRep.clean();
+				m_MeshSimplifier.appendLods(currentMesh3DRep);
 				if (!currentMesh3DRep.isEmpty())
 				{
 					if (GLC_State::cacheIsUsed())
@@ -1014,6 +1122,7 @@ GLC_StructReference* GLC_3dxmlToWorld::createReferenceRep(QString repId, GLC_3DR
 	pMesh->finish();
 
 	currentMesh3DRep.clean();
+	m_MeshSimplifier.appendLods(currentMesh3DRep);
 	if (!currentMesh3DRep.isEmpty())
 	{
 		if (GLC_State::cacheIsUsed())
@@ -1231,57 +1340,48 @@ void GLC_3dxmlToWorld::loadFace(GLC_Mesh* pMesh, const int lod, double accuracy)
 	// Trying to find triangles
 	if (!triangles.isEmpty())
 	{
-		// For 3dvia mesh
-		if (triangles.contains(','))
-		{
-			triangles.remove(',');
-		}
-		QTextStream trianglesStream(&triangles);
+		// For 3dvia mesh, ',' is a separator
 		IndexList trianglesIndex;
-		QString buff;
-		while ((!trianglesStream.atEnd()))
-		{
-			trianglesStream >> buff;
-			trianglesIndex.append(buff.toUInt());
-		}
+		GLC_NumberParser<IndexList>::parseAll(triangles, &trianglesIndex);
 		pMesh->addTriangles(pCurrentMaterial, trianglesIndex, lod, accuracy);
 	}
 	// Trying to find trips
 	if (!strips.isEmpty())
 	{
 
-		QStringList stripsList(strips.split(","));
-		const int size= stripsList.size();
-		for (int i= 0; i < size; ++i)
+		// Strips are separated by ','
+		const QChar* pData= strips.constData();
+		const int size= strips.size();
+		int stripBegin= 0;
+		while (stripBegin <= size)
 		{
-			//qDebug() << "Strip " << stripsList.at(i);
-			QTextStream stripsStream(&stripsList[i]);
+			int stripEnd= strips.indexOf(',', stripBegin);
+			if (stripEnd == -1) stripEnd= size;
 			IndexList stripsIndex;
-			QString buff;
-			while ((!stripsStream.atEnd()))
-			{
-				stripsStream >> buff;
-				stripsIndex.append(buff.toUInt());
-			}
+			GLC_NumberParser<IndexList> parser(&stripsIndex);
+			parser.parse(pData + stripBegin, pData + stripEnd);
+			parser.finish();
 			pMesh->addTrianglesStrip(pCurrentMaterial, stripsIndex, lod, accuracy);
+			stripBegin= stripEnd + 1;
 		}
 	}
 	// Trying to find fans
 	if (!fans.isEmpty())
 	{
-		QStringList fansList(fans.split(","));
-		const int size= fansList.size();
-		for (int i= 0; i < size; ++i)
+		// Fans are separated by ','
+		const QChar* pData= fans.constData();
+		const int size= fans.size();
+		int fanBegin= 0;
+		while (fanBegin <= size)
 		{
-			QTextStream fansStream(&fansList[i]);
+			int fanEnd= fans.indexOf(',', fanBegin);
+			if (fanEnd == -1) fanEnd= size;
 			IndexList fansIndex;
-			QString buff;
-			while ((!fansStream.atEnd()))
-			{
-				fansStream >> buff;
-				fansIndex.append(buff.toUInt());
-			}
+			GLC_NumberParser<IndexList> parser(&fansIndex);
+			parser.parse(pData + fanBegin, pData + fanEnd);
+			parser.finish();
 			pMesh->addTrianglesFan(pCurrentMaterial, fansIndex, lod, accuracy);
+			fanBegin= fanEnd + 1;
 		}
 	}
 
@@ -1290,20 +1390,13 @@ void GLC_3dxmlToWorld::loadFace(GLC_Mesh* pMesh, const int lod, double accuracy)
 // Load polyline
 void GLC_3dxmlToWorld::loadPolyline(GLC_Mesh* pMesh)
 {
-	QString data= readAttribute("vertices", true);
+	const QString data= readAttribute("vertices", true);
 
-	data.replace(',', ' ');
-	QTextStream dataStream(&data);
-	QList<GLfloat> values;
-	QString buff;
-	while ((!dataStream.atEnd()))
-	{
-		dataStream >> buff;
-		values.append(buff.toFloat());
-	}
+	GLfloatVector values;
+	GLC_NumberParser<GLfloatVector>::parseAll(data, &values);
 	if ((values.size() % 3) == 0)
 	{
-		pMesh->addVerticeGroup(values.toVector());
+		pMesh->addVerticeGroup(values);
 	}
 	else
 	{
@@ -1397,6 +1490,11 @@ GLC_Material* GLC_3dxmlToWorld::getMaterial()
 		m_MaterialHash.insert(matKey, pMaterial);
 	}
 
+	if (m_IsWorker && !m_ColorMaterialKeys.contains(matKey))
+	{
+		m_ColorMaterialKeys.append(matKey);
+	}
+
 	return pMaterial;
 }
 
@@ -1406,7 +1504,8 @@ bool GLC_3dxmlToWorld::setStreamReaderToFile(QString fileName, bool test)
 	m_CurrentFileName= fileName;
 	if (m_IsInArchive)
 	{
-		QMutexLocker locker(&m_ZipMutex);
+		// A worker has its own archive handle
+		QMutexLocker locker(m_IsWorker ? NULL : &m_ZipMutex);
 		m_ByteArrayList.clear();
 		// Create QuaZip File
 		QuaZipFile* p3dxmlFile= new QuaZipFile(m_p3dxmlArchive);
@@ -1776,66 +1875,54 @@ void GLC_3dxmlToWorld::loadExternRepresentations()
 	emit currentQuantum(currentQuantumValue);
 
 	// Load all external rep
-	ReferenceRepHash::iterator iRefRep= m_ReferenceRepHash.begin();
-	while (iRefRep != m_ReferenceRepHash.constEnd())
+	if (!m_LoadStructureOnly && GLC_State::isParallelLoadingActivated() && (size > 1))
 	{
-		m_CurrentFileName= iRefRep.value();
-		const unsigned int id= iRefRep.key();
-
-		if (!m_IsInArchive)
+		loadExternRepresentationsInParallel(&repHash);
+	}
+	else
+	{
+		ReferenceRepHash::iterator iRefRep= m_ReferenceRepHash.begin();
+		while (iRefRep != m_ReferenceRepHash.constEnd())
 		{
-			// Get the 3DXML time stamp
-			m_CurrentDateTime= QFileInfo(QFileInfo(m_FileName).absolutePath() + QDir::separator() + QFileInfo(m_CurrentFileName).fileName()).lastModified();
-		}
-
+			m_CurrentFileName= iRefRep.value();
+			const unsigned int id= iRefRep.key();
 
-		if (!m_LoadStructureOnly && setStreamReaderToFile(m_CurrentFileName))
-		{
-			GLC_3DRep representation;
-			if (GLC_State::cacheIsUsed() && GLC_State::currentCacheManager().isUsable(m_CurrentDateTime, QFileInfo(m_FileName).baseName(), m_CurrentFileName))
+			if (!m_LoadStructureOnly)
 			{
-				GLC_CacheManager cacheManager= GLC_State::currentCacheManager();
-				GLC_BSRep binaryRep= cacheManager.binary3DRep(QFileInfo(m_FileName).baseName(), m_CurrentFileName);
-				representation= binaryRep.loadRep();
-				setRepresentationFileName(&representation);
+				GLC_3DRep representation;
+				if (loadExternRepresentation(m_CurrentFileName, &representation))
+				{
+					repHash.insert(id, representation);
+				}
 			}
 			else
 			{
-				representation= loadCurrentExtRep();
-				representation.clean();
-			}
-			if (!representation.isEmpty())
-			{
+				GLC_3DRep representation;
+				if (m_IsInArchive)
+				{
+					representation.setFileName(glc::builtArchiveString(m_FileName, m_CurrentFileName));
+				}
+				else
+				{
+					const QString repFileName= glc::builtFileString(m_FileName, m_CurrentFileName);
+					representation.setFileName(repFileName);
+					m_SetOfAttachedFileName << glc::archiveEntryFileName(repFileName);
+				}
+
 				repHash.insert(id, representation);
 			}
-		}
-		else if (m_LoadStructureOnly)
-		{
-			GLC_3DRep representation;
-			if (m_IsInArchive)
-			{
-				representation.setFileName(glc::builtArchiveString(m_FileName, m_CurrentFileName));
-			}
-			else
+
+			// Progrees bar indicator
+			++currentFileIndex;
+			currentQuantumValue = static_cast<int>((static_cast<double>(currentFileIndex) / size) * 100);
+			if (currentQuantumValue > previousQuantumValue)
 			{
-				const QString repFileName= glc::builtFileString(m_FileName, m_CurrentFileName);
-				representation.setFileName(repFileName);
-				m_SetOfAttachedFileName << glc::archiveEntryFileName(repFileName);
+				emit currentQuantum(currentQuantumValue);
 			}
+			previousQuantumValue= currentQuantumValue;
 
-			repHash.insert(id, representation);
-		}
-
-		// Progrees bar indicator
-		++currentFileIndex;
-		currentQuantumValue = static_cast<int>((static_cast<double>(currentFileIndex) / size) * 100);
-		if (currentQuantumValue > previousQuantumValue)
-		{
-			emit currentQuantum(currentQuantumValue);
+			++iRefRep;
 		}
-		previousQuantumValue= currentQuantumValue;
-
-		++iRefRep;
 	}
 
 	// Attach the ref to the structure reference
@@ -1870,6 +1957,223 @@ void GLC_3dxmlToWorld::loadExternRepresentations()
 
 }
 
+// Load the extern representation of the given file in the given 3DRep
+bool GLC_3dxmlToWorld::loadExternRepresentation(const QString& fileName, GLC_3DRep* pRep)
+{
+	m_CurrentFileName= fileName;
+
+	if (!m_IsInArchive)
+	{
+		// Get the 3DXML time stamp
+		m_CurrentDateTime= QFileInfo(QFileInfo(m_FileName).absolutePath() + QDir::separator() + QFileInfo(m_CurrentFileName).fileName()).lastModified();
+	}
+
+	bool repIsLoaded= false;
+	if (setStreamReaderToFile(m_CurrentFileName))
+	{
+		if (GLC_State::cacheIsUsed() && GLC_State::currentCacheManager().isUsable(m_CurrentDateTime, QFileInfo(m_FileName).baseName(), m_CurrentFileName))
+		{
+			GLC_CacheManager cacheManager= GLC_State::currentCacheManager();
+			GLC_BSRep binaryRep= cacheManager.binary3DRep(QFileInfo(m_FileName).baseName(), m_CurrentFileName);
+			*pRep= binaryRep.loadRep();
+			setRepresentationFileName(pRep);
+		}
+		else
+		{
+			*pRep= loadCurrentExtRep();
+			pRep->clean();
+		}
+		repIsLoaded= !pRep->isEmpty();
+	}
+	return repIsLoaded;
+}
+
+// Load the extern representations on worker threads
+void GLC_3dxmlToWorld::loadExternRepresentationsInParallel(QHash<const unsigned int, GLC_3DRep>* pRepHash)
+{
+	// Representations are loaded and merged in the order of the serial loading
+	QList<unsigned int> idList;
+	QStringList fileNames;
+	ReferenceRepHash::const_iterator iRefRep= m_ReferenceRepHash.constBegin();
+	while (iRefRep != m_ReferenceRepHash.constEnd())
+	{
+		idList.append(iRefRep.key());
+		fileNames.append(iRefRep.value());
+		++iRefRep;
+	}
+	const int size= fileNames.size();
+
+	// The catalog materials shared by all representations
+	const MaterialHash catalogMaterials(m_MaterialHash);
+
+	// Create the workers in this thread, they are deleted when the list goes out of scope
+	const int workerCount= qMin(QThread::idealThreadCount(), size);
+	WorkerList workers;
+	for (int i= 0; i < workerCount; ++i)
+	{
+		workers.append(createWorker());
+	}
+
+	QVector<ExtRepResult> results(size);
+	ExtRepResult* pResults= results.data();
+	QAtomicInt nextIndex(0);
+	QAtomicInt abort(0);
+
+	QThreadPool threadPool;
+	threadPool.setMaxThreadCount(qMax(1, workerCount));
+	for (int i= 0; i < workerCount; ++i)
+	{
+		threadPool.start(new RepLoader(workers.at(i), fileNames, pResults, &nextIndex, &abort));
+	}
+
+	// Progress bar indicator
+	int previousQuantumValue= 0;
+	while (!threadPool.waitForDone(100))
+	{
+		const int currentQuantumValue= static_cast<int>((static_cast<double>(qMin(nextIndex.fetchAndAddOrdered(0), size)) / size) * 100);
+		if (currentQuantumValue > previousQuantumValue)
+		{
+			emit currentQuantum(currentQuantumValue);
+			previousQuantumValue= currentQuantumValue;
+		}
+	}
+
+	// Delete workers materials which are not used by any representation
+	for (int i= 0; i < workerCount; ++i)
+	{
+		workers.at(i)->clearMaterialHash();
+	}
+
+	// Keep the first error in the serial order
+	GLC_FileFormatException* pException= NULL;
+	for (int i= 0; i < size; ++i)
+	{
+		if (NULL != results.at(i).m_pException)
+		{
+			if (NULL == pException) pException= results.at(i).m_pException;
+			else delete results.at(i).m_pException;
+		}
+	}
+
+	if (NULL == pException)
+	{
+		for (int i= 0; i < size; ++i)
+		{
+			const ExtRepResult& result= results.at(i);
+			mergeWorkerMaterials(result.m_pWorker, result, catalogMaterials);
+			m_SetOfAttachedFileName.unite(result.m_pWorker->m_SetOfAttachedFileName);
+			if (result.m_IsLoaded)
+			{
+				pRepHash->insert(idList.at(i), result.m_Rep);
+			}
+		}
+	}
+	else
+	{
+		// Delete loaded representations and the worker materials they use
+		results.clear();
+	}
+
+	// Worker materials still in use are owned by representations
+	for (int i= 0; i < workerCount; ++i)
+	{
+		workers.at(i)->m_MaterialHash.clear();
+	}
+
+	if (NULL != pException)
+	{
+		GLC_FileFormatException fileFormatException(*pException);
+		delete pException;
+		clear();
+		throw(fileFormatException);
+	}
+}
+
+// Return a new worker loader
+GLC_3dxmlToWorld* GLC_3dxmlToWorld::createWorker() const
+{
+	GLC_3dxmlToWorld* pWorker= new GLC_3dxmlToWorld();
+	pWorker->m_IsWorker= true;
+	pWorker->m_FileName= m_FileName;
+	pWorker->m_IsInArchive= m_IsInArchive;
+	pWorker->m_CurrentDateTime= m_CurrentDateTime;
+	pWorker->m_TextureImagesHash= m_TextureImagesHash;
+	pWorker->m_IsVersion3= m_IsVersion3;
+	pWorker->m_MeshSimplifier= m_MeshSimplifier;
+
+	if (m_IsInArchive)
+	{
+		// Each worker reads the archive with its own handle
+		pWorker->m_p3dxmlArchive= new QuaZip(m_FileName);
+		if (!pWorker->m_p3dxmlArchive->open(QuaZip::mdUnzip))
+		{
+			delete pWorker;
+			QString message(QString("GLC_3dxmlToWorld::createWorker Unable to open the archive ") + m_FileName);
+			GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotFound);
+			throw(fileFormatException);
+		}
+	}
+
+	// Material usage table is not thread safe, the worker use copies of the catalog materials
+	MaterialHash::const_iterator iMaterial= m_MaterialHash.constBegin();
+	while (m_MaterialHash.constEnd() != iMaterial)
+	{
+		pWorker->m_MaterialHash.insert(iMaterial.key(), new GLC_Material(*(iMaterial.value())));
+		++iMaterial;
+	}
+
+	return pWorker;
+}
+
+// Replace in the given 3DRep the materials created by the given worker
+void GLC_3dxmlToWorld::mergeWorkerMaterials(GLC_3dxmlToWorld* pWorker, const ExtRepResult& result, const MaterialHash& catalogMaterials)
+{
+	const GLC_3DRep& rep= result.m_Rep;
+	const int bodyCount= rep.numberOfBody();
+
+	// Color materials are named as they would have been by the serial loading
+	const int keyCount= result.m_ColorMaterialKeys.size();
+	for (int i= 0; i < keyCount; ++i)
+	{
+		const QString& key= result.m_ColorMaterialKeys.at(i);
+		GLC_Material* pWorkerMaterial= pWorker->m_MaterialHash.value(key);
+		Q_ASSERT(NULL != pWorkerMaterial);
+		GLC_Material* pMaterial= m_MaterialHash.value(key);
+		if (NULL == pMaterial)
+		{
+			pWorkerMaterial->setName("Material_" + QString::number(m_MaterialHash.size()));
+			m_MaterialHash.insert(key, pWorkerMaterial);
+		}
+		else if (pMaterial != pWorkerMaterial)
+		{
+			for (int iBody= 0; iBody < bodyCount; ++iBody)
+			{
+				GLC_Mesh* pMesh= dynamic_cast<GLC_Mesh*>(rep.geomAt(iBody));
+				if ((NULL != pMesh) && pMesh->containsMaterial(pWorkerMaterial->id()))
+				{
+					pMesh->replaceMaterial(pWorkerMaterial->id(), pMaterial);
+				}
+			}
+		}
+	}
+
+	// Catalog materials copies have the same id than this loader materials
+	MaterialHash::const_iterator iMaterial= catalogMaterials.constBegin();
+	while (catalogMaterials.constEnd() != iMaterial)
+	{
+		GLC_Material* pMaterial= iMaterial.value();
+		for (int iBody= 0; iBody < bodyCount; ++iBody)
+		{
+			GLC_Mesh* pMesh= dynamic_cast<GLC_Mesh*>(rep.geomAt(iBody));
+			if ((NULL != pMesh) && pMesh->containsMaterial(pMaterial->id()) && (pMesh->material(pMaterial->id()) != pMaterial))
+			{
+				pMesh->replaceMaterial(pMaterial->id(), pMaterial);
+			}
+		}
+		++iMaterial;
+	}
+}
+
 // Return the instance of the current extern representation
 GLC_3DRep GLC_3dxmlToWorld::loadCurrentExtRep()
 {
@@ -1899,6 +2203,7 @@ GLC_3DRep GLC_3dxmlToWorld::loadCurrentExtRep()
 			{
 				pMesh->finish();
 				currentMeshRep.clean();
+				m_MeshSimplifier.appendLods(currentMeshRep);
 
 				if (GLC_State::cacheIsUsed())
 				{
@@ -1923,6 +2228,7 @@ GLC_3DRep GLC_3dxmlToWorld::loadCurrentExtRep()
 
 	pMesh->finish();
 	currentMeshRep.clean();
+	m_MeshSimplifier.appendLods(currentMeshRep);
 
 	if (GLC_State::cacheIsUsed())
 	{
@@ -2325,21 +2631,13 @@ void GLC_3dxmlToWorld::loadRep(GLC_Mesh* pMesh)
 void GLC_3dxmlToWorld::loadVertexBuffer(GLC_Mesh* pMesh)
 {
 	{
-		QString verticePosition= getContent(m_pStreamReader, "Positions").replace(',', ' ');
-		//qDebug() << "Position " << verticePosition;
-		checkForXmlError("Error while retrieving Position ContentVertexBuffer");
 		// Load Vertice position
-		QTextStream verticeStream(&verticePosition);
-		QList<GLfloat> verticeValues;
-		QString buff;
-		while ((!verticeStream.atEnd()))
-		{
-			verticeStream >> buff;
-			verticeValues.append(buff.toFloat());
-		}
+		GLfloatVector verticeValues;
+		readNumbers(m_pStreamReader, "Positions", &verticeValues);
+		checkForXmlError("Error while retrieving Position ContentVertexBuffer");
 		if ((verticeValues.size() % 3) == 0)
 		{
-			pMesh->addVertice(verticeValues.toVector());
+			pMesh->addVertice(verticeValues);
 		}
 		else
 		{
@@ -2355,21 +2653,13 @@ void GLC_3dxmlToWorld::loadVertexBuffer(GLC_Mesh* pMesh)
 	}
 
 	{
-		QString normals= getContent(m_pStreamReader, "Normals").replace(',', ' ');
-		//qDebug() << "Normals " << normals;
-		checkForXmlError("Error while retrieving Normals values");
 		// Load Vertice Normals
-		QTextStream normalsStream(&normals);
-		QList<GLfloat> normalValues;
-		QString buff;
-		while ((!normalsStream.atEnd()))
-		{
-			normalsStream >> buff;
-			normalValues.append(buff.toFloat());
-		}
+		GLfloatVector normalValues;
+		readNumbers(m_pStreamReader, "Normals", &normalValues);
+		checkForXmlError("Error while retrieving Normals values");
 		if ((normalValues.size() % 3) == 0)
 		{
-			pMesh->addNormals(normalValues.toVector());
+			pMesh->addNormals(normalValues);
 		}
 		else
 		{
@@ -2389,20 +2679,13 @@ void GLC_3dxmlToWorld::loadVertexBuffer(GLC_Mesh* pMesh)
 	{
 		if ((QXmlStreamReader::StartElement == m_pStreamReader->tokenType()) && (m_pStreamReader->name() == "TextureCoordinates"))
 		{
-			QString texels= getContent(m_pStreamReader, "TextureCoordinates").replace(',', ' ');
+			GLfloatVector texelValues;
+			readNumbers(m_pStreamReader, "TextureCoordinates", &texelValues);
 			checkForXmlError("Error while retrieving Texture coordinates");
-			QTextStream texelStream(&texels);
-			QList<GLfloat> texelValues;
-			QString buff;
-			while ((!texelStream.atEnd()))
-			{
-				texelStream >> buff;
-				texelValues.append(buff.toFloat());
-			}
 
 			if ((texelValues.size() % 2) == 0)
 			{
-				pMesh->addTexels(texelValues.toVector());
+				pMesh->addTexels(texelValues);
 			}
 			else
 			{
@@ -33,6 +33,8 @@
 #include <QDateTime>
 #include "../maths/glc_matrix4x4.h"
 #include "../sceneGraph/glc_3dviewinstance.h"
+#include "glc_numberparser.h"
+#include "../geometry/glc_meshsimplifier.h"
 
 #include "../glc_config.h"
 
@@ -55,6 +57,19 @@ class GLC_LIB_EXPORT GLC_3dxmlToWorld : public QObject
 {
 	Q_OBJECT
 
+	//! \class RepLoader
+	/*! \brief RepLoader : Runnable which loads extern representations with a worker loader */
+	class RepLoader;
+	friend class RepLoader;
+
+	//! \class WorkerList
+	/*! \brief WorkerList : List of worker loaders which deletes them when it goes out of scope */
+	class WorkerList;
+
+	//! \struct ExtRepResult
+	/*! \brief ExtRepResult : Extern representation loaded by a worker */
+	struct ExtRepResult;
+
 	//! \struct AssyLink
 	/*! \brief AssyLink : Assemblage link between parent id and GLC_StructInstance* */
 	struct AssyLink
@@ -159,6 +174,11 @@ public:
 	inline QStringList listOfAttachedFileName() const
 	{return m_SetOfAttachedFileName.toList();}
 
+	//! Set the relative accuracies of the LODs built for loaded meshes
+	/*! LODs are built before representations are added to the cache*/
+	inline void setLodAccuracies(const QList<double>& accuracies)
+	{m_MeshSimplifier.setAccuracies(accuracies);}
+
 
 //@}
 
@@ -264,6 +284,18 @@ private:
 	//! Return the instance of the current extern representation
 	GLC_3DRep loadCurrentExtRep();
 
+	//! Load the extern representation of the given file in the given 3DRep, return true on success
+	bool loadExternRepresentation(const QString& fileName, GLC_3DRep* pRep);
+
+	//! Load the extern representations on worker threads in the given hash table
+	void loadExternRepresentationsInParallel(QHash<const unsigned int, GLC_3DRep>* pRepHash);
+
+	//! Return a new worker loader with its own archive handle and copies of the catalog materials
+	GLC_3dxmlToWorld* createWorker() const;
+
+	//! Replace in the given 3DRep the materials created by the given worker by this loader materials
+	void mergeWorkerMaterials(GLC_3dxmlToWorld* pWorker, const ExtRepResult& result, const MaterialHash& catalogMaterials);
+
 	//! Load CatMaterial Ref if present
 	void loadCatMaterialRef();
 
@@ -288,6 +320,10 @@ private:
 	// Return the content of an element
 	inline QString getContent(QXmlStreamReader* pReader, const QString& element);
 
+	//! Parse the numbers of the content of an element and append them to the given container
+	template <class Container>
+	inline void readNumbers(QXmlStreamReader* pReader, const QString& element, Container* pContainer);
+
 	//! Read the specified attribute
 	inline QString readAttribute(QXmlStreamReader* pReader, const QString& attribute);
 
@@ -406,6 +442,15 @@ private:
 	//! Flag to know if the 3DXML is in version 3.x
 	bool m_IsVersion3;
 
+	//! Flag to know if this loader is a parallel loading worker with its own archive handle
+	bool m_IsWorker;
+
+	//! Keys of the color materials used by the current representation (Worker only)
+	QStringList m_ColorMaterialKeys;
+
+	//! The simplifier which builds the LODs of loaded meshes
+	GLC_MeshSimplifier m_MeshSimplifier;
+
 };
 
 QXmlStreamReader::TokenType GLC_3dxmlToWorld::readNext()
@@ -447,6 +492,21 @@ QString GLC_3dxmlToWorld::getContent(QXmlStreamReader* pReader, const QString& e
 	return content.trimmed();
 }
 
+template <class Container>
+void GLC_3dxmlToWorld::readNumbers(QXmlStreamReader* pReader, const QString& element, Container* pContainer)
+{
+	GLC_NumberParser<Container> parser(pContainer);
+	while(endElementNotReached(pReader, element))
+	{
+		readNext();
+		if (pReader->isCharacters() && !pReader->text().isEmpty())
+		{
+			parser.parse(pReader->text());
+		}
+	}
+	parser.finish();
+}
+
 QString GLC_3dxmlToWorld::readAttribute(QXmlStreamReader* pReader, const QString& attribute)
 {
 	return pReader->attributes().value(attribute).toString();
@@ -21,6 +21,7 @@
  *****************************************************************************/
 
 #include "glc_colladatoworld.h"
+#include "glc_numberparser.h"
 #include "../sceneGraph/glc_world.h"
 #include "../glc_fileformatexception.h"
 #include "../maths/glc_geomtools.h"
@@ -805,7 +806,7 @@ void GLC_ColladaToWorld::loadVertexBulkData()
 	// load Vertex Bulk data id
 	m_CurrentId= readAttribute("id", true);
 	//qDebug() << "id=" << m_CurrentId;
-	QList<float> vertices;
+	GLfloatVector vertices;
 
 	while (endElementNotReached(m_pStreamReader, "source"))
 	{
@@ -814,16 +815,24 @@ void GLC_ColladaToWorld::loadVertexBulkData()
 			const QStringRef currentElementName= m_pStreamReader->name();
 			if ((currentElementName == "float_array"))
 			{
-				int count= readAttribute("count", true).toInt();
-				QString array= getContent("float_array");
-				QStringList list= array.split(' ');
-				// Check the array size
-				if (count != list.size()) throwException("float_array size not match");
+				const int count= readAttribute("count", true).toInt();
+				const int previousSize= vertices.size();
+				vertices.reserve(previousSize + count);
 
-				for (int i= 0; i < count; ++i)
+				// Parse the array directly from the stream reader text
+				GLC_NumberParser<GLfloatVector> parser(&vertices);
+				while(endElementNotReached(m_pStreamReader, "float_array"))
 				{
-					vertices.append(list.at(i).toFloat());
+					m_pStreamReader->readNext();
+					if (m_pStreamReader->isCharacters() && !m_pStreamReader->text().isEmpty())
+					{
+						parser.parse(m_pStreamReader->text());
+					}
 				}
+				parser.finish();
+
+				// Check the array size
+				if (count != (vertices.size() - previousSize)) throwException("float_array size not match");
 			}
 			else if (currentElementName == "technique_common") loadTechniqueCommon();
 		}
@@ -1110,7 +1119,7 @@ void GLC_ColladaToWorld::addPolylistToCurrentMesh(const QList<InputData>& inputD
 			{
 				// The current input data
 				InputData currentInputData= inputDataList.at(dataIndex);
-				// QHash iterator on the right QList<float>
+				// QHash iterator on the right GLfloatVector
 				BulkDataHash::const_iterator iBulkHash= m_BulkDataHash.find(currentInputData.m_Source);
 				int stride;
 				if (m_DataAccessorHash.contains(currentInputData.m_Source))
@@ -1141,22 +1150,24 @@ void GLC_ColladaToWorld::addPolylistToCurrentMesh(const QList<InputData>& inputD
 	const int indexOffset= m_pMeshInfo->m_Index.size();
 	// Triangulate the polygons of the polylist
 	// Input polygon index must start from 0 and succesive : (0 1 2 3 4)
-	QList<GLuint> onePolygonIndex;
+	QList<QList<GLuint> > polygons;
 	for (int i= 0; i < polygonCount; ++i)
 	{
 		const int polygonSize= vcountList.at(i);
 		Q_ASSERT(polygonSize > 2);
+		QList<GLuint> onePolygonIndex;
 		for (int i= 0; i < polygonSize; ++i)
 		{
 			onePolygonIndex.append(polygonIndex.takeFirst());
 		}
-		// Triangulate the current polygon if the polygon as more than 3 vertice
-		if (polygonSize > 3)
-		{
-			glc::triangulatePolygon(&onePolygonIndex, m_pMeshInfo->m_Datas.at(VERTEX));
-		}
+		polygons.append(onePolygonIndex);
+	}
+	// The polygons of more than 3 vertice are triangulated in parallel
+	glc::triangulatePolygons(&polygons, m_pMeshInfo->m_Datas.at(VERTEX));
+	for (int i= 0; i < polygonCount; ++i)
+	{
 		// Add index to the mesh info
-		//Q_ASSERT(not onePolygonIndex.isEmpty());
+		const QList<GLuint>& onePolygonIndex= polygons.at(i);
 		if (!onePolygonIndex.isEmpty())
 		{
 			m_pMeshInfo->m_Index.append(onePolygonIndex);
@@ -1167,7 +1178,6 @@ void GLC_ColladaToWorld::addPolylistToCurrentMesh(const QList<InputData>& inputD
 			stringList.append("Unable to triangulate a polygon of " + m_pMeshInfo->m_pMesh->name());
 			GLC_ErrorLog::addError(stringList);
 		}
-		onePolygonIndex.clear();
 	}
 
 	// Check if normal computation is needed
@@ -1366,7 +1376,7 @@ void GLC_ColladaToWorld::addTrianglesToCurrentMesh(const QList<InputData>& input
 			{
 				// The current input data
 				InputData currentInputData= inputDataList.at(dataIndex);
-				// QHash iterator on the right QList<float>
+				// QHash iterator on the right GLfloatVector
 				BulkDataHash::const_iterator iBulkHash= m_BulkDataHash.find(currentInputData.m_Source);
 				int stride;
 				if (m_DataAccessorHash.contains(currentInputData.m_Source))
@@ -153,7 +153,7 @@ private:
 	};
 
 	typedef QHash<const QString, GLC_Material*> MaterialHash;
-	typedef QHash<const QString, QList<float> > BulkDataHash;
+	typedef QHash<const QString, GLfloatVector> BulkDataHash;
 	typedef QHash<const QString, Accessor> DataAccessorHash;
 //////////////////////////////////////////////////////////////////////
 /*! @name Constructor / Destructor */
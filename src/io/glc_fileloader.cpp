@@ -35,6 +35,7 @@
 #include "glc_bsreptoworld.h"
 
 #include "../sceneGraph/glc_world.h"
+#include "../geometry/glc_meshsimplifier.h"
 #include "../glc_fileformatexception.h"
 #include "../glc_factory.h"
 #include "glc_worldreaderplugin.h"
@@ -43,6 +44,9 @@
 // Constructor
 //////////////////////////////////////////////////////////////////////
 GLC_FileLoader::GLC_FileLoader()
+: m_LodAccuracies()
+, m_UseStlVertexWelding(true)
+, m_ComputeStlNormals(false)
 {
 }
 
@@ -80,6 +84,7 @@ GLC_World GLC_FileLoader::createWorldFromFile(QFile &file, QStringList* pAttache
 			{
 				(*pAttachedFileName)= pReaderHandler->listOfAttachedFileName();
 			}
+			GLC_MeshSimplifier(m_LodAccuracies).appendLods(resultWorld, true);
 
 			delete pReaderHandler;
 			return resultWorld;
@@ -100,6 +105,8 @@ GLC_World GLC_FileLoader::createWorldFromFile(QFile &file, QStringList* pAttache
 	{
 		GLC_StlToWorld stlToWorld;
 		connect(&stlToWorld, SIGNAL(currentQuantum(int)), this, SIGNAL(currentQuantum(int)));
+		stlToWorld.setVertexWeldingUsage(m_UseStlVertexWelding);
+		stlToWorld.setNormalsComputingUsage(m_ComputeStlNormals);
 		pWorld= stlToWorld.CreateWorldFromStl(file);
 	}
 	else if (QFileInfo(file).suffix().toLower() == "off")
@@ -122,6 +129,8 @@ GLC_World GLC_FileLoader::createWorldFromFile(QFile &file, QStringList* pAttache
 	{
 		GLC_3dxmlToWorld d3dxmlToWorld;
 		connect(&d3dxmlToWorld, SIGNAL(currentQuantum(int)), this, SIGNAL(currentQuantum(int)));
+		// LODs are built by the 3DXML loader before representations are cached
+		d3dxmlToWorld.setLodAccuracies(m_LodAccuracies);
 		pWorld= d3dxmlToWorld.createWorldFrom3dxml(file, false);
 		if (NULL != pAttachedFileName)
 		{
@@ -152,6 +161,13 @@ GLC_World GLC_FileLoader::createWorldFromFile(QFile &file, QStringList* pAttache
 		GLC_FileFormatException fileFormatException(message, file.fileName(), GLC_FileFormatException::FileNotSupported);
 		throw(fileFormatException);
 	}
+
+	// Meshes which already have LODs, like BSRep meshes, are not simplified again
+	if (suffix.toLower() != "3dxml")
+	{
+		GLC_MeshSimplifier(m_LodAccuracies).appendLods(*pWorld, true);
+	}
+
 	GLC_World resulWorld(*pWorld);
 	delete pWorld;
 
@@ -62,12 +62,43 @@ public:
 	virtual ~GLC_FileLoader();
 //@}
 //////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return the relative accuracies of the LODs built for loaded meshes
+	inline QList<double> lodAccuracies() const
+	{return m_LodAccuracies;}
+
+	//! Return true if duplicate vertices of loaded STL files are welded
+	inline bool stlVertexWeldingIsUsed() const
+	{return m_UseStlVertexWelding;}
+
+	//! Return true if smooth normals of loaded STL files are computed
+	inline bool stlNormalsComputingIsUsed() const
+	{return m_ComputeStlNormals;}
+
+//@}
+//////////////////////////////////////////////////////////////////////
 /*! @name Set Functions*/
 //@{
 //////////////////////////////////////////////////////////////////////
 public:
 	//! Create a GLC_World from a file
 	GLC_World createWorldFromFile(QFile &file, QStringList* pAttachedFileName= NULL);
+
+	//! Set the relative accuracies of the LODs built for loaded meshes
+	/*! LODs are built with GLC_MeshSimplifier on worker threads, an empty list disables LODs building*/
+	inline void setLodAccuracies(const QList<double>& accuracies)
+	{m_LodAccuracies= accuracies;}
+
+	//! Set the vertex welding usage of loaded STL files (Default true) \see GLC_StlToWorld
+	inline void setStlVertexWeldingUsage(bool usage)
+	{m_UseStlVertexWelding= usage;}
+
+	//! Set the smooth normals computing usage of loaded STL files (Default false) \see GLC_StlToWorld
+	inline void setStlNormalsComputingUsage(bool usage)
+	{m_ComputeStlNormals= usage;}
 //@}
 
 
@@ -81,6 +112,14 @@ public:
 // Private members
 //////////////////////////////////////////////////////////////////////
 private:
+	//! The relative accuracies of the LODs built for loaded meshes
+	QList<double> m_LodAccuracies;
+
+	//! Vertex welding usage of loaded STL files
+	bool m_UseStlVertexWelding;
+
+	//! Smooth normals computing usage of loaded STL files
+	bool m_ComputeStlNormals;
 };
 
 #endif /*GLC_FILELOADER_H_*/
@@ -0,0 +1,322 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_numberparser.h interface for the GLC_NumberParser class.
+
+#ifndef GLC_NUMBERPARSER_H_
+#define GLC_NUMBERPARSER_H_
+
+#include <QString>
+#include <QByteArray>
+#include <limits>
+
+#include "../glc_global.h"
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_NumberParser
+/*! \brief GLC_NumberParser : Streaming parser of numbers list */
+
+/*! GLC_NumberParser parse numbers separated by white spaces or ',' directly
+ *  from UTF-16 text and append them to the given container (GLfloatVector, GLuintVector, IndexList).
+ *  The text can be given in several pieces (XML characters token), a number split
+ *  between two pieces is kept until the next call.
+ *  Simple decimal numbers are converted without allocation, the result is the same
+ *  than QString::toFloat() and QString::toUInt(), other numbers are converted with QString.*/
+//////////////////////////////////////////////////////////////////////
+template <class Container>
+class GLC_NumberParser
+{
+	typedef typename Container::value_type ValueType;
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Construct a parser which append numbers to the given container
+	inline GLC_NumberParser(Container* pContainer)
+	: m_pContainer(pContainer)
+	, m_Pending()
+	{}
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Parse the given piece of text
+	void parse(const QChar* pBegin, const QChar* pEnd);
+
+	//! Parse the given piece of text
+	inline void parse(const QStringRef& text)
+	{parse(text.unicode(), text.unicode() + text.size());}
+
+	//! Parse the given piece of text
+	inline void parse(const QString& text)
+	{parse(text.constData(), text.constData() + text.size());}
+
+	//! Append the pending number if any, must be called after the last piece of text
+	inline void finish()
+	{
+		if (!m_Pending.isEmpty())
+		{
+			appendNumber(m_Pending.constData(), m_Pending.constData() + m_Pending.size());
+			m_Pending.clear();
+		}
+	}
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Tools Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Parse all the numbers of the given text and append them to the given container
+	static inline void parseAll(const QString& text, Container* pContainer)
+	{
+		GLC_NumberParser<Container> parser(pContainer);
+		parser.parse(text);
+		parser.finish();
+	}
+
+	//! Convert the given UTF-16 or Latin-1 token to float, return false if the token is not a number
+	template <class Char>
+	static bool toFloat(const Char* pBegin, const Char* pEnd, GLfloat* pValue);
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Return true if the given character is a separator
+	static inline bool isSeparator(const QChar& c)
+	{
+		const ushort code= c.unicode();
+		return (code == ' ') || (code == ',') || (code == '\n') || (code == '\r') || (code == '\t');
+	}
+
+	//! Append the number of the given token to the container
+	inline void appendNumber(const QChar* pBegin, const QChar* pEnd)
+	{
+		ValueType value;
+		convert(pBegin, pEnd, &value);
+		m_pContainer->append(value);
+	}
+
+	//! Return the code of the given character
+	static inline ushort charCode(const QChar& c)
+	{return c.unicode();}
+
+	//! Return the code of the given character
+	static inline ushort charCode(char c)
+	{return static_cast<uchar>(c);}
+
+	//! Convert the given token to float with Qt
+	static inline GLfloat qtToFloat(const QChar* pBegin, const QChar* pEnd, bool* pOk)
+	{return QString::fromRawData(pBegin, static_cast<int>(pEnd - pBegin)).toFloat(pOk);}
+
+	//! Convert the given token to float with Qt
+	static inline GLfloat qtToFloat(const char* pBegin, const char* pEnd, bool* pOk)
+	{return QByteArray::fromRawData(pBegin, static_cast<int>(pEnd - pBegin)).toFloat(pOk);}
+
+	//! Convert the given token to float
+	static inline void convert(const QChar* pBegin, const QChar* pEnd, GLfloat* pValue)
+	{toFloat(pBegin, pEnd, pValue);}
+
+	//! Convert the given token to unsigned int
+	static void convert(const QChar* pBegin, const QChar* pEnd, GLuint* pValue);
+
+	//! Convert the given simple decimal token to double, return false if the token is not simple
+	template <class Char>
+	static bool fastToDouble(const Char* pBegin, const Char* pEnd, double* pValue);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	//! The container of parsed numbers
+	Container* m_pContainer;
+
+	//! The begining of a number split between two pieces of text
+	QString m_Pending;
+};
+
+template <class Container>
+void GLC_NumberParser<Container>::parse(const QChar* pBegin, const QChar* pEnd)
+{
+	const QChar* pCurrent= pBegin;
+
+	// Complete the pending number with the begining of this piece
+	if (!m_Pending.isEmpty())
+	{
+		while ((pCurrent != pEnd) && !isSeparator(*pCurrent)) ++pCurrent;
+		m_Pending.append(QString(pBegin, static_cast<int>(pCurrent - pBegin)));
+		if (pCurrent == pEnd) return;
+		appendNumber(m_Pending.constData(), m_Pending.constData() + m_Pending.size());
+		m_Pending.clear();
+	}
+
+	while (pCurrent != pEnd)
+	{
+		while ((pCurrent != pEnd) && isSeparator(*pCurrent)) ++pCurrent;
+		const QChar* pToken= pCurrent;
+		while ((pCurrent != pEnd) && !isSeparator(*pCurrent)) ++pCurrent;
+		if (pToken != pCurrent)
+		{
+			if (pCurrent == pEnd)
+			{
+				// The number may continue in the next piece
+				m_Pending= QString(pToken, static_cast<int>(pCurrent - pToken));
+			}
+			else
+			{
+				appendNumber(pToken, pCurrent);
+			}
+		}
+	}
+}
+
+template <class Container>
+template <class Char>
+bool GLC_NumberParser<Container>::toFloat(const Char* pBegin, const Char* pEnd, GLfloat* pValue)
+{
+	double value;
+	const double absValue= fastToDouble(pBegin, pEnd, &value) ? qAbs(value) : -1.0;
+	if ((absValue == 0.0) || ((absValue >= std::numeric_limits<float>::min()) && (absValue <= std::numeric_limits<float>::max())))
+	{
+		*pValue= static_cast<GLfloat>(value);
+		return true;
+	}
+	else
+	{
+		bool ok;
+		*pValue= qtToFloat(pBegin, pEnd, &ok);
+		return ok;
+	}
+}
+
+template <class Container>
+void GLC_NumberParser<Container>::convert(const QChar* pBegin, const QChar* pEnd, GLuint* pValue)
+{
+	const QChar* pCurrent= pBegin;
+	if ((pCurrent != pEnd) && (pCurrent->unicode() == '+')) ++pCurrent;
+
+	quint64 value= 0;
+	bool isSimple= (pCurrent != pEnd) && ((pEnd - pCurrent) < 11);
+	while (isSimple && (pCurrent != pEnd))
+	{
+		const ushort digit= pCurrent->unicode() - '0';
+		isSimple= (digit < 10);
+		value= value * 10 + digit;
+		++pCurrent;
+	}
+
+	if (isSimple && (value <= std::numeric_limits<GLuint>::max()))
+	{
+		*pValue= static_cast<GLuint>(value);
+	}
+	else
+	{
+		*pValue= QString::fromRawData(pBegin, static_cast<int>(pEnd - pBegin)).toUInt();
+	}
+}
+
+template <class Container>
+template <class Char>
+bool GLC_NumberParser<Container>::fastToDouble(const Char* pBegin, const Char* pEnd, double* pValue)
+{
+	// Powers of ten exactly representable in double
+	static const double powersOfTen[]= {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+	const Char* pCurrent= pBegin;
+	bool isNegative= false;
+	if ((pCurrent != pEnd) && ((charCode(*pCurrent) == '-') || (charCode(*pCurrent) == '+')))
+	{
+		isNegative= (charCode(*pCurrent) == '-');
+		++pCurrent;
+	}
+
+	quint64 mantissa= 0;
+	int significantDigitCount= 0;
+	int exponent= 0;
+	bool hasDigit= false;
+
+	// Integer part
+	while ((pCurrent != pEnd) && (static_cast<ushort>(charCode(*pCurrent) - '0') < 10))
+	{
+		mantissa= mantissa * 10 + (charCode(*pCurrent) - '0');
+		if (mantissa != 0) ++significantDigitCount;
+		hasDigit= true;
+		++pCurrent;
+	}
+
+	// Fractional part
+	if ((pCurrent != pEnd) && (charCode(*pCurrent) == '.'))
+	{
+		++pCurrent;
+		while ((pCurrent != pEnd) && (static_cast<ushort>(charCode(*pCurrent) - '0') < 10))
+		{
+			mantissa= mantissa * 10 + (charCode(*pCurrent) - '0');
+			if (mantissa != 0) ++significantDigitCount;
+			--exponent;
+			hasDigit= true;
+			++pCurrent;
+		}
+	}
+	if (!hasDigit || (significantDigitCount > 15)) return false;
+
+	// Exponent part
+	if ((pCurrent != pEnd) && ((charCode(*pCurrent) == 'e') || (charCode(*pCurrent) == 'E')))
+	{
+		++pCurrent;
+		bool exponentIsNegative= false;
+		if ((pCurrent != pEnd) && ((charCode(*pCurrent) == '-') || (charCode(*pCurrent) == '+')))
+		{
+			exponentIsNegative= (charCode(*pCurrent) == '-');
+			++pCurrent;
+		}
+		if (pCurrent == pEnd) return false;
+		int exponentValue= 0;
+		while ((pCurrent != pEnd) && (static_cast<ushort>(charCode(*pCurrent) - '0') < 10) && (exponentValue < 1000))
+		{
+			exponentValue= exponentValue * 10 + (charCode(*pCurrent) - '0');
+			++pCurrent;
+		}
+		exponent+= exponentIsNegative ? -exponentValue : exponentValue;
+	}
+	if (pCurrent != pEnd) return false;
+
+	// With less than 16 digits and a power of ten exactly representable, the result is correctly rounded
+	double value= static_cast<double>(mantissa);
+	if (mantissa != 0)
+	{
+		if ((exponent < -22) || (exponent > 22)) return false;
+		if (exponent < 0) value/= powersOfTen[-exponent];
+		else value*= powersOfTen[exponent];
+	}
+	*pValue= isNegative ? -value : value;
+
+	return true;
+}
+
+#endif /* GLC_NUMBERPARSER_H_ */
@@ -33,9 +33,265 @@
 #include "../sceneGraph/glc_structreference.h"
 #include "../sceneGraph/glc_structinstance.h"
 #include "../sceneGraph/glc_structoccurence.h"
+#include "../geometry/glc_mappedbuffer.h"
+#include "../glc_state.h"
+#include "glc_numberparser.h"
 #include <QTextStream>
 #include <QFileInfo>
 #include <QGLContext>
+#include <QSharedPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+
+// Number of bytes per chunk of the parallel loading
+static const qint64 bytesPerChunk= 4194304;
+
+// Return true if the given character is a white space
+static inline bool isSpace(char c)
+{
+	return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n') || (c == '\v') || (c == '\f');
+}
+
+// Return true if the given text is the given keyword
+static inline bool textIs(const char* pBegin, const char* pEnd, const char* keyword)
+{
+	while ((pBegin != pEnd) && ('\0' != *keyword) && (*pBegin == *keyword))
+	{
+		++pBegin;
+		++keyword;
+	}
+	return (pBegin == pEnd) && ('\0' == *keyword);
+}
+
+// Read the line at the given position and move the position to the next line
+static inline void readLine(const char** ppCurrent, const char* pEnd, const char** ppLineBegin, const char** ppLineEnd)
+{
+	const char* pLineEnd= *ppCurrent;
+	while ((pLineEnd != pEnd) && ('\n' != *pLineEnd)) ++pLineEnd;
+	*ppLineBegin= *ppCurrent;
+	*ppCurrent= (pLineEnd != pEnd) ? (pLineEnd + 1) : pEnd;
+	// As QTextStream::readLine() "\r\n" is an end of line
+	if ((pLineEnd != *ppLineBegin) && ('\r' == *(pLineEnd - 1))) --pLineEnd;
+	*ppLineEnd= pLineEnd;
+}
+
+// Return true if the given line is continued on the next line (See mergeLines)
+static inline bool lineIsContinued(const char* pLineBegin, const char* pLineEnd)
+{
+	return (pLineBegin != pLineEnd) && ('\\' == *(pLineEnd - 1));
+}
+
+// Read the given number of floats of the given text
+// Return the number of tokens found or -1 if a token is not a float, as extract3dVect and extract2dVect
+static int readVector(const char* pCurrent, const char* pEnd, int size, GLfloat* pValues)
+{
+	const char* tokens[6];
+	int count= 0;
+	while (count < size)
+	{
+		while ((pCurrent != pEnd) && isSpace(*pCurrent)) ++pCurrent;
+		if (pCurrent == pEnd) break;
+		tokens[2 * count]= pCurrent;
+		while ((pCurrent != pEnd) && !isSpace(*pCurrent)) ++pCurrent;
+		tokens[2 * count + 1]= pCurrent;
+		++count;
+	}
+	for (int i= 0; (i < count) && (count == size); ++i)
+	{
+		if (!GLC_NumberParser<GLfloatVector>::toFloat(tokens[2 * i], tokens[2 * i + 1], &pValues[i])) return -1;
+	}
+	return count;
+}
+
+// Append the given range of the given source to the given vector
+static inline void appendRange(GLfloatVector* pVector, const GLfloatVector& source, int begin, int end)
+{
+	const int size= pVector->size();
+	pVector->resize(size + end - begin);
+	memcpy(pVector->data() + size, source.constData() + begin, (end - begin) * sizeof(GLfloat));
+}
+
+// Parse the given integer as QString::toInt(), return false if it doesn't match [-+]?\d+
+static bool readInt(const char* pBegin, const char* pEnd, int* pValue, bool* pIsValid)
+{
+	bool isNegative= false;
+	if ((pBegin != pEnd) && (('-' == *pBegin) || ('+' == *pBegin)))
+	{
+		isNegative= ('-' == *pBegin);
+		++pBegin;
+	}
+	if (pBegin == pEnd) return false;
+	qint64 value= 0;
+	while (pBegin != pEnd)
+	{
+		const uint digit= static_cast<uchar>(*pBegin) - '0';
+		if (digit > 9) return false;
+		if (value <= std::numeric_limits<int>::max()) value= value * 10 + digit;
+		++pBegin;
+	}
+	if (isNegative) value= -value;
+	*pIsValid= (value >= std::numeric_limits<int>::min()) && (value <= std::numeric_limits<int>::max());
+	*pValue= *pIsValid ? static_cast<int>(value) : 0;
+	return true;
+}
+
+// Face vertex parsed from a chunk of an OBJ file
+struct GLC_ObjToWorld::ObjFaceVertex
+{
+	//! Values of the non empty fields separated by '/'
+	int m_Values[3];
+	//! The face type matching this vertex, notSet if there is no match
+	quint8 m_Form;
+	//! The number of non empty fields
+	quint8 m_FieldCount;
+	//! Bit mask of fields which are valid integers
+	quint8 m_ValidMask;
+	//! True if the vertex contains '/'
+	bool m_HasSlash;
+};
+
+// Data parsed from a chunk of an OBJ file
+struct GLC_ObjToWorld::ObjChunk
+{
+	//! Type of record
+	enum RecordType
+	{
+		VertexData,
+		Faces,
+		Group,
+		Material,
+		VectorError,
+		TexelError
+	};
+
+	//! Record of the chunk, records are added to the world in order
+	struct Record
+	{
+		inline Record()
+		: m_Type(VertexData)
+		, m_Line(0)
+		, m_Text()
+		{
+			for (int i= 0; i < 6; ++i) m_Values[i]= 0;
+		}
+		inline Record(RecordType type, int line)
+		: m_Type(type)
+		, m_Line(line)
+		, m_Text()
+		{
+			for (int i= 0; i < 6; ++i) m_Values[i]= 0;
+		}
+
+		//! The type of the record
+		RecordType m_Type;
+		//! The line of the record in the chunk
+		int m_Line;
+		//! VertexData : number of v, vn, vt lines and of positions, normals, texels floats since the begining of the chunk
+		//! Faces : first face and number of faces
+		int m_Values[6];
+		//! Group and Material : the line without the keyword
+		QString m_Text;
+	};
+
+	inline ObjChunk()
+	: m_Begin(0)
+	, m_End(0)
+	, m_LineCount(0)
+	, m_Positions()
+	, m_Normals()
+	, m_Texels()
+	, m_PositionLineCount(0)
+	, m_NormalLineCount(0)
+	, m_TexelLineCount(0)
+	, m_FaceVertices()
+	, m_FaceEnd()
+	, m_FaceLine()
+	, m_Records()
+	{}
+
+	//! Update the last vertex data record of the chunk
+	inline void updateVertexData(int line)
+	{
+		if (m_Records.isEmpty() || (VertexData != m_Records.last().m_Type))
+		{
+			m_Records.append(Record(VertexData, line));
+		}
+		int* pValues= m_Records.last().m_Values;
+		pValues[0]= m_PositionLineCount;
+		pValues[1]= m_NormalLineCount;
+		pValues[2]= m_TexelLineCount;
+		pValues[3]= m_Positions.size();
+		pValues[4]= m_Normals.size();
+		pValues[5]= m_Texels.size();
+	}
+
+	//! Return true if the parsing of this chunk failed
+	inline bool hasError() const
+	{return !m_Records.isEmpty() && (TexelError == m_Records.last().m_Type);}
+
+	//! Offset of the begining of the chunk
+	qint64 m_Begin;
+	//! Offset of the end of the chunk
+	qint64 m_End;
+	//! Number of lines of the chunk
+	int m_LineCount;
+	//! Position bulk data
+	GLfloatVector m_Positions;
+	//! Normal bulk data
+	GLfloatVector m_Normals;
+	//! Texture coordinate bulk data
+	GLfloatVector m_Texels;
+	//! Number of v lines
+	int m_PositionLineCount;
+	//! Number of vn lines
+	int m_NormalLineCount;
+	//! Number of vt lines
+	int m_TexelLineCount;
+	//! Vertices of faces
+	QVector<ObjFaceVertex> m_FaceVertices;
+	//! End of each face in vertices of faces
+	QVector<int> m_FaceEnd;
+	//! Line of each face
+	QVector<int> m_FaceLine;
+	//! The records of the chunk
+	QVector<Record> m_Records;
+};
+
+// Runnable which parses chunks of the parallel loading
+class GLC_ObjToWorld::ChunkRunner : public QRunnable
+{
+public:
+	inline ChunkRunner(GLC_ObjToWorld* pLoader, ChunkFunction function, int chunkCount, QAtomicInt* pNextChunk)
+	: QRunnable()
+	, m_pLoader(pLoader)
+	, m_Function(function)
+	, m_ChunkCount(chunkCount)
+	, m_pNextChunk(pNextChunk)
+	{}
+
+	//! Process the next chunks until all chunks are taken
+	virtual void run()
+	{
+		int chunkIndex= m_pNextChunk->fetchAndAddOrdered(1);
+		while (chunkIndex < m_ChunkCount)
+		{
+			(m_pLoader->*m_Function)(chunkIndex);
+			chunkIndex= m_pNextChunk->fetchAndAddOrdered(1);
+		}
+	}
+
+private:
+	//! The loader which owns the chunks
+	GLC_ObjToWorld* m_pLoader;
+	//! The function which process a chunk
+	ChunkFunction m_Function;
+	//! The number of chunks
+	int m_ChunkCount;
+	//! The index of the next chunk to process
+	QAtomicInt* m_pNextChunk;
+};
 
 //////////////////////////////////////////////////////////////////////
 // Constructor
@@ -60,6 +316,8 @@ GLC_ObjToWorld::GLC_ObjToWorld()
 , m_NormalOffset(0)
 , m_TextureOffset(0)
 , m_ResetIndex(false)
+, m_pMappedData(NULL)
+, m_Chunks()
 {
 }
 
@@ -106,30 +364,66 @@ GLC_World* GLC_ObjToWorld::CreateWorldFromObj(QFile &file)
 
 	QString mtlLibLine;
 
-	//////////////////////////////////////////////////////////////////
-	// Searching mtllib attribute
-	//////////////////////////////////////////////////////////////////
-	while (!objStream.atEnd() && !lineBuff.contains("mtllib"))
+	// The mapped file of the parallel loading
+	QSharedPointer<GLC_MappedBuffer> mappedFile;
+	if (GLC_State::isParallelLoadingActivated())
 	{
-		++numberOfLine;
-		lineBuff= objStream.readLine();
-		if (lineBuff.contains("mtllib")) mtlLibLine= lineBuff;
+		mappedFile= QSharedPointer<GLC_MappedBuffer>(new GLC_MappedBuffer(m_FileName, 0, file.size()));
+		if (mappedFile->isValid())
+		{
+			// Searching mtllib attribute
+			const char* pData= static_cast<const char*>(mappedFile->constData(0));
+			const char* pEnd= pData + mappedFile->size();
+			const char* pCurrent= pData;
+			while ((pCurrent != pEnd) && mtlLibLine.isEmpty())
+			{
+				const char* pLineBegin;
+				const char* pLineEnd;
+				readLine(&pCurrent, pEnd, &pLineBegin, &pLineEnd);
+				const char* pMtlLib= static_cast<const char*>(memchr(pLineBegin, 'm', pLineEnd - pLineBegin));
+				while ((NULL != pMtlLib) && !textIs(pMtlLib, qMin(pMtlLib + 6, pLineEnd), "mtllib"))
+				{
+					pMtlLib= static_cast<const char*>(memchr(pMtlLib + 1, 'm', pLineEnd - pMtlLib - 1));
+				}
+				if (NULL != pMtlLib)
+				{
+					mtlLibLine= QString::fromLocal8Bit(pLineBegin, static_cast<int>(pLineEnd - pLineBegin));
+				}
+			}
+		}
+		else
+		{
+			mappedFile.clear();
+		}
 	}
 
-	//////////////////////////////////////////////////////////////////
-	// Count the number of lines of the OBJ file
-	//////////////////////////////////////////////////////////////////
-	while (!objStream.atEnd())
+	if (mappedFile.isNull())
 	{
-		++numberOfLine;
-		objStream.readLine();
-	}
+		//////////////////////////////////////////////////////////////////
+		// Searching mtllib attribute
+		//////////////////////////////////////////////////////////////////
+		while (!objStream.atEnd() && !lineBuff.contains("mtllib"))
+		{
+			++numberOfLine;
+			lineBuff= objStream.readLine();
+			if (lineBuff.contains("mtllib")) mtlLibLine= lineBuff;
+		}
 
-	//////////////////////////////////////////////////////////////////
-	// Reset the stream
-	//////////////////////////////////////////////////////////////////
-	objStream.resetStatus();
-	objStream.seek(0);
+		//////////////////////////////////////////////////////////////////
+		// Count the number of lines of the OBJ file
+		//////////////////////////////////////////////////////////////////
+		while (!objStream.atEnd())
+		{
+			++numberOfLine;
+			objStream.readLine();
+		}
+
+		//////////////////////////////////////////////////////////////////
+		// Reset the stream
+		//////////////////////////////////////////////////////////////////
+		objStream.resetStatus();
+		objStream.seek(0);
+	}
 
 	//////////////////////////////////////////////////////////////////
 	// if mtl file found, load it
@@ -174,21 +468,29 @@ GLC_World* GLC_ObjToWorld::CreateWorldFromObj(QFile &file)
     m_NormalOffset= 0;
     m_TextureOffset= 0;
 
-	while (!objStream.atEnd())
+	if (!mappedFile.isNull())
 	{
-		++m_CurrentLineNumber;
-		lineBuff= objStream.readLine();
+		loadMappedObj(static_cast<const char*>(mappedFile->constData(0)), mappedFile->size());
+		mappedFile.clear();
+	}
+	else
+	{
+		while (!objStream.atEnd())
+		{
+			++m_CurrentLineNumber;
+			lineBuff= objStream.readLine();
 
-		mergeLines(&lineBuff, &objStream);
+			mergeLines(&lineBuff, &objStream);
 
-		scanLigne(lineBuff);
-		currentQuantumValue = static_cast<int>((static_cast<double>(m_CurrentLineNumber) / numberOfLine) * 100);
-		if (currentQuantumValue > previousQuantumValue)
-		{
-			emit currentQuantum(currentQuantumValue);
-		}
-		previousQuantumValue= currentQuantumValue;
+			scanLigne(lineBuff);
+			currentQuantumValue = static_cast<int>((static_cast<double>(m_CurrentLineNumber) / numberOfLine) * 100);
+			if (currentQuantumValue > previousQuantumValue)
+			{
+				emit currentQuantum(currentQuantumValue);
+			}
+			previousQuantumValue= currentQuantumValue;
 
+		}
 	}
 	file.close();
 
@@ -261,7 +563,7 @@ void GLC_ObjToWorld::scanLigne(QString &line)
             m_ResetIndex= false;
         }
 		line.remove(0,2); // Remove first 2 char
-		m_Positions.append(extract3dVect(line));
+		m_Positions+= extract3dVect(line).toVector();
 		m_FaceType = notSet;
         ++m_VerticeIndex;
 	}
@@ -270,7 +572,7 @@ void GLC_ObjToWorld::scanLigne(QString &line)
 	else if (line.startsWith("vt ")|| line.startsWith(QString("vt") + QString(QChar(9))))
 	{
 		line.remove(0,3); // Remove first 3 char
-		m_Texels.append(extract2dVect(line));
+		m_Texels+= extract2dVect(line).toVector();
 		m_FaceType = notSet;
         ++m_TextureIndex;
 	}
@@ -279,7 +581,7 @@ void GLC_ObjToWorld::scanLigne(QString &line)
 	else if (line.startsWith("vn ") || line.startsWith(QString("vn") + QString(QChar(9))))
 	{
 		line.remove(0,3); // Remove first 3 char
-		m_Normals.append(extract3dVect(line));
+		m_Normals+= extract3dVect(line).toVector();
 		m_FaceType = notSet;
         ++m_NormalIndex;
 	}
@@ -437,7 +739,7 @@ void GLC_ObjToWorld::extractFaceIndex(QString &line)
 	int normalIndex;
 	int textureCoordinateIndex;
 
-	QList<GLuint> currentFaceIndex;
+	QVector<ObjVertice> vertices;
 	//////////////////////////////////////////////////////////////////
 	// Parse the line containing face index
 	//////////////////////////////////////////////////////////////////
@@ -446,11 +748,27 @@ void GLC_ObjToWorld::extractFaceIndex(QString &line)
 	{
 		streamFace >> buff;
 		extractVertexIndex(buff, coordinateIndex, normalIndex, textureCoordinateIndex);
+		vertices.append(ObjVertice(coordinateIndex, normalIndex, textureCoordinateIndex));
+	}
+	addFace(vertices);
+}
+
+// Add a face of the given vertices to the current Obj mesh
+void GLC_ObjToWorld::addFace(const QVector<ObjVertice>& vertices)
+{
+	QList<GLuint> currentFaceIndex;
+	const int verticeCount= vertices.size();
+	for (int i= 0; i < verticeCount; ++i)
+	{
+		const ObjVertice& currentVertice= vertices.at(i);
+		const int coordinateIndex= currentVertice.m_Values[0];
+		const int normalIndex= currentVertice.m_Values[1];
+		const int textureCoordinateIndex= currentVertice.m_Values[2];
 
-		ObjVertice currentVertice(coordinateIndex, normalIndex, textureCoordinateIndex);
-		if (m_pCurrentObjMesh->m_ObjVerticeIndexMap.contains(currentVertice))
+		QHash<ObjVertice, GLuint>::const_iterator iVertice= m_pCurrentObjMesh->m_ObjVerticeIndexMap.constFind(currentVertice);
+		if (m_pCurrentObjMesh->m_ObjVerticeIndexMap.constEnd() != iVertice)
 		{
-			currentFaceIndex.append(m_pCurrentObjMesh->m_ObjVerticeIndexMap.value(currentVertice));
+			currentFaceIndex.append(iVertice.value());
 		}
 		else
 		{
@@ -866,7 +1184,8 @@ void GLC_ObjToWorld::clear()
 		delete m_pCurrentObjMesh;
 		m_pCurrentObjMesh= NULL;
 	}
-
+	m_pMappedData= NULL;
+	m_Chunks.clear();
 }
 // Merge Mutli line in one
 void GLC_ObjToWorld::mergeLines(QString* pLineBuff, QTextStream* p0bjStream)
@@ -948,3 +1267,399 @@ void GLC_ObjToWorld::addCurrentObjMeshToWorld()
 }
 
 
+
+// Load the given mapped OBJ file in parallel
+void GLC_ObjToWorld::loadMappedObj(const char* pData, qint64 size)
+{
+	m_pMappedData= pData;
+
+	// Chunks begin on a line which is not the continuation of the previous line
+	const int chunkCount= static_cast<int>(qBound(static_cast<qint64>(1), (size + bytesPerChunk - 1) / bytesPerChunk, static_cast<qint64>(4096)));
+	m_Chunks.resize(chunkCount);
+	qint64 offset= 0;
+	for (int i= 0; i < chunkCount; ++i)
+	{
+		m_Chunks[i].m_Begin= offset;
+		offset= qMax(offset, (size * (i + 1)) / chunkCount);
+		while (offset < size)
+		{
+			if ('\n' == pData[offset - 1])
+			{
+				const char* pLineEnd= pData + offset - 1;
+				if ((pLineEnd != pData) && ('\r' == *(pLineEnd - 1))) --pLineEnd;
+				if (!lineIsContinued(pData, pLineEnd)) break;
+			}
+			++offset;
+		}
+		m_Chunks[i].m_End= offset;
+	}
+	processChunks(&GLC_ObjToWorld::parseChunk, chunkCount, 0, 50);
+
+	// Add chunks to the world in file order
+	int firstLineNumber= 0;
+	int previousQuantumValue= 50;
+	for (int i= 0; i < chunkCount; ++i)
+	{
+		addChunk(i, firstLineNumber);
+		firstLineNumber+= m_Chunks.at(i).m_LineCount;
+		m_Chunks[i]= ObjChunk();
+
+		const int currentQuantumValue= 50 + static_cast<int>((static_cast<double>(i + 1) / chunkCount) * 50);
+		if (currentQuantumValue > previousQuantumValue)
+		{
+			emit currentQuantum(currentQuantumValue);
+		}
+		previousQuantumValue= currentQuantumValue;
+	}
+	m_CurrentLineNumber= firstLineNumber;
+	m_Chunks.clear();
+	m_pMappedData= NULL;
+}
+
+// Process the given number of chunks with the given function in parallel
+void GLC_ObjToWorld::processChunks(ChunkFunction function, int chunkCount, int firstQuantum, int lastQuantum)
+{
+	const int threadCount= qBound(1, QThread::idealThreadCount(), chunkCount);
+	QAtomicInt nextChunk(0);
+
+	QThreadPool threadPool;
+	threadPool.setMaxThreadCount(threadCount);
+	for (int i= 0; i < threadCount; ++i)
+	{
+		threadPool.start(new ChunkRunner(this, function, chunkCount, &nextChunk));
+	}
+
+	// Progress bar indicator
+	int previousQuantumValue= firstQuantum;
+	while (!threadPool.waitForDone(100))
+	{
+		const double ratio= static_cast<double>(qMin(nextChunk.fetchAndAddOrdered(0), chunkCount)) / chunkCount;
+		const int currentQuantumValue= firstQuantum + static_cast<int>(ratio * (lastQuantum - firstQuantum));
+		if (currentQuantumValue > previousQuantumValue)
+		{
+			emit currentQuantum(currentQuantumValue);
+		}
+		previousQuantumValue= currentQuantumValue;
+	}
+	emit currentQuantum(lastQuantum);
+}
+
+// Parse the given chunk of the mapped OBJ file
+void GLC_ObjToWorld::parseChunk(int chunkIndex)
+{
+	ObjChunk* pChunk= &(m_Chunks[chunkIndex]);
+	const char* pCurrent= m_pMappedData + pChunk->m_Begin;
+	const char* pEnd= m_pMappedData + pChunk->m_End;
+
+	int lineNumber= 0;
+	while ((pCurrent != pEnd) && !pChunk->hasError())
+	{
+		const char* pLineBegin;
+		const char* pLineEnd;
+		readLine(&pCurrent, pEnd, &pLineBegin, &pLineEnd);
+		++lineNumber;
+		if (lineIsContinued(pLineBegin, pLineEnd))
+		{
+			// Merge multi line in one, as mergeLines()
+			QByteArray mergedLine;
+			do
+			{
+				mergedLine.append(QByteArray(pLineBegin, static_cast<int>(pLineEnd - pLineBegin)).replace('\\', ' '));
+				if (pCurrent == pEnd)
+				{
+					pLineBegin= pLineEnd;
+					break;
+				}
+				readLine(&pCurrent, pEnd, &pLineBegin, &pLineEnd);
+				++lineNumber;
+			}
+			while (lineIsContinued(pLineBegin, pLineEnd));
+			mergedLine.append(QByteArray(pLineBegin, static_cast<int>(pLineEnd - pLineBegin)));
+			parseChunkLine(pChunk, mergedLine.constData(), mergedLine.constData() + mergedLine.size(), lineNumber);
+		}
+		else
+		{
+			parseChunkLine(pChunk, pLineBegin, pLineEnd, lineNumber);
+		}
+	}
+	pChunk->m_LineCount= lineNumber;
+}
+
+// Parse the given line of the given chunk, as scanLigne()
+void GLC_ObjToWorld::parseChunkLine(ObjChunk* pChunk, const char* pBegin, const char* pEnd, int lineNumber)
+{
+	// Trim the line and find the keyword
+	while ((pBegin != pEnd) && isSpace(*pBegin)) ++pBegin;
+	while ((pBegin != pEnd) && isSpace(*(pEnd - 1))) --pEnd;
+	const char* pKeywordEnd= pBegin;
+	while ((pKeywordEnd != pEnd) && (' ' != *pKeywordEnd) && ('\t' != *pKeywordEnd)) ++pKeywordEnd;
+	if (pKeywordEnd == pEnd) return;
+	const char* pValues= pKeywordEnd + 1;
+
+	GLfloat values[3];
+	if (textIs(pBegin, pKeywordEnd, "v"))
+	{
+		const int result= readVector(pValues, pEnd, 3, values);
+		if (3 == result)
+		{
+			pChunk->m_Positions << values[0] << values[1] << values[2];
+		}
+		else if (-1 == result)
+		{
+			pChunk->m_Records.append(ObjChunk::Record(ObjChunk::VectorError, lineNumber));
+		}
+		++(pChunk->m_PositionLineCount);
+		pChunk->updateVertexData(lineNumber);
+	}
+	else if (textIs(pBegin, pKeywordEnd, "vt"))
+	{
+		const int result= readVector(pValues, pEnd, 2, values);
+		if (2 == result)
+		{
+			pChunk->m_Texels << values[0] << values[1];
+		}
+		else if (-1 == result)
+		{
+			pChunk->m_Records.append(ObjChunk::Record(ObjChunk::TexelError, lineNumber));
+			return;
+		}
+		++(pChunk->m_TexelLineCount);
+		pChunk->updateVertexData(lineNumber);
+	}
+	else if (textIs(pBegin, pKeywordEnd, "vn"))
+	{
+		const int result= readVector(pValues, pEnd, 3, values);
+		if (3 == result)
+		{
+			pChunk->m_Normals << values[0] << values[1] << values[2];
+		}
+		else if (-1 == result)
+		{
+			pChunk->m_Records.append(ObjChunk::Record(ObjChunk::VectorError, lineNumber));
+		}
+		++(pChunk->m_NormalLineCount);
+		pChunk->updateVertexData(lineNumber);
+	}
+	else if (textIs(pBegin, pKeywordEnd, "f"))
+	{
+		const char* pCurrent= pValues;
+		while (pCurrent != pEnd)
+		{
+			while ((pCurrent != pEnd) && isSpace(*pCurrent)) ++pCurrent;
+			if (pCurrent == pEnd) break;
+
+			// Parse the parts separated by '/' of the vertex
+			ObjFaceVertex faceVertex;
+			faceVertex.m_Values[0]= faceVertex.m_Values[1]= faceVertex.m_Values[2]= 0;
+			faceVertex.m_FieldCount= 0;
+			faceVertex.m_ValidMask= 0;
+			faceVertex.m_HasSlash= false;
+			const char* pTokenEnd= pCurrent;
+			while ((pTokenEnd != pEnd) && !isSpace(*pTokenEnd)) ++pTokenEnd;
+			bool partIsNumber[3]= {false, false, false};
+			bool partIsEmpty[3]= {false, false, false};
+			int partCount= 0;
+			while (true)
+			{
+				const char* pPartEnd= pCurrent;
+				while ((pPartEnd != pTokenEnd) && ('/' != *pPartEnd)) ++pPartEnd;
+				int value= 0;
+				bool isValid= false;
+				const bool isNumber= readInt(pCurrent, pPartEnd, &value, &isValid);
+				if (partCount < 3)
+				{
+					partIsNumber[partCount]= isNumber;
+					partIsEmpty[partCount]= (pCurrent == pPartEnd);
+				}
+				// Empty parts are not fields
+				if ((pCurrent != pPartEnd) && (faceVertex.m_FieldCount < 3))
+				{
+					faceVertex.m_Values[faceVertex.m_FieldCount]= value;
+					if (isNumber && isValid) faceVertex.m_ValidMask|= (1 << faceVertex.m_FieldCount);
+					++(faceVertex.m_FieldCount);
+				}
+				++partCount;
+				if (pPartEnd == pTokenEnd) break;
+				faceVertex.m_HasSlash= true;
+				pCurrent= pPartEnd + 1;
+			}
+			pCurrent= pTokenEnd;
+
+			// The face type of the vertex, as setObjType()
+			faceVertex.m_Form= notSet;
+			if ((1 == partCount) && partIsNumber[0])
+			{
+				faceVertex.m_Form= coordinate;
+			}
+			else if ((2 == partCount) && partIsNumber[0] && partIsNumber[1])
+			{
+				faceVertex.m_Form= coordinateAndTexture;
+			}
+			else if ((3 == partCount) && partIsNumber[0] && partIsNumber[1] && partIsNumber[2])
+			{
+				faceVertex.m_Form= coordinateAndTextureAndNormal;
+			}
+			else if ((3 == partCount) && partIsNumber[0] && partIsEmpty[1] && partIsNumber[2])
+			{
+				faceVertex.m_Form= coordinateAndNormal;
+			}
+			pChunk->m_FaceVertices.append(faceVertex);
+		}
+		pChunk->m_FaceEnd.append(pChunk->m_FaceVertices.size());
+		pChunk->m_FaceLine.append(lineNumber);
+
+		if (pChunk->m_Records.isEmpty() || (ObjChunk::Faces != pChunk->m_Records.last().m_Type))
+		{
+			ObjChunk::Record record(ObjChunk::Faces, lineNumber);
+			record.m_Values[0]= pChunk->m_FaceEnd.size() - 1;
+			pChunk->m_Records.append(record);
+		}
+		++(pChunk->m_Records.last().m_Values[1]);
+	}
+	else if (textIs(pBegin, pKeywordEnd, "usemtl") || textIs(pBegin, pKeywordEnd, "g") || textIs(pBegin, pKeywordEnd, "o"))
+	{
+		const ObjChunk::RecordType type= textIs(pBegin, pKeywordEnd, "usemtl") ? ObjChunk::Material : ObjChunk::Group;
+		ObjChunk::Record record(type, lineNumber);
+		record.m_Text= QString::fromLocal8Bit(pValues, static_cast<int>(pEnd - pValues));
+		pChunk->m_Records.append(record);
+	}
+}
+
+// Add the data of the given parsed chunk which begin at the given line to the world
+void GLC_ObjToWorld::addChunk(int chunkIndex, int firstLineNumber)
+{
+	const ObjChunk& chunk= m_Chunks.at(chunkIndex);
+
+	// Number of v, vn and vt lines of the previous chunks
+	const int verticeIndex= m_VerticeIndex;
+	const int normalIndex= m_NormalIndex;
+	const int textureIndex= m_TextureIndex;
+
+	int positionSize= 0;
+	int normalSize= 0;
+	int texelSize= 0;
+	QVector<ObjVertice> vertices;
+	const int recordCount= chunk.m_Records.size();
+	for (int i= 0; i < recordCount; ++i)
+	{
+		const ObjChunk::Record& record= chunk.m_Records.at(i);
+		m_CurrentLineNumber= firstLineNumber + record.m_Line;
+		if (ObjChunk::VertexData == record.m_Type)
+		{
+			// Append the bulk data parsed before this record
+			appendRange(&m_Positions, chunk.m_Positions, positionSize, record.m_Values[3]);
+			appendRange(&m_Normals, chunk.m_Normals, normalSize, record.m_Values[4]);
+			appendRange(&m_Texels, chunk.m_Texels, texelSize, record.m_Values[5]);
+			positionSize= record.m_Values[3];
+			normalSize= record.m_Values[4];
+			texelSize= record.m_Values[5];
+			m_VerticeIndex= verticeIndex + record.m_Values[0];
+			m_NormalIndex= normalIndex + record.m_Values[1];
+			m_TextureIndex= textureIndex + record.m_Values[2];
+			m_FaceType= notSet;
+		}
+		else if (ObjChunk::Faces == record.m_Type)
+		{
+			const int lastFace= record.m_Values[0] + record.m_Values[1];
+			for (int face= record.m_Values[0]; face < lastFace; ++face)
+			{
+				m_CurrentLineNumber= firstLineNumber + chunk.m_FaceLine.at(face);
+				// If there is no group or object in the OBJ file
+				if (NULL == m_pCurrentObjMesh)
+				{
+					changeGroup("GLC_Default");
+				}
+				vertices.clear();
+				const int lastVertex= chunk.m_FaceEnd.at(face);
+				for (int vertex= (0 == face) ? 0 : chunk.m_FaceEnd.at(face - 1); vertex < lastVertex; ++vertex)
+				{
+					vertices.append(objVertice(chunk.m_FaceVertices.at(vertex)));
+				}
+				addFace(vertices);
+			}
+		}
+		else if (ObjChunk::Group == record.m_Type)
+		{
+			m_FaceType= notSet;
+			changeGroup(record.m_Text);
+		}
+		else if (ObjChunk::Material == record.m_Type)
+		{
+			QString line(record.m_Text);
+			setCurrentMaterial(line);
+			m_FaceType= notSet;
+		}
+		else if (ObjChunk::VectorError == record.m_Type)
+		{
+			QString message= "GLC_ObjToWorld::extract3dVect " + m_FileName + " failed to convert vector component to float";
+			message.append("\nAt ligne : ");
+			message.append(QString::number(m_CurrentLineNumber));
+			QStringList stringList(m_FileName);
+			stringList.append(message);
+			GLC_ErrorLog::addError(stringList);
+		}
+		else
+		{
+			Q_ASSERT(ObjChunk::TexelError == record.m_Type);
+			QString message= "GLC_ObjToWorld::extract2dVect " + m_FileName + " failed to convert vector component to double";
+			message.append("\nAt ligne : ");
+			message.append(QString::number(m_CurrentLineNumber));
+			GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
+			clear();
+			throw(fileFormatException);
+		}
+	}
+}
+
+// Return the Obj vertice of the given parsed face vertex, as extractVertexIndex()
+GLC_ObjToWorld::ObjVertice GLC_ObjToWorld::objVertice(const ObjFaceVertex& faceVertex)
+{
+	if (m_FaceType == notSet)
+	{
+		if (notSet == faceVertex.m_Form)
+		{
+			QString message= "GLC_ObjToWorld::setObjType OBJ file " + m_FileName + " not reconize";
+			message.append("\nAt line : ");
+			message.append(QString::number(m_CurrentLineNumber));
+			GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotSupported);
+			clear();
+			throw(fileFormatException);
+		}
+		m_FaceType= static_cast<FaceType>(faceVertex.m_Form);
+	}
+
+	const bool hasTexture= (m_FaceType == coordinateAndTexture) || (m_FaceType == coordinateAndTextureAndNormal);
+	const bool hasNormal= (m_FaceType == coordinateAndNormal) || (m_FaceType == coordinateAndTextureAndNormal);
+	const int fieldCount= 1 + (hasTexture ? 1 : 0) + (hasNormal ? 1 : 0);
+	if ((m_FaceType != coordinate) && (faceVertex.m_FieldCount < fieldCount))
+	{
+		QString message= "GLC_ObjToWorld::extractVertexIndex " + m_FileName + " this Obj file type is not supported";
+		message.append("\nAt line : ");
+		message.append(QString::number(m_CurrentLineNumber));
+		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotSupported);
+		clear();
+		throw(fileFormatException);
+	}
+	const int validMask= (1 << fieldCount) - 1;
+	if (((faceVertex.m_ValidMask & validMask) != validMask) || ((m_FaceType == coordinate) && faceVertex.m_HasSlash))
+	{
+		QString message= "GLC_ObjToWorld::extractVertexIndex " + m_FileName + " failed to convert String to int";
+		message.append("\nAt line : ");
+		message.append(QString::number(m_CurrentLineNumber));
+		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
+		clear();
+		throw(fileFormatException);
+	}
+
+	int coordinateIndex= faceVertex.m_Values[0] - 1;
+	int textureCoordinateIndex= hasTexture ? (faceVertex.m_Values[1] - 1) : -1;
+	int normalIndex= hasNormal ? (faceVertex.m_Values[fieldCount - 1] - 1) : -1;
+	if (coordinateIndex < 0)
+	{
+		// Relative index
+		coordinateIndex= m_VerticeIndex + m_VerticeOffset + coordinateIndex + 1;
+		if (hasNormal) normalIndex= m_NormalIndex + m_NormalOffset + normalIndex + 1;
+		if (hasTexture) textureCoordinateIndex= m_TextureIndex + m_TextureOffset + textureCoordinateIndex + 1;
+	}
+	return ObjVertice(coordinateIndex, normalIndex, textureCoordinateIndex);
+}
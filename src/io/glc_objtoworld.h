@@ -64,32 +64,50 @@ class QGLContext;
  * 		- Face
  * 		- Texture coordinate
  * 		- Normal coordinate
+ *
+ * 	If parallel loading is activated (See GLC_State::setParallelLoadingUsage) the file is mapped
+ * 	and split at line boundaries in chunks which are parsed in parallel. Chunks are then added
+ * 	to the world in file order, so the world is the same as the one created line by line.
   */
 //////////////////////////////////////////////////////////////////////
 class GLC_LIB_EXPORT GLC_ObjToWorld : public QObject
 {
 	Q_OBJECT
 
+	//! \class ChunkRunner
+	/*! \brief ChunkRunner : Runnable which parses chunks of the parallel loading */
+	class ChunkRunner;
+	friend class ChunkRunner;
+
+	//! \struct ObjChunk
+	/*! \brief ObjChunk : Data parsed from a chunk of an OBJ file */
+	struct ObjChunk;
+
+	//! \struct ObjFaceVertex
+	/*! \brief ObjFaceVertex : Face vertex parsed from a chunk of an OBJ file */
+	struct ObjFaceVertex;
+
+	//! Member function which processes the chunk of the given index
+	typedef void (GLC_ObjToWorld::*ChunkFunction)(int);
+
 public:
 	// OBJ Vertice (Position index, Normal index and TexCoord index)
 	struct ObjVertice
 	{
 		ObjVertice()
-		: m_Values(3)
 		{
 			m_Values[0]= 0;
 			m_Values[1]= 0;
 			m_Values[2]= 0;
 		}
 		ObjVertice(int v1, int v2, int v3)
-		: m_Values(3)
 		{
 			m_Values[0]= v1;
 			m_Values[1]= v2;
 			m_Values[2]= v3;
 		}
 
-		QVector<int> m_Values;
+		int m_Values[3];
 	};
 
 	// Material assignement
@@ -209,6 +227,27 @@ private:
 	//! Add the current Obj mesh to the world
 	void addCurrentObjMeshToWorld();
 
+	//! Add a face of the given vertices to the current Obj mesh
+	void addFace(const QVector<ObjVertice>& vertices);
+
+	//! Load the given mapped OBJ file in parallel
+	void loadMappedObj(const char* pData, qint64 size);
+
+	//! Process the given number of chunks with the given function in parallel and emit progress in the given range
+	void processChunks(ChunkFunction function, int chunkCount, int firstQuantum, int lastQuantum);
+
+	//! Parse the given chunk of the mapped OBJ file
+	void parseChunk(int chunkIndex);
+
+	//! Parse the given line of the given chunk
+	void parseChunkLine(ObjChunk* pChunk, const char* pBegin, const char* pEnd, int lineNumber);
+
+	//! Add the data of the given parsed chunk which begin at the given line to the world
+	void addChunk(int chunkIndex, int firstLineNumber);
+
+	//! Return the Obj vertice of the given parsed face vertex
+	ObjVertice objVertice(const ObjFaceVertex& faceVertex);
+
 
 
 //////////////////////////////////////////////////////////////////////
@@ -249,13 +288,13 @@ private:
 	QStringList m_ListOfAttachedFileName;
 
 	//! The position bulk data
-	QList<float> m_Positions;
+	GLfloatVector m_Positions;
 
 	//! The normal bulk data
-	QList<float> m_Normals;
+	GLfloatVector m_Normals;
 
 	//! The texture coordinate bulk data
-	QList<float> m_Texels;
+	GLfloatVector m_Texels;
 
     int m_VerticeIndex;
     int m_NormalIndex;
@@ -268,14 +307,20 @@ private:
 
     bool m_ResetIndex;
 
+	//! The mapped file data
+	const char* m_pMappedData;
+
+	//! Data parsed from the chunks of the mapped file
+	QVector<ObjChunk> m_Chunks;
+
 };
 
 // To use ObjVertice as a QHash key
 inline bool operator==(const GLC_ObjToWorld::ObjVertice& vertice1, const GLC_ObjToWorld::ObjVertice& vertice2)
-{ return (vertice1.m_Values == vertice2.m_Values);}
+{ return (vertice1.m_Values[0] == vertice2.m_Values[0]) && (vertice1.m_Values[1] == vertice2.m_Values[1]) && (vertice1.m_Values[2] == vertice2.m_Values[2]);}
 
 inline uint qHash(const GLC_ObjToWorld::ObjVertice& vertice)
-{ return qHash(QString::number(vertice.m_Values.at(0)) + QString::number(vertice.m_Values.at(1)) + QString::number(vertice.m_Values.at(2)));}
+{ return (static_cast<uint>(vertice.m_Values[0]) * 73856093U) ^ (static_cast<uint>(vertice.m_Values[1]) * 19349663U) ^ (static_cast<uint>(vertice.m_Values[2]) * 83492791U);}
 
 
 #endif /*GLC_OBJTOWORLD_H_*/
@@ -28,11 +28,177 @@
 #include "../sceneGraph/glc_structreference.h"
 #include "../sceneGraph/glc_structinstance.h"
 #include "../sceneGraph/glc_structoccurence.h"
+#include "../geometry/glc_mappedbuffer.h"
+#include "../glc_state.h"
+#include "glc_numberparser.h"
 
 #include <QTextStream>
 #include <QFileInfo>
 #include <QGLContext>
 #include <QDataStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QtEndian>
+
+// Number of partitions of the vertex welding (2^partitionBits)
+static const int partitionBits= 6;
+static const int partitionCount= 1 << partitionBits;
+
+// Number of facets and corners per chunk of the parallel loading
+static const int facetsPerChunk= 16384;
+static const int cornersPerChunk= 65536;
+// Number of bytes per chunk of ASCII STL
+static const qint64 bytesPerChunk= 4194304;
+
+// Return the number of chunks of the given size needed for the given number of elements
+static inline int chunkCountOf(qint64 size, qint64 chunkSize)
+{
+	return static_cast<int>(qBound(static_cast<qint64>(1), (size + chunkSize - 1) / chunkSize, static_cast<qint64>(4096)));
+}
+
+// Return the float stored in little endian at the given address
+static inline float littleEndianFloat(const uchar* pData)
+{
+	const quint32 bits= qFromLittleEndian<quint32>(pData);
+	float value;
+	memcpy(&value, &bits, sizeof(float));
+	return value;
+}
+
+// Return the bits of the given float, 0.0 and -0.0 have the same bits
+static inline uint floatBits(float value)
+{
+	if (value == 0.0f) value= 0.0f;
+	quint32 bits;
+	memcpy(&bits, &value, sizeof(float));
+	return bits;
+}
+
+// Return true if the given character is an ASCII STL separator
+static inline bool isSpace(char c)
+{
+	return (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t');
+}
+
+// Return true if the token at the given offset is the first token of its line
+static inline bool isFirstTokenOfLine(const char* pData, qint64 offset)
+{
+	while ((offset > 0) && ((pData[offset - 1] == ' ') || (pData[offset - 1] == '\t'))) --offset;
+	return (0 == offset) || (pData[offset - 1] == '\n') || (pData[offset - 1] == '\r');
+}
+
+// Return the end of the token which begin at the given position
+static inline const char* tokenEnd(const char* pCurrent, const char* pEnd)
+{
+	while ((pCurrent != pEnd) && !isSpace(*pCurrent)) ++pCurrent;
+	return pCurrent;
+}
+
+// Return true if the given token is the given lower case keyword (case insensitive)
+static inline bool tokenIs(const char* pBegin, const char* pEnd, const char* keyword)
+{
+	while ((pBegin != pEnd) && ('\0' != *keyword) && ((*pBegin | 0x20) == *keyword))
+	{
+		++pBegin;
+		++keyword;
+	}
+	return (pBegin == pEnd) && ('\0' == *keyword);
+}
+
+// Read the next token of the given text which must be the given keyword
+static bool readKeyword(const char** ppCurrent, const char* pEnd, const char* keyword)
+{
+	const char* pToken= *ppCurrent;
+	while ((pToken != pEnd) && isSpace(*pToken)) ++pToken;
+	*ppCurrent= tokenEnd(pToken, pEnd);
+	return tokenIs(pToken, *ppCurrent, keyword);
+}
+
+// Read the next 3 floats of the given text and append them to the given vector
+static bool readVector(const char** ppCurrent, const char* pEnd, GLfloatVector* pVector)
+{
+	for (int i= 0; i < 3; ++i)
+	{
+		const char* pToken= *ppCurrent;
+		while ((pToken != pEnd) && isSpace(*pToken)) ++pToken;
+		*ppCurrent= tokenEnd(pToken, pEnd);
+		GLfloat value;
+		if ((pToken == *ppCurrent) || !GLC_NumberParser<GLfloatVector>::toFloat(pToken, *ppCurrent, &value)) return false;
+		pVector->append(value);
+	}
+	return true;
+}
+
+// Facets parsed from a chunk of an ASCII STL file
+struct GLC_StlToWorld::FacetChunk
+{
+	inline FacetChunk()
+	: m_Begin(0)
+	, m_End(0)
+	, m_Positions()
+	, m_Normals()
+	, m_SolidFirstFacet()
+	, m_SolidNames()
+	, m_FirstFacet(0)
+	, m_ErrorOffset(-1)
+	, m_Error()
+	{}
+
+	//! Offset of the begining of the chunk
+	qint64 m_Begin;
+	//! Offset of the end of the chunk
+	qint64 m_End;
+	//! Facets positions (9 floats per facet)
+	GLfloatVector m_Positions;
+	//! Facets normals (3 floats per facet)
+	GLfloatVector m_Normals;
+	//! Index in this chunk of the first facet of solids begining in this chunk
+	QList<int> m_SolidFirstFacet;
+	//! Name of solids begining in this chunk
+	QStringList m_SolidNames;
+	//! Index in the file of the first facet of this chunk
+	int m_FirstFacet;
+	//! Offset of the parsing error, -1 if there is no error
+	qint64 m_ErrorOffset;
+	//! The parsing error message
+	QString m_Error;
+};
+
+// Runnable which processes chunks of the parallel loading
+class GLC_StlToWorld::ChunkRunner : public QRunnable
+{
+public:
+	inline ChunkRunner(GLC_StlToWorld* pLoader, ChunkFunction function, int chunkCount, QAtomicInt* pNextChunk)
+	: QRunnable()
+	, m_pLoader(pLoader)
+	, m_Function(function)
+	, m_ChunkCount(chunkCount)
+	, m_pNextChunk(pNextChunk)
+	{}
+
+	//! Process the next chunks until all chunks are taken
+	virtual void run()
+	{
+		int chunkIndex= m_pNextChunk->fetchAndAddOrdered(1);
+		while (chunkIndex < m_ChunkCount)
+		{
+			(m_pLoader->*m_Function)(chunkIndex);
+			chunkIndex= m_pNextChunk->fetchAndAddOrdered(1);
+		}
+	}
+
+private:
+	//! The loader which owns the chunks
+	GLC_StlToWorld* m_pLoader;
+	//! The function which process a chunk
+	ChunkFunction m_Function;
+	//! The number of chunks
+	int m_ChunkCount;
+	//! The index of the next chunk to process
+	QAtomicInt* m_pNextChunk;
+};
 
 GLC_StlToWorld::GLC_StlToWorld()
 : QObject()
@@ -45,6 +211,24 @@ GLC_StlToWorld::GLC_StlToWorld()
 , m_VertexBulk()
 , m_NormalBulk()
 , m_CurrentIndex(0)
+, m_UseVertexWelding(true)
+, m_ComputeNormals(false)
+, m_pMappedData(NULL)
+, m_MappedSize(0)
+, m_ChunkCount(0)
+, m_FacetChunks()
+, m_FacetPositions()
+, m_FacetNormals()
+, m_FirstFacet(0)
+, m_CornerCount(0)
+, m_CornerHash()
+, m_PartitionOffset()
+, m_SortedCorners()
+, m_FirstEqualCorner()
+, m_ChunkFirstVertex()
+, m_CornerVertex()
+, m_WeldedPositions()
+, m_WeldedNormals()
 {
 
 }
@@ -77,6 +261,23 @@ GLC_World* GLC_StlToWorld::CreateWorldFromStl(QFile &file)
 	//////////////////////////////////////////////////////////////////
 	m_pWorld= new GLC_World;
 
+	if (GLC_State::isParallelLoadingActivated())
+	{
+		// Map the file and load it in parallel
+		GLC_MappedBuffer mappedFile(m_FileName, 0, file.size());
+		file.close();
+		if (!mappedFile.isValid())
+		{
+			QString message(QString("GLC_StlToWorld::CreateWorldFromStl File ") + m_FileName + QString(" cannot be read"));
+			GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotFound);
+			clear();
+			throw(fileFormatException);
+		}
+		loadMappedStl(static_cast<const char*>(mappedFile.constData(0)), mappedFile.size());
+
+		return m_pWorld;
+	}
+
 	// Create Working variables
 	int currentQuantumValue= 0;
 	int previousQuantumValue= 0;
@@ -173,6 +374,7 @@ void GLC_StlToWorld::clear()
 	m_CurrentLineNumber= 0;
 	m_pCurrentMesh= NULL;
 	m_CurrentFace.clear();
+	clearParallelLoadingData();
 }
 
 // Scan a line previously extracted from STL file
@@ -426,3 +628,562 @@ void GLC_StlToWorld::LoadBinariStl(QFile &file)
 	}
 }
 
+
+// Load the given mapped STL file in parallel
+void GLC_StlToWorld::loadMappedStl(const char* pData, qint64 size)
+{
+	m_pMappedData= pData;
+	m_MappedSize= size;
+
+	QList<int> solidFirstFacet;
+	QStringList solidNames;
+	int facetCount= 0;
+
+	// A binary STL is recognized by its size even if its header begins with "solid"
+	qint64 binaryFacetCount= 0;
+	if (size >= 84)
+	{
+		binaryFacetCount= qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(pData + 80));
+	}
+	const bool sizeIsBinary= (size >= 84) && ((84 + 50 * binaryFacetCount) == size);
+	const char* pHeader= pData;
+	while ((pHeader != (pData + size)) && isSpace(*pHeader)) ++pHeader;
+	const bool isAscii= !sizeIsBinary && tokenIs(pHeader, tokenEnd(pHeader, pData + size), "solid");
+
+	if (!isAscii)
+	{
+		if ((size < 84) || ((84 + 50 * binaryFacetCount) > size) || (binaryFacetCount > (std::numeric_limits<int>::max() / 9)))
+		{
+			QString message= "GLC_StlToWorld::loadMappedStl : Failed to read the facets of binary STL";
+			GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
+			clear();
+			throw(fileFormatException);
+		}
+		facetCount= static_cast<int>(binaryFacetCount);
+		m_FacetPositions.resize(9 * facetCount);
+		m_FacetNormals.resize(3 * facetCount);
+		m_ChunkCount= chunkCountOf(facetCount, facetsPerChunk);
+		processChunks(&GLC_StlToWorld::decodeBinaryChunk, m_ChunkCount, 0, 40);
+		solidFirstFacet.append(0);
+		solidNames.append(QString());
+	}
+	else
+	{
+		// Chunks begin on a facet keyword which is the first token of its line,
+		// solid names can contain the word facet
+		m_ChunkCount= chunkCountOf(size, bytesPerChunk);
+		m_FacetChunks.resize(m_ChunkCount);
+		qint64 offset= 0;
+		for (int i= 0; i < m_ChunkCount; ++i)
+		{
+			m_FacetChunks[i].m_Begin= offset;
+			offset= qMax(offset, (size * (i + 1)) / m_ChunkCount);
+			while ((offset < size) && (!isSpace(pData[offset - 1]) || !tokenIs(pData + offset, tokenEnd(pData + offset, pData + size), "facet")
+					|| !isFirstTokenOfLine(pData, offset)))
+			{
+				++offset;
+			}
+			m_FacetChunks[i].m_End= offset;
+		}
+		processChunks(&GLC_StlToWorld::parseAsciiChunk, m_ChunkCount, 0, 40);
+
+		for (int i= 0; i < m_ChunkCount; ++i)
+		{
+			const FacetChunk& chunk= m_FacetChunks.at(i);
+			if (-1 != chunk.m_ErrorOffset)
+			{
+				int lineNumber= 1;
+				for (qint64 j= 0; j < chunk.m_ErrorOffset; ++j)
+				{
+					if ('\n' == pData[j]) ++lineNumber;
+				}
+				QString message= "GLC_StlToWorld::parseAsciiChunk : " + chunk.m_Error;
+				message.append("\nAt line : ");
+				message.append(QString::number(lineNumber));
+				GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
+				clear();
+				throw(fileFormatException);
+			}
+			m_FacetChunks[i].m_FirstFacet= facetCount;
+			const int solidCount= chunk.m_SolidFirstFacet.size();
+			for (int j= 0; j < solidCount; ++j)
+			{
+				solidFirstFacet.append(facetCount + chunk.m_SolidFirstFacet.at(j));
+				solidNames.append(chunk.m_SolidNames.at(j));
+			}
+			facetCount+= chunk.m_Normals.size() / 3;
+		}
+		if (solidFirstFacet.isEmpty() || (solidFirstFacet.first() != 0))
+		{
+			solidFirstFacet.prepend(0);
+			solidNames.prepend(QString());
+		}
+		m_FacetPositions.resize(9 * facetCount);
+		m_FacetNormals.resize(3 * facetCount);
+		processChunks(&GLC_StlToWorld::copyAsciiChunk, m_ChunkCount, 40, 45);
+		m_FacetChunks.clear();
+	}
+
+	if (m_ComputeNormals)
+	{
+		m_ChunkCount= chunkCountOf(facetCount, facetsPerChunk);
+		processChunks(&GLC_StlToWorld::computeFacetNormalsChunk, m_ChunkCount, 45, 50);
+	}
+
+	// Create a mesh per solid
+	const int solidCount= solidFirstFacet.size();
+	for (int i= 0; i < solidCount; ++i)
+	{
+		const int firstFacet= solidFirstFacet.at(i);
+		const int lastFacet= (i + 1 < solidCount) ? solidFirstFacet.at(i + 1) : facetCount;
+		if (lastFacet > firstFacet)
+		{
+			const int firstQuantum= 50 + static_cast<int>((static_cast<double>(firstFacet) / facetCount) * 50);
+			const int lastQuantum= 50 + static_cast<int>((static_cast<double>(lastFacet) / facetCount) * 50);
+			createMesh(firstFacet, lastFacet, solidNames.at(i), firstQuantum, lastQuantum);
+		}
+	}
+	clearParallelLoadingData();
+}
+
+// Process the given number of chunks with the given function in parallel
+void GLC_StlToWorld::processChunks(ChunkFunction function, int chunkCount, int firstQuantum, int lastQuantum)
+{
+	if (chunkCount > 0)
+	{
+		const int threadCount= qBound(1, QThread::idealThreadCount(), chunkCount);
+		QAtomicInt nextChunk(0);
+
+		QThreadPool threadPool;
+		threadPool.setMaxThreadCount(threadCount);
+		for (int i= 0; i < threadCount; ++i)
+		{
+			threadPool.start(new ChunkRunner(this, function, chunkCount, &nextChunk));
+		}
+
+		// Progress bar indicator
+		int previousQuantumValue= firstQuantum;
+		while (!threadPool.waitForDone(100))
+		{
+			const double ratio= static_cast<double>(qMin(nextChunk.fetchAndAddOrdered(0), chunkCount)) / chunkCount;
+			const int currentQuantumValue= firstQuantum + static_cast<int>(ratio * (lastQuantum - firstQuantum));
+			if (currentQuantumValue > previousQuantumValue)
+			{
+				emit currentQuantum(currentQuantumValue);
+			}
+			previousQuantumValue= currentQuantumValue;
+		}
+	}
+	emit currentQuantum(lastQuantum);
+}
+
+// Decode binary facets of the given chunk
+void GLC_StlToWorld::decodeBinaryChunk(int chunkIndex)
+{
+	const int facetCount= m_FacetNormals.size() / 3;
+	const int begin= chunkBegin(chunkIndex, facetCount);
+	const int end= chunkBegin(chunkIndex + 1, facetCount);
+	GLfloat* pPositions= m_FacetPositions.data();
+	GLfloat* pNormals= m_FacetNormals.data();
+	for (int i= begin; i < end; ++i)
+	{
+		// Facet of 50 bytes : normal, 3 vertices and 2 fill-bytes
+		const uchar* pFacet= reinterpret_cast<const uchar*>(m_pMappedData) + 84 + 50 * static_cast<qint64>(i);
+		for (int j= 0; j < 3; ++j)
+		{
+			pNormals[3 * i + j]= littleEndianFloat(pFacet + 4 * j);
+		}
+		for (int j= 0; j < 9; ++j)
+		{
+			pPositions[9 * i + j]= littleEndianFloat(pFacet + 12 + 4 * j);
+		}
+	}
+}
+
+// Parse ASCII facets of the given chunk
+void GLC_StlToWorld::parseAsciiChunk(int chunkIndex)
+{
+	FacetChunk& chunk= m_FacetChunks[chunkIndex];
+	const char* pCurrent= m_pMappedData + chunk.m_Begin;
+	const char* pEnd= m_pMappedData + chunk.m_End;
+
+	// A facet takes more than 200 bytes
+	const int facetCountEstimate= static_cast<int>((chunk.m_End - chunk.m_Begin) / 200);
+	chunk.m_Positions.reserve(9 * facetCountEstimate);
+	chunk.m_Normals.reserve(3 * facetCountEstimate);
+
+	while (chunk.m_Error.isEmpty())
+	{
+		const char* pToken= pCurrent;
+		while ((pToken != pEnd) && isSpace(*pToken)) ++pToken;
+		if (pToken == pEnd) break;
+		pCurrent= tokenEnd(pToken, pEnd);
+
+		if (tokenIs(pToken, pCurrent, "facet"))
+		{
+			if (!readKeyword(&pCurrent, pEnd, "normal"))
+			{
+				chunk.m_Error= "\"facet normal\" not found!";
+			}
+			else if (!readVector(&pCurrent, pEnd, &chunk.m_Normals))
+			{
+				chunk.m_Error= "failed to convert vector component to float";
+			}
+			else if (!readKeyword(&pCurrent, pEnd, "outer") || !readKeyword(&pCurrent, pEnd, "loop"))
+			{
+				chunk.m_Error= "\"outer loop\" not found!";
+			}
+			for (int i= 0; (i < 3) && chunk.m_Error.isEmpty(); ++i)
+			{
+				if (!readKeyword(&pCurrent, pEnd, "vertex"))
+				{
+					chunk.m_Error= "\"vertex\" not found!";
+				}
+				else if (!readVector(&pCurrent, pEnd, &chunk.m_Positions))
+				{
+					chunk.m_Error= "failed to convert vector component to float";
+				}
+			}
+			if (chunk.m_Error.isEmpty() && !readKeyword(&pCurrent, pEnd, "endloop"))
+			{
+				chunk.m_Error= "\"endloop\" not found!";
+			}
+			else if (chunk.m_Error.isEmpty() && !readKeyword(&pCurrent, pEnd, "endfacet"))
+			{
+				chunk.m_Error= "\"endfacet\" not found!";
+			}
+		}
+		else if (tokenIs(pToken, pCurrent, "solid") || tokenIs(pToken, pCurrent, "endsolid") || tokenIs(pToken, pCurrent, "end"))
+		{
+			const char* pLineEnd= pCurrent;
+			while ((pLineEnd != pEnd) && (*pLineEnd != '\n') && (*pLineEnd != '\r')) ++pLineEnd;
+			if (tokenIs(pToken, pCurrent, "solid"))
+			{
+				chunk.m_SolidFirstFacet.append(chunk.m_Normals.size() / 3);
+				chunk.m_SolidNames.append(QString::fromLatin1(pCurrent, static_cast<int>(pLineEnd - pCurrent)).trimmed().toLower());
+			}
+			pCurrent= pLineEnd;
+		}
+		else
+		{
+			chunk.m_Error= "\"facet normal\" not found!";
+		}
+
+		if (!chunk.m_Error.isEmpty())
+		{
+			chunk.m_ErrorOffset= pToken - m_pMappedData;
+		}
+	}
+}
+
+// Copy ASCII facets of the given chunk in facets bulk data
+void GLC_StlToWorld::copyAsciiChunk(int chunkIndex)
+{
+	const FacetChunk& chunk= m_FacetChunks.at(chunkIndex);
+	const int facetCount= chunk.m_Normals.size() / 3;
+	memcpy(m_FacetPositions.data() + 9 * chunk.m_FirstFacet, chunk.m_Positions.constData(), 9 * facetCount * sizeof(GLfloat));
+	memcpy(m_FacetNormals.data() + 3 * chunk.m_FirstFacet, chunk.m_Normals.constData(), 3 * facetCount * sizeof(GLfloat));
+}
+
+// Replace facet normals of the given chunk by area weighted normals
+void GLC_StlToWorld::computeFacetNormalsChunk(int chunkIndex)
+{
+	const int facetCount= m_FacetNormals.size() / 3;
+	const int begin= chunkBegin(chunkIndex, facetCount);
+	const int end= chunkBegin(chunkIndex + 1, facetCount);
+	const GLfloat* pPositions= m_FacetPositions.constData();
+	GLfloat* pNormals= m_FacetNormals.data();
+	for (int i= begin; i < end; ++i)
+	{
+		const GLfloat* p= pPositions + 9 * i;
+		// Cross product of the edges, its length is twice the facet area
+		const GLfloat u[3]= {p[3] - p[0], p[4] - p[1], p[5] - p[2]};
+		const GLfloat v[3]= {p[6] - p[0], p[7] - p[1], p[8] - p[2]};
+		pNormals[3 * i]= u[1] * v[2] - u[2] * v[1];
+		pNormals[3 * i + 1]= u[2] * v[0] - u[0] * v[2];
+		pNormals[3 * i + 2]= u[0] * v[1] - u[1] * v[0];
+	}
+}
+
+// Hash corners of the given chunk and count them per partition
+void GLC_StlToWorld::hashCornersChunk(int chunkIndex)
+{
+	const int begin= chunkBegin(chunkIndex, m_CornerCount);
+	const int end= chunkBegin(chunkIndex + 1, m_CornerCount);
+	const GLfloat* pPositions= m_FacetPositions.constData() + 9 * m_FirstFacet;
+	const GLfloat* pNormals= m_FacetNormals.constData() + 3 * m_FirstFacet;
+	uint* pHash= m_CornerHash.data();
+	int* pCount= m_PartitionOffset.data() + chunkIndex * partitionCount;
+	for (int i= begin; i < end; ++i)
+	{
+		// Spatial hash of the position, mixed with the facet normal if vertices keep it
+		const GLfloat* pPosition= pPositions + 3 * i;
+		uint hash= (floatBits(pPosition[0]) * 73856093U) ^ (floatBits(pPosition[1]) * 19349663U) ^ (floatBits(pPosition[2]) * 83492791U);
+		if (!m_ComputeNormals)
+		{
+			const GLfloat* pNormal= pNormals + 3 * (i / 3);
+			hash^= (floatBits(pNormal[0]) * 2654435761U) ^ (floatBits(pNormal[1]) * 40503U) ^ (floatBits(pNormal[2]) * 2246822519U);
+		}
+		hash^= hash >> 16;
+		hash*= 0x85ebca6bU;
+		hash^= hash >> 13;
+		hash*= 0xc2b2ae35U;
+		hash^= hash >> 16;
+
+		pHash[i]= hash;
+		++pCount[hash >> (32 - partitionBits)];
+	}
+}
+
+// Sort corners of the given chunk by partition
+void GLC_StlToWorld::sortCornersChunk(int chunkIndex)
+{
+	const int begin= chunkBegin(chunkIndex, m_CornerCount);
+	const int end= chunkBegin(chunkIndex + 1, m_CornerCount);
+	const uint* pHash= m_CornerHash.constData();
+	int* pOffset= m_PartitionOffset.data() + chunkIndex * partitionCount;
+	int* pSortedCorners= m_SortedCorners.data();
+	for (int i= begin; i < end; ++i)
+	{
+		pSortedCorners[pOffset[pHash[i] >> (32 - partitionBits)]++]= i;
+	}
+}
+
+// Find the first equal corner of each corner of the given partition
+void GLC_StlToWorld::weldPartition(int partitionIndex)
+{
+	// After sorting, offsets of the last chunk are the end of partitions
+	const int* pPartitionEnd= m_PartitionOffset.constData() + (m_ChunkCount - 1) * partitionCount;
+	const int begin= (0 == partitionIndex) ? 0 : pPartitionEnd[partitionIndex - 1];
+	const int end= pPartitionEnd[partitionIndex];
+
+	// Open addressing hash table of corners, corners are inserted in file order
+	int tableSize= 16;
+	while (tableSize < (2 * (end - begin))) tableSize*= 2;
+	const uint mask= tableSize - 1;
+	QVector<int> table(tableSize, -1);
+	int* pTable= table.data();
+
+	const int* pSortedCorners= m_SortedCorners.constData();
+	const uint* pHash= m_CornerHash.constData();
+	int* pFirstEqualCorner= m_FirstEqualCorner.data();
+	for (int i= begin; i < end; ++i)
+	{
+		const int corner= pSortedCorners[i];
+		uint slot= pHash[corner] & mask;
+		while ((-1 != pTable[slot]) && ((pHash[pTable[slot]] != pHash[corner]) || !cornersAreEqual(pTable[slot], corner)))
+		{
+			slot= (slot + 1) & mask;
+		}
+		if (-1 == pTable[slot])
+		{
+			pTable[slot]= corner;
+		}
+		pFirstEqualCorner[corner]= pTable[slot];
+	}
+}
+
+// Count vertices of the given chunk
+void GLC_StlToWorld::countVerticesChunk(int chunkIndex)
+{
+	const int begin= chunkBegin(chunkIndex, m_CornerCount);
+	const int end= chunkBegin(chunkIndex + 1, m_CornerCount);
+	int count= end - begin;
+	if (m_UseVertexWelding)
+	{
+		count= 0;
+		const int* pFirstEqualCorner= m_FirstEqualCorner.constData();
+		for (int i= begin; i < end; ++i)
+		{
+			if (pFirstEqualCorner[i] == i) ++count;
+		}
+	}
+	m_ChunkFirstVertex[chunkIndex]= count;
+}
+
+// Number vertices of the given chunk and copy their data
+void GLC_StlToWorld::numberVerticesChunk(int chunkIndex)
+{
+	const int begin= chunkBegin(chunkIndex, m_CornerCount);
+	const int end= chunkBegin(chunkIndex + 1, m_CornerCount);
+	const GLfloat* pPositions= m_FacetPositions.constData() + 9 * m_FirstFacet;
+	const GLfloat* pNormals= m_FacetNormals.constData() + 3 * m_FirstFacet;
+	const int* pFirstEqualCorner= m_FirstEqualCorner.constData();
+	GLuint* pCornerVertex= m_CornerVertex.data();
+	GLfloat* pWeldedPositions= m_WeldedPositions.data();
+	GLfloat* pWeldedNormals= m_WeldedNormals.data();
+
+	GLuint vertex= m_ChunkFirstVertex.at(chunkIndex);
+	for (int i= begin; i < end; ++i)
+	{
+		if (!m_UseVertexWelding || (pFirstEqualCorner[i] == i))
+		{
+			pCornerVertex[i]= vertex;
+			memcpy(pWeldedPositions + 3 * vertex, pPositions + 3 * i, 3 * sizeof(GLfloat));
+			if (!m_ComputeNormals)
+			{
+				memcpy(pWeldedNormals + 3 * vertex, pNormals + 3 * (i / 3), 3 * sizeof(GLfloat));
+			}
+			++vertex;
+		}
+	}
+}
+
+// Set vertex index of welded corners of the given chunk
+void GLC_StlToWorld::indexCornersChunk(int chunkIndex)
+{
+	const int begin= chunkBegin(chunkIndex, m_CornerCount);
+	const int end= chunkBegin(chunkIndex + 1, m_CornerCount);
+	const int* pFirstEqualCorner= m_FirstEqualCorner.constData();
+	GLuint* pCornerVertex= m_CornerVertex.data();
+	for (int i= begin; i < end; ++i)
+	{
+		// The first equal corner has been numbered by numberVerticesChunk
+		const int firstEqualCorner= pFirstEqualCorner[i];
+		if (firstEqualCorner != i)
+		{
+			pCornerVertex[i]= pCornerVertex[firstEqualCorner];
+		}
+	}
+}
+
+// Create the mesh of the given range of facets
+void GLC_StlToWorld::createMesh(int firstFacet, int lastFacet, const QString& name, int firstQuantum, int lastQuantum)
+{
+	m_FirstFacet= firstFacet;
+	m_CornerCount= 3 * (lastFacet - firstFacet);
+	m_ChunkCount= chunkCountOf(m_CornerCount, cornersPerChunk);
+	const int quantumStep= (lastQuantum - firstQuantum) / 4;
+
+	if (m_UseVertexWelding)
+	{
+		m_CornerHash.resize(m_CornerCount);
+		m_PartitionOffset.fill(0, m_ChunkCount * partitionCount);
+		processChunks(&GLC_StlToWorld::hashCornersChunk, m_ChunkCount, firstQuantum, firstQuantum + quantumStep);
+
+		// Convert corners count to offsets, in a partition corners are sorted by chunk
+		int offset= 0;
+		for (int partition= 0; partition < partitionCount; ++partition)
+		{
+			for (int chunk= 0; chunk < m_ChunkCount; ++chunk)
+			{
+				int& value= m_PartitionOffset[chunk * partitionCount + partition];
+				const int count= value;
+				value= offset;
+				offset+= count;
+			}
+		}
+		m_SortedCorners.resize(m_CornerCount);
+		processChunks(&GLC_StlToWorld::sortCornersChunk, m_ChunkCount, firstQuantum + quantumStep, firstQuantum + 2 * quantumStep);
+
+		m_FirstEqualCorner.resize(m_CornerCount);
+		processChunks(&GLC_StlToWorld::weldPartition, partitionCount, firstQuantum + 2 * quantumStep, firstQuantum + 3 * quantumStep);
+		m_SortedCorners.clear();
+		m_CornerHash.clear();
+		m_PartitionOffset.clear();
+	}
+
+	// Number vertices in file order
+	m_ChunkFirstVertex.resize(m_ChunkCount);
+	processChunks(&GLC_StlToWorld::countVerticesChunk, m_ChunkCount, firstQuantum + 3 * quantumStep, firstQuantum + 3 * quantumStep);
+	int vertexCount= 0;
+	for (int i= 0; i < m_ChunkCount; ++i)
+	{
+		const int count= m_ChunkFirstVertex.at(i);
+		m_ChunkFirstVertex[i]= vertexCount;
+		vertexCount+= count;
+	}
+	m_WeldedPositions.resize(3 * vertexCount);
+	m_WeldedNormals.resize(3 * vertexCount);
+	m_CornerVertex.resize(m_CornerCount);
+	processChunks(&GLC_StlToWorld::numberVerticesChunk, m_ChunkCount, firstQuantum + 3 * quantumStep, firstQuantum + 3 * quantumStep);
+	if (m_UseVertexWelding)
+	{
+		processChunks(&GLC_StlToWorld::indexCornersChunk, m_ChunkCount, firstQuantum + 3 * quantumStep, lastQuantum);
+		m_FirstEqualCorner.clear();
+	}
+
+	if (m_ComputeNormals)
+	{
+		// Sum area weighted normals of the facets which share a vertex
+		const GLfloat* pNormals= m_FacetNormals.constData() + 3 * m_FirstFacet;
+		GLfloat* pWeldedNormals= m_WeldedNormals.data();
+		for (int i= 0; i < m_CornerCount; ++i)
+		{
+			GLfloat* pNormal= pWeldedNormals + 3 * m_CornerVertex.at(i);
+			const GLfloat* pFacetNormal= pNormals + 3 * (i / 3);
+			pNormal[0]+= pFacetNormal[0];
+			pNormal[1]+= pFacetNormal[1];
+			pNormal[2]+= pFacetNormal[2];
+		}
+		for (int i= 0; i < vertexCount; ++i)
+		{
+			GLfloat* pNormal= pWeldedNormals + 3 * i;
+			const GLfloat length= sqrt(pNormal[0] * pNormal[0] + pNormal[1] * pNormal[1] + pNormal[2] * pNormal[2]);
+			if (length > 0.0f)
+			{
+				pNormal[0]/= length;
+				pNormal[1]/= length;
+				pNormal[2]/= length;
+			}
+		}
+	}
+
+	IndexList indexList;
+	indexList.reserve(m_CornerCount);
+	for (int i= 0; i < m_CornerCount; ++i)
+	{
+		indexList.append(m_CornerVertex.at(i));
+	}
+	m_CornerVertex.clear();
+
+	m_pCurrentMesh= new GLC_Mesh();
+	m_pCurrentMesh->setName(name);
+	m_pCurrentMesh->addTriangles(NULL, indexList);
+	m_pCurrentMesh->addVertice(m_WeldedPositions);
+	m_WeldedPositions.clear();
+	m_pCurrentMesh->addNormals(m_WeldedNormals);
+	m_WeldedNormals.clear();
+	m_pCurrentMesh->finish();
+	GLC_3DRep* pRep= new GLC_3DRep(m_pCurrentMesh);
+	m_pCurrentMesh= NULL;
+	m_pWorld->rootOccurence()->addChild(new GLC_StructOccurence(pRep));
+}
+
+// Return true if the given corners have the same position and normal
+bool GLC_StlToWorld::cornersAreEqual(int corner1, int corner2) const
+{
+	const GLfloat* pPositions= m_FacetPositions.constData() + 9 * m_FirstFacet;
+	const GLfloat* pPosition1= pPositions + 3 * corner1;
+	const GLfloat* pPosition2= pPositions + 3 * corner2;
+	bool subject= (pPosition1[0] == pPosition2[0]) && (pPosition1[1] == pPosition2[1]) && (pPosition1[2] == pPosition2[2]);
+	if (subject && !m_ComputeNormals)
+	{
+		const GLfloat* pNormals= m_FacetNormals.constData() + 3 * m_FirstFacet;
+		const GLfloat* pNormal1= pNormals + 3 * (corner1 / 3);
+		const GLfloat* pNormal2= pNormals + 3 * (corner2 / 3);
+		subject= (pNormal1[0] == pNormal2[0]) && (pNormal1[1] == pNormal2[1]) && (pNormal1[2] == pNormal2[2]);
+	}
+	return subject;
+}
+
+// Release parallel loading working data
+void GLC_StlToWorld::clearParallelLoadingData()
+{
+	m_pMappedData= NULL;
+	m_MappedSize= 0;
+	m_ChunkCount= 0;
+	m_FacetChunks.clear();
+	m_FacetPositions.clear();
+	m_FacetNormals.clear();
+	m_FirstFacet= 0;
+	m_CornerCount= 0;
+	m_CornerHash.clear();
+	m_PartitionOffset.clear();
+	m_SortedCorners.clear();
+	m_FirstEqualCorner.clear();
+	m_ChunkFirstVertex.clear();
+	m_CornerVertex.clear();
+	m_WeldedPositions.clear();
+	m_WeldedNormals.clear();
+}
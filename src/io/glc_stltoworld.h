@@ -29,6 +29,8 @@
 #include <QObject>
 #include <QFile>
 #include <QTextStream>
+#include <QVector>
+#include <QStringList>
 
 #include "../geometry/glc_mesh.h"
 #include "../maths/glc_vector3df.h"
@@ -47,12 +49,29 @@ class QGLContext;
  * 		- Vertex
  * 		- Face
  * 		- Normal coordinate
+ *
+ * 	If parallel loading is activated (See GLC_State::setParallelLoadingUsage) the file is mapped
+ * 	and facets are decoded in parallel chunks. Duplicate vertices are then welded with a parallel
+ * 	spatial hash to create indexed meshes. Vertices are only welded if their facet normals are equal
+ * 	unless normals computing is used, in this case smooth normals are computed from the welded triangles.
   */
 //////////////////////////////////////////////////////////////////////
 
 class GLC_LIB_EXPORT GLC_StlToWorld : public QObject
 {
 	Q_OBJECT
+
+	//! \class ChunkRunner
+	/*! \brief ChunkRunner : Runnable which processes chunks of the parallel loading */
+	class ChunkRunner;
+	friend class ChunkRunner;
+
+	//! \struct FacetChunk
+	/*! \brief FacetChunk : Facets parsed from a chunk of an ASCII STL file */
+	struct FacetChunk;
+
+	//! Member function which processes the chunk of the given index
+	typedef void (GLC_StlToWorld::*ChunkFunction)(int);
 //////////////////////////////////////////////////////////////////////
 /*! @name Constructor / Destructor */
 //@{
@@ -61,6 +80,20 @@ public:
 	GLC_StlToWorld();
 	virtual ~GLC_StlToWorld();
 //@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return true if duplicate vertices are welded by the parallel loading
+	inline bool vertexWeldingIsUsed() const
+	{return m_UseVertexWelding;}
+
+	//! Return true if normals are computed by the parallel loading
+	inline bool normalsComputingIsUsed() const
+	{return m_ComputeNormals;}
+//@}
 //////////////////////////////////////////////////////////////////////
 /*! @name Set Functions*/
 //@{
@@ -68,6 +101,15 @@ public:
 public:
 	//! Create and return an GLC_World* from an input STL File
 	GLC_World* CreateWorldFromStl(QFile &file);
+
+	//! Set the vertex welding usage of the parallel loading (Default true)
+	inline void setVertexWeldingUsage(bool usage)
+	{m_UseVertexWelding= usage;}
+
+	//! Set the normals computing usage of the parallel loading (Default false)
+	/*! If used, facet normals of the file are ignored and smooth normals are computed*/
+	inline void setNormalsComputingUsage(bool usage)
+	{m_ComputeNormals= usage;}
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -84,7 +126,54 @@ private:
 	//! Load Binarie STL File
 	void LoadBinariStl(QFile &);
 
+	//! Load the given mapped STL file in parallel
+	void loadMappedStl(const char* pData, qint64 size);
+
+	//! Process the given number of chunks with the given function in parallel and emit progress in the given range
+	void processChunks(ChunkFunction function, int chunkCount, int firstQuantum, int lastQuantum);
+
+	//! Decode binary facets of the given chunk
+	void decodeBinaryChunk(int chunkIndex);
+
+	//! Parse ASCII facets of the given chunk
+	void parseAsciiChunk(int chunkIndex);
+
+	//! Copy ASCII facets of the given chunk in facets bulk data
+	void copyAsciiChunk(int chunkIndex);
+
+	//! Replace facet normals of the given chunk by area weighted normals
+	void computeFacetNormalsChunk(int chunkIndex);
+
+	//! Hash corners of the given chunk and count them per partition
+	void hashCornersChunk(int chunkIndex);
+
+	//! Sort corners of the given chunk by partition
+	void sortCornersChunk(int chunkIndex);
+
+	//! Find the first equal corner of each corner of the given partition
+	void weldPartition(int partitionIndex);
+
+	//! Count vertices of the given chunk
+	void countVerticesChunk(int chunkIndex);
+
+	//! Number vertices of the given chunk and copy their data
+	void numberVerticesChunk(int chunkIndex);
 
+	//! Set vertex index of welded corners of the given chunk
+	void indexCornersChunk(int chunkIndex);
+
+	//! Create the mesh of the given range of facets
+	void createMesh(int firstFacet, int lastFacet, const QString& name, int firstQuantum, int lastQuantum);
+
+	//! Return the begin of the given chunk of the given number of elements
+	inline int chunkBegin(int chunkIndex, int size) const
+	{return static_cast<int>((static_cast<qint64>(size) * chunkIndex) / m_ChunkCount);}
+
+	//! Return true if the given corners have the same position and normal
+	bool cornersAreEqual(int corner1, int corner2) const;
+
+	//! Release parallel loading working data
+	void clearParallelLoadingData();
 
 //@}
 
@@ -124,6 +213,60 @@ private:
 
 	//! The current index
 	GLuint m_CurrentIndex;
+
+	//! Vertex welding usage of the parallel loading
+	bool m_UseVertexWelding;
+
+	//! Normals computing usage of the parallel loading
+	bool m_ComputeNormals;
+
+	//! The mapped file data
+	const char* m_pMappedData;
+
+	//! The size of the mapped file data
+	qint64 m_MappedSize;
+
+	//! The current number of chunks
+	int m_ChunkCount;
+
+	//! Facets parsed from ASCII chunks
+	QVector<FacetChunk> m_FacetChunks;
+
+	//! Facets positions bulk data (9 floats per facet)
+	GLfloatVector m_FacetPositions;
+
+	//! Facets normals bulk data (3 floats per facet)
+	GLfloatVector m_FacetNormals;
+
+	//! The first facet of the mesh being created
+	int m_FirstFacet;
+
+	//! The number of corners of the mesh being created
+	int m_CornerCount;
+
+	//! Hash of corners
+	QVector<uint> m_CornerHash;
+
+	//! Number of corners per chunk and partition, then offset in sorted corners
+	QVector<int> m_PartitionOffset;
+
+	//! Corners sorted by partition
+	QVector<int> m_SortedCorners;
+
+	//! The first corner equal to each corner
+	QVector<int> m_FirstEqualCorner;
+
+	//! The first vertex of each chunk
+	QVector<int> m_ChunkFirstVertex;
+
+	//! The vertex index of each corner
+	QVector<GLuint> m_CornerVertex;
+
+	//! Welded vertices positions
+	GLfloatVector m_WeldedPositions;
+
+	//! Welded vertices normals
+	GLfloatVector m_WeldedNormals;
 };
 
 #endif /*GLC_STLTOWORLD_H_*/
@@ -0,0 +1,427 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_worldloader.cpp implementation of the GLC_WorldLoader class.
+
+#include "glc_worldloader.h"
+#include "glc_fileloader.h"
+#include "glc_3dxmltoworld.h"
+
+#include "../sceneGraph/glc_structoccurence.h"
+#include "../sceneGraph/glc_structreference.h"
+#include "../geometry/glc_3drep.h"
+#include "../glc_exception.h"
+#include "../glc_errorlog.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSet>
+
+// Runnable which runs the loading of a world loader
+class GLC_WorldLoader::LoadTask : public QRunnable
+{
+public:
+	inline LoadTask(GLC_WorldLoader* pLoader)
+	: QRunnable()
+	, m_pLoader(pLoader)
+	{}
+
+	//! Run the loading
+	virtual void run()
+	{m_pLoader->run();}
+
+private:
+	//! The world loader of the task
+	GLC_WorldLoader* m_pLoader;
+};
+
+GLC_WorldLoader::GLC_WorldLoader(QObject* pParent)
+: QObject(pParent)
+, m_FileName()
+, m_LodAccuracies()
+, m_UseStlVertexWelding(true)
+, m_ComputeStlNormals(false)
+, m_World()
+, m_pLoadedWorld(NULL)
+, m_AttachedFileNames()
+, m_LoadedRepresentations()
+, m_ErrorMessage()
+, m_IsRunning(false)
+, m_StructureIsLoaded(false)
+, m_StructureIsFirst(false)
+, m_Mutex()
+, m_ThreadPool()
+, m_ReadWriteLock()
+, m_IsInterupted(false)
+{
+	// The loadings of this loader are run one after the other
+	m_ThreadPool.setMaxThreadCount(1);
+}
+
+GLC_WorldLoader::~GLC_WorldLoader()
+{
+	cancel();
+	wait();
+
+	delete m_pLoadedWorld;
+	const int size= m_LoadedRepresentations.size();
+	for (int i= 0; i < size; ++i)
+	{
+		delete m_LoadedRepresentations.at(i).second;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+bool GLC_WorldLoader::isRunning() const
+{
+	QMutexLocker locker(&m_Mutex);
+	return m_IsRunning;
+}
+
+bool GLC_WorldLoader::isCanceled() const
+{
+	QReadLocker locker(&m_ReadWriteLock);
+	return m_IsInterupted;
+}
+
+bool GLC_WorldLoader::structureIsLoaded() const
+{
+	QMutexLocker locker(&m_Mutex);
+	return m_StructureIsLoaded;
+}
+
+bool GLC_WorldLoader::hasFailed() const
+{
+	QMutexLocker locker(&m_Mutex);
+	return !m_ErrorMessage.isEmpty();
+}
+
+QString GLC_WorldLoader::errorMessage() const
+{
+	QMutexLocker locker(&m_Mutex);
+	return m_ErrorMessage;
+}
+
+GLC_World GLC_WorldLoader::world() const
+{
+	QMutexLocker locker(&m_Mutex);
+	if (NULL != m_pLoadedWorld)
+	{
+		m_World= *m_pLoadedWorld;
+		delete m_pLoadedWorld;
+		m_pLoadedWorld= NULL;
+	}
+	return m_World;
+}
+
+QStringList GLC_WorldLoader::listOfAttachedFileName() const
+{
+	QMutexLocker locker(&m_Mutex);
+	return m_AttachedFileNames;
+}
+
+int GLC_WorldLoader::loadedRepresentationCount() const
+{
+	QMutexLocker locker(&m_Mutex);
+	return m_LoadedRepresentations.size();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+bool GLC_WorldLoader::load(const QString& fileName)
+{
+	{
+		QMutexLocker locker(&m_Mutex);
+		if (m_IsRunning) return false;
+
+		m_FileName= fileName;
+		m_World= GLC_World();
+		delete m_pLoadedWorld;
+		m_pLoadedWorld= NULL;
+		const int size= m_LoadedRepresentations.size();
+		for (int i= 0; i < size; ++i)
+		{
+			delete m_LoadedRepresentations.at(i).second;
+		}
+		m_LoadedRepresentations.clear();
+		m_AttachedFileNames.clear();
+		m_ErrorMessage.clear();
+		m_StructureIsLoaded= false;
+		m_StructureIsFirst= false;
+		m_IsRunning= true;
+	}
+	{
+		QWriteLocker locker(&m_ReadWriteLock);
+		m_IsInterupted= false;
+	}
+
+	m_ThreadPool.start(new LoadTask(this));
+	return true;
+}
+
+void GLC_WorldLoader::cancel()
+{
+	QWriteLocker locker(&m_ReadWriteLock);
+	m_IsInterupted= true;
+}
+
+void GLC_WorldLoader::wait()
+{
+	// The loading task has returned once the thread pool is done
+	m_ThreadPool.waitForDone();
+}
+
+int GLC_WorldLoader::publishRepresentations()
+{
+	QList<LoadedRepresentation> loadedRepresentations;
+	{
+		QMutexLocker locker(&m_Mutex);
+		loadedRepresentations.swap(m_LoadedRepresentations);
+	}
+
+	// The references are found in the current world, the world can have been cleared
+	const GLC_World currentWorld(world());
+	int publishedCount= 0;
+	const int size= loadedRepresentations.size();
+	for (int i= 0; i < size; ++i)
+	{
+		const GLC_uint occurenceId= loadedRepresentations.at(i).first;
+		GLC_3DRep* pLoadedRep= loadedRepresentations.at(i).second;
+		try
+		{
+			if (currentWorld.containsOccurence(occurenceId))
+			{
+				GLC_StructOccurence* pOccurence= currentWorld.occurence(occurenceId);
+				GLC_3DRep* pRep= NULL;
+				if (pOccurence->hasRepresentation())
+				{
+					pRep= dynamic_cast<GLC_3DRep*>(pOccurence->structReference()->representationHandle());
+				}
+				if ((NULL != pRep) && pOccurence->structReference()->takeLoadedRepresentation(pLoadedRep))
+				{
+					++publishedCount;
+				}
+			}
+		}
+		catch (GLC_Exception& e)
+		{
+			// The other representations are published
+			QStringList errorList("GLC_WorldLoader::publishRepresentations");
+			errorList.append(QString(e.what()));
+			GLC_ErrorLog::addError(errorList);
+		}
+		delete pLoadedRep;
+	}
+
+	return publishedCount;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private slots
+//////////////////////////////////////////////////////////////////////
+
+void GLC_WorldLoader::structureQuantum(int quantum)
+{
+	// The structure is the first half of a structure first loading
+	if (m_StructureIsFirst)
+	{
+		emit currentQuantum(quantum / 2);
+	}
+	else
+	{
+		emit currentQuantum(quantum);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_WorldLoader::run()
+{
+	QFile file(m_FileName);
+	try
+	{
+		if (!continu())
+		{
+			// Canceled before the loading has started
+		}
+		else if (QFileInfo(file).suffix().toLower() == "3dxml")
+		{
+			loadStructureFirst(file);
+		}
+		else
+		{
+			loadWorld(file);
+		}
+	}
+	catch (GLC_Exception& e)
+	{
+		setError(QString(e.what()));
+	}
+
+	{
+		QMutexLocker locker(&m_Mutex);
+		m_IsRunning= false;
+	}
+	// The destructor waits for the return of this function
+	emit finished();
+}
+
+void GLC_WorldLoader::loadStructureFirst(QFile& file)
+{
+	m_StructureIsFirst= true;
+
+	GLC_World* pWorld= NULL;
+	QStringList attachedFileNames;
+	{
+		GLC_3dxmlToWorld d3dxmlToWorld;
+		connect(&d3dxmlToWorld, SIGNAL(currentQuantum(int)), this, SLOT(structureQuantum(int)), Qt::DirectConnection);
+		pWorld= d3dxmlToWorld.createWorldFrom3dxml(file, true);
+		attachedFileNames= d3dxmlToWorld.listOfAttachedFileName();
+	}
+	if (NULL == pWorld)
+	{
+		setError(QString("GLC_WorldLoader::loadStructureFirst File ") + file.fileName() + QString(" not loaded"));
+		return;
+	}
+
+	// The references to load are collected before the world is given to its thread,
+	// they are identified by the id of one of their occurences
+	QList<GLC_StructReference*> references;
+	QList<GLC_uint> occurenceIds;
+	QSet<GLC_StructReference*> referenceSet;
+	const QList<GLC_StructOccurence*> occurences(pWorld->listOfOccurence());
+	const int occurenceCount= occurences.size();
+	for (int i= 0; i < occurenceCount; ++i)
+	{
+		GLC_StructOccurence* pOccurence= occurences.at(i);
+		if (!pOccurence->hasRepresentation()) continue;
+		GLC_StructReference* pReference= pOccurence->structReference();
+		GLC_3DRep* pRep= dynamic_cast<GLC_3DRep*>(pReference->representationHandle());
+		if ((NULL != pRep) && !pRep->isLoaded() && !pRep->fileName().isEmpty() && !referenceSet.contains(pReference))
+		{
+			referenceSet.insert(pReference);
+			references.append(pReference);
+			occurenceIds.append(pOccurence->id());
+		}
+	}
+	QStringList repFileNames;
+	const int referenceCount= references.size();
+	for (int i= 0; i < referenceCount; ++i)
+	{
+		repFileNames.append(references.at(i)->representationHandle()->fileName());
+	}
+
+	{
+		QMutexLocker locker(&m_Mutex);
+		m_AttachedFileNames= attachedFileNames;
+	}
+	setLoadedWorld(pWorld);
+
+	// The representations are loaded one by one until the loading is canceled
+	for (int i= 0; (i < referenceCount) && continu(); ++i)
+	{
+		try
+		{
+			GLC_3dxmlToWorld repLoader;
+			repLoader.setLodAccuracies(m_LodAccuracies);
+			GLC_3DRep rep(repLoader.create3DrepFrom3dxmlRep(repFileNames.at(i)));
+			if (!rep.isEmpty())
+			{
+				GLC_3DRep* pLoadedRep= new GLC_3DRep();
+				pLoadedRep->take(&rep);
+				QMutexLocker locker(&m_Mutex);
+				m_LoadedRepresentations.append(qMakePair(occurenceIds.at(i), pLoadedRep));
+			}
+		}
+		catch (GLC_Exception& e)
+		{
+			// A representation which can't be loaded doesn't stop the loading of the others
+			QStringList errorList("GLC_WorldLoader::loadStructureFirst");
+			errorList.append(QString(e.what()));
+			GLC_ErrorLog::addError(errorList);
+		}
+		emit representationsLoaded();
+		emit currentQuantum(50 + ((i + 1) * 50) / referenceCount);
+	}
+}
+
+void GLC_WorldLoader::loadWorld(QFile& file)
+{
+	m_StructureIsFirst= false;
+
+	GLC_World* pWorld= NULL;
+	QStringList attachedFileNames;
+	{
+		GLC_FileLoader fileLoader;
+		fileLoader.setLodAccuracies(m_LodAccuracies);
+		fileLoader.setStlVertexWeldingUsage(m_UseStlVertexWelding);
+		fileLoader.setStlNormalsComputingUsage(m_ComputeStlNormals);
+		connect(&fileLoader, SIGNAL(currentQuantum(int)), this, SLOT(structureQuantum(int)), Qt::DirectConnection);
+		pWorld= new GLC_World(fileLoader.createWorldFromFile(file, &attachedFileNames));
+	}
+
+	// The parsers do not poll the cancellation, a world loaded after cancel() is dropped
+	if (continu())
+	{
+		{
+			QMutexLocker locker(&m_Mutex);
+			m_AttachedFileNames= attachedFileNames;
+		}
+		setLoadedWorld(pWorld);
+	}
+	else
+	{
+		delete pWorld;
+	}
+}
+
+void GLC_WorldLoader::setLoadedWorld(GLC_World* pWorld)
+{
+	{
+		QMutexLocker locker(&m_Mutex);
+		delete m_pLoadedWorld;
+		m_pLoadedWorld= pWorld;
+		m_StructureIsLoaded= true;
+	}
+	emit structureLoaded();
+}
+
+void GLC_WorldLoader::setError(const QString& message)
+{
+	QMutexLocker locker(&m_Mutex);
+	m_ErrorMessage= message;
+}
+
+bool GLC_WorldLoader::continu()
+{
+	QReadLocker locker(&m_ReadWriteLock);
+	return !m_IsInterupted;
+}
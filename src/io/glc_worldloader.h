@@ -0,0 +1,263 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_worldloader.h interface for the GLC_WorldLoader class.
+
+#ifndef GLC_WORLDLOADER_H_
+#define GLC_WORLDLOADER_H_
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QPair>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QThreadPool>
+
+#include "../sceneGraph/glc_world.h"
+
+#include "../glc_config.h"
+
+class GLC_3DRep;
+class QFile;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_WorldLoader
+/*! \brief GLC_WorldLoader : Load a GLC_World from file on a worker thread */
+
+/*! load() returns immediately and the file is parsed on a worker thread by
+ *  the loader of its suffix. The loading can be canceled with cancel(), the
+ *  loader checks the cancellation between its steps.
+ *
+ *  3DXML files are loaded structure first : structureLoaded() is emitted once
+ *  the world is available with unloaded representations, then the representations
+ *  are loaded one by one. The loaded representations are added to the world by
+ *  publishRepresentations(), which must be called in the thread of the world,
+ *  representationsLoaded() is emitted when new representations can be published.
+ *  Other files are loaded in one step and structureLoaded() is emitted with the
+ *  complete world.
+ *
+ *  The structure of the world must not be changed until finished() is emitted.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_WorldLoader : public QObject
+{
+	Q_OBJECT
+
+	//! Runnable which runs the loading
+	class LoadTask;
+
+	//! A loaded representation and the id of an occurence of its reference
+	/*! The reference is found in the world when the representation is published*/
+	typedef QPair<GLC_uint, GLC_3DRep*> LoadedRepresentation;
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	GLC_WorldLoader(QObject* pParent= NULL);
+
+	//! Destructor, cancel the loading and wait for the worker thread
+	virtual ~GLC_WorldLoader();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return the name of the loaded file
+	inline QString fileName() const
+	{return m_FileName;}
+
+	//! Return the relative accuracies of the LODs built for loaded meshes
+	inline QList<double> lodAccuracies() const
+	{return m_LodAccuracies;}
+
+	//! Return true if duplicate vertices of loaded STL files are welded
+	inline bool stlVertexWeldingIsUsed() const
+	{return m_UseStlVertexWelding;}
+
+	//! Return true if smooth normals of loaded STL files are computed
+	inline bool stlNormalsComputingIsUsed() const
+	{return m_ComputeStlNormals;}
+
+	//! Return true if the loading is running
+	bool isRunning() const;
+
+	//! Return true if the loading has been canceled
+	bool isCanceled() const;
+
+	//! Return true if the structure of the world is loaded
+	bool structureIsLoaded() const;
+
+	//! Return true if the loading has failed
+	bool hasFailed() const;
+
+	//! Return the error message of a failed loading
+	QString errorMessage() const;
+
+	//! Return the loaded world, an empty world until the structure is loaded
+	GLC_World world() const;
+
+	//! Return the list of attached files of the loaded file
+	QStringList listOfAttachedFileName() const;
+
+	//! Return the number of loaded representations which are not published
+	int loadedRepresentationCount() const;
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Set the relative accuracies of the LODs built for loaded meshes
+	inline void setLodAccuracies(const QList<double>& accuracies)
+	{m_LodAccuracies= accuracies;}
+
+	//! Set the vertex welding usage of loaded STL files (Default true) \see GLC_StlToWorld
+	inline void setStlVertexWeldingUsage(bool usage)
+	{m_UseStlVertexWelding= usage;}
+
+	//! Set the smooth normals computing usage of loaded STL files (Default false) \see GLC_StlToWorld
+	inline void setStlNormalsComputingUsage(bool usage)
+	{m_ComputeStlNormals= usage;}
+
+	//! Start the loading of the given file, return false if a loading is running
+	bool load(const QString& fileName);
+
+	//! Ask the loading to stop, the loaded part of the world is kept
+	void cancel();
+
+	//! Wait until the loading is finished
+	void wait();
+
+	//! Add the loaded representations to the world and return their number
+	/*! Must be called in the thread of the world. The representations of the
+	 *  references which are no more in the world are dropped*/
+	int publishRepresentations();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Qt Signals
+//////////////////////////////////////////////////////////////////////
+	signals:
+	void currentQuantum(int);
+
+	//! Emitted when the structure of the world is loaded
+	void structureLoaded();
+
+	//! Emitted when loaded representations can be published
+	void representationsLoaded();
+
+	//! Emitted when the loading is finished, failed or canceled
+	void finished();
+
+//////////////////////////////////////////////////////////////////////
+// Private slots
+//////////////////////////////////////////////////////////////////////
+private slots:
+	//! Emit the quantum of the structure loading
+	void structureQuantum(int quantum);
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Run the loading in the worker thread
+	void run();
+
+	//! Load the structure of the given 3DXML file and then its representations
+	void loadStructureFirst(QFile& file);
+
+	//! Load the given file in one step
+	void loadWorld(QFile& file);
+
+	//! Set the world created by the worker thread and take its ownership
+	void setLoadedWorld(GLC_World* pWorld);
+
+	//! Set the loading error
+	void setError(const QString& message);
+
+	//! Return true if the loading must continue
+	bool continu();
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	Q_DISABLE_COPY(GLC_WorldLoader)
+
+	//! The name of the loaded file
+	QString m_FileName;
+
+	//! The relative accuracies of the LODs built for loaded meshes
+	QList<double> m_LodAccuracies;
+
+	//! Vertex welding usage of loaded STL files
+	bool m_UseStlVertexWelding;
+
+	//! Smooth normals computing usage of loaded STL files
+	bool m_ComputeStlNormals;
+
+	//! The loaded world, handled in the thread of the world
+	mutable GLC_World m_World;
+
+	//! The world created by the worker thread until world() takes it
+	mutable GLC_World* m_pLoadedWorld;
+
+	//! The list of attached files of the loaded file
+	QStringList m_AttachedFileNames;
+
+	//! The loaded representations which are not published
+	QList<LoadedRepresentation> m_LoadedRepresentations;
+
+	//! The error message of a failed loading
+	QString m_ErrorMessage;
+
+	//! Flag to know if the loading is running
+	bool m_IsRunning;
+
+	//! Flag to know if the structure is loaded
+	bool m_StructureIsLoaded;
+
+	//! Flag to know if the quantum of the structure is a part of the loading
+	bool m_StructureIsFirst;
+
+	//! The mutex of the loading state and results
+	mutable QMutex m_Mutex;
+
+	//! The thread pool of the loading, the loader waits for it before being deleted
+	QThreadPool m_ThreadPool;
+
+	//! The lock of the interruption flag
+	mutable QReadWriteLock m_ReadWriteLock;
+
+	//! Flag to know if the loading must be interupted
+	bool m_IsInterupted;
+};
+
+#endif /* GLC_WORLDLOADER_H_ */
@@ -77,6 +77,7 @@ bool GLC_WorldTo3ds::exportToFile(const QString& fileName, bool useAbsolutePosit
 	m_TextureToFileName.clear();
 
 	m_FileName= fileName;
+	m_World.updateAbsoluteMatrices();
 	bool subject= false;
 	{
 		QFile exportFile(m_FileName);
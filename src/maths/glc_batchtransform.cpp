@@ -0,0 +1,400 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+
+//! \file glc_batchtransform.cpp implementation of the batched transform functions
+
+#include "glc_batchtransform.h"
+
+#include <QtGlobal>
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define GLC_BATCHTRANSFORM_SSE
+#include <emmintrin.h>
+#if defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9))))
+// AVX functions are compiled for AVX without the AVX compiler flag
+#define GLC_BATCHTRANSFORM_AVX
+#define GLC_AVX_FUNCTION __attribute__((target("avx")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (_MSC_VER >= 1600)
+#define GLC_BATCHTRANSFORM_AVX
+#define GLC_AVX_FUNCTION
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// Dispatch services
+//////////////////////////////////////////////////////////////////////
+
+// Return true if the processor and the operating system support AVX
+static bool avxIsSupported()
+{
+#if defined(GLC_BATCHTRANSFORM_AVX) && defined(_MSC_VER)
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 1);
+	const bool osUsesXSave= (cpuInfo[2] & (1 << 27)) != 0;
+	const bool cpuHasAvx= (cpuInfo[2] & (1 << 28)) != 0;
+	// The operating system must save the AVX registers
+	return osUsesXSave && cpuHasAvx && ((_xgetbv(0) & 0x6) == 0x6);
+#elif defined(GLC_BATCHTRANSFORM_AVX)
+	return __builtin_cpu_supports("avx");
+#else
+	return false;
+#endif
+}
+
+// Return the instruction set used by the batched transforms
+static glc::SimdInstructionSet& currentInstructionSet()
+{
+	static glc::SimdInstructionSet instructionSet= glc::supportedSimdInstructionSet();
+	return instructionSet;
+}
+
+// Return true if the given matrix does not change the homogeneous coordinate
+static inline bool isAffine(const double* pMatrix)
+{
+	return (pMatrix[3] == 0.0) && (pMatrix[7] == 0.0) && (pMatrix[11] == 0.0) && (pMatrix[15] == 1.0);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Scalar kernels
+//////////////////////////////////////////////////////////////////////
+
+static void scalarMultiplyMatrix4x4(const double* pLeft, const double* pRight, double* pResult)
+{
+	for (int column= 0; column < 4; ++column)
+	{
+		const double* pRightColumn= pRight + column * 4;
+		for (int row= 0; row < 4; ++row)
+		{
+			pResult[column * 4 + row]= pLeft[row] * pRightColumn[0] + pLeft[4 + row] * pRightColumn[1]
+					+ pLeft[8 + row] * pRightColumn[2] + pLeft[12 + row] * pRightColumn[3];
+		}
+	}
+}
+
+// Transform points by a projection, with the precision of GLC_Matrix4x4::operator*
+static void scalarTransformPoints(const double* pMatrix, float* pPoints, int count)
+{
+	const bool affine= isAffine(pMatrix);
+	for (int i= 0; i < count; ++i)
+	{
+		float* pPoint= pPoints + i * 3;
+		const double x= pPoint[0];
+		const double y= pPoint[1];
+		const double z= pPoint[2];
+		double invW= 1.0;
+		if (!affine)
+		{
+			const double w= pMatrix[3] * x + pMatrix[7] * y + pMatrix[11] * z + pMatrix[15];
+			if (fabs(w) > 0.00001) invW/= w;
+		}
+		pPoint[0]= static_cast<float>((pMatrix[0] * x + pMatrix[4] * y + pMatrix[8] * z + pMatrix[12]) * invW);
+		pPoint[1]= static_cast<float>((pMatrix[1] * x + pMatrix[5] * y + pMatrix[9] * z + pMatrix[13]) * invW);
+		pPoint[2]= static_cast<float>((pMatrix[2] * x + pMatrix[6] * y + pMatrix[10] * z + pMatrix[14]) * invW);
+	}
+}
+
+static void scalarTransformVectors(const double* pMatrix, float* pVectors, int count)
+{
+	for (int i= 0; i < count; ++i)
+	{
+		float* pVector= pVectors + i * 3;
+		const double x= pVector[0];
+		const double y= pVector[1];
+		const double z= pVector[2];
+		pVector[0]= static_cast<float>(pMatrix[0] * x + pMatrix[4] * y + pMatrix[8] * z);
+		pVector[1]= static_cast<float>(pMatrix[1] * x + pMatrix[5] * y + pMatrix[9] * z);
+		pVector[2]= static_cast<float>(pMatrix[2] * x + pMatrix[6] * y + pMatrix[10] * z);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// SSE kernels
+//////////////////////////////////////////////////////////////////////
+
+#if defined(GLC_BATCHTRANSFORM_SSE)
+
+// A column of the matrix is a pair of registers of 2 doubles
+static void sseMultiplyMatrix4x4(const double* pLeft, const double* pRight, double* pResult)
+{
+	__m128d leftColumns[8];
+	for (int i= 0; i < 8; ++i)
+	{
+		leftColumns[i]= _mm_loadu_pd(pLeft + i * 2);
+	}
+	for (int column= 0; column < 4; ++column)
+	{
+		const double* pRightColumn= pRight + column * 4;
+		__m128d low= _mm_setzero_pd();
+		__m128d high= _mm_setzero_pd();
+		for (int i= 0; i < 4; ++i)
+		{
+			const __m128d factor= _mm_set1_pd(pRightColumn[i]);
+			low= _mm_add_pd(low, _mm_mul_pd(leftColumns[i * 2], factor));
+			high= _mm_add_pd(high, _mm_mul_pd(leftColumns[i * 2 + 1], factor));
+		}
+		_mm_storeu_pd(pResult + column * 4, low);
+		_mm_storeu_pd(pResult + column * 4 + 2, high);
+	}
+}
+
+// Load the first 3 rows of the given column of the matrix in floats
+static inline __m128 loadColumn(const double* pMatrix, int column)
+{
+	const double* pColumn= pMatrix + column * 4;
+	return _mm_setr_ps(static_cast<float>(pColumn[0]), static_cast<float>(pColumn[1]), static_cast<float>(pColumn[2]), 0.0f);
+}
+
+// Store the 3 first floats of the given register
+static inline void store3(float* pData, __m128 value)
+{
+	_mm_storel_pi(reinterpret_cast<__m64*>(pData), value);
+	_mm_store_ss(pData + 2, _mm_movehl_ps(value, value));
+}
+
+// Transform the given points by the given columns, the last column is added if the points are not vectors
+static inline void sseTransform(const __m128* pColumns, float* pData, int count, bool translate)
+{
+	for (int i= 0; i < count; ++i)
+	{
+		float* pItem= pData + i * 3;
+		__m128 result= _mm_add_ps(_mm_mul_ps(pColumns[0], _mm_set1_ps(pItem[0])), _mm_mul_ps(pColumns[1], _mm_set1_ps(pItem[1])));
+		result= _mm_add_ps(result, _mm_mul_ps(pColumns[2], _mm_set1_ps(pItem[2])));
+		if (translate) result= _mm_add_ps(result, pColumns[3]);
+		store3(pItem, result);
+	}
+}
+
+static void sseTransformPoints(const double* pMatrix, float* pPoints, int count)
+{
+	const __m128 columns[4]= {loadColumn(pMatrix, 0), loadColumn(pMatrix, 1), loadColumn(pMatrix, 2), loadColumn(pMatrix, 3)};
+	sseTransform(columns, pPoints, count, true);
+}
+
+static void sseTransformVectors(const double* pMatrix, float* pVectors, int count)
+{
+	const __m128 columns[4]= {loadColumn(pMatrix, 0), loadColumn(pMatrix, 1), loadColumn(pMatrix, 2), _mm_setzero_ps()};
+	sseTransform(columns, pVectors, count, false);
+}
+
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// AVX kernels
+//////////////////////////////////////////////////////////////////////
+
+#if defined(GLC_BATCHTRANSFORM_AVX)
+
+// A column of the matrix is a register of 4 doubles
+GLC_AVX_FUNCTION static void avxMultiplyMatrix4x4(const double* pLeft, const double* pRight, double* pResult)
+{
+	const __m256d leftColumn0= _mm256_loadu_pd(pLeft);
+	const __m256d leftColumn1= _mm256_loadu_pd(pLeft + 4);
+	const __m256d leftColumn2= _mm256_loadu_pd(pLeft + 8);
+	const __m256d leftColumn3= _mm256_loadu_pd(pLeft + 12);
+	for (int column= 0; column < 4; ++column)
+	{
+		const double* pRightColumn= pRight + column * 4;
+		__m256d result= _mm256_add_pd(_mm256_mul_pd(leftColumn0, _mm256_broadcast_sd(pRightColumn)), _mm256_mul_pd(leftColumn1, _mm256_broadcast_sd(pRightColumn + 1)));
+		result= _mm256_add_pd(result, _mm256_mul_pd(leftColumn2, _mm256_broadcast_sd(pRightColumn + 2)));
+		result= _mm256_add_pd(result, _mm256_mul_pd(leftColumn3, _mm256_broadcast_sd(pRightColumn + 3)));
+		_mm256_storeu_pd(pResult + column * 4, result);
+	}
+	_mm256_zeroupper();
+}
+
+// Return a register with the first given value in the low half and the second one in the high half
+GLC_AVX_FUNCTION static inline __m256 setPair(float low, float high)
+{
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(low)), _mm_set1_ps(high), 1);
+}
+
+// Transform 2 items per iteration, the columns are duplicated in the 2 halves of the registers
+GLC_AVX_FUNCTION static void avxTransform(const __m128* pColumns, float* pData, int count, bool translate)
+{
+	const __m256 column0= _mm256_insertf128_ps(_mm256_castps128_ps256(pColumns[0]), pColumns[0], 1);
+	const __m256 column1= _mm256_insertf128_ps(_mm256_castps128_ps256(pColumns[1]), pColumns[1], 1);
+	const __m256 column2= _mm256_insertf128_ps(_mm256_castps128_ps256(pColumns[2]), pColumns[2], 1);
+	const __m256 column3= _mm256_insertf128_ps(_mm256_castps128_ps256(pColumns[3]), pColumns[3], 1);
+	const int pairCount= count / 2;
+	for (int i= 0; i < pairCount; ++i)
+	{
+		float* pItems= pData + i * 6;
+		__m256 result= _mm256_add_ps(_mm256_mul_ps(column0, setPair(pItems[0], pItems[3])), _mm256_mul_ps(column1, setPair(pItems[1], pItems[4])));
+		result= _mm256_add_ps(result, _mm256_mul_ps(column2, setPair(pItems[2], pItems[5])));
+		if (translate) result= _mm256_add_ps(result, column3);
+		store3(pItems, _mm256_castps256_ps128(result));
+		store3(pItems + 3, _mm256_extractf128_ps(result, 1));
+	}
+	_mm256_zeroupper();
+
+	// The last odd item
+	sseTransform(pColumns, pData + pairCount * 6, count - pairCount * 2, translate);
+}
+
+static void avxTransformPoints(const double* pMatrix, float* pPoints, int count)
+{
+	const __m128 columns[4]= {loadColumn(pMatrix, 0), loadColumn(pMatrix, 1), loadColumn(pMatrix, 2), loadColumn(pMatrix, 3)};
+	avxTransform(columns, pPoints, count, true);
+}
+
+static void avxTransformVectors(const double* pMatrix, float* pVectors, int count)
+{
+	const __m128 columns[4]= {loadColumn(pMatrix, 0), loadColumn(pMatrix, 1), loadColumn(pMatrix, 2), _mm_setzero_ps()};
+	avxTransform(columns, pVectors, count, false);
+}
+
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// Batched transform Functions
+//////////////////////////////////////////////////////////////////////
+
+glc::SimdInstructionSet glc::supportedSimdInstructionSet()
+{
+#if defined(GLC_BATCHTRANSFORM_SSE)
+	if (avxIsSupported()) return AvxInstructions;
+	return SseInstructions;
+#else
+	return ScalarInstructions;
+#endif
+}
+
+glc::SimdInstructionSet glc::simdInstructionSet()
+{
+	return currentInstructionSet();
+}
+
+void glc::setSimdInstructionSet(SimdInstructionSet instructionSet)
+{
+	currentInstructionSet()= qMin(instructionSet, supportedSimdInstructionSet());
+}
+
+void glc::multiplyMatrix4x4(const double* pLeft, const double* pRight, double* pResult)
+{
+	Q_ASSERT((pResult != pLeft) && (pResult != pRight));
+	switch (currentInstructionSet())
+	{
+#if defined(GLC_BATCHTRANSFORM_AVX)
+	case AvxInstructions:
+		avxMultiplyMatrix4x4(pLeft, pRight, pResult);
+		break;
+#endif
+#if defined(GLC_BATCHTRANSFORM_SSE)
+	case SseInstructions:
+		sseMultiplyMatrix4x4(pLeft, pRight, pResult);
+		break;
+#endif
+	default:
+		scalarMultiplyMatrix4x4(pLeft, pRight, pResult);
+		break;
+	}
+}
+
+void glc::transformPoints(const double* pMatrix, float* pPoints, int count)
+{
+	// The float kernels do not divide by the homogeneous coordinate
+	const SimdInstructionSet instructionSet= isAffine(pMatrix) ? currentInstructionSet() : ScalarInstructions;
+	switch (instructionSet)
+	{
+#if defined(GLC_BATCHTRANSFORM_AVX)
+	case AvxInstructions:
+		avxTransformPoints(pMatrix, pPoints, count);
+		break;
+#endif
+#if defined(GLC_BATCHTRANSFORM_SSE)
+	case SseInstructions:
+		sseTransformPoints(pMatrix, pPoints, count);
+		break;
+#endif
+	default:
+		scalarTransformPoints(pMatrix, pPoints, count);
+		break;
+	}
+}
+
+void glc::transformVectors(const double* pMatrix, float* pVectors, int count)
+{
+	switch (currentInstructionSet())
+	{
+#if defined(GLC_BATCHTRANSFORM_AVX)
+	case AvxInstructions:
+		avxTransformVectors(pMatrix, pVectors, count);
+		break;
+#endif
+#if defined(GLC_BATCHTRANSFORM_SSE)
+	case SseInstructions:
+		sseTransformVectors(pMatrix, pVectors, count);
+		break;
+#endif
+	default:
+		scalarTransformVectors(pMatrix, pVectors, count);
+		break;
+	}
+}
+
+void glc::transformBox(const double* pMatrix, const double* pLower, const double* pUpper, double* pNewLower, double* pNewUpper)
+{
+	if (isAffine(pMatrix))
+	{
+		// Each coordinate of the new box is the translation plus the extremums of the products of its row
+		for (int row= 0; row < 3; ++row)
+		{
+			double lower= pMatrix[12 + row];
+			double upper= lower;
+			for (int column= 0; column < 3; ++column)
+			{
+				const double coefficient= pMatrix[column * 4 + row];
+				const double a= coefficient * pLower[column];
+				const double b= coefficient * pUpper[column];
+				lower+= qMin(a, b);
+				upper+= qMax(a, b);
+			}
+			pNewLower[row]= lower;
+			pNewUpper[row]= upper;
+		}
+	}
+	else
+	{
+		// The box of a projection is the box of its 8 transformed corners
+		for (int corner= 0; corner < 8; ++corner)
+		{
+			const double x= (corner & 1) ? pUpper[0] : pLower[0];
+			const double y= (corner & 2) ? pUpper[1] : pLower[1];
+			const double z= (corner & 4) ? pUpper[2] : pLower[2];
+			double invW= 1.0;
+			const double w= pMatrix[3] * x + pMatrix[7] * y + pMatrix[11] * z + pMatrix[15];
+			if (fabs(w) > 0.00001) invW/= w;
+			for (int row= 0; row < 3; ++row)
+			{
+				const double value= (pMatrix[row] * x + pMatrix[4 + row] * y + pMatrix[8 + row] * z + pMatrix[12 + row]) * invW;
+				if ((corner == 0) || (value < pNewLower[row])) pNewLower[row]= value;
+				if ((corner == 0) || (value > pNewUpper[row])) pNewUpper[row]= value;
+			}
+		}
+	}
+}
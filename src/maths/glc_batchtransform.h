@@ -0,0 +1,77 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_batchtransform.h declaration of the batched transform functions
+
+#ifndef GLC_BATCHTRANSFORM_H_
+#define GLC_BATCHTRANSFORM_H_
+
+#include "../glc_config.h"
+
+/*! The matrices are arrays of 16 doubles in the column major order of GLC_Matrix4x4.
+ *  Points and vectors are packed arrays of 3 floats transformed in place.
+ *  The kernel is chosen at run time from the instruction sets supported by the
+ *  processor, the scalar kernel is used on other processors.*/
+namespace glc
+{
+	//! The instruction sets of the batched transform kernels
+	enum SimdInstructionSet
+	{
+		ScalarInstructions,
+		SseInstructions,
+		AvxInstructions
+	};
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Batched transform Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+	//! Return the best instruction set supported by the compiler and the processor
+	GLC_LIB_EXPORT SimdInstructionSet supportedSimdInstructionSet();
+
+	//! Return the instruction set used by the batched transforms
+	GLC_LIB_EXPORT SimdInstructionSet simdInstructionSet();
+
+	//! Set the instruction set used by the batched transforms
+	/*! The instruction set is limited to the supported one*/
+	GLC_LIB_EXPORT void setSimdInstructionSet(SimdInstructionSet instructionSet);
+
+	//! Set the given result to the product of the given left and right matrices
+	/*! The result must not be one of the operands*/
+	GLC_LIB_EXPORT void multiplyMatrix4x4(const double* pLeft, const double* pRight, double* pResult);
+
+	//! Transform the given number of points by the given matrix
+	/*! Points are divided by their homogeneous coordinate if the matrix is a projection*/
+	GLC_LIB_EXPORT void transformPoints(const double* pMatrix, float* pPoints, int count);
+
+	//! Transform the given number of vectors by the linear part of the given matrix
+	GLC_LIB_EXPORT void transformVectors(const double* pMatrix, float* pVectors, int count);
+
+	//! Set the given new lower and upper corners to the box of the transformed box
+	/*! The box of an affine matrix is computed from the matrix coefficients (Arvo method)*/
+	GLC_LIB_EXPORT void transformBox(const double* pMatrix, const double* pLower, const double* pUpper, double* pNewLower, double* pNewUpper);
+
+//@}
+
+}
+
+#endif /* GLC_BATCHTRANSFORM_H_ */
@@ -26,10 +26,757 @@
 #include "glc_matrix4x4.h"
 
 #include <QtGlobal>
+#include <QAtomicInt>
+#include <QMap>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
 
 
 double glc::comparedPrecision= glc::defaultPrecision;
 
+//////////////////////////////////////////////////////////////////////
+// Polygon triangulation services
+//////////////////////////////////////////////////////////////////////
+
+// The number of polygons triangulated by a chunk of triangulatePolygons()
+static const int triangulationChunkSize= 256;
+
+/****************************************************************************
+ The monotone partition and the monotone polygon triangulation below, from
+ isBelow() to triangulateMonotone(), are adapted from PolyPartition :
+ https://github.com/ivanfratric/polypartition
+
+ Copyright (C) 2011 by Ivan Fratric
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+*****************************************************************************/
+
+// Return true if the first point is below the second in the sweep order
+static inline bool isBelow(const GLC_Point2d& p1, const GLC_Point2d& p2)
+{
+	return (p1.y() < p2.y()) || ((p1.y() == p2.y()) && (p1.x() < p2.x()));
+}
+
+// Return true if the given points turn to the left
+static inline bool isLeftTurn(const GLC_Point2d& p1, const GLC_Point2d& p2, const GLC_Point2d& p3)
+{
+	return ((p3.y() - p1.y()) * (p2.x() - p1.x()) - (p3.x() - p1.x()) * (p2.y() - p1.y())) > 0.0;
+}
+
+// Return the signed area of the given contour, positive if it is counterclockwise
+static double signedArea(const QVector<GLC_Point2d>& points, const QVector<int>& contour)
+{
+	double area= 0.0;
+	const int size= contour.size();
+	for (int i= 0, j= size - 1; i < size; j= i++)
+	{
+		area+= points.at(contour.at(j)) ^ points.at(contour.at(i));
+	}
+	return area * 0.5;
+}
+
+// The type of a vertex for the monotone partition sweep
+enum MonotoneVertexType
+{
+	RegularVertex,
+	StartVertex,
+	EndVertex,
+	SplitVertex,
+	MergeVertex
+};
+
+// A vertex of the polygon split in monotone polygons, diagonals duplicate their vertices
+struct MonotoneVertex
+{
+	GLC_Point2d m_Point;
+	int m_Index;
+	int m_Previous;
+	int m_Next;
+};
+
+// An edge crossed by the sweep line, edges are ordered from left to right
+struct ScanLineEdge
+{
+	GLC_Point2d m_P1;
+	GLC_Point2d m_P2;
+
+	bool operator<(const ScanLineEdge& other) const
+	{
+		if (other.m_P1.y() == other.m_P2.y())
+		{
+			if (m_P1.y() == m_P2.y()) return m_P1.y() < other.m_P1.y();
+			return isLeftTurn(m_P1, m_P2, other.m_P1);
+		}
+		else if ((m_P1.y() == m_P2.y()) || (m_P1.y() < other.m_P1.y()))
+		{
+			return !isLeftTurn(other.m_P1, other.m_P2, m_P1);
+		}
+		else
+		{
+			return isLeftTurn(m_P1, m_P2, other.m_P1);
+		}
+	}
+};
+
+// The edges crossed by the sweep line and the index of their first vertex
+typedef QMap<ScanLineEdge, int> ScanLine;
+
+// Split a polygon with holes in monotone polygons with a sweep line in O(n log n)
+class MonotonePartition
+{
+public:
+	MonotonePartition(const QVector<GLC_Point2d>& points, const QList<QVector<int> >& contours, int vertexCount)
+	: m_Vertices(3 * vertexCount)
+	, m_VertexCount(0)
+	, m_Types(3 * vertexCount)
+	, m_EdgeIterators()
+	, m_Helpers(3 * vertexCount)
+	, m_ScanLine()
+	{
+		m_EdgeIterators.fill(m_ScanLine.end(), 3 * vertexCount);
+		const int contourCount= contours.size();
+		for (int i= 0; i < contourCount; ++i)
+		{
+			const QVector<int>& contour= contours.at(i);
+			const int size= contour.size();
+			for (int j= 0; j < size; ++j)
+			{
+				MonotoneVertex& vertex= m_Vertices[m_VertexCount + j];
+				vertex.m_Point= points.at(contour.at(j));
+				vertex.m_Index= contour.at(j);
+				vertex.m_Previous= m_VertexCount + ((j + size - 1) % size);
+				vertex.m_Next= m_VertexCount + ((j + 1) % size);
+			}
+			m_VertexCount+= size;
+		}
+	}
+
+	// Split the polygon, return false if the polygon is not simple
+	bool split(QList<QVector<int> >* pMonotonePolygons)
+	{
+		const int vertexCount= m_VertexCount;
+		QVector<int> priority(vertexCount);
+		for (int i= 0; i < vertexCount; ++i)
+		{
+			priority[i]= i;
+			const GLC_Point2d& point= m_Vertices.at(i).m_Point;
+			const GLC_Point2d& previous= m_Vertices.at(m_Vertices.at(i).m_Previous).m_Point;
+			const GLC_Point2d& next= m_Vertices.at(m_Vertices.at(i).m_Next).m_Point;
+			if (isBelow(previous, point) && isBelow(next, point))
+			{
+				m_Types[i]= isLeftTurn(next, previous, point) ? StartVertex : SplitVertex;
+			}
+			else if (isBelow(point, previous) && isBelow(point, next))
+			{
+				m_Types[i]= isLeftTurn(next, previous, point) ? EndVertex : MergeVertex;
+			}
+			else
+			{
+				m_Types[i]= RegularVertex;
+			}
+		}
+		std::sort(priority.begin(), priority.end(), VertexSorter(m_Vertices));
+
+		for (int i= 0; i < vertexCount; ++i)
+		{
+			const int index= priority.at(i);
+			int index2= index;
+			const int previous= m_Vertices.at(index).m_Previous;
+			ScanLineEdge probe;
+			probe.m_P1= probe.m_P2= m_Vertices.at(index).m_Point;
+
+			switch (m_Types.at(index))
+			{
+			case StartVertex:
+				insertEdge(index);
+				m_Helpers[index]= index;
+				break;
+
+			case EndVertex:
+				if (m_ScanLine.end() == m_EdgeIterators.at(previous)) return false;
+				if (MergeVertex == m_Types.at(m_Helpers.at(previous)))
+				{
+					addDiagonal(index, m_Helpers.at(previous));
+				}
+				m_ScanLine.erase(m_EdgeIterators.at(previous));
+				break;
+
+			case SplitVertex:
+			{
+				ScanLine::iterator iEdge= m_ScanLine.lowerBound(probe);
+				if (m_ScanLine.begin() == iEdge) return false;
+				--iEdge;
+				addDiagonal(index, m_Helpers.at(iEdge.value()));
+				index2= m_VertexCount - 2;
+				m_Helpers[iEdge.value()]= index;
+				insertEdge(index2);
+				m_Helpers[index2]= index2;
+				break;
+			}
+
+			case MergeVertex:
+			{
+				if (m_ScanLine.end() == m_EdgeIterators.at(previous)) return false;
+				if (MergeVertex == m_Types.at(m_Helpers.at(previous)))
+				{
+					addDiagonal(index, m_Helpers.at(previous));
+					index2= m_VertexCount - 2;
+				}
+				m_ScanLine.erase(m_EdgeIterators.at(previous));
+				ScanLine::iterator iEdge= m_ScanLine.lowerBound(probe);
+				if (m_ScanLine.begin() == iEdge) return false;
+				--iEdge;
+				if (MergeVertex == m_Types.at(m_Helpers.at(iEdge.value())))
+				{
+					addDiagonal(index2, m_Helpers.at(iEdge.value()));
+				}
+				m_Helpers[iEdge.value()]= index2;
+				break;
+			}
+
+			default:
+				if (isBelow(m_Vertices.at(index).m_Point, m_Vertices.at(previous).m_Point))
+				{
+					// The interior of the polygon is on the right of the vertex
+					if (m_ScanLine.end() == m_EdgeIterators.at(previous)) return false;
+					if (MergeVertex == m_Types.at(m_Helpers.at(previous)))
+					{
+						addDiagonal(index, m_Helpers.at(previous));
+						index2= m_VertexCount - 2;
+					}
+					m_ScanLine.erase(m_EdgeIterators.at(previous));
+					insertEdge(index2);
+					m_Helpers[index2]= index2;
+				}
+				else
+				{
+					ScanLine::iterator iEdge= m_ScanLine.lowerBound(probe);
+					if (m_ScanLine.begin() == iEdge) return false;
+					--iEdge;
+					if (MergeVertex == m_Types.at(m_Helpers.at(iEdge.value())))
+					{
+						addDiagonal(index, m_Helpers.at(iEdge.value()));
+					}
+					m_Helpers[iEdge.value()]= index;
+				}
+				break;
+			}
+		}
+
+		// Each loop of vertices is a monotone polygon
+		QVector<bool> used(m_VertexCount, false);
+		for (int i= 0; i < m_VertexCount; ++i)
+		{
+			if (used.at(i)) continue;
+			QVector<int> polygon;
+			int index= i;
+			do
+			{
+				if (used.at(index)) return false;
+				used[index]= true;
+				polygon.append(m_Vertices.at(index).m_Index);
+				index= m_Vertices.at(index).m_Next;
+			}
+			while (index != i);
+			pMonotonePolygons->append(polygon);
+		}
+		return true;
+	}
+
+private:
+	// Sort vertices from the top of the sweep
+	struct VertexSorter
+	{
+		VertexSorter(const QVector<MonotoneVertex>& vertices)
+		: m_Vertices(vertices)
+		{}
+		bool operator()(int index1, int index2) const
+		{return isBelow(m_Vertices.at(index2).m_Point, m_Vertices.at(index1).m_Point);}
+		const QVector<MonotoneVertex>& m_Vertices;
+	};
+
+	// Insert in the scan line the edge which starts at the given vertex
+	void insertEdge(int index)
+	{
+		ScanLineEdge edge;
+		edge.m_P1= m_Vertices.at(index).m_Point;
+		edge.m_P2= m_Vertices.at(m_Vertices.at(index).m_Next).m_Point;
+		m_EdgeIterators[index]= m_ScanLine.insertMulti(edge, index);
+	}
+
+	// Add a diagonal between the given vertices, the copies of the vertices take their next edges
+	void addDiagonal(int index1, int index2)
+	{
+		const int newIndex1= m_VertexCount++;
+		const int newIndex2= m_VertexCount++;
+		MonotoneVertex& vertex1= m_Vertices[index1];
+		MonotoneVertex& vertex2= m_Vertices[index2];
+		MonotoneVertex& newVertex1= m_Vertices[newIndex1];
+		MonotoneVertex& newVertex2= m_Vertices[newIndex2];
+
+		newVertex1= vertex1;
+		newVertex2= vertex2;
+		m_Vertices[vertex2.m_Next].m_Previous= newIndex2;
+		m_Vertices[vertex1.m_Next].m_Previous= newIndex1;
+		vertex1.m_Next= newIndex2;
+		newVertex2.m_Previous= index1;
+		vertex2.m_Next= newIndex1;
+		newVertex1.m_Previous= index2;
+
+		moveVertexState(index1, newIndex1);
+		moveVertexState(index2, newIndex2);
+	}
+
+	// The copy of a vertex takes its type, its helper and its edge
+	void moveVertexState(int index, int newIndex)
+	{
+		m_Types[newIndex]= m_Types.at(index);
+		m_Helpers[newIndex]= m_Helpers.at(index);
+		m_EdgeIterators[newIndex]= m_EdgeIterators.at(index);
+		if (m_ScanLine.end() != m_EdgeIterators.at(newIndex))
+		{
+			m_EdgeIterators[newIndex].value()= newIndex;
+		}
+	}
+
+	QVector<MonotoneVertex> m_Vertices;
+	int m_VertexCount;
+	QVector<MonotoneVertexType> m_Types;
+	QVector<ScanLine::iterator> m_EdgeIterators;
+	QVector<int> m_Helpers;
+	ScanLine m_ScanLine;
+};
+
+// Triangulate the given counterclockwise monotone polygon in O(n)
+static bool triangulateMonotone(const QVector<GLC_Point2d>& points, const QVector<int>& polygon, QVector<int>* pTriangles)
+{
+	const int size= polygon.size();
+	if (size < 3) return false;
+	if (size == 3)
+	{
+		(*pTriangles) << polygon.at(0) << polygon.at(1) << polygon.at(2);
+		return true;
+	}
+
+	int top= 0;
+	int bottom= 0;
+	for (int i= 1; i < size; ++i)
+	{
+		if (isBelow(points.at(polygon.at(i)), points.at(polygon.at(bottom)))) bottom= i;
+		if (isBelow(points.at(polygon.at(top)), points.at(polygon.at(i)))) top= i;
+	}
+
+	// Merge the left chain, from top to bottom, and the right chain
+	QVector<int> order(size);
+	QVector<int> chain(size);
+	order[0]= top;
+	chain[top]= 0;
+	int left= (top + 1) % size;
+	int right= (top + size - 1) % size;
+	for (int i= 1; i < (size - 1); ++i)
+	{
+		if ((left == bottom) || ((right != bottom) && isBelow(points.at(polygon.at(left)), points.at(polygon.at(right)))))
+		{
+			order[i]= right;
+			chain[right]= -1;
+			right= (right + size - 1) % size;
+		}
+		else
+		{
+			order[i]= left;
+			chain[left]= 1;
+			left= (left + 1) % size;
+		}
+	}
+	order[size - 1]= bottom;
+	chain[bottom]= 0;
+
+	QVector<int> stack(size);
+	stack[0]= order.at(0);
+	stack[1]= order.at(1);
+	int stackSize= 2;
+	for (int i= 2; i < (size - 1); ++i)
+	{
+		const int index= order.at(i);
+		if (chain.at(index) != chain.at(stack.at(stackSize - 1)))
+		{
+			for (int j= 0; j < (stackSize - 1); ++j)
+			{
+				if (1 == chain.at(index))
+				{
+					(*pTriangles) << polygon.at(stack.at(j + 1)) << polygon.at(stack.at(j)) << polygon.at(index);
+				}
+				else
+				{
+					(*pTriangles) << polygon.at(stack.at(j)) << polygon.at(stack.at(j + 1)) << polygon.at(index);
+				}
+			}
+			stack[0]= order.at(i - 1);
+			stack[1]= index;
+			stackSize= 2;
+		}
+		else
+		{
+			--stackSize;
+			while (stackSize > 0)
+			{
+				const int top1= polygon.at(stack.at(stackSize));
+				const int top2= polygon.at(stack.at(stackSize - 1));
+				const int current= polygon.at(index);
+				if ((1 == chain.at(index)) && isLeftTurn(points.at(current), points.at(top2), points.at(top1)))
+				{
+					(*pTriangles) << current << top2 << top1;
+				}
+				else if ((-1 == chain.at(index)) && isLeftTurn(points.at(current), points.at(top1), points.at(top2)))
+				{
+					(*pTriangles) << current << top1 << top2;
+				}
+				else break;
+				--stackSize;
+			}
+			++stackSize;
+			stack[stackSize++]= index;
+		}
+	}
+
+	const int index= order.at(size - 1);
+	for (int j= 0; j < (stackSize - 1); ++j)
+	{
+		if (1 == chain.at(stack.at(j + 1)))
+		{
+			(*pTriangles) << polygon.at(stack.at(j)) << polygon.at(stack.at(j + 1)) << polygon.at(index);
+		}
+		else
+		{
+			(*pTriangles) << polygon.at(stack.at(j + 1)) << polygon.at(stack.at(j)) << polygon.at(index);
+		}
+	}
+	return true;
+}
+
+// End of the code adapted from PolyPartition
+
+// Return the point of the given index in the given positions
+template <class Positions>
+static inline GLC_Point3d positionOf(const Positions& positions, GLuint index)
+{
+	return GLC_Point3d(positions[index * 3], positions[index * 3 + 1], positions[index * 3 + 2]);
+}
+
+// Triangulate the given 3D polygon with holes with a monotone partition, return false if it fails
+template <class Positions>
+static bool monotoneTriangulation(QList<GLuint>* pIndexList, const QList<QList<GLuint> >& holes, const Positions& positions)
+{
+	// The contours of distinct successive points
+	QVector<GLuint> indexes;
+	QVector<GLC_Point3d> points3d;
+	QList<QVector<int> > contours;
+	const int contourCount= holes.size() + 1;
+	for (int i= 0; i < contourCount; ++i)
+	{
+		const QList<GLuint>& indexList= (0 == i) ? *pIndexList : holes.at(i - 1);
+		QVector<int> contour;
+		const int size= indexList.size();
+		for (int j= 0; j < size; ++j)
+		{
+			const GLuint index= indexList.at(j);
+			const GLC_Point3d point(positionOf(positions, index));
+			if (!contour.isEmpty() && (point == points3d.at(contour.last()))) continue;
+			contour.append(indexes.size());
+			indexes.append(index);
+			points3d.append(point);
+		}
+		while ((contour.size() > 1) && (points3d.at(contour.last()) == points3d.at(contour.first())))
+		{
+			contour.removeLast();
+		}
+
+		if (contour.size() > 2)
+		{
+			contours.append(contour);
+		}
+		else if (0 == i)
+		{
+			// Degenerated polygon
+			pIndexList->clear();
+			return true;
+		}
+	}
+
+	// The Newell normal of the outer contour gives its plane and its orientation
+	const QVector<int>& outer= contours.first();
+	const int outerSize= outer.size();
+	double normalX= 0.0;
+	double normalY= 0.0;
+	double normalZ= 0.0;
+	for (int i= 0, j= outerSize - 1; i < outerSize; j= i++)
+	{
+		const GLC_Point3d& p1= points3d.at(outer.at(j));
+		const GLC_Point3d& p2= points3d.at(outer.at(i));
+		normalX+= (p1.y() - p2.y()) * (p1.z() + p2.z());
+		normalY+= (p1.z() - p2.z()) * (p1.x() + p2.x());
+		normalZ+= (p1.x() - p2.x()) * (p1.y() + p2.y());
+	}
+	if ((0.0 == normalX) && (0.0 == normalY) && (0.0 == normalZ)) return false;
+	GLC_Vector3d normal(normalX, normalY, normalZ);
+	normal.normalize();
+
+	// The outer contour is counterclockwise in the frame of the polygon plane
+	GLC_Vector3d u(normal ^ ((qAbs(normal.x()) < 0.9) ? glc::X_AXIS : glc::Y_AXIS));
+	u.normalize();
+	const GLC_Vector3d v(normal ^ u);
+	const int pointCount= points3d.size();
+	QVector<GLC_Point2d> points2d(pointCount);
+	for (int i= 0; i < pointCount; ++i)
+	{
+		points2d[i]= GLC_Point2d(points3d.at(i) * u, points3d.at(i) * v);
+	}
+
+	QVector<int> triangles;
+	if (1 == contours.size())
+	{
+		// A convex polygon is a fan
+		bool isConvex= true;
+		for (int i= 0; (i < outerSize) && isConvex; ++i)
+		{
+			const GLC_Point2d& p0= points2d.at(outer.at(i));
+			const GLC_Point2d& p1= points2d.at(outer.at((i + 1) % outerSize));
+			const GLC_Point2d& p2= points2d.at(outer.at((i + 2) % outerSize));
+			isConvex= ((p1 - p0) ^ (p2 - p1)) >= 0.0;
+		}
+		if (isConvex)
+		{
+			for (int i= 1; i < (outerSize - 1); ++i)
+			{
+				triangles << outer.at(0) << outer.at(i) << outer.at(i + 1);
+			}
+		}
+	}
+	if (triangles.isEmpty() && !glc::triangulatePolygon2D(points2d, contours, &triangles)) return false;
+
+	pIndexList->clear();
+	const int size= triangles.size();
+	for (int i= 0; i < size; ++i)
+	{
+		pIndexList->append(indexes.at(triangles.at(i)));
+	}
+	return true;
+}
+
+// Triangulate the given 3D polygon by ear clipping, used if the monotone partition fails
+template <class Positions>
+static void earClippingTriangulation(QList<GLuint>* pIndexList, const Positions& positions)
+{
+	int size= pIndexList->size();
+	// Get the polygon vertice
+	QList<GLC_Point3d> originPoints;
+	QHash<int, int> indexMap;
+
+	QList<int> face;
+	GLC_Point3d currentPoint;
+	int delta= 0;
+	for (int i= 0; i < size; ++i)
+	{
+		const int currentIndex= pIndexList->at(i);
+		currentPoint= GLC_Point3d(positions[currentIndex * 3], positions[currentIndex * 3 + 1], positions[currentIndex * 3 + 2]);
+		if (!originPoints.contains(currentPoint))
+		{
+			originPoints.append(GLC_Point3d(positions[currentIndex * 3], positions[currentIndex * 3 + 1], positions[currentIndex * 3 + 2]));
+			indexMap.insert(i - delta, currentIndex);
+			face.append(i - delta);
+		}
+		else
+		{
+			qDebug() << "Multi points";
+			++delta;
+		}
+	}
+	// Values of PindexList must be reset
+	pIndexList->clear();
+
+	// Update size
+	size= size - delta;
+
+	// Check new size
+	if (size < 3) return;
+
+	//-------------- Change frame to mach polygon plane
+		// Compute face normal
+		const GLC_Point3d point1(originPoints[0]);
+		const GLC_Point3d point2(originPoints[1]);
+		const GLC_Point3d point3(originPoints[2]);
+
+		const GLC_Vector3d edge1(point2 - point1);
+		const GLC_Vector3d edge2(point3 - point2);
+
+		GLC_Vector3d polygonPlaneNormal(edge1 ^ edge2);
+		polygonPlaneNormal.normalize();
+
+		// Create the transformation matrix
+		GLC_Matrix4x4 transformation;
+
+		GLC_Vector3d rotationAxis(polygonPlaneNormal ^ glc::Z_AXIS);
+		if (!rotationAxis.isNull())
+		{
+			const double angle= acos(polygonPlaneNormal * glc::Z_AXIS);
+			transformation.setMatRot(rotationAxis, angle);
+		}
+
+		QList<GLC_Point2d> polygon;
+		// Transform polygon vertexs
+		for (int i=0; i < size; ++i)
+		{
+			originPoints[i]= transformation * originPoints[i];
+			// Create 2d vector
+			polygon << originPoints[i].toVector2d(glc::Z_AXIS);
+		}
+		// Create the index
+		QList<int> index= face;
+
+		const bool faceIsCounterclockwise= glc::isCounterclockwiseOrdered(polygon);
+
+		if(!faceIsCounterclockwise)
+		{
+			//qDebug() << "face Is Not Counterclockwise";
+			const int max= size / 2;
+			for (int i= 0; i < max; ++i)
+			{
+				polygon.swap(i, size - 1 -i);
+				int temp= face[i];
+				face[i]= face[size - 1 - i];
+				face[size - 1 - i]= temp;
+			}
+		}
+
+            QList<int> tList;
+		glc::triangulate(polygon, index, tList);
+		size= tList.size();
+		for (int i= 0; i < size; i+= 3)
+		{
+			// Avoid normal problem
+			if (faceIsCounterclockwise)
+			{
+				pIndexList->append(indexMap.value(face[tList[i]]));
+				pIndexList->append(indexMap.value(face[tList[i + 1]]));
+				pIndexList->append(indexMap.value(face[tList[i + 2]]));
+			}
+			else
+			{
+				pIndexList->append(indexMap.value(face[tList[i + 2]]));
+				pIndexList->append(indexMap.value(face[tList[i + 1]]));
+				pIndexList->append(indexMap.value(face[tList[i]]));
+			}
+		}
+		Q_ASSERT(size == pIndexList->size());
+}
+
+// Triangulate the given 3D polygon
+template <class Positions>
+static void triangulatePolygonOf(QList<GLuint>* pIndexList, const Positions& positions)
+{
+	if (!monotoneTriangulation(pIndexList, QList<QList<GLuint> >(), positions))
+	{
+		earClippingTriangulation(pIndexList, positions);
+	}
+}
+
+// Return the thread pool of the polygon triangulations
+static QThreadPool* triangulationThreadPool()
+{
+	static QThreadPool threadPool;
+	return &threadPool;
+}
+
+// Runnable which triangulates chunks of polygons
+template <class Positions>
+class TriangulationRunner : public QRunnable
+{
+public:
+	inline TriangulationRunner(QList<QList<GLuint> >* pPolygons, const Positions& positions, int chunkCount, QAtomicInt* pNextChunk, QSemaphore* pDoneSemaphore)
+	: QRunnable()
+	, m_pPolygons(pPolygons)
+	, m_Positions(positions)
+	, m_ChunkCount(chunkCount)
+	, m_pNextChunk(pNextChunk)
+	, m_pDoneSemaphore(pDoneSemaphore)
+	{}
+
+	//! Triangulate the next chunks until all chunks are taken
+	virtual void run()
+	{
+		int chunkIndex= m_pNextChunk->fetchAndAddOrdered(1);
+		while (chunkIndex < m_ChunkCount)
+		{
+			const int first= chunkIndex * triangulationChunkSize;
+			const int last= qMin(first + triangulationChunkSize, m_pPolygons->size());
+			for (int i= first; i < last; ++i)
+			{
+				QList<GLuint>& polygon= (*m_pPolygons)[i];
+				if (polygon.size() > 3) triangulatePolygonOf(&polygon, m_Positions);
+			}
+			chunkIndex= m_pNextChunk->fetchAndAddOrdered(1);
+		}
+		if (NULL != m_pDoneSemaphore) m_pDoneSemaphore->release();
+	}
+
+private:
+	//! The triangulated polygons
+	QList<QList<GLuint> >* m_pPolygons;
+	//! The positions of the polygons
+	const Positions& m_Positions;
+	//! The number of chunks
+	int m_ChunkCount;
+	//! The next chunk to triangulate
+	QAtomicInt* m_pNextChunk;
+	//! The semaphore released when the runner is done, NULL for the calling thread
+	QSemaphore* m_pDoneSemaphore;
+};
+
+// Triangulate the given polygons on the triangulation thread pool
+template <class Positions>
+static void triangulatePolygonsOf(QList<QList<GLuint> >* pPolygons, const Positions& positions, bool parallel)
+{
+	const int polygonCount= pPolygons->size();
+	if (0 == polygonCount) return;
+
+	// The list must not be detached by the runners
+	pPolygons->detach();
+	const int chunkCount= (polygonCount + triangulationChunkSize - 1) / triangulationChunkSize;
+	const int threadCount= parallel ? qBound(1, QThread::idealThreadCount(), chunkCount) : 1;
+	QAtomicInt nextChunk(0);
+	QSemaphore doneSemaphore;
+	for (int i= 1; i < threadCount; ++i)
+	{
+		triangulationThreadPool()->start(new TriangulationRunner<Positions>(pPolygons, positions, chunkCount, &nextChunk, &doneSemaphore));
+	}
+
+	// The calling thread triangulates chunks too
+	TriangulationRunner<Positions> runner(pPolygons, positions, chunkCount, &nextChunk, NULL);
+	runner.run();
+	doneSemaphore.acquire(threadCount - 1);
+}
+
 //////////////////////////////////////////////////////////////////////
 //Tools Functions
 //////////////////////////////////////////////////////////////////////
@@ -377,125 +1124,102 @@ bool glc::isCounterclockwiseOrdered(const QList<GLC_Point2d>& polygon)
 
 }
 
-// Triangulate a no convex polygon
+// Triangulate a polygon
 void glc::triangulatePolygon(QList<GLuint>* pIndexList, const QList<float>& bulkList)
 {
-	int size= pIndexList->size();
-	if (polygonIsConvex(pIndexList, bulkList))
-	{
-		QList<GLuint> indexList(*pIndexList);
-		pIndexList->clear();
-		for (int i= 0; i < size - 2; ++i)
-		{
-			pIndexList->append(indexList.at(0));
-			pIndexList->append(indexList.at(i + 1));
-			pIndexList->append(indexList.at(i + 2));
-		}
-	}
-	else
-	{
-		// Get the polygon vertice
-		QList<GLC_Point3d> originPoints;
-		QHash<int, int> indexMap;
-
-		QList<int> face;
-		GLC_Point3d currentPoint;
-		int delta= 0;
-		for (int i= 0; i < size; ++i)
-		{
-			const int currentIndex= pIndexList->at(i);
-			currentPoint= GLC_Point3d(bulkList.at(currentIndex * 3), bulkList.at(currentIndex * 3 + 1), bulkList.at(currentIndex * 3 + 2));
-			if (!originPoints.contains(currentPoint))
-			{
-				originPoints.append(GLC_Point3d(bulkList.at(currentIndex * 3), bulkList.at(currentIndex * 3 + 1), bulkList.at(currentIndex * 3 + 2)));
-				indexMap.insert(i - delta, currentIndex);
-				face.append(i - delta);
-			}
-			else
-			{
-				qDebug() << "Multi points";
-				++delta;
-			}
-		}
-		// Values of PindexList must be reset
-		pIndexList->clear();
-
-		// Update size
-		size= size - delta;
-
-		// Check new size
-		if (size < 3) return;
-
-		//-------------- Change frame to mach polygon plane
-			// Compute face normal
-			const GLC_Point3d point1(originPoints[0]);
-			const GLC_Point3d point2(originPoints[1]);
-			const GLC_Point3d point3(originPoints[2]);
+	triangulatePolygonOf(pIndexList, bulkList);
+}
 
-			const GLC_Vector3d edge1(point2 - point1);
-			const GLC_Vector3d edge2(point3 - point2);
+// Triangulate a polygon of contiguous positions
+void glc::triangulatePolygon(QList<GLuint>* pIndexList, const GLfloat* pPositions)
+{
+	triangulatePolygonOf(pIndexList, pPositions);
+}
 
-			GLC_Vector3d polygonPlaneNormal(edge1 ^ edge2);
-			polygonPlaneNormal.normalize();
+// Triangulate a polygon with holes of contiguous positions
+bool glc::triangulatePolygon(QList<GLuint>* pIndexList, const QList<QList<GLuint> >& holes, const GLfloat* pPositions)
+{
+	if (holes.isEmpty())
+	{
+		triangulatePolygonOf(pIndexList, pPositions);
+		return true;
+	}
+	return monotoneTriangulation(pIndexList, holes, pPositions);
+}
 
-			// Create the transformation matrix
-			GLC_Matrix4x4 transformation;
+// Triangulate polygons in parallel
+void glc::triangulatePolygons(QList<QList<GLuint> >* pPolygons, const QList<float>& bulkList, bool parallel)
+{
+	triangulatePolygonsOf(pPolygons, bulkList, parallel);
+}
 
-			GLC_Vector3d rotationAxis(polygonPlaneNormal ^ Z_AXIS);
-			if (!rotationAxis.isNull())
-			{
-				const double angle= acos(polygonPlaneNormal * Z_AXIS);
-				transformation.setMatRot(rotationAxis, angle);
-			}
+// Triangulate polygons of contiguous positions in parallel
+void glc::triangulatePolygons(QList<QList<GLuint> >* pPolygons, const GLfloat* pPositions, bool parallel)
+{
+	triangulatePolygonsOf(pPolygons, pPositions, parallel);
+}
 
-			QList<GLC_Point2d> polygon;
-			// Transform polygon vertexs
-			for (int i=0; i < size; ++i)
+// Triangulate a 2D polygon with holes with a sweep line
+bool glc::triangulatePolygon2D(const QVector<GLC_Point2d>& points, const QList<QVector<int> >& contours, QVector<int>* pTriangles)
+{
+	if (contours.isEmpty()) return false;
+
+	// The outer contour is counterclockwise and the holes are clockwise
+	QList<QVector<int> > orientedContours;
+	double polygonArea= 0.0;
+	int vertexCount= 0;
+	const int contourCount= contours.size();
+	for (int i= 0; i < contourCount; ++i)
+	{
+		QVector<int> contour(contours.at(i));
+		const int size= contour.size();
+		if (size < 3) return false;
+		const double area= signedArea(points, contour);
+		if (0.0 == area) return false;
+		if ((0 == i) != (area > 0.0))
+		{
+			for (int j= 0; j < (size / 2); ++j)
 			{
-				originPoints[i]= transformation * originPoints[i];
-				// Create 2d vector
-				polygon << originPoints[i].toVector2d(Z_AXIS);
+				qSwap(contour[j], contour[size - 1 - j]);
 			}
-			// Create the index
-			QList<int> index= face;
+		}
+		polygonArea+= (0 == i) ? qAbs(area) : -qAbs(area);
+		vertexCount+= size;
+		orientedContours.append(contour);
+	}
 
-			const bool faceIsCounterclockwise= isCounterclockwiseOrdered(polygon);
+	QList<QVector<int> > monotonePolygons;
+	MonotonePartition partition(points, orientedContours, vertexCount);
+	if (!partition.split(&monotonePolygons)) return false;
 
-			if(!faceIsCounterclockwise)
-			{
-				//qDebug() << "face Is Not Counterclockwise";
-				const int max= size / 2;
-				for (int i= 0; i < max; ++i)
-				{
-					polygon.swap(i, size - 1 -i);
-					int temp= face[i];
-					face[i]= face[size - 1 - i];
-					face[size - 1 - i]= temp;
-				}
-			}
+	const int first= pTriangles->size();
+	const int monotoneCount= monotonePolygons.size();
+	for (int i= 0; i < monotoneCount; ++i)
+	{
+		if (!triangulateMonotone(points, monotonePolygons.at(i), pTriangles))
+		{
+			pTriangles->resize(first);
+			return false;
+		}
+	}
 
-            QList<int> tList;
-			triangulate(polygon, index, tList);
-			size= tList.size();
-			for (int i= 0; i < size; i+= 3)
-			{
-				// Avoid normal problem
-				if (faceIsCounterclockwise)
-				{
-					pIndexList->append(indexMap.value(face[tList[i]]));
-					pIndexList->append(indexMap.value(face[tList[i + 1]]));
-					pIndexList->append(indexMap.value(face[tList[i + 2]]));
-				}
-				else
-				{
-					pIndexList->append(indexMap.value(face[tList[i + 2]]));
-					pIndexList->append(indexMap.value(face[tList[i + 1]]));
-					pIndexList->append(indexMap.value(face[tList[i]]));
-				}
-			}
-			Q_ASSERT(size == pIndexList->size());
+	// The triangulation of a simple polygon has at least n + 2h - 2 triangles which cover its area,
+	// collinear vertices can add triangles of null area
+	const int triangleCount= (pTriangles->size() - first) / 3;
+	bool isValid= (triangleCount >= (vertexCount + 2 * (contourCount - 1) - 2));
+	const double tolerance= qAbs(polygonArea) * 1.0e-6;
+	double trianglesArea= 0.0;
+	for (int i= first; isValid && (i < pTriangles->size()); i+= 3)
+	{
+		const GLC_Point2d& p0= points.at(pTriangles->at(i));
+		const double area= ((points.at(pTriangles->at(i + 1)) - p0) ^ (points.at(pTriangles->at(i + 2)) - p0)) * 0.5;
+		isValid= (area >= -tolerance);
+		trianglesArea+= area;
 	}
+	isValid= isValid && (qAbs(trianglesArea - polygonArea) <= tolerance);
+	if (!isValid) pTriangles->resize(first);
 
+	return isValid;
 }
 
 bool glc::lineIntersectPlane(const GLC_Line3d& line, const GLC_Plane& plane, GLC_Point3d* pPoint)
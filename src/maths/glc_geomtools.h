@@ -77,7 +77,7 @@ namespace glc
 	//! Return true if the segment is a polygon diagonal
 	GLC_LIB_EXPORT bool isDiagonal(const QList<GLC_Point2d>&, const int, const int);
 
-	//! Triangulate a polygon
+	//! Triangulate a polygon by ear clipping
 	GLC_LIB_EXPORT void triangulate(QList<GLC_Point2d>&, QList<int>&, QList<int>&);
 
 	//! Return true if the polygon is couterclockwise ordered
@@ -87,6 +87,25 @@ namespace glc
 	/*! If the polygon is convex the returned index is a fan*/
 	GLC_LIB_EXPORT void triangulatePolygon(QList<GLuint>*, const QList<float>&);
 
+	//! Triangulate the polygon of the given indexes in the given contiguous positions
+	GLC_LIB_EXPORT void triangulatePolygon(QList<GLuint>* pIndexList, const GLfloat* pPositions);
+
+	//! Triangulate the polygon of the given indexes with the given holes in the given contiguous positions
+	/*! Return false if the polygon with its holes is not simple*/
+	GLC_LIB_EXPORT bool triangulatePolygon(QList<GLuint>* pIndexList, const QList<QList<GLuint> >& holes, const GLfloat* pPositions);
+
+	//! Triangulate the given polygons of more than 3 indexes, on a thread pool if parallel is true
+	GLC_LIB_EXPORT void triangulatePolygons(QList<QList<GLuint> >* pPolygons, const QList<float>& bulkList, bool parallel= true);
+
+	//! Triangulate the given polygons of more than 3 indexes in the given contiguous positions, on a thread pool if parallel is true
+	GLC_LIB_EXPORT void triangulatePolygons(QList<QList<GLuint> >* pPolygons, const GLfloat* pPositions, bool parallel= true);
+
+	//! Triangulate the given 2D polygon with holes with a sweep line in O(n log n)
+	/*! The first contour is the outer one and the next ones are holes, a contour is a list of indexes
+	 *  of the given points. The triangles are appended to the given indexes, counterclockwise ordered.
+	 *  Return false if the polygon is not simple*/
+	GLC_LIB_EXPORT bool triangulatePolygon2D(const QVector<GLC_Point2d>& points, const QList<QVector<int> >& contours, QVector<int>* pTriangles);
+
 	//! Return true if the given 3d line is intersected with the given plane
 	/*! If there is an intersection point is set to the given 3d point
 	 *  If the line lie on the plane this method return false*/
@@ -30,6 +30,7 @@
 #include <QPair>
 
 #include "glc_vector3d.h"
+#include "glc_batchtransform.h"
 
 #include "../glc_config.h"
 
@@ -336,28 +337,8 @@ GLC_Matrix4x4 GLC_Matrix4x4::operator * (const GLC_Matrix4x4 &Mat) const
 		return *this;
 	}
 
-	int Colonne;
-	int Ligne;
-	int i;
-	double ValInt;
-
-	int IndexInt;
-
 	GLC_Matrix4x4 MatResult;
-	for (Ligne= 0; Ligne < DIMMAT4X4; Ligne++)
-	{
-		for (Colonne=0; Colonne < DIMMAT4X4; Colonne++)
-		{
-			ValInt= 0.0;
-			IndexInt= Colonne * DIMMAT4X4;
-
-			for (i= 0; i < DIMMAT4X4; i++)
-			{
-				ValInt+= m_Matrix[ (i * DIMMAT4X4) + Ligne] * Mat.m_Matrix[ IndexInt + i];
-			}
-			MatResult.m_Matrix[ IndexInt + Ligne]= ValInt;
-		}
-	}
+	glc::multiplyMatrix4x4(m_Matrix, Mat.m_Matrix, MatResult.m_Matrix);
 	if ((m_Type == Indirect) || (Mat.m_Type == Indirect))
 	{
 		MatResult.m_Type= Indirect;
@@ -28,9 +28,11 @@
 #include "../glc_openglexception.h"
 #include "../shading/glc_selectionmaterial.h"
 #include "../glc_state.h"
+#include "../glc_renderstatistics.h"
 #include "../shading/glc_shader.h"
 #include "../viewport/glc_viewport.h"
 #include "glc_spacepartitioning.h"
+#include "glc_worldhandle.h"
 
 #include <QtDebug>
 
@@ -40,15 +42,27 @@
 
 GLC_3DViewCollection::GLC_3DViewCollection()
 : m_3DViewInstanceHash()
-, m_SelectedInstances()
+, m_Instances()
+, m_InstanceIndexHash()
+, m_VisibleBits()
+, m_SelectedBits()
+, m_SelectionHash()
 , m_ShadedPointerViewInstanceHash()
 , m_ShaderGroup()
-, m_MainInstances()
 , m_IsInShowSate(true)
 , m_UseLod(false)
 , m_pViewport(NULL)
+, m_pWorldHandle(NULL)
 , m_pSpacePartitioning(NULL)
 , m_UseSpacePartitioning(false)
+, m_FrustumCuller()
+, m_FrustumCullerIsValid(false)
+, m_OcclusionCuller()
+, m_StaticBatcher()
+, m_InstancedRenderer()
+, m_DrawListHash()
+, m_DrawListsAreValid(false)
+, m_DrawListsAreCulled(false)
 , m_IsViewable(true)
 {
 }
@@ -84,25 +98,16 @@ bool GLC_3DViewCollection::unBindShader(GLC_uint shaderId)
 		// Find node which use the shader
 		QList<GLC_uint> nodeId(m_ShaderGroup.keys(shaderId));
 
-		// Move these node in the standard hash and remove them from shader group
+		// Move these node in the main group
 		PointerViewInstanceHash* pShaderNodeHash= m_ShadedPointerViewInstanceHash.take(shaderId);
 		for (int i= 0; i < nodeId.size(); ++i)
 		{
-			const GLC_uint id= nodeId[i];
-			GLC_3DViewInstance* pInstance= pShaderNodeHash->value(id);
-
-			if (!pInstance->isSelected())
-			{
-				m_MainInstances.insert(id, pInstance);
-			}
-			else
-			{
-				m_SelectedInstances.insert(id, pInstance);
-			}
-			m_ShaderGroup.remove(id);
+			m_ShaderGroup.remove(nodeId[i]);
 		}
 		pShaderNodeHash->clear();
 		delete pShaderNodeHash;
+		m_DrawListHash.remove(shaderId);
+		m_DrawListsAreValid= false;
 		result= true;
 	}
 	Q_ASSERT(!m_ShadedPointerViewInstanceHash.contains(shaderId));
@@ -129,48 +134,53 @@ bool GLC_3DViewCollection::unBindAllShader()
 
 bool GLC_3DViewCollection::add(const GLC_3DViewInstance& node, GLC_uint shaderID)
 {
-	bool result= false;
 	const GLC_uint key= node.id();
 	if (m_3DViewInstanceHash.contains(key))
 	{
 		return false;
 	}
+	// Test if shaderId group exist
+	if ((0 != shaderID) && !m_ShadedPointerViewInstanceHash.contains(shaderID))
+	{
+		return false;
+	}
 
 	m_3DViewInstanceHash.insert(key, node);
+	// The frustum culler indexes are not the bit sets indexes until the next culling
+	m_FrustumCullerIsValid= false;
+	m_DrawListsAreValid= false;
+	m_DrawListsAreCulled= false;
 	// Create an GLC_3DViewInstance pointer of the inserted instance
 	ViewInstancesHash::iterator iNode= m_3DViewInstanceHash.find(key);
 	GLC_3DViewInstance* pInstance= &(iNode.value());
-	// Chose the hash where instance is
-	if(0 != shaderID)
+	if (NULL != m_pSpacePartitioning)
 	{
-		// Test if shaderId group exist
-		if (m_ShadedPointerViewInstanceHash.contains(shaderID))
-		{
-			m_ShaderGroup.insert(key, shaderID);
-
-			if(pInstance->isSelected())
-			{
-				m_SelectedInstances.insert(key, pInstance);
-			}
-			else
-			{
-				m_ShadedPointerViewInstanceHash.value(shaderID)->insert(key, pInstance);
-			}
-			result=true;
-		}
+		pInstance->setSpacePartitioning(m_pSpacePartitioning);
+		m_pSpacePartitioning->insertInstance(pInstance);
 	}
-	else if (!pInstance->isSelected())
+
+	// The instance takes the next index of the bit sets
+	const int index= m_Instances.size();
+	m_Instances.append(pInstance);
+	m_InstanceIndexHash.insert(key, index);
+	pInstance->setCollection(this, index);
+	m_VisibleBits.resize(index + 1);
+	m_VisibleBits.setBit(index, pInstance->isVisible());
+	m_SelectedBits.resize(index + 1);
+	if (pInstance->isSelected())
 	{
-		m_MainInstances.insert(key, pInstance);
-		result=true;
+		m_SelectedBits.setBit(index);
+		m_SelectionHash.insert(key, pInstance);
 	}
-	else
+
+	// Chose the group where instance is
+	if(0 != shaderID)
 	{
-		m_SelectedInstances.insert(key, pInstance);
-		result=true;
+		m_ShaderGroup.insert(key, shaderID);
+		m_ShadedPointerViewInstanceHash.value(shaderID)->insert(key, pInstance);
 	}
 
-	return result;
+	return true;
 }
 
 void GLC_3DViewCollection::changeShadingGroup(GLC_uint instanceId, GLC_uint shaderId)
@@ -180,51 +190,20 @@ void GLC_3DViewCollection::changeShadingGroup(GLC_uint instanceId, GLC_uint shad
 	// Get the instance shading group
 	const GLuint instanceShadingGroup= shadingGroup(instanceId);
 	// Get a pointer to the instance
-	GLC_3DViewInstance* pInstance= NULL;
-	if (0 == instanceShadingGroup)
+	GLC_3DViewInstance* pInstance= m_Instances.at(m_InstanceIndexHash.value(instanceId));
+	if (0 != instanceShadingGroup)
 	{
-		// The instance is not in a shading group
-		if (m_MainInstances.contains(instanceId))
-		{
-			pInstance= m_MainInstances.take(instanceId);
-		}
-		else if (m_SelectedInstances.contains(instanceId))
-		{
-			// The instance is selected don't take it
-			pInstance= m_SelectedInstances.value(instanceId);
-		}
-		else
-		{
-			Q_ASSERT(false);
-		}
-	}
-	else
-	{
-		m_ShaderGroup.remove(instanceId);
 		// The instance is in a shading group
-		if (m_SelectedInstances.contains(instanceId))
-		{
-			// The instance is selected don't take it
-			pInstance= m_SelectedInstances.value(instanceId);
-		}
-		else
-		{
-			pInstance= m_ShadedPointerViewInstanceHash.value(instanceShadingGroup)->take(instanceId);
-		}
-
+		m_ShaderGroup.remove(instanceId);
+		m_ShadedPointerViewInstanceHash.value(instanceShadingGroup)->remove(instanceId);
 	}
+	m_DrawListsAreValid= false;
 	// Put the instance in specified shading group
 	if (0 != shaderId)
 	{
+		m_StaticBatcher.removeInstance(pInstance);
 		m_ShaderGroup.insert(instanceId, shaderId);
-		if (!pInstance->isSelected())
-		{
-			m_ShadedPointerViewInstanceHash.value(shaderId)->insert(instanceId, pInstance);
-		}
-	}
-	else if (!pInstance->isSelected())
-	{
-		m_MainInstances.insert(instanceId, pInstance);
+		m_ShadedPointerViewInstanceHash.value(shaderId)->insert(instanceId, pInstance);
 	}
 }
 
@@ -235,15 +214,26 @@ bool GLC_3DViewCollection::remove(GLC_uint Key)
 	if (iNode != m_3DViewInstanceHash.end())
 	{	// Ok, the key exist
 
-		if (selectionSize() > 0)
+		// if the geometry is selected, unselect it
+		unselect(Key);
+
+		if (isInAShadingGroup(Key))
 		{
-			// if the geometry is selected, unselect it
-			unselect(Key);
+			m_ShadedPointerViewInstanceHash.value(shadingGroup(Key))->remove(Key);
+			m_ShaderGroup.remove(Key);
 		}
+		m_StaticBatcher.removeInstance(&(iNode.value()));
 
-		m_MainInstances.remove(Key);
+		if (NULL != m_pSpacePartitioning)
+		{
+			m_pSpacePartitioning->removeInstance(&(iNode.value()));
+		}
 
+		removeIndex(m_InstanceIndexHash.take(Key));
 		m_3DViewInstanceHash.remove(Key);		// Delete the conteneur
+		m_FrustumCullerIsValid= false;
+		m_DrawListsAreValid= false;
+		m_DrawListsAreCulled= false;
 
 		//qDebug("GLC_3DViewCollection::removeNode : Element succesfuly deleted");
 		return true;
@@ -258,10 +248,12 @@ bool GLC_3DViewCollection::remove(GLC_uint Key)
 
 void GLC_3DViewCollection::clear(void)
 {
-	// Clear Selected node Hash Table
-	m_SelectedInstances.clear();
-	// Clear the not transparent Hash Table
-	m_MainInstances.clear();
+	// Clear the instances bit sets
+	m_Instances.clear();
+	m_InstanceIndexHash.clear();
+	m_VisibleBits.clear();
+	m_SelectedBits.clear();
+	m_SelectionHash.clear();
 	// Clear Other Node Hash List
 	HashList::iterator iEntry= m_ShadedPointerViewInstanceHash.begin();
     while (iEntry != m_ShadedPointerViewInstanceHash.constEnd())
@@ -273,39 +265,36 @@ void GLC_3DViewCollection::clear(void)
 
 	m_ShadedPointerViewInstanceHash.clear();
 	m_ShaderGroup.clear();
+	m_StaticBatcher.clear();
 
 	// Clear main Hash table
     m_3DViewInstanceHash.clear();
+	m_FrustumCuller.setInstances(QVector<GLC_3DViewInstance*>());
+	m_FrustumCullerIsValid= true;
+	m_DrawListHash.clear();
+	m_DrawListsAreValid= false;
+	m_DrawListsAreCulled= false;
 
 	// delete the space partitioning
 	delete m_pSpacePartitioning;
+	m_pSpacePartitioning= NULL;
 }
 
 bool GLC_3DViewCollection::select(GLC_uint key, bool primitive)
 {
-	if (!m_3DViewInstanceHash.contains(key)) return false;
 	//qDebug() << "GLC_Collection::select " << key;
+	QHash<GLC_uint, int>::const_iterator iIndex= m_InstanceIndexHash.constFind(key);
 
-	GLC_3DViewInstance* pSelectedInstance;
-	ViewInstancesHash::iterator iNode= m_3DViewInstanceHash.find(key);
-	PointerViewInstanceHash::iterator iSelectedNode= m_SelectedInstances.find(key);
-
-	if ((iNode != m_3DViewInstanceHash.end()) && (iSelectedNode == m_SelectedInstances.end()))
+	if ((iIndex != m_InstanceIndexHash.constEnd()) && !m_SelectedBits.testBit(iIndex.value()))
 	{	// Ok, the key exist and the node is not selected
-		pSelectedInstance= &(iNode.value());
-		m_SelectedInstances.insert(pSelectedInstance->id(), pSelectedInstance);
+		const int index= iIndex.value();
+		GLC_3DViewInstance* pSelectedInstance= m_Instances.at(index);
+		m_SelectedBits.setBit(index);
 
-		// Remove Selected Node from is previous collection
-		if (isInAShadingGroup(key))
-		{
-			m_ShadedPointerViewInstanceHash.value(shadingGroup(key))->remove(key);
-			//qDebug() << "remove from shader list";
-		}
-		else
-		{
-			m_MainInstances.remove(key);
-		}
+		m_StaticBatcher.removeInstance(pSelectedInstance);
 		pSelectedInstance->select(primitive);
+		m_SelectionHash.insert(key, pSelectedInstance);
+		m_DrawListsAreValid= false;
 
 		//qDebug("GLC_3DViewCollection::selectNode : Element succesfuly selected");
 		return true;
@@ -319,48 +308,36 @@ bool GLC_3DViewCollection::select(GLC_uint key, bool primitive)
 void GLC_3DViewCollection::selectAll(bool allShowState)
 {
 	unselectAll();
-	ViewInstancesHash::iterator iNode= m_3DViewInstanceHash.begin();
-	while (iNode != m_3DViewInstanceHash.end())
+	if (allShowState)
+	{
+		m_SelectedBits.fill(true);
+	}
+	else
 	{
-		GLC_3DViewInstance *pCurrentInstance= &(iNode.value());
-		const GLC_uint instanceId= pCurrentInstance->id();
+		m_SelectedBits= viewableBits();
+	}
 
-		if (allShowState || (pCurrentInstance->isVisible() == m_IsInShowSate))
-		{
-			pCurrentInstance->select(false);
-			m_SelectedInstances.insert(instanceId, pCurrentInstance);
-			m_MainInstances.remove(instanceId);
-			if(isInAShadingGroup(instanceId))
-			{
-				m_ShadedPointerViewInstanceHash.value(shadingGroup(instanceId))->remove(instanceId);
-			}
-		}
-		iNode++;
+	for (int i= m_SelectedBits.nextSetBit(0); i != -1; i= m_SelectedBits.nextSetBit(i + 1))
+	{
+		GLC_3DViewInstance *pCurrentInstance= m_Instances.at(i);
+		m_StaticBatcher.removeInstance(pCurrentInstance);
+		pCurrentInstance->select(false);
+		m_SelectionHash.insert(pCurrentInstance->id(), pCurrentInstance);
 	}
+	m_DrawListsAreValid= false;
 }
 
 bool GLC_3DViewCollection::unselect(GLC_uint key)
 {
-	GLC_3DViewInstance* pSelectedNode;
-
-	PointerViewInstanceHash::iterator iSelectedNode= m_SelectedInstances.find(key);
+	QHash<GLC_uint, int>::const_iterator iIndex= m_InstanceIndexHash.constFind(key);
 
-	if (iSelectedNode != m_SelectedInstances.end())
+	if ((iIndex != m_InstanceIndexHash.constEnd()) && m_SelectedBits.testBit(iIndex.value()))
 	{	// Ok, the key exist and the node is selected
-		iSelectedNode.value()->unselect();
-
-		pSelectedNode= iSelectedNode.value();
-		m_SelectedInstances.remove(key);
-
-		// Insert Selected Node to the right collection
-		if (isInAShadingGroup(key))
-		{
-			m_ShadedPointerViewInstanceHash.value(shadingGroup(key))->insert(key, pSelectedNode);
-		}
-		else
-		{
-			m_MainInstances.insert(key, pSelectedNode);
-		}
+		const int index= iIndex.value();
+		m_Instances.at(index)->unselect();
+		m_SelectedBits.clearBit(index);
+		m_SelectionHash.remove(key);
+		m_DrawListsAreValid= false;
 
 		//qDebug("GLC_3DViewCollection::unselectNode : Node succesfuly unselected");
 		return true;
@@ -375,25 +352,13 @@ bool GLC_3DViewCollection::unselect(GLC_uint key)
 
 void GLC_3DViewCollection::unselectAll()
 {
-	PointerViewInstanceHash::iterator iSelectedNode= m_SelectedInstances.begin();
-
-    while (iSelectedNode != m_SelectedInstances.end())
-    {
-    	GLC_3DViewInstance* pInstance= iSelectedNode.value();
-    	pInstance->unselect();
-		if (isInAShadingGroup(pInstance->id()))
-		{
-			m_ShadedPointerViewInstanceHash.value(shadingGroup(pInstance->id()))->insert(pInstance->id(), pInstance);
-		}
-		else
-		{
-			m_MainInstances.insert(pInstance->id(), pInstance);
-		}
-
-        ++iSelectedNode;
-    }
-    // Clear selected node hash table
-    m_SelectedInstances.clear();
+	for (int i= m_SelectedBits.nextSetBit(0); i != -1; i= m_SelectedBits.nextSetBit(i + 1))
+	{
+		m_Instances.at(i)->unselect();
+	}
+	m_SelectedBits.fill(false);
+	m_SelectionHash.clear();
+	m_DrawListsAreValid= false;
 }
 
 void GLC_3DViewCollection::setPolygonModeForAll(GLenum face, GLenum mode)
@@ -410,34 +375,57 @@ void GLC_3DViewCollection::setPolygonModeForAll(GLenum face, GLenum mode)
 
 void GLC_3DViewCollection::setVisibility(const GLC_uint key, const bool visibility)
 {
-	ViewInstancesHash::iterator iNode= m_3DViewInstanceHash.find(key);
-	if (iNode != m_3DViewInstanceHash.end())
-	{	// Ok, the key exist
-		iNode.value().setVisibility(visibility);
+	QHash<GLC_uint, int>::const_iterator iIndex= m_InstanceIndexHash.constFind(key);
+	if (iIndex != m_InstanceIndexHash.constEnd())
+	{	// Ok, the key exist, the instance updates the visibility bit
+		m_Instances.at(iIndex.value())->setVisibility(visibility);
 	}
 }
 
 void GLC_3DViewCollection::showAll()
 {
-	ViewInstancesHash::iterator iEntry= m_3DViewInstanceHash.begin();
-
-    while (iEntry != m_3DViewInstanceHash.constEnd())
-    {
-     	iEntry.value().setVisibility(true);
-    	iEntry++;
-    }
+	// Only the hidden instances are changed
+	const GLC_BitSet hiddenInstances(~m_VisibleBits);
+	for (int i= hiddenInstances.nextSetBit(0); i != -1; i= hiddenInstances.nextSetBit(i + 1))
+	{
+		m_Instances.at(i)->setVisibility(true);
+	}
 }
 
 void GLC_3DViewCollection::hideAll()
 {
-	ViewInstancesHash::iterator iEntry= m_3DViewInstanceHash.begin();
+	// Only the visible instances are changed
+	const GLC_BitSet visibleInstances(m_VisibleBits);
+	for (int i= visibleInstances.nextSetBit(0); i != -1; i= visibleInstances.nextSetBit(i + 1))
+	{
+		m_Instances.at(i)->setVisibility(false);
+	}
+}
 
-    while (iEntry != m_3DViewInstanceHash.constEnd())
-    {
-    	iEntry.value().setVisibility(false);
-    	iEntry++;
-    }
+void GLC_3DViewCollection::setSelectedVisibility(bool visible)
+{
+	// Only the selected instances of the other visibility are changed
+	GLC_BitSet changedInstances(m_SelectedBits);
+	if (visible)
+	{
+		changedInstances.subtract(m_VisibleBits);
+	}
+	else
+	{
+		changedInstances&= m_VisibleBits;
+	}
+	for (int i= changedInstances.nextSetBit(0); i != -1; i= changedInstances.nextSetBit(i + 1))
+	{
+		m_Instances.at(i)->setVisibility(visible);
+	}
+}
 
+void GLC_3DViewCollection::swapSelectedVisibility()
+{
+	for (int i= m_SelectedBits.nextSetBit(0); i != -1; i= m_SelectedBits.nextSetBit(i + 1))
+	{
+		m_Instances.at(i)->setVisibility(!m_VisibleBits.testBit(i));
+	}
 }
 
 void GLC_3DViewCollection::bindSpacePartitioning(GLC_SpacePartitioning* pSpacePartitioning)
@@ -447,6 +435,7 @@ void GLC_3DViewCollection::bindSpacePartitioning(GLC_SpacePartitioning* pSpacePa
 
 	delete m_pSpacePartitioning;
 	m_pSpacePartitioning= pSpacePartitioning;
+	setInstancesSpacePartitioning(m_pSpacePartitioning);
 }
 
 void GLC_3DViewCollection::unbindSpacePartitioning()
@@ -454,6 +443,7 @@ void GLC_3DViewCollection::unbindSpacePartitioning()
 	delete m_pSpacePartitioning;
 	m_pSpacePartitioning= NULL;
 	m_UseSpacePartitioning= false;
+	setInstancesSpacePartitioning(NULL);
 
 	ViewInstancesHash::iterator iEntry= m_3DViewInstanceHash.begin();
     while (iEntry != m_3DViewInstanceHash.constEnd())
@@ -467,19 +457,63 @@ void GLC_3DViewCollection::unbindSpacePartitioning()
 
 void GLC_3DViewCollection::updateInstanceViewableState(GLC_Matrix4x4* pMatrix)
 {
+	updateAbsoluteMatrices();
 	if ((NULL != m_pViewport) && m_UseSpacePartitioning && (NULL != m_pSpacePartitioning))
 	{
+		// The space partitioning sets the viewable flag of all instances
+		if (m_DrawListsAreCulled)
+		{
+			m_DrawListsAreValid= false;
+			m_DrawListsAreCulled= false;
+		}
 		if (m_pViewport->updateFrustum(pMatrix))
 			m_pSpacePartitioning->updateViewableInstances(m_pViewport->frustum());
 	}
+	else if ((NULL != m_pViewport) && GLC_State::isFrustumCullingActivated())
+	{
+		// Instances can move without frustum change, they are culled before each frame
+		m_pViewport->updateFrustum(pMatrix);
+		const GLC_Matrix4x4 compositionMatrix(NULL != pMatrix ? *pMatrix : m_pViewport->compositionMatrix());
+		cullInstances(m_pViewport->frustum(), &compositionMatrix);
+	}
+	else if (m_DrawListsAreCulled)
+	{
+		// The frustum culling has been deactivated
+		m_DrawListsAreValid= false;
+		m_DrawListsAreCulled= false;
+		ViewInstancesHash::iterator iEntry= m_3DViewInstanceHash.begin();
+		while (iEntry != m_3DViewInstanceHash.constEnd())
+		{
+			iEntry.value().setViewable(GLC_3DViewInstance::FullViewable);
+			++iEntry;
+		}
+	}
 }
 
 void GLC_3DViewCollection::updateInstanceViewableState(const GLC_Frustum& frustum)
 {
+	updateAbsoluteMatrices();
     if (NULL != m_pSpacePartitioning)
     {
+        if (m_DrawListsAreCulled)
+        {
+            m_DrawListsAreValid= false;
+            m_DrawListsAreCulled= false;
+        }
         m_pSpacePartitioning->updateViewableInstances(frustum);
     }
+    else if (GLC_State::isFrustumCullingActivated())
+    {
+        if (NULL != m_pViewport)
+        {
+            const GLC_Matrix4x4 compositionMatrix(m_pViewport->compositionMatrix());
+            cullInstances(frustum, &compositionMatrix);
+        }
+        else
+        {
+            cullInstances(frustum, NULL);
+        }
+    }
 }
 
 void GLC_3DViewCollection::updateSpacePartitionning()
@@ -501,34 +535,34 @@ void GLC_3DViewCollection::setVboUsage(bool usage)
     }
 }
 
-QList<GLC_3DViewInstance*> GLC_3DViewCollection::instancesHandle()
+int GLC_3DViewCollection::buildStaticBatches()
 {
-	QList<GLC_3DViewInstance*> instancesList;
-
-	ViewInstancesHash::iterator iEntry= m_3DViewInstanceHash.begin();
+	// Only the not selected instances of the main group are batched
+	QList<GLC_3DViewInstance*> instances;
+	const GLC_BitSet notSelectedBits(~m_SelectedBits);
+	for (int i= notSelectedBits.nextSetBit(0); i != -1; i= notSelectedBits.nextSetBit(i + 1))
+	{
+		GLC_3DViewInstance* pInstance= m_Instances.at(i);
+		if (!m_ShaderGroup.contains(pInstance->id()))
+		{
+			instances.append(pInstance);
+		}
+	}
+	return m_StaticBatcher.build(instances);
+}
 
-    while (iEntry != m_3DViewInstanceHash.constEnd())
-    {
-    	instancesList.append(&(iEntry.value()));
-    	iEntry++;
-    }
-	return instancesList;
+QList<GLC_3DViewInstance*> GLC_3DViewCollection::instancesHandle()
+{
+	return m_Instances.toList();
 }
 
 QList<GLC_3DViewInstance*> GLC_3DViewCollection::visibleInstancesHandle()
 {
 	QList<GLC_3DViewInstance*> instancesList;
-
-	ViewInstancesHash::iterator iEntry= m_3DViewInstanceHash.begin();
-
-    while (iEntry != m_3DViewInstanceHash.constEnd())
-    {
-    	if (iEntry.value().isVisible())
-    	{
-        	instancesList.append(&(iEntry.value()));
-    	}
-    	iEntry++;
-    }
+	for (int i= m_VisibleBits.nextSetBit(0); i != -1; i= m_VisibleBits.nextSetBit(i + 1))
+	{
+		instancesList.append(m_Instances.at(i));
+	}
 	return instancesList;
 
 }
@@ -536,20 +570,36 @@ QList<GLC_3DViewInstance*> GLC_3DViewCollection::visibleInstancesHandle()
 QList<GLC_3DViewInstance*> GLC_3DViewCollection::viewableInstancesHandle()
 {
 	QList<GLC_3DViewInstance*> instancesList;
+	const GLC_BitSet viewableInstances(viewableBits());
+	for (int i= viewableInstances.nextSetBit(0); i != -1; i= viewableInstances.nextSetBit(i + 1))
+	{
+		instancesList.append(m_Instances.at(i));
+	}
+	return instancesList;
+}
 
-	ViewInstancesHash::iterator iEntry= m_3DViewInstanceHash.begin();
-
-    while (iEntry != m_3DViewInstanceHash.constEnd())
-    {
-    	if (iEntry.value().isVisible() == m_IsInShowSate)
-    	{
-        	instancesList.append(&(iEntry.value()));
-    	}
-    	iEntry++;
-    }
+QList<GLC_3DViewInstance*> GLC_3DViewCollection::selectedInstancesHandle()
+{
+	QList<GLC_3DViewInstance*> instancesList;
+	for (int i= m_SelectedBits.nextSetBit(0); i != -1; i= m_SelectedBits.nextSetBit(i + 1))
+	{
+		instancesList.append(m_Instances.at(i));
+	}
 	return instancesList;
 }
 
+GLC_BitSet GLC_3DViewCollection::viewableBits() const
+{
+	if (m_IsInShowSate)
+	{
+		return m_VisibleBits;
+	}
+	else
+	{
+		return ~m_VisibleBits;
+	}
+}
+
 GLC_3DViewInstance* GLC_3DViewCollection::instanceHandle(GLC_uint Key)
 {
 	Q_ASSERT(m_3DViewInstanceHash.contains(Key));
@@ -558,41 +608,33 @@ GLC_3DViewInstance* GLC_3DViewCollection::instanceHandle(GLC_uint Key)
 
 GLC_BoundingBox GLC_3DViewCollection::boundingBox(bool allObject)
 {
+	updateAbsoluteMatrices();
 	GLC_BoundingBox boundingBox;
-	// Check if the bounding box have to be updated
-	if (!m_3DViewInstanceHash.isEmpty())
+	if (allObject)
 	{
-		ViewInstancesHash::iterator iEntry= m_3DViewInstanceHash.begin();
-	    while (iEntry != m_3DViewInstanceHash.constEnd())
-	    {
-	        if(allObject || iEntry.value().isVisible() == m_IsInShowSate)
-	        {
-	        	// Combine Collection BoundingBox with element Bounding Box
-	        	boundingBox.combine(iEntry.value().boundingBox());
-	        }
-	        ++iEntry;
-	    }
+		const int size= m_Instances.size();
+		for (int i= 0; i < size; ++i)
+		{
+			boundingBox.combine(m_Instances.at(i)->boundingBox());
+		}
+	}
+	else
+	{
+		const GLC_BitSet viewableInstances(viewableBits());
+		for (int i= viewableInstances.nextSetBit(0); i != -1; i= viewableInstances.nextSetBit(i + 1))
+		{
+			// Combine Collection BoundingBox with element Bounding Box
+			boundingBox.combine(m_Instances.at(i)->boundingBox());
+		}
 	}
 	return boundingBox;
 }
 
 int GLC_3DViewCollection::drawableObjectsSize() const
 {
-	// The number of object to drw
-	int numberOffDrawnHit= 0;
-
-	// Count the number off instance to draw
-	ViewInstancesHash::const_iterator i= m_3DViewInstanceHash.begin();
-	while (i != m_3DViewInstanceHash.constEnd())
-	{
-		//qDebug() << "transparent";
-		if (i.value().isVisible() == m_IsInShowSate)
-		{
-			++numberOffDrawnHit;
-		}
-		++i;
-	}
-	return numberOffDrawnHit;
+	// The number of object to draw
+	const int visibleCount= m_VisibleBits.count();
+	return m_IsInShowSate ? visibleCount : (m_Instances.size() - visibleCount);
 }
 
 QList<QString> GLC_3DViewCollection::instanceNamesFromShadingGroup(GLuint shaderId) const
@@ -621,6 +663,7 @@ int GLC_3DViewCollection::numberOfUsedShadingGroup() const
 
 void GLC_3DViewCollection::render(GLuint groupId, glc::RenderFlag renderFlag)
 {
+	updateAbsoluteMatrices();
 	if (!isEmpty() && m_IsViewable)
 	{
 		if (renderFlag == glc::WireRenderFlag)
@@ -648,6 +691,7 @@ void GLC_3DViewCollection::render(GLuint groupId, glc::RenderFlag renderFlag)
 }
 void GLC_3DViewCollection::renderShaderGroup(glc::RenderFlag renderFlag)
 {
+	updateAbsoluteMatrices();
 	if (!isEmpty() && m_IsViewable)
 	{
 		if (GLC_State::isInSelectionMode())
@@ -686,30 +730,47 @@ void GLC_3DViewCollection::glDraw(GLC_uint groupId, glc::RenderFlag renderFlag)
 		}
 	}
 
+	if (!m_DrawListsAreValid)
+	{
+		updateDrawLists();
+	}
+
 	// Normal GLC_3DViewInstance
-	if ((groupId == 0) && !m_MainInstances.isEmpty())
+	if ((groupId == 0) && !m_DrawListHash.value(0).isEmpty())
 	{
-		glDrawInstancesOf(&m_MainInstances, renderFlag);
+		QVector<GLC_3DViewInstance*>* pDrawList= &m_DrawListHash[0];
+		// Static batches are opaque, their silhouette is drawn by their instances
+		if ((renderFlag != glc::TransparentRenderFlag) && (renderFlag != glc::OutlineSilhouetteRenderFlag))
+		{
+			m_StaticBatcher.glDraw(m_IsInShowSate);
+		}
+
+		// Instances sharing a representation are drawn instanced, the others by the group
+		const bool useInstancing= !m_UseLod && (renderFlag == glc::ShadingFlag) && GLC_InstancedRenderer::isUsable();
+		if (useInstancing)
+		{
+			glDrawInstancedOf(pDrawList);
+		}
+		glDrawInstancesOf(pDrawList, renderFlag);
+		if (useInstancing) m_InstancedRenderer.clear();
 
 	}
 	// Selected GLC_3DVIewInstance
-	else if ((groupId == 1) && !m_SelectedInstances.isEmpty())
+	else if ((groupId == 1) && !m_DrawListHash.value(1).isEmpty())
 	{
 		if (GLC_State::selectionShaderUsed()) GLC_SelectionMaterial::useShader();
 
-		glDrawInstancesOf(&m_SelectedInstances, renderFlag);
+		glDrawInstancesOf(&m_DrawListHash[1], renderFlag);
 
 		if (GLC_State::selectionShaderUsed()) GLC_SelectionMaterial::unUseShader();
 	}
 	// GLC_3DViewInstance with shader
 	else if (!m_ShadedPointerViewInstanceHash.isEmpty())
 	{
-	    if(m_ShadedPointerViewInstanceHash.contains(groupId) && !m_ShadedPointerViewInstanceHash.value(groupId)->isEmpty())
+	    if(m_ShadedPointerViewInstanceHash.contains(groupId) && !m_DrawListHash.value(groupId).isEmpty())
 	    {
-	    	PointerViewInstanceHash* pNodeHash= m_ShadedPointerViewInstanceHash.value(groupId);
-
 	    	GLC_Shader::use(groupId);
-	    	glDrawInstancesOf(pNodeHash, renderFlag);
+	    	glDrawInstancesOf(&m_DrawListHash[groupId], renderFlag);
 	    	GLC_Shader::unuse();
 	    }
 	}
@@ -722,3 +783,110 @@ void GLC_3DViewCollection::glDraw(GLC_uint groupId, glc::RenderFlag renderFlag)
 		glEnable(GL_DEPTH_TEST);
 	}
 }
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_3DViewCollection::setInstancesSpacePartitioning(GLC_SpacePartitioning* pSpacePartitioning)
+{
+	ViewInstancesHash::iterator iEntry= m_3DViewInstanceHash.begin();
+	while (iEntry != m_3DViewInstanceHash.constEnd())
+	{
+		iEntry.value().setSpacePartitioning(pSpacePartitioning);
+		++iEntry;
+	}
+}
+
+void GLC_3DViewCollection::updateAbsoluteMatrices()
+{
+	if (NULL != m_pWorldHandle)
+	{
+		m_pWorldHandle->updateAbsoluteMatrices();
+	}
+}
+
+void GLC_3DViewCollection::cullInstances(const GLC_Frustum& frustum, const GLC_Matrix4x4* pCompositionMatrix)
+{
+	if (!m_FrustumCullerIsValid)
+	{
+		// The frustum culler indexes are the indexes of the bit sets
+		m_FrustumCuller.setInstances(m_Instances);
+		m_FrustumCullerIsValid= true;
+	}
+	const bool parallel= GLC_State::isParallelCullingActivated();
+	m_FrustumCuller.cull(frustum, parallel);
+
+	int occlusionCulledCount= 0;
+	if ((NULL != pCompositionMatrix) && GLC_State::isOcclusionCullingActivated())
+	{
+		occlusionCulledCount= m_OcclusionCuller.cull(&m_FrustumCuller, *pCompositionMatrix, m_IsInShowSate, parallel);
+	}
+
+	// Merge viewable instances in the draw list of their group
+	m_DrawListsAreCulled= true;
+	updateDrawLists();
+
+	const int size= m_FrustumCuller.instanceCount();
+	const int viewableCount= m_FrustumCuller.viewableBits().count();
+	GLC_RenderStatistics::addFrustumCulledInstances(size - viewableCount - occlusionCulledCount);
+	GLC_RenderStatistics::addOcclusionCulledInstances(occlusionCulledCount);
+}
+
+void GLC_3DViewCollection::removeIndex(int index)
+{
+	const int lastIndex= m_Instances.size() - 1;
+	if (index != lastIndex)
+	{
+		GLC_3DViewInstance* pLastInstance= m_Instances.at(lastIndex);
+		m_Instances[index]= pLastInstance;
+		m_InstanceIndexHash[pLastInstance->id()]= index;
+		pLastInstance->setCollection(this, index);
+		m_VisibleBits.setBit(index, m_VisibleBits.testBit(lastIndex));
+		m_SelectedBits.setBit(index, m_SelectedBits.testBit(lastIndex));
+	}
+	m_Instances.resize(lastIndex);
+	m_VisibleBits.resize(lastIndex);
+	m_SelectedBits.resize(lastIndex);
+}
+
+void GLC_3DViewCollection::resetDrawLists()
+{
+	QHash<GLC_uint, QVector<GLC_3DViewInstance*> >::iterator iList= m_DrawListHash.begin();
+	while (iList != m_DrawListHash.constEnd())
+	{
+		iList.value().resize(0);
+		++iList;
+	}
+
+	// All groups have a draw list, so the draw lists are not moved while they are filled
+	m_DrawListHash[0];
+	m_DrawListHash[1];
+	HashList::const_iterator iGroup= m_ShadedPointerViewInstanceHash.constBegin();
+	while (iGroup != m_ShadedPointerViewInstanceHash.constEnd())
+	{
+		m_DrawListHash[iGroup.key()];
+		++iGroup;
+	}
+}
+
+void GLC_3DViewCollection::updateDrawLists()
+{
+	// Only the instances in the current show state are drawn
+	GLC_BitSet drawnInstances(viewableBits());
+	if (m_DrawListsAreCulled)
+	{
+		// The draw lists stay culled by the last frustum culling
+		Q_ASSERT(m_FrustumCullerIsValid);
+		drawnInstances&= m_FrustumCuller.viewableBits();
+	}
+
+	resetDrawLists();
+	QVector<GLC_3DViewInstance*>* pMainList= &m_DrawListHash[0];
+	QVector<GLC_3DViewInstance*>* pSelectedList= &m_DrawListHash[1];
+	for (int i= drawnInstances.nextSetBit(0); i != -1; i= drawnInstances.nextSetBit(i + 1))
+	{
+		appendToDrawList(i, pMainList, pSelectedList);
+	}
+	m_DrawListsAreValid= true;
+}
@@ -28,6 +28,11 @@
 
 #include <QHash>
 #include "glc_3dviewinstance.h"
+#include "glc_bitset.h"
+#include "glc_frustumculler.h"
+#include "glc_occlusionculler.h"
+#include "glc_staticbatcher.h"
+#include "glc_instancedrenderer.h"
 #include "../glc_global.h"
 #include "../viewport/glc_frustum.h"
 
@@ -37,6 +42,7 @@ class GLC_SpacePartitioning;
 class GLC_Material;
 class GLC_Shader;
 class GLC_Viewport;
+class GLC_WorldHandle;
 
 //! GLC_3DViewInstance Hash table
 typedef QHash< GLC_uint, GLC_3DViewInstance> ViewInstancesHash;
@@ -57,6 +63,14 @@ typedef QHash<GLC_uint, GLC_uint> ShaderIdToInstancesId;
 /*! An GLC_3DViewCollection contains  :
  * 		- A hash table containing GLC_3DViewInstance Class
  * 		- A hash table use to associate shader with GLC_3DViewInstance
+ * 		- Bit sets of the visible and selected instances
+ *
+ * Each instance has an index in the bit sets, the indexes are dense :
+ * when an instance is removed, the last instance takes its index.
+ * An instance updates the visibility bit set of its collection when its
+ * visibility is changed. The selection of the instances must be changed
+ * with this collection to keep the selection bit set up to date.
+ * The draw lists contain only the instances in the current show state.
  */
 //////////////////////////////////////////////////////////////////////
 
@@ -108,13 +122,17 @@ public:
 	/*! If all object is set to true, visible and non visible object are used*/
 	GLC_BoundingBox boundingBox(bool allObject= false);
 
-	//! Return the number of Node in the selection Hash
+	//! Return the number of selected instances
 	inline int selectionSize(void) const
-	{return m_SelectedInstances.size();}
+	{return m_SelectedBits.count();}
 
 	//! Get the Hash table of Selected Nodes
+	/*! The hash table is updated by each selection change of this collection*/
 	inline PointerViewInstanceHash* selection()
-	{return &m_SelectedInstances;}
+	{return &m_SelectionHash;}
+
+	//! Return all selected GLC_3DViewInstance from the collection
+	QList<GLC_3DViewInstance*> selectedInstancesHandle();
 
 	//! Return true if the Instance Id is in the collection
 	inline bool contains(GLC_uint key) const
@@ -122,7 +140,33 @@ public:
 
 	//! Return true if the element is selected
 	inline bool isSelected(GLC_uint key) const
-	{return m_SelectedInstances.contains(key);}
+	{
+		QHash<GLC_uint, int>::const_iterator iIndex= m_InstanceIndexHash.constFind(key);
+		return (iIndex != m_InstanceIndexHash.constEnd()) && m_SelectedBits.testBit(iIndex.value());
+	}
+
+	//! Return the index in the bit sets of the instance of the given id, -1 if there is none
+	inline int indexOf(GLC_uint key) const
+	{return m_InstanceIndexHash.value(key, -1);}
+
+	//! Return the instance at the given index of the bit sets
+	inline GLC_3DViewInstance* instanceHandleAt(int index) const
+	{return m_Instances.at(index);}
+
+	//! Return the visibility of the instances, one bit per instance index
+	inline const GLC_BitSet& visibleBits() const
+	{return m_VisibleBits;}
+
+	//! Return the hidden instances, one bit per instance index
+	inline GLC_BitSet hiddenBits() const
+	{return ~m_VisibleBits;}
+
+	//! Return the instances in the current show state, one bit per instance index
+	GLC_BitSet viewableBits() const;
+
+	//! Return the selected instances, one bit per instance index
+	inline const GLC_BitSet& selectedBits() const
+	{return m_SelectedBits;}
 
 	//! Return the showing state
 	inline bool showState() const
@@ -157,6 +201,14 @@ public:
 	inline bool isViewable() const
 	{return m_IsViewable;}
 
+	//! Return an handle to the static batcher of the main group instances
+	inline GLC_StaticBatcher* staticBatcherHandle()
+	{return &m_StaticBatcher;}
+
+	//! Return an handle to the instanced renderer of the main group instances
+	inline GLC_InstancedRenderer* instancedRendererHandle()
+	{return &m_InstancedRenderer;}
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -224,9 +276,29 @@ public:
 	//! Hide all instances of collection
 	void hideAll();
 
+	//! Set the visibility of the selected instances
+	void setSelectedVisibility(bool visible);
+
+	//! Swap the visibility of the selected instances
+	void swapSelectedVisibility();
+
 	//! Set the Show or noShow state
 	inline void swapShowState()
-	{m_IsInShowSate= !m_IsInShowSate;}
+	{
+		m_IsInShowSate= !m_IsInShowSate;
+		m_DrawListsAreValid= false;
+	}
+
+	//! Set the visibility bit of the instance at the given index
+	/*! Used by GLC_3DViewInstance::setVisibility()*/
+	inline void setVisibleBit(int index, bool visible)
+	{
+		if (m_VisibleBits.testBit(index) != visible)
+		{
+			m_VisibleBits.setBit(index, visible);
+			m_DrawListsAreValid= false;
+		}
+	}
 
 	//! Set the LOD usage
 	inline void setLodUsage(const bool usage, GLC_Viewport* pView)
@@ -247,7 +319,9 @@ public:
 
 	//! Update the instance viewable state
 	/*! Update the frustrum culling from the viewport
-	 * If the specified matrix pointer is not null*/
+	 * If the specified matrix pointer is not null.
+	 * Without space partitioning, if frustum culling is activated in GLC_State,
+	 * all instances are culled and only viewable instances are drawn*/
 	void updateInstanceViewableState(GLC_Matrix4x4* pMatrix= NULL);
 
 	//! Update the instance viewable state with the specified frustum
@@ -260,6 +334,10 @@ public:
 	inline void setAttachedViewport(GLC_Viewport* pViewport)
 	{m_pViewport= pViewport;}
 
+	//! Set the world handle whose dirty absolute matrices are updated before rendering and culling
+	inline void setWorldHandle(GLC_WorldHandle* pWorldHandle)
+	{m_pWorldHandle= pWorldHandle;}
+
 	//! Set the collection viewable state
 	inline void setViewable(bool viewable)
 	{m_IsViewable= viewable;}
@@ -267,6 +345,16 @@ public:
 	//! Set VBO usage
 	void setVboUsage(bool usage);
 
+	//! Merge the small static instances of the main group in static batches
+	/*! Return the number of batched instances. Instances which are moved, selected
+	 *  or moved in a shading group are removed from the batches, the batches have
+	 *  to be built again after a geometry or a material change*/
+	int buildStaticBatches();
+
+	//! Remove all instances from the static batches
+	inline void clearStaticBatches()
+	{m_StaticBatcher.clear();}
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -295,11 +383,43 @@ private:
 	//! Display collection's member
 	void glDraw(GLC_uint groupID, glc::RenderFlag renderFlag);
 
-	//! Draw instances of a PointerViewInstanceHash
-	inline void glDrawInstancesOf(PointerViewInstanceHash*, glc::RenderFlag);
+	//! Draw instances of a draw list
+	template <class Container>
+	inline void glDrawInstancesOf(Container*, glc::RenderFlag);
+
+	//! Draw with instanced draw calls the instances of a draw list which can be
+	template <class Container>
+	inline void glDrawInstancedOf(Container*);
 
 //@}
 
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Set the space partitioning of all the instances of this collection
+	void setInstancesSpacePartitioning(GLC_SpacePartitioning*);
+
+	//! Update the dirty absolute matrices of the world of this collection
+	void updateAbsoluteMatrices();
+
+	//! Remove the instance at the given index from the bit sets, the last instance takes its index
+	void removeIndex(int index);
+
+	//! Empty the draw lists of all groups
+	void resetDrawLists();
+
+	//! Append the instance at the given index in the draw list of its group
+	inline void appendToDrawList(int index, QVector<GLC_3DViewInstance*>* pMainList, QVector<GLC_3DViewInstance*>* pSelectedList);
+
+	//! Put the instances in the current show state, and viewable if the draw lists are culled, in the draw lists of their group
+	void updateDrawLists();
+
+	//! Cull all instances with the given frustum and create the draw lists of viewable instances
+	/*! If occlusion culling is activated and the given composition matrix is not NULL,
+	 *  instances viewable in the frustum are also occlusion culled*/
+	void cullInstances(const GLC_Frustum&, const GLC_Matrix4x4* pCompositionMatrix);
+
 //////////////////////////////////////////////////////////////////////
 // Private members
 //////////////////////////////////////////////////////////////////////
@@ -307,8 +427,20 @@ private:
 	//! GLC_3DViewInstance Hash Table
 	ViewInstancesHash m_3DViewInstanceHash;
 
-	//! Selected Node Hash Table
-	PointerViewInstanceHash m_SelectedInstances;
+	//! The instances of the collection indexed by their index in the bit sets
+	QVector<GLC_3DViewInstance*> m_Instances;
+
+	//! Map instance id to instance index in the bit sets
+	QHash<GLC_uint, int> m_InstanceIndexHash;
+
+	//! One bit per instance index, set if the instance is visible
+	GLC_BitSet m_VisibleBits;
+
+	//! One bit per instance index, set if the instance is selected
+	GLC_BitSet m_SelectedBits;
+
+	//! Hash table of the selected instances
+	PointerViewInstanceHash m_SelectionHash;
 
 	//! List of other Node Hash Table
 	HashList m_ShadedPointerViewInstanceHash;
@@ -316,9 +448,6 @@ private:
 	//! Shader groups hash
 	ShaderIdToInstancesId m_ShaderGroup;
 
-	//! Normal Node Hash Table
-	PointerViewInstanceHash m_MainInstances;
-
 	//! Show State
 	bool m_IsInShowSate;
 
@@ -328,12 +457,39 @@ private:
 	//! The viewport associted to the collection for LOD Usage
 	GLC_Viewport* m_pViewport;
 
+	//! The world handle of this collection, NULL if the collection is not a world collection
+	GLC_WorldHandle* m_pWorldHandle;
+
 	//! The space partitioning
 	GLC_SpacePartitioning* m_pSpacePartitioning;
 
 	//! The space partition usage
 	bool m_UseSpacePartitioning;
 
+	//! The frustum culler of instances used without space partitioning
+	GLC_FrustumCuller m_FrustumCuller;
+
+	//! True if the instances of the frustum culler are the instances of this collection
+	bool m_FrustumCullerIsValid;
+
+	//! The occlusion culler of instances viewable after frustum culling
+	GLC_OcclusionCuller m_OcclusionCuller;
+
+	//! The static batcher of the main group instances
+	GLC_StaticBatcher m_StaticBatcher;
+
+	//! The instanced renderer of the main group instances
+	GLC_InstancedRenderer m_InstancedRenderer;
+
+	//! The instances to draw of each group, the selected instances are in the group 1
+	QHash<GLC_uint, QVector<GLC_3DViewInstance*> > m_DrawListHash;
+
+	//! True if the draw lists are up to date with the groups and the selection
+	bool m_DrawListsAreValid;
+
+	//! True if the draw lists contain only the instances viewable after the frustum culling
+	bool m_DrawListsAreCulled;
+
 	//! Viewable state
 	bool m_IsViewable;
 
@@ -341,8 +497,31 @@ private:
     Q_DISABLE_COPY(GLC_3DViewCollection)
 };
 
-// Draw instances of a PointerViewInstanceHash
-void GLC_3DViewCollection::glDrawInstancesOf(PointerViewInstanceHash* pHash, glc::RenderFlag renderFlag)
+// Append the instance at the given index in the draw list of its group
+void GLC_3DViewCollection::appendToDrawList(int index, QVector<GLC_3DViewInstance*>* pMainList, QVector<GLC_3DViewInstance*>* pSelectedList)
+{
+	GLC_3DViewInstance* pInstance= m_Instances.at(index);
+	if (m_SelectedBits.testBit(index))
+	{
+		pSelectedList->append(pInstance);
+	}
+	else
+	{
+		ShaderIdToInstancesId::const_iterator iGroup= m_ShaderGroup.constFind(pInstance->id());
+		if (iGroup != m_ShaderGroup.constEnd())
+		{
+			m_DrawListHash[iGroup.value()].append(pInstance);
+		}
+		else
+		{
+			pMainList->append(pInstance);
+		}
+	}
+}
+
+// Draw instances of a draw list
+template <class Container>
+void GLC_3DViewCollection::glDrawInstancesOf(Container* pHash, glc::RenderFlag renderFlag)
 {
 	bool forceDisplay= false;
 	if (GLC_State::isInSelectionMode())
@@ -350,15 +529,15 @@ void GLC_3DViewCollection::glDrawInstancesOf(PointerViewInstanceHash* pHash, glc
 		forceDisplay= true;
 	}
 
-	PointerViewInstanceHash::iterator iEntry= pHash->begin();
+	typename Container::iterator iEntry= pHash->begin();
 	// The current instance
 	GLC_3DViewInstance* pCurInstance;
 	if (forceDisplay)
 	{
 		while (iEntry != pHash->constEnd())
 		{
-			pCurInstance= iEntry.value();
-			if ((pCurInstance->viewableFlag() != GLC_3DViewInstance::NoViewable) && (pCurInstance->isVisible() == m_IsInShowSate))
+			pCurInstance= *iEntry;
+			if ((pCurInstance->viewableFlag() != GLC_3DViewInstance::NoViewable) && !pCurInstance->isBatched() && !pCurInstance->isInstanced())
 			{
 				pCurInstance->render(renderFlag, m_UseLod, m_pViewport);
 			}
@@ -371,10 +550,12 @@ void GLC_3DViewCollection::glDrawInstancesOf(PointerViewInstanceHash* pHash, glc
 		{
 			while (iEntry != pHash->constEnd())
 			{
-				pCurInstance= iEntry.value();
-				if ((pCurInstance->viewableFlag() != GLC_3DViewInstance::NoViewable) && (pCurInstance->isVisible() == m_IsInShowSate))
+				pCurInstance= *iEntry;
+				if (pCurInstance->viewableFlag() != GLC_3DViewInstance::NoViewable)
 				{
-					if (!pCurInstance->isTransparent() || pCurInstance->renderPropertiesHandle()->isSelected() || (renderFlag == glc::WireRenderFlag))
+					// Batched instances are drawn by the static batcher except their silhouette
+					const bool isBatched= pCurInstance->isBatched() && (renderFlag != glc::OutlineSilhouetteRenderFlag);
+					if (!isBatched && !pCurInstance->isInstanced() && (!pCurInstance->isTransparent() || pCurInstance->renderPropertiesHandle()->isSelected() || (renderFlag == glc::WireRenderFlag)))
 					{
 						pCurInstance->render(renderFlag, m_UseLod, m_pViewport);
 					}
@@ -388,8 +569,8 @@ void GLC_3DViewCollection::glDrawInstancesOf(PointerViewInstanceHash* pHash, glc
 		{
 			while (iEntry != pHash->constEnd())
 			{
-				pCurInstance= iEntry.value();
-				if ((pCurInstance->viewableFlag() != GLC_3DViewInstance::NoViewable) && (pCurInstance->isVisible() == m_IsInShowSate))
+				pCurInstance= *iEntry;
+				if (pCurInstance->viewableFlag() != GLC_3DViewInstance::NoViewable)
 				{
 					if (pCurInstance->hasTransparentMaterials())
 					{
@@ -404,4 +585,21 @@ void GLC_3DViewCollection::glDrawInstancesOf(PointerViewInstanceHash* pHash, glc
 	}
 }
 
+// Draw with instanced draw calls the instances of a draw list which can be
+template <class Container>
+void GLC_3DViewCollection::glDrawInstancedOf(Container* pHash)
+{
+	typename Container::iterator iEntry= pHash->begin();
+	while (iEntry != pHash->constEnd())
+	{
+		GLC_3DViewInstance* pCurInstance= *iEntry;
+		if (pCurInstance->viewableFlag() != GLC_3DViewInstance::NoViewable)
+		{
+			m_InstancedRenderer.addInstance(pCurInstance);
+		}
+		++iEntry;
+	}
+	m_InstancedRenderer.glDraw();
+}
+
 #endif //GLC_3DVIEWCOLLECTION_H_
@@ -25,7 +25,12 @@
 #include "glc_3dviewinstance.h"
 #include "../shading/glc_selectionmaterial.h"
 #include "../viewport/glc_viewport.h"
+#include "../viewport/glc_pickinghit.h"
+#include "../maths/glc_line3d.h"
+#include "glc_spacepartitioning.h"
+#include "glc_3dviewcollection.h"
 #include <QMutexLocker>
+#include <limits>
 #include "../glc_state.h"
 
 //! A Mutex
@@ -50,6 +55,11 @@ GLC_3DViewInstance::GLC_3DViewInstance()
 , m_DefaultLOD(m_GlobalDefaultLOD)
 , m_ViewableFlag(GLC_3DViewInstance::FullViewable)
 , m_ViewableGeomFlag()
+, m_pSpacePartitioning(NULL)
+, m_IsBatched(false)
+, m_IsInstanced(false)
+, m_pCollection(NULL)
+, m_CollectionIndex(-1)
 {
 	// Encode Color Id
 	glc::encodeRgbId(m_Uid, m_colorId);
@@ -67,6 +77,11 @@ GLC_3DViewInstance::GLC_3DViewInstance(GLC_Geometry* pGeom)
 , m_DefaultLOD(m_GlobalDefaultLOD)
 , m_ViewableFlag(GLC_3DViewInstance::FullViewable)
 , m_ViewableGeomFlag()
+, m_pSpacePartitioning(NULL)
+, m_IsBatched(false)
+, m_IsInstanced(false)
+, m_pCollection(NULL)
+, m_CollectionIndex(-1)
 {
 	// Encode Color Id
 	glc::encodeRgbId(m_Uid, m_colorId);
@@ -85,6 +100,11 @@ GLC_3DViewInstance::GLC_3DViewInstance(GLC_Geometry* pGeom, GLC_uint id)
 , m_DefaultLOD(m_GlobalDefaultLOD)
 , m_ViewableFlag(GLC_3DViewInstance::FullViewable)
 , m_ViewableGeomFlag()
+, m_pSpacePartitioning(NULL)
+, m_IsBatched(false)
+, m_IsInstanced(false)
+, m_pCollection(NULL)
+, m_CollectionIndex(-1)
 {
 	// Encode Color Id
 	glc::encodeRgbId(m_Uid, m_colorId);
@@ -103,6 +123,11 @@ GLC_3DViewInstance::GLC_3DViewInstance(const GLC_3DRep& rep)
 , m_DefaultLOD(m_GlobalDefaultLOD)
 , m_ViewableFlag(GLC_3DViewInstance::FullViewable)
 , m_ViewableGeomFlag()
+, m_pSpacePartitioning(NULL)
+, m_IsBatched(false)
+, m_IsInstanced(false)
+, m_pCollection(NULL)
+, m_CollectionIndex(-1)
 {
 	// Encode Color Id
 	glc::encodeRgbId(m_Uid, m_colorId);
@@ -120,6 +145,11 @@ GLC_3DViewInstance::GLC_3DViewInstance(const GLC_3DRep& rep, GLC_uint id)
 , m_DefaultLOD(m_GlobalDefaultLOD)
 , m_ViewableFlag(GLC_3DViewInstance::FullViewable)
 , m_ViewableGeomFlag()
+, m_pSpacePartitioning(NULL)
+, m_IsBatched(false)
+, m_IsInstanced(false)
+, m_pCollection(NULL)
+, m_CollectionIndex(-1)
 {
 	// Encode Color Id
 	glc::encodeRgbId(m_Uid, m_colorId);
@@ -138,6 +168,11 @@ GLC_3DViewInstance::GLC_3DViewInstance(const GLC_3DViewInstance& inputNode)
 , m_DefaultLOD(inputNode.m_DefaultLOD)
 , m_ViewableFlag(inputNode.m_ViewableFlag)
 , m_ViewableGeomFlag(inputNode.m_ViewableGeomFlag)
+, m_pSpacePartitioning(NULL)
+, m_IsBatched(false)
+, m_IsInstanced(false)
+, m_pCollection(NULL)
+, m_CollectionIndex(-1)
 {
 	// Encode Color Id
 	glc::encodeRgbId(m_Uid, m_colorId);
@@ -172,6 +207,14 @@ GLC_3DViewInstance& GLC_3DViewInstance::operator=(const GLC_3DViewInstance& inpu
 		m_DefaultLOD= inputNode.m_DefaultLOD;
 		m_ViewableFlag= inputNode.m_ViewableFlag;
 		m_ViewableGeomFlag= inputNode.m_ViewableGeomFlag;
+		if (NULL != m_pSpacePartitioning)
+		{
+			m_pSpacePartitioning->updateInstance(this);
+		}
+		if (NULL != m_pCollection)
+		{
+			m_pCollection->setVisibleBit(m_CollectionIndex, m_IsVisible);
+		}
 
 		//qDebug() << "GLC_3DViewInstance::operator= :ID = " << m_Uid;
 		//qDebug() << "Number of instance" << (*m_pNumberOfInstance);
@@ -208,6 +251,38 @@ GLC_BoundingBox GLC_3DViewInstance::boundingBox(void)
 	return resultBox;
 }
 
+bool GLC_3DViewInstance::intersect(const GLC_Line3d& ray, GLC_PickingHit* pHit)
+{
+	if (m_3DRep.isEmpty() || !boundingBox().intersect(ray)) return false;
+
+	// The ray in the instance coordinate system, the parameter of a point is unchanged
+	const GLC_Matrix4x4 inverse(m_AbsoluteMatrix.inverted());
+	const GLC_Point3d origin(inverse * ray.startingPoint());
+	const GLC_Vector3d direction((inverse * (ray.startingPoint() + ray.direction())) - origin);
+	const GLC_Line3d localRay(origin, direction);
+
+	double nearestParameter= pHit->isValid() ? pHit->parameter() : std::numeric_limits<double>::max();
+	bool intersect= false;
+	const int size= m_3DRep.numberOfBody();
+	for (int i= 0; i < size; ++i)
+	{
+		GLC_Geometry* pGeom= m_3DRep.geomAt(i);
+		double parameter;
+		GLC_uint primitiveId;
+		if (pGeom->intersect(localRay, &parameter, &primitiveId) && (parameter < nearestParameter))
+		{
+			nearestParameter= parameter;
+			pHit->setInstanceId(m_Uid);
+			pHit->setBody(pGeom->id(), i);
+			pHit->setPrimitiveId(primitiveId);
+			pHit->setPoint(ray.startingPoint() + ray.direction() * parameter, parameter);
+			intersect= true;
+		}
+	}
+
+	return intersect;
+}
+
 //! Set the global default LOD value
 void GLC_3DViewInstance::setGlobalDefaultLod(int lod)
 {
@@ -215,6 +290,21 @@ void GLC_3DViewInstance::setGlobalDefaultLod(int lod)
 	m_GlobalDefaultLOD= lod;
 }
 
+void GLC_3DViewInstance::setGeomViewable(const GLC_Frustum& frustum)
+{
+	const int size= numberOfBody();
+	for (int i= 0; i < size; ++i)
+	{
+		// Get the geometry bounding box
+		GLC_BoundingBox geomBox= geomAt(i)->boundingBox();
+		GLC_Point3d center(m_AbsoluteMatrix * geomBox.center());
+		double radius= geomBox.boundingSphereRadius() * m_AbsoluteMatrix.scalingX();
+		GLC_Frustum::Localisation geomLocalisation= frustum.localizeSphere(center, radius);
+
+		setGeomViewable(i, geomLocalisation != GLC_Frustum::OutFrustum);
+	}
+}
+
 void GLC_3DViewInstance::setVboUsage(bool usage)
 {
 	m_3DRep.setVboUsage(usage);
@@ -273,6 +363,16 @@ bool GLC_3DViewInstance::addGeometry(GLC_Geometry* pGeom)
 	}
 }
 
+// Set instance visibility
+void GLC_3DViewInstance::setVisibility(bool visibility)
+{
+	m_IsVisible= visibility;
+	if (NULL != m_pCollection)
+	{
+		m_pCollection->setVisibleBit(m_CollectionIndex, visibility);
+	}
+}
+
 // Instance translation
 GLC_3DViewInstance& GLC_3DViewInstance::translate(double Tx, double Ty, double Tz)
 {
@@ -287,6 +387,10 @@ GLC_3DViewInstance& GLC_3DViewInstance::multMatrix(const GLC_Matrix4x4 &MultMat)
 {
 	m_AbsoluteMatrix= MultMat * m_AbsoluteMatrix;
 	m_IsBoundingBoxValid= false;
+	if (NULL != m_pSpacePartitioning)
+	{
+		m_pSpacePartitioning->updateInstance(this);
+	}
 
 	return *this;
 }
@@ -296,6 +400,10 @@ GLC_3DViewInstance& GLC_3DViewInstance::setMatrix(const GLC_Matrix4x4 &SetMat)
 {
 	m_AbsoluteMatrix= SetMat;
 	m_IsBoundingBoxValid= false;
+	if (NULL != m_pSpacePartitioning)
+	{
+		m_pSpacePartitioning->updateInstance(this);
+	}
 
 	return *this;
 }
@@ -305,6 +413,10 @@ GLC_3DViewInstance& GLC_3DViewInstance::resetMatrix(void)
 {
 	m_AbsoluteMatrix.setToIdentity();
 	m_IsBoundingBoxValid= false;
+	if (NULL != m_pSpacePartitioning)
+	{
+		m_pSpacePartitioning->updateInstance(this);
+	}
 
 	return *this;
 }
@@ -470,12 +582,15 @@ void GLC_3DViewInstance::computeBoundingBox(void)
 {
 	if (m_3DRep.isEmpty()) return;
 
+	// The bounding box is reused when the matrix changes
 	if (m_pBoundingBox != NULL)
 	{
-		delete m_pBoundingBox;
-		m_pBoundingBox= NULL;
+		*m_pBoundingBox= GLC_BoundingBox();
+	}
+	else
+	{
+		m_pBoundingBox= new GLC_BoundingBox();
 	}
-	m_pBoundingBox= new GLC_BoundingBox();
 	const int size= m_3DRep.numberOfBody();
 	for (int i= 0; i < size; ++i)
 	{
@@ -39,6 +39,10 @@
 #include "../glc_config.h"
 
 class GLC_Viewport;
+class GLC_PickingHit;
+class GLC_Frustum;
+class GLC_SpacePartitioning;
+class GLC_3DViewCollection;
 
 //////////////////////////////////////////////////////////////////////
 //! \class GLC_3DViewInstance
@@ -126,6 +130,11 @@ public:
 	//! Get the bounding box
 	GLC_BoundingBox boundingBox();
 
+	//! Return true if the given ray intersect a body of this instance nearer than the given hit
+	/*! If the given hit is not valid, any intersection is accepted.
+	 *  The ray is given in world coordinates and the hit is updated with the nearest intersection.*/
+	bool intersect(const GLC_Line3d& ray, GLC_PickingHit* pHit);
+
 	//! Get the validity of the Bounding Box
 	inline bool boundingBoxValidity() const
 	{return (m_pBoundingBox != NULL) && m_IsBoundingBoxValid && m_3DRep.boundingBoxIsValid();}
@@ -161,6 +170,14 @@ public:
 	inline bool isGeomViewable(int index) const
 	{return m_ViewableGeomFlag.at(index);}
 
+	//! Return true if the instance is drawn by the static batches of its collection
+	inline bool isBatched() const
+	{return m_IsBatched;}
+
+	//! Return true if the instance has been drawn by the instanced renderer of its collection in the current frame
+	inline bool isInstanced() const
+	{return m_IsInstanced;}
+
 	//! Get number of faces
 	inline unsigned int numberOfFaces() const
 	{return m_3DRep.faceCount();}
@@ -247,8 +264,8 @@ public:
 	{m_RenderProperties.unselect();}
 
 	//! Set instance visibility
-	inline void setVisibility(bool visibility)
-	{m_IsVisible= visibility;}
+	/*! The visibility bit of the collection of this instance is updated*/
+	void setVisibility(bool visibility);
 
 	//! Set Instance Id
 	inline void setId(const GLC_uint id)
@@ -270,6 +287,31 @@ public:
 	inline void setGeomViewable(int index, bool flag)
 	{m_ViewableGeomFlag[index]= flag;}
 
+	//! Set the viewable flag of each geometry from its localisation in the given frustum
+	void setGeomViewable(const GLC_Frustum& frustum);
+
+	//! Set the space partitioning to update when this instance moves
+	/*! Used by GLC_3DViewCollection, the space partitioning is not copied with the instance*/
+	inline void setSpacePartitioning(GLC_SpacePartitioning* pSpacePartitioning)
+	{m_pSpacePartitioning= pSpacePartitioning;}
+
+	//! Set the static batching state of this instance
+	/*! Used by GLC_StaticBatcher, the batching state is not copied with the instance*/
+	inline void setBatched(bool batched)
+	{m_IsBatched= batched;}
+
+	//! Set the instanced drawing state of this instance
+	/*! Used by GLC_InstancedRenderer, the instanced drawing state is not copied with the instance*/
+	inline void setInstanced(bool instanced)
+	{m_IsInstanced= instanced;}
+
+	//! Set the collection which contains this instance and the index of this instance in its bit sets
+	/*! Used by GLC_3DViewCollection, the collection is not copied with the instance*/
+	inline void setCollection(GLC_3DViewCollection* pCollection, int index)
+	{
+		m_pCollection= pCollection;
+		m_CollectionIndex= index;
+	}
 
 	//! Set the global default LOD value
 	static void setGlobalDefaultLod(int);
@@ -359,6 +401,21 @@ private:
 	//! vector of Flag to know if geometies of this instance are viewable
 	QVector<bool> m_ViewableGeomFlag;
 
+	//! The space partitioning which contains this instance
+	GLC_SpacePartitioning* m_pSpacePartitioning;
+
+	//! True if the instance is drawn by the static batches of its collection
+	bool m_IsBatched;
+
+	//! True if the instance has been drawn by the instanced renderer of its collection in the current frame
+	bool m_IsInstanced;
+
+	//! The collection which contains this instance
+	GLC_3DViewCollection* m_pCollection;
+
+	//! The index of this instance in the bit sets of its collection
+	int m_CollectionIndex;
+
 	//! A Mutex
 	static QMutex m_Mutex;
 
@@ -0,0 +1,226 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+
+//! \file glc_bitset.cpp implementation of the GLC_BitSet class.
+
+#include "glc_bitset.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Return the number of set bits of the given word
+static inline int wordBitCount(quint32 word)
+{
+#if defined(__GNUC__)
+	return __builtin_popcount(word);
+#else
+	word= word - ((word >> 1) & 0x55555555u);
+	word= (word & 0x33333333u) + ((word >> 2) & 0x33333333u);
+	return static_cast<int>((((word + (word >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#endif
+}
+
+// Return the index of the lowest set bit of the given not null word
+static inline int wordLowestSetBit(quint32 word)
+{
+	Q_ASSERT(0 != word);
+#if defined(__GNUC__)
+	return __builtin_ctz(word);
+#elif defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, word);
+	return static_cast<int>(index);
+#else
+	int index= 0;
+	while (0 == (word & 1u))
+	{
+		word>>= 1;
+		++index;
+	}
+	return index;
+#endif
+}
+
+GLC_BitSet::GLC_BitSet()
+: m_Words()
+, m_Size(0)
+{
+
+}
+
+GLC_BitSet::GLC_BitSet(int size, bool value)
+: m_Words((size + 31) / 32, value ? 0xFFFFFFFFu : 0u)
+, m_Size(size)
+{
+	clearUnusedBits();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+int GLC_BitSet::count() const
+{
+	int result= 0;
+	const int wordCount= m_Words.size();
+	const quint32* pWords= m_Words.constData();
+	for (int i= 0; i < wordCount; ++i)
+	{
+		result+= wordBitCount(pWords[i]);
+	}
+	return result;
+}
+
+bool GLC_BitSet::hasSetBit() const
+{
+	const int wordCount= m_Words.size();
+	const quint32* pWords= m_Words.constData();
+	for (int i= 0; i < wordCount; ++i)
+	{
+		if (0 != pWords[i]) return true;
+	}
+	return false;
+}
+
+int GLC_BitSet::nextSetBit(int index) const
+{
+	if (index >= m_Size) return -1;
+	Q_ASSERT(index >= 0);
+
+	const int wordCount= m_Words.size();
+	const quint32* pWords= m_Words.constData();
+	int wordIndex= index >> 5;
+
+	// The bits of the first word before the given index are ignored
+	quint32 word= pWords[wordIndex] & (0xFFFFFFFFu << (index & 31));
+	while (0 == word)
+	{
+		if (++wordIndex == wordCount) return -1;
+		word= pWords[wordIndex];
+	}
+	return (wordIndex << 5) + wordLowestSetBit(word);
+}
+
+GLC_BitSet GLC_BitSet::operator~() const
+{
+	GLC_BitSet result(*this);
+	const int wordCount= result.m_Words.size();
+	quint32* pWords= result.m_Words.data();
+	for (int i= 0; i < wordCount; ++i)
+	{
+		pWords[i]= ~pWords[i];
+	}
+	result.clearUnusedBits();
+	return result;
+}
+
+bool GLC_BitSet::operator==(const GLC_BitSet& other) const
+{
+	return (m_Size == other.m_Size) && (m_Words == other.m_Words);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_BitSet::resize(int size)
+{
+	Q_ASSERT(size >= 0);
+	if (size < m_Size)
+	{
+		m_Size= size;
+		m_Words.resize((size + 31) / 32);
+		clearUnusedBits();
+	}
+	else
+	{
+		// The unused bits of the last word are already null
+		m_Size= size;
+		m_Words.resize((size + 31) / 32);
+	}
+}
+
+void GLC_BitSet::clear()
+{
+	m_Words.clear();
+	m_Size= 0;
+}
+
+void GLC_BitSet::fill(bool value)
+{
+	m_Words.fill(value ? 0xFFFFFFFFu : 0u);
+	clearUnusedBits();
+}
+
+GLC_BitSet& GLC_BitSet::operator&=(const GLC_BitSet& other)
+{
+	Q_ASSERT(m_Size == other.m_Size);
+	const int wordCount= m_Words.size();
+	quint32* pWords= m_Words.data();
+	const quint32* pOtherWords= other.m_Words.constData();
+	for (int i= 0; i < wordCount; ++i)
+	{
+		pWords[i]&= pOtherWords[i];
+	}
+	return *this;
+}
+
+GLC_BitSet& GLC_BitSet::operator|=(const GLC_BitSet& other)
+{
+	Q_ASSERT(m_Size == other.m_Size);
+	const int wordCount= m_Words.size();
+	quint32* pWords= m_Words.data();
+	const quint32* pOtherWords= other.m_Words.constData();
+	for (int i= 0; i < wordCount; ++i)
+	{
+		pWords[i]|= pOtherWords[i];
+	}
+	return *this;
+}
+
+GLC_BitSet& GLC_BitSet::subtract(const GLC_BitSet& other)
+{
+	Q_ASSERT(m_Size == other.m_Size);
+	const int wordCount= m_Words.size();
+	quint32* pWords= m_Words.data();
+	const quint32* pOtherWords= other.m_Words.constData();
+	for (int i= 0; i < wordCount; ++i)
+	{
+		pWords[i]&= ~pOtherWords[i];
+	}
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_BitSet::clearUnusedBits()
+{
+	const int usedBits= m_Size & 31;
+	if (0 != usedBits)
+	{
+		m_Words.last()&= (1u << usedBits) - 1u;
+	}
+}
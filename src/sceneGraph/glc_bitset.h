@@ -0,0 +1,179 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+
+//! \file glc_bitset.h interface for the GLC_BitSet class.
+
+#ifndef GLC_BITSET_H_
+#define GLC_BITSET_H_
+
+#include <QVector>
+
+#include "../glc_config.h"
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_BitSet
+/*! \brief GLC_BitSet : Dense set of bits stored in 32 bits words */
+
+/*! Bulk operations (fill, count, and, or, inversion) work on whole words and
+ *  the iteration over the set bits skips the null words.
+ *  The unused bits of the last word are always null.
+ *
+ *  Iterate over the set bits with :
+ *  \code
+ *  for (int i= bitSet.nextSetBit(0); i != -1; i= bitSet.nextSetBit(i + 1))
+ *  \endcode
+ *  */
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_BitSet
+{
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Construct an empty bit set
+	GLC_BitSet();
+
+	//! Construct a bit set of the given size with all bits set to the given value
+	explicit GLC_BitSet(int size, bool value= false);
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return the number of bits of this bit set
+	inline int size() const
+	{return m_Size;}
+
+	//! Return true if this bit set has no bits
+	inline bool isEmpty() const
+	{return 0 == m_Size;}
+
+	//! Return the number of words of this bit set
+	inline int wordCount() const
+	{return m_Words.size();}
+
+	//! Return the words of this bit set
+	inline const quint32* words() const
+	{return m_Words.constData();}
+
+	//! Return true if the bit at the given index is set
+	inline bool testBit(int index) const
+	{
+		Q_ASSERT((index >= 0) && (index < m_Size));
+		return 0 != (m_Words.at(index >> 5) & (1u << (index & 31)));
+	}
+
+	//! Return the number of set bits
+	int count() const;
+
+	//! Return true if at least one bit is set
+	bool hasSetBit() const;
+
+	//! Return the index of the first set bit at or after the given index, -1 if there is none
+	int nextSetBit(int index) const;
+
+	//! Return the inverted bit set
+	GLC_BitSet operator~() const;
+
+	//! Return true if the given bit set is equal to this bit set
+	bool operator==(const GLC_BitSet& other) const;
+
+	//! Return true if the given bit set is not equal to this bit set
+	inline bool operator!=(const GLC_BitSet& other) const
+	{return !operator==(other);}
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return the words of this bit set
+	/*! The unused bits of the last word must stay null*/
+	inline quint32* words()
+	{return m_Words.data();}
+
+	//! Resize this bit set, the added bits are not set
+	void resize(int size);
+
+	//! Remove all the bits of this bit set
+	void clear();
+
+	//! Set the bit at the given index
+	inline void setBit(int index)
+	{
+		Q_ASSERT((index >= 0) && (index < m_Size));
+		m_Words[index >> 5]|= (1u << (index & 31));
+	}
+
+	//! Clear the bit at the given index
+	inline void clearBit(int index)
+	{
+		Q_ASSERT((index >= 0) && (index < m_Size));
+		m_Words[index >> 5]&= ~(1u << (index & 31));
+	}
+
+	//! Set the bit at the given index to the given value
+	inline void setBit(int index, bool value)
+	{
+		if (value) setBit(index);
+		else clearBit(index);
+	}
+
+	//! Set all the bits to the given value
+	void fill(bool value);
+
+	//! Keep the bits which are set in this bit set and in the given bit set of the same size
+	GLC_BitSet& operator&=(const GLC_BitSet& other);
+
+	//! Set the bits which are set in this bit set or in the given bit set of the same size
+	GLC_BitSet& operator|=(const GLC_BitSet& other);
+
+	//! Clear the bits which are set in the given bit set of the same size
+	GLC_BitSet& subtract(const GLC_BitSet& other);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Clear the unused bits of the last word
+	void clearUnusedBits();
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	//! The words of this bit set
+	QVector<quint32> m_Words;
+
+	//! The number of bits
+	int m_Size;
+};
+
+#endif /* GLC_BITSET_H_ */
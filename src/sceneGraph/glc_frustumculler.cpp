@@ -0,0 +1,172 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_frustumculler.cpp implementation for the GLC_FrustumCuller class.
+
+#include "glc_frustumculler.h"
+#include "glc_3dviewinstance.h"
+
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+// Number of instances of a chunk, a multiple of the 32 bits of a bitset word
+static const int chunkSize= 1024;
+
+// Runnable which culls chunks of instances
+class GLC_FrustumCuller::ChunkRunner : public QRunnable
+{
+public:
+	inline ChunkRunner(GLC_FrustumCuller* pCuller, int chunkCount, QAtomicInt* pNextChunk, QSemaphore* pDoneSemaphore)
+	: QRunnable()
+	, m_pCuller(pCuller)
+	, m_ChunkCount(chunkCount)
+	, m_pNextChunk(pNextChunk)
+	, m_pDoneSemaphore(pDoneSemaphore)
+	{}
+
+	//! Cull the next chunks until all chunks are taken
+	virtual void run()
+	{
+		int chunkIndex= m_pNextChunk->fetchAndAddOrdered(1);
+		while (chunkIndex < m_ChunkCount)
+		{
+			m_pCuller->cullChunk(chunkIndex);
+			chunkIndex= m_pNextChunk->fetchAndAddOrdered(1);
+		}
+		if (NULL != m_pDoneSemaphore) m_pDoneSemaphore->release();
+	}
+
+private:
+	//! The culler which owns the chunks
+	GLC_FrustumCuller* m_pCuller;
+	//! The number of chunks
+	int m_ChunkCount;
+	//! The index of the next chunk to cull
+	QAtomicInt* m_pNextChunk;
+	//! The semaphore released when this runner is done
+	QSemaphore* m_pDoneSemaphore;
+};
+
+GLC_FrustumCuller::GLC_FrustumCuller()
+: m_Instances()
+, m_ViewableBits()
+, m_pFrustum(NULL)
+{
+
+}
+
+GLC_FrustumCuller::~GLC_FrustumCuller()
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+QThreadPool* GLC_FrustumCuller::threadPool()
+{
+	static QThreadPool cullingThreadPool;
+	return &cullingThreadPool;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_FrustumCuller::setInstances(const QVector<GLC_3DViewInstance*>& instances)
+{
+	m_Instances= instances;
+	m_ViewableBits= GLC_BitSet(m_Instances.size());
+}
+
+void GLC_FrustumCuller::cull(const GLC_Frustum& frustum, bool parallel)
+{
+	const int instanceCount= m_Instances.size();
+	if (0 == instanceCount) return;
+
+	// Geometries can be shared by instances, their bounding boxes are computed before culling in parallel
+	for (int i= 0; i < instanceCount; ++i)
+	{
+		GLC_3DViewInstance* pInstance= m_Instances.at(i);
+		if (!pInstance->boundingBoxValidity()) pInstance->boundingBox();
+	}
+
+	m_pFrustum= &frustum;
+	const int chunkCount= (instanceCount + chunkSize - 1) / chunkSize;
+	const int threadCount= parallel ? qBound(1, QThread::idealThreadCount(), chunkCount) : 1;
+	QAtomicInt nextChunk(0);
+	QSemaphore doneSemaphore;
+	for (int i= 1; i < threadCount; ++i)
+	{
+		threadPool()->start(new ChunkRunner(this, chunkCount, &nextChunk, &doneSemaphore));
+	}
+
+	// The calling thread culls chunks too
+	ChunkRunner runner(this, chunkCount, &nextChunk, NULL);
+	runner.run();
+	doneSemaphore.acquire(threadCount - 1);
+	m_pFrustum= NULL;
+}
+
+void GLC_FrustumCuller::cullInstance(int index)
+{
+	m_Instances.at(index)->setViewable(GLC_3DViewInstance::NoViewable);
+	m_ViewableBits.clearBit(index);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_FrustumCuller::cullChunk(int chunkIndex)
+{
+	const int first= chunkIndex * chunkSize;
+	const int last= qMin(first + chunkSize, m_Instances.size());
+	quint32* pBits= m_ViewableBits.words();
+	for (int i= first; i < last; ++i)
+	{
+		GLC_3DViewInstance* pCurrentInstance= m_Instances.at(i);
+		const GLC_Frustum::Localisation instanceLocalisation= m_pFrustum->localizeBoundingBox(pCurrentInstance->boundingBox());
+		const quint32 bit= 1u << (i & 31);
+		if (instanceLocalisation == GLC_Frustum::OutFrustum)
+		{
+			pCurrentInstance->setViewable(GLC_3DViewInstance::NoViewable);
+			pBits[i >> 5]&= ~bit;
+		}
+		else
+		{
+			if (instanceLocalisation == GLC_Frustum::InFrustum)
+			{
+				pCurrentInstance->setViewable(GLC_3DViewInstance::FullViewable);
+			}
+			else
+			{
+				pCurrentInstance->setViewable(GLC_3DViewInstance::PartialViewable);
+				pCurrentInstance->setGeomViewable(*m_pFrustum);
+			}
+			pBits[i >> 5]|= bit;
+		}
+	}
+}
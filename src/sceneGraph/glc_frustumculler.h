@@ -0,0 +1,128 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_frustumculler.h interface for the GLC_FrustumCuller class.
+
+#ifndef GLC_FRUSTUMCULLER_H_
+#define GLC_FRUSTUMCULLER_H_
+
+#include <QVector>
+
+#include "glc_bitset.h"
+#include "../viewport/glc_frustum.h"
+#include "../glc_config.h"
+
+class GLC_3DViewInstance;
+class QThreadPool;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_FrustumCuller
+/*! \brief GLC_FrustumCuller : Frustum culling of a flat list of 3D view instances*/
+
+/*! GLC_FrustumCuller localizes each instance bounding box in the frustum, sets the
+ *  instance and bodies viewable flags and stores the viewable state in a bitset.
+ *  Instances are processed by chunks of a multiple of 32 instances, so chunks can be
+ *  culled in parallel without sharing a word of the bitset.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_FrustumCuller
+{
+	//! \class ChunkRunner
+	/*! \brief ChunkRunner : Runnable which culls chunks of instances */
+	class ChunkRunner;
+	friend class ChunkRunner;
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Construct an empty frustum culler
+	GLC_FrustumCuller();
+
+	//! Destructor
+	~GLC_FrustumCuller();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return the number of instances of this culler
+	inline int instanceCount() const
+	{return m_Instances.size();}
+
+	//! Return the instance at the given index
+	inline GLC_3DViewInstance* instanceAt(int index) const
+	{return m_Instances.at(index);}
+
+	//! Return true if the instance at the given index was viewable at the last culling
+	inline bool isViewable(int index) const
+	{return m_ViewableBits.testBit(index);}
+
+	//! Return the viewable state of the instances at the last culling, one bit per instance
+	inline const GLC_BitSet& viewableBits() const
+	{return m_ViewableBits;}
+
+	//! Return the thread pool used to cull instances in parallel
+	static QThreadPool* threadPool();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Set the instances to cull
+	void setInstances(const QVector<GLC_3DViewInstance*>& instances);
+
+	//! Cull the instances with the given frustum, in parallel if the given flag is true
+	void cull(const GLC_Frustum& frustum, bool parallel);
+
+	//! Cull the instance at the given index after the frustum culling
+	void cullInstance(int index);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Cull the instances of the given chunk
+	void cullChunk(int chunkIndex);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	Q_DISABLE_COPY(GLC_FrustumCuller)
+
+	//! The instances to cull
+	QVector<GLC_3DViewInstance*> m_Instances;
+
+	//! One bit per instance, set if the instance is viewable
+	GLC_BitSet m_ViewableBits;
+
+	//! The frustum of the current culling
+	const GLC_Frustum* m_pFrustum;
+};
+
+#endif /* GLC_FRUSTUMCULLER_H_ */
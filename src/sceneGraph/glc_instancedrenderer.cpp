@@ -0,0 +1,308 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_instancedrenderer.cpp Implementation for the GLC_InstancedRenderer class.
+
+#include "glc_instancedrenderer.h"
+#include "glc_3dviewinstance.h"
+#include "../geometry/glc_mesh.h"
+#include "../shading/glc_material.h"
+#include "../glc_state.h"
+#include "../glc_ext.h"
+
+#include <QGLShaderProgram>
+
+#include <cstring>
+
+// The size of an instance record : 16 floats of the matrix and 4 bytes of the color id
+static const int recordSize= 16 * sizeof(GLfloat) + 4;
+
+// The maximum number of lights read by the shader
+static const int maximumLightCount= 8;
+
+GLC_InstancedRenderer::GLC_InstancedRenderer()
+: m_Groups()
+, m_GroupIndexHash()
+, m_DrawnInstances()
+, m_MinimumInstanceCount(4)
+, m_pProgram(NULL)
+, m_ProgramHasFailed(false)
+, m_ColorIdLocation(-1)
+, m_InstanceData()
+, m_InstanceBuffer(QGLBuffer::VertexBuffer)
+{
+	for (int i= 0; i < 4; ++i)
+	{
+		m_MatrixLocation[i]= -1;
+	}
+}
+
+GLC_InstancedRenderer::~GLC_InstancedRenderer()
+{
+	clear();
+	delete m_pProgram;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+bool GLC_InstancedRenderer::isUsable()
+{
+	return GLC_State::isInstancedRenderingUsed() && GLC_State::instancingSupported() && GLC_State::glslSupported()
+			&& GLC_State::vboUsed() && !GLC_State::isPixelCullingActivated();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_InstancedRenderer::addInstance(GLC_3DViewInstance* pInstance)
+{
+	if (pInstance->isEmpty() || pInstance->isBatched() || pInstance->isSelected()) return;
+	if (pInstance->viewableFlag() != GLC_3DViewInstance::FullViewable) return;
+	if ((pInstance->polygonMode() != GL_FILL) || (pInstance->renderPropertiesHandle()->renderingMode() != glc::NormalRenderMode)) return;
+
+	const int lod= pInstance->defaultLodValue();
+	const bool isIndirect= (pInstance->matrix().type() == GLC_Matrix4x4::Indirect);
+	const QPair<GLC_Geometry*, int> key(pInstance->geomAt(0), 2 * lod + (isIndirect ? 1 : 0));
+
+	QList<int>& groupIndexes= m_GroupIndexHash[key];
+	const int size= groupIndexes.size();
+	for (int i= 0; i < size; ++i)
+	{
+		Group& group= m_Groups[groupIndexes.at(i)];
+		if (haveSameBodies(group.m_pReference, pInstance))
+		{
+			if (group.m_IsInstanceable) group.m_Instances.append(pInstance);
+			return;
+		}
+	}
+
+	Group group;
+	group.m_pReference= pInstance;
+	group.m_IsInstanceable= bodiesAreInstanceable(pInstance);
+	group.m_Lod= lod;
+	group.m_IsIndirect= isIndirect;
+	if (group.m_IsInstanceable) group.m_Instances.append(pInstance);
+	groupIndexes.append(m_Groups.size());
+	m_Groups.append(group);
+}
+
+void GLC_InstancedRenderer::clear()
+{
+	const int size= m_DrawnInstances.size();
+	for (int i= 0; i < size; ++i)
+	{
+		m_DrawnInstances.at(i)->setInstanced(false);
+	}
+	m_DrawnInstances.clear();
+	m_Groups.clear();
+	m_GroupIndexHash.clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+// OpenGL Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_InstancedRenderer::glDraw()
+{
+#if !defined(Q_OS_MAC)
+	int instanceCount= 0;
+	const int groupCount= m_Groups.size();
+	for (int i= 0; i < groupCount; ++i)
+	{
+		const int count= m_Groups.at(i).m_Instances.size();
+		if (count >= m_MinimumInstanceCount) instanceCount+= count;
+	}
+	if ((0 == instanceCount) || !createProgram()) return;
+
+	// Fill the instance buffer
+	m_InstanceData.resize(instanceCount * recordSize);
+	char* pRecord= m_InstanceData.data();
+	for (int i= 0; i < groupCount; ++i)
+	{
+		const Group& group= m_Groups.at(i);
+		const int count= group.m_Instances.size();
+		if (count < m_MinimumInstanceCount) continue;
+		for (int j= 0; j < count; ++j)
+		{
+			GLC_3DViewInstance* pInstance= group.m_Instances.at(j);
+			const double* pMatrix= pInstance->matrix().getData();
+			GLfloat matrix[16];
+			for (int k= 0; k < 16; ++k) matrix[k]= static_cast<GLfloat>(pMatrix[k]);
+			GLubyte colorId[4];
+			glc::encodeRgbId(pInstance->id(), colorId);
+			memcpy(pRecord, matrix, sizeof(matrix));
+			memcpy(pRecord + sizeof(matrix), colorId, sizeof(colorId));
+			pRecord+= recordSize;
+		}
+	}
+	if (!m_InstanceBuffer.isCreated())
+	{
+		m_InstanceBuffer.create();
+		m_InstanceBuffer.setUsagePattern(QGLBuffer::StreamDraw);
+	}
+	m_InstanceBuffer.bind();
+	m_InstanceBuffer.allocate(m_InstanceData.constData(), m_InstanceData.size());
+
+	// Shader uniforms from the fixed pipeline state
+	m_pProgram->bind();
+	m_pProgram->setUniformValue("u_SelectionMode", static_cast<GLint>(GLC_State::isInSelectionMode()));
+	m_pProgram->setUniformValue("u_LightingEnabled", static_cast<GLint>(glIsEnabled(GL_LIGHTING)));
+	GLint lightEnabled[maximumLightCount];
+	for (int i= 0; i < maximumLightCount; ++i)
+	{
+		lightEnabled[i]= glIsEnabled(GL_LIGHT0 + i);
+	}
+	m_pProgram->setUniformValueArray("u_LightEnabled", lightEnabled, maximumLightCount);
+	GLint twoSide= 0;
+	glGetIntegerv(GL_LIGHT_MODEL_TWO_SIDE, &twoSide);
+	if (twoSide) glEnable(GL_VERTEX_PROGRAM_TWO_SIDE);
+
+	// The polygon mode is restored after the instanced draw calls
+	GLint polygonMode[2];
+	glGetIntegerv(GL_POLYGON_MODE, polygonMode);
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	for (int i= 0; i < 5; ++i)
+	{
+		const int location= (0 == i) ? m_ColorIdLocation : m_MatrixLocation[i - 1];
+		m_pProgram->enableAttributeArray(location);
+		glVertexAttribDivisor(location, 1);
+	}
+
+	int offset= 0;
+	for (int i= 0; i < groupCount; ++i)
+	{
+		const Group& group= m_Groups.at(i);
+		const int count= group.m_Instances.size();
+		if (count < m_MinimumInstanceCount) continue;
+
+		// Attributes pointers are read from the instance buffer bound when they are set
+		m_InstanceBuffer.bind();
+		setInstanceAttributes(offset);
+		if (group.m_IsIndirect) glFrontFace(GL_CW);
+
+		const int bodyCount= group.m_pReference->numberOfBody();
+		for (int body= 0; body < bodyCount; ++body)
+		{
+			GLC_Mesh* pMesh= static_cast<GLC_Mesh*>(group.m_pReference->geomAt(body));
+			pMesh->setCurrentLod(group.m_Lod);
+			pMesh->glDrawInstanced(count);
+		}
+
+		if (group.m_IsIndirect) glFrontFace(GL_CCW);
+		for (int j= 0; j < count; ++j)
+		{
+			group.m_Instances.at(j)->setInstanced(true);
+		}
+		m_DrawnInstances+= group.m_Instances.toList();
+		offset+= count * recordSize;
+	}
+
+	for (int i= 0; i < 5; ++i)
+	{
+		const int location= (0 == i) ? m_ColorIdLocation : m_MatrixLocation[i - 1];
+		glVertexAttribDivisor(location, 0);
+		m_pProgram->disableAttributeArray(location);
+	}
+	glPolygonMode(GL_FRONT, polygonMode[0]);
+	glPolygonMode(GL_BACK, polygonMode[1]);
+	if (twoSide) glDisable(GL_VERTEX_PROGRAM_TWO_SIDE);
+	m_pProgram->release();
+	QGLBuffer::release(QGLBuffer::VertexBuffer);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+
+bool GLC_InstancedRenderer::bodiesAreInstanceable(GLC_3DViewInstance* pInstance) const
+{
+	const int bodyCount= pInstance->numberOfBody();
+	for (int i= 0; i < bodyCount; ++i)
+	{
+		GLC_Mesh* pMesh= dynamic_cast<GLC_Mesh*>(pInstance->geomAt(i));
+		if ((NULL == pMesh) || !pMesh->isValid() || !pMesh->vboIsUsed() || pMesh->isPacked()) return false;
+		if (pMesh->typeIsWire() || !pMesh->wireDataIsEmpty() || pMesh->usedColorPerVertex() || (0 == pMesh->lodCount())) return false;
+
+		QSet<GLC_Material*> materials(pMesh->materialSet());
+		QSet<GLC_Material*>::const_iterator iMaterial= materials.constBegin();
+		while (materials.constEnd() != iMaterial)
+		{
+			if ((*iMaterial)->hasTexture() || (*iMaterial)->isTransparent()) return false;
+			++iMaterial;
+		}
+	}
+	return true;
+}
+
+bool GLC_InstancedRenderer::haveSameBodies(GLC_3DViewInstance* pInstance1, GLC_3DViewInstance* pInstance2) const
+{
+	const int bodyCount= pInstance1->numberOfBody();
+	if (bodyCount != pInstance2->numberOfBody()) return false;
+	for (int i= 0; i < bodyCount; ++i)
+	{
+		if (pInstance1->geomAt(i) != pInstance2->geomAt(i)) return false;
+	}
+	return true;
+}
+
+bool GLC_InstancedRenderer::createProgram()
+{
+	if (NULL != m_pProgram) return true;
+	if (m_ProgramHasFailed) return false;
+
+	m_pProgram= new QGLShaderProgram();
+	bool result= m_pProgram->addShaderFromSourceFile(QGLShader::Vertex, ":/GLC_lib_Shaders/instanced_vert");
+	result= result && m_pProgram->addShaderFromSourceFile(QGLShader::Fragment, ":/GLC_lib_Shaders/instanced_frag");
+	result= result && m_pProgram->link();
+	if (result)
+	{
+		// Locations are chosen by the linker which avoids the fixed pipeline attributes aliased by the driver
+		m_ColorIdLocation= m_pProgram->attributeLocation("a_InstanceColorId");
+		result= (-1 != m_ColorIdLocation);
+		for (int i= 0; i < 4; ++i)
+		{
+			m_MatrixLocation[i]= m_pProgram->attributeLocation(QString("a_InstanceMatrix%1").arg(i));
+			result= result && (-1 != m_MatrixLocation[i]);
+		}
+	}
+	if (!result)
+	{
+		qWarning("GLC_InstancedRenderer::createProgram : %s", qPrintable(m_pProgram->log()));
+		delete m_pProgram;
+		m_pProgram= NULL;
+		m_ProgramHasFailed= true;
+	}
+	return result;
+}
+
+void GLC_InstancedRenderer::setInstanceAttributes(int offset)
+{
+	for (int i= 0; i < 4; ++i)
+	{
+		m_pProgram->setAttributeBuffer(m_MatrixLocation[i], GL_FLOAT, offset + i * 4 * sizeof(GLfloat), 4, recordSize);
+	}
+	m_pProgram->setAttributeBuffer(m_ColorIdLocation, GL_UNSIGNED_BYTE, offset + 16 * sizeof(GLfloat), 4, recordSize);
+}
@@ -0,0 +1,181 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_instancedrenderer.h Interface for the GLC_InstancedRenderer class.
+
+#ifndef GLC_INSTANCEDRENDERER_H_
+#define GLC_INSTANCEDRENDERER_H_
+
+#include <QByteArray>
+#include <QGLBuffer>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QVector>
+
+#include "../glc_global.h"
+
+#include "../glc_config.h"
+
+class GLC_3DViewInstance;
+class GLC_Geometry;
+class QGLShaderProgram;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_InstancedRenderer
+/*! \brief GLC_InstancedRenderer : Draw instances sharing the same representation with instanced draw calls*/
+
+/*! Viewable instances are grouped by representation, LOD and matrix orientation.
+ *  The matrices and the color ids of the instances of each group are uploaded in a per
+ *  frame instance buffer and each body of the representation is drawn once for the group
+ *  with glDrawElementsInstanced. A shader reads the per instance attributes and computes
+ *  the fixed pipeline lighting.
+ *  Instances drawn by this renderer are flagged until clear() is called.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_InstancedRenderer
+{
+	//! Instances of the same representation, LOD and matrix orientation
+	struct Group
+	{
+		//! The first instance of the group
+		GLC_3DViewInstance* m_pReference;
+		//! True if the bodies of the representation can be drawn instanced
+		bool m_IsInstanceable;
+		//! The LOD of the group
+		int m_Lod;
+		//! True if the matrices of the group are indirect
+		bool m_IsIndirect;
+		//! The instances of the group
+		QVector<GLC_3DViewInstance*> m_Instances;
+	};
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Construct an instanced renderer
+	GLC_InstancedRenderer();
+
+	//! Destructor
+	~GLC_InstancedRenderer();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return true if instanced rendering is used and supported by the current OpenGL context
+	static bool isUsable();
+
+	//! Return the minimum number of instances of a group drawn instanced
+	inline int minimumInstanceCount() const
+	{return m_MinimumInstanceCount;}
+
+	//! Return the number of instances drawn instanced since the last clear
+	inline int instanceCount() const
+	{return m_DrawnInstances.size();}
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Set the minimum number of instances of a group drawn instanced
+	inline void setMinimumInstanceCount(int count)
+	{m_MinimumInstanceCount= qMax(2, count);}
+
+	//! Add the given viewable instance to its group if it can be drawn instanced
+	void addInstance(GLC_3DViewInstance* pInstance);
+
+	//! Unflag the drawn instances and clear the groups
+	void clear();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name OpenGL Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Draw the groups which have enough instances and flag their instances
+	void glDraw();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Return true if the bodies of the given instance can be drawn instanced
+	bool bodiesAreInstanceable(GLC_3DViewInstance* pInstance) const;
+
+	//! Return true if the given instances have the same bodies
+	bool haveSameBodies(GLC_3DViewInstance* pInstance1, GLC_3DViewInstance* pInstance2) const;
+
+	//! Create and link the instancing shader program, return true on success
+	bool createProgram();
+
+	//! Set the per instance attributes from the given offset of the instance buffer
+	void setInstanceAttributes(int offset);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	Q_DISABLE_COPY(GLC_InstancedRenderer)
+
+	//! The groups of the current frame
+	QList<Group> m_Groups;
+
+	//! The index of the groups of each first body and LOD and orientation
+	QHash<QPair<GLC_Geometry*, int>, QList<int> > m_GroupIndexHash;
+
+	//! The instances drawn instanced since the last clear
+	QList<GLC_3DViewInstance*> m_DrawnInstances;
+
+	//! The minimum number of instances of a group drawn instanced
+	int m_MinimumInstanceCount;
+
+	//! The instancing shader program
+	QGLShaderProgram* m_pProgram;
+
+	//! True if the creation of the shader program has failed
+	bool m_ProgramHasFailed;
+
+	//! The attribute location of the instance color id
+	int m_ColorIdLocation;
+
+	//! The attribute locations of the columns of the instance matrix
+	int m_MatrixLocation[4];
+
+	//! The per frame instance data
+	QByteArray m_InstanceData;
+
+	//! The per frame instance buffer
+	QGLBuffer m_InstanceBuffer;
+};
+
+#endif /* GLC_INSTANCEDRENDERER_H_ */
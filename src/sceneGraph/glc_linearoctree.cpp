@@ -0,0 +1,524 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_linearoctree.cpp implementation for the GLC_LinearOctree class.
+
+#include "glc_linearoctree.h"
+#include "glc_3dviewcollection.h"
+#include "../maths/glc_line3d.h"
+
+#include <QPair>
+#include <QtAlgorithms>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+#define GLC_LINEAROCTREE_SSE
+#include <xmmintrin.h>
+#endif
+
+int GLC_LinearOctree::m_DefaultDepth= 4;
+
+// Morton codes of the cells are stored on 32 bits
+static const int maxDepth= 10;
+
+// Spread the 10 lower bits of the given value every 3 bits
+static inline quint32 spreadBits(quint32 value)
+{
+	value= (value | (value << 16)) & 0x030000FF;
+	value= (value | (value << 8)) & 0x0300F00F;
+	value= (value | (value << 4)) & 0x030C30C3;
+	value= (value | (value << 2)) & 0x09249249;
+	return value;
+}
+
+// Return the Morton code of the given cell coordinates
+static inline quint32 mortonCode(const quint32* pCell)
+{
+	return spreadBits(pCell[0]) | (spreadBits(pCell[1]) << 1) | (spreadBits(pCell[2]) << 2);
+}
+
+GLC_LinearOctree::GLC_LinearOctree(GLC_3DViewCollection* pCollection)
+: GLC_SpacePartitioning(pCollection)
+, m_Nodes()
+, m_NodeBounds()
+, m_Instances()
+, m_InstanceBounds()
+, m_NodeLocalisation()
+, m_InstanceLocalisation()
+, m_IsPartitioned(false)
+, m_Depth(m_DefaultDepth)
+{
+
+}
+
+GLC_LinearOctree::GLC_LinearOctree(const GLC_LinearOctree& octree)
+: GLC_SpacePartitioning(octree)
+, m_Nodes(octree.m_Nodes)
+, m_NodeBounds(octree.m_NodeBounds)
+, m_Instances(octree.m_Instances)
+, m_InstanceBounds(octree.m_InstanceBounds)
+, m_NodeLocalisation()
+, m_InstanceLocalisation()
+, m_IsPartitioned(octree.m_IsPartitioned)
+, m_Depth(octree.m_Depth)
+{
+
+}
+
+GLC_LinearOctree::~GLC_LinearOctree()
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+int GLC_LinearOctree::defaultDepth()
+{
+	return m_DefaultDepth;
+}
+
+int GLC_LinearOctree::maximumDepth()
+{
+	return maxDepth;
+}
+
+QList<GLC_3DViewInstance*> GLC_LinearOctree::listOfIntersectedInstances(const GLC_BoundingBox& bBox)
+{
+	if (!m_IsPartitioned)
+	{
+		updateSpacePartitioning();
+	}
+	QList<GLC_3DViewInstance*> instanceList;
+	const int nodeCount= m_Nodes.size();
+	int index= 0;
+	while (index < nodeCount)
+	{
+		const Node& node= m_Nodes.at(index);
+		if (nodeBoundingBox(index).intersect(bBox))
+		{
+			const int last= node.m_FirstInstance + node.m_InstanceCount;
+			for (int i= node.m_FirstInstance; i < last; ++i)
+			{
+				if (m_Instances.at(i)->boundingBox().intersect(bBox))
+				{
+					instanceList.append(m_Instances.at(i));
+				}
+			}
+			++index;
+		}
+		else index= node.m_Skip;
+	}
+	return instanceList;
+}
+
+QList<GLC_3DViewInstance*> GLC_LinearOctree::listOfIntersectedInstances(const GLC_Line3d& ray)
+{
+	if (!m_IsPartitioned)
+	{
+		updateSpacePartitioning();
+	}
+	QList<GLC_3DViewInstance*> instanceList;
+	const int nodeCount= m_Nodes.size();
+	int index= 0;
+	while (index < nodeCount)
+	{
+		const Node& node= m_Nodes.at(index);
+		if (nodeBoundingBox(index).intersect(ray))
+		{
+			const int last= node.m_FirstInstance + node.m_InstanceCount;
+			for (int i= node.m_FirstInstance; i < last; ++i)
+			{
+				if (m_Instances.at(i)->boundingBox().intersect(ray))
+				{
+					instanceList.append(m_Instances.at(i));
+				}
+			}
+			++index;
+		}
+		else index= node.m_Skip;
+	}
+	return instanceList;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_LinearOctree::updateViewableInstances(const GLC_Frustum& frustum)
+{
+	if (!m_IsPartitioned)
+	{
+		updateSpacePartitioning();
+	}
+	const int nodeCount= m_Nodes.size();
+	if (0 == nodeCount) return;
+
+	const GLC_Plane planeList[6]= {frustum.leftClippingPlane(), frustum.rightClippingPlane(), frustum.topClippingPlane()
+			, frustum.bottomClippingPlane(), frustum.nearClippingPlane(), frustum.farClippingPlane()};
+	float planes[24];
+	for (int i= 0; i < 6; ++i)
+	{
+		planes[4 * i]= static_cast<float>(planeList[i].coefA());
+		planes[4 * i + 1]= static_cast<float>(planeList[i].coefB());
+		planes[4 * i + 2]= static_cast<float>(planeList[i].coefC());
+		planes[4 * i + 3]= static_cast<float>(planeList[i].coefD());
+	}
+
+	// Localize all the nodes at once
+	m_NodeLocalisation.resize(nodeCount);
+	localizeBoxes(m_NodeBounds.constData(), nodeCount, 0, nodeCount, planes, m_NodeLocalisation.data());
+
+	const int instanceCount= m_Instances.size();
+	m_InstanceLocalisation.resize(instanceCount);
+	int index= 0;
+	while (index < nodeCount)
+	{
+		const Node& node= m_Nodes.at(index);
+		const uchar nodeLocalisation= m_NodeLocalisation.at(index);
+		if (nodeLocalisation == GLC_Frustum::OutFrustum)
+		{
+			setViewable(node.m_FirstInstance, node.m_InstanceEnd, GLC_3DViewInstance::NoViewable);
+			index= node.m_Skip;
+		}
+		else if (nodeLocalisation == GLC_Frustum::InFrustum)
+		{
+			setViewable(node.m_FirstInstance, node.m_InstanceEnd, GLC_3DViewInstance::FullViewable);
+			index= node.m_Skip;
+		}
+		else // The current node intersect the frustum
+		{
+			const int last= node.m_FirstInstance + node.m_InstanceCount;
+			localizeBoxes(m_InstanceBounds.constData(), instanceCount, node.m_FirstInstance, last, planes, m_InstanceLocalisation.data());
+			for (int i= node.m_FirstInstance; i < last; ++i)
+			{
+				GLC_3DViewInstance* pCurrentInstance= m_Instances.at(i);
+				const uchar instanceLocalisation= m_InstanceLocalisation.at(i);
+				if (instanceLocalisation == GLC_Frustum::OutFrustum)
+				{
+					pCurrentInstance->setViewable(GLC_3DViewInstance::NoViewable);
+				}
+				else if (instanceLocalisation == GLC_Frustum::InFrustum)
+				{
+					pCurrentInstance->setViewable(GLC_3DViewInstance::FullViewable);
+				}
+				else
+				{
+					pCurrentInstance->setViewable(GLC_3DViewInstance::PartialViewable);
+					pCurrentInstance->setGeomViewable(frustum);
+				}
+			}
+			++index;
+		}
+	}
+}
+
+void GLC_LinearOctree::updateSpacePartitioning()
+{
+	clear();
+	m_IsPartitioned= true;
+
+	const GLC_BoundingBox rootBox(m_pCollection->boundingBox(true));
+	if (rootBox.isEmpty()) return;
+
+	// Scale from collection coordinates to the cells coordinates of the deepest level
+	const quint32 cellCount= 1 << m_Depth;
+	const double* pRootLower= rootBox.lowerCorner().data();
+	const double* pRootUpper= rootBox.upperCorner().data();
+	double scale[3];
+	for (int axis= 0; axis < 3; ++axis)
+	{
+		const double length= pRootUpper[axis] - pRootLower[axis];
+		scale[axis]= (length > 0.0) ? (static_cast<double>(cellCount) / length) : 0.0;
+	}
+
+	// Compute the key of the smallest cell which contains each instance : Morton code and level
+	QList<GLC_3DViewInstance*> instanceList(m_pCollection->instancesHandle());
+	const int size= instanceList.size();
+	QVector<GLC_BoundingBox> boxes(size);
+	QVector<QPair<quint64, int> > keys;
+	keys.reserve(size);
+	for (int i= 0; i < size; ++i)
+	{
+		boxes[i]= instanceList.at(i)->boundingBox();
+		if (boxes.at(i).isEmpty()) continue;
+
+		const double* pLower= boxes.at(i).lowerCorner().data();
+		const double* pUpper= boxes.at(i).upperCorner().data();
+		quint32 cellLower[3];
+		quint32 difference= 0;
+		for (int axis= 0; axis < 3; ++axis)
+		{
+			const double lower= qBound(0.0, (pLower[axis] - pRootLower[axis]) * scale[axis], static_cast<double>(cellCount - 1));
+			const double upper= qBound(0.0, (pUpper[axis] - pRootLower[axis]) * scale[axis], static_cast<double>(cellCount - 1));
+			cellLower[axis]= static_cast<quint32>(lower);
+			difference|= cellLower[axis] ^ static_cast<quint32>(upper);
+		}
+		// Go up until the lower and upper corners are in the same cell
+		int level= m_Depth;
+		while (0 != difference)
+		{
+			--level;
+			difference>>= 1;
+		}
+		const int shift= m_Depth - level;
+		for (int axis= 0; axis < 3; ++axis)
+		{
+			cellLower[axis]= (cellLower[axis] >> shift) << shift;
+		}
+		keys.append(qMakePair((static_cast<quint64>(mortonCode(cellLower)) << 4) | static_cast<quint64>(level), i));
+	}
+	// Sorting by Morton code then by level gives the depth first order of cells
+	qSort(keys.begin(), keys.end());
+
+	// Create the nodes of occupied cells and of their ancestors
+	const int keyCount= keys.size();
+	m_Instances.reserve(keyCount);
+	QVector<quint32> nodeCodes;
+	QVector<int> nodeLevels;
+	QVector<int> nodeParents;
+	QVector<int> stack;
+	int keyIndex= 0;
+	while (keyIndex < keyCount)
+	{
+		const quint64 key= keys.at(keyIndex).first;
+		const quint32 code= static_cast<quint32>(key >> 4);
+		const int level= static_cast<int>(key & 0xF);
+
+		// Close the nodes which do not contain this cell
+		while (!stack.isEmpty())
+		{
+			const int top= stack.last();
+			const int topLevel= nodeLevels.at(top);
+			if ((topLevel <= level) && (0 == ((code ^ nodeCodes.at(top)) >> (3 * (m_Depth - topLevel))))) break;
+			m_Nodes[top].m_Skip= m_Nodes.size();
+			m_Nodes[top].m_InstanceEnd= m_Instances.size();
+			stack.removeLast();
+		}
+
+		// Open the missing ancestors and the cell
+		for (int currentLevel= stack.isEmpty() ? 0 : (nodeLevels.at(stack.last()) + 1); currentLevel <= level; ++currentLevel)
+		{
+			const int shift= 3 * (m_Depth - currentLevel);
+			Node node;
+			node.m_FirstInstance= m_Instances.size();
+			node.m_InstanceCount= 0;
+			node.m_InstanceEnd= m_Instances.size();
+			node.m_Skip= m_Nodes.size() + 1;
+			nodeCodes.append((code >> shift) << shift);
+			nodeLevels.append(currentLevel);
+			nodeParents.append(stack.isEmpty() ? -1 : stack.last());
+			stack.append(m_Nodes.size());
+			m_Nodes.append(node);
+		}
+
+		// Add the instances of this cell
+		Node& node= m_Nodes[stack.last()];
+		while ((keyIndex < keyCount) && (keys.at(keyIndex).first == key))
+		{
+			m_Instances.append(instanceList.at(keys.at(keyIndex).second));
+			++node.m_InstanceCount;
+			++keyIndex;
+		}
+	}
+	while (!stack.isEmpty())
+	{
+		const int top= stack.last();
+		m_Nodes[top].m_Skip= m_Nodes.size();
+		m_Nodes[top].m_InstanceEnd= m_Instances.size();
+		stack.removeLast();
+	}
+
+	// Store instances bounds and compute the tight bounds of nodes from their children
+	const int nodeCount= m_Nodes.size();
+	QVector<double> nodeLower(3 * nodeCount, std::numeric_limits<double>::max());
+	QVector<double> nodeUpper(3 * nodeCount, -std::numeric_limits<double>::max());
+	m_InstanceBounds.resize(6 * keyCount);
+	for (int index= nodeCount - 1; index >= 0; --index)
+	{
+		const Node& node= m_Nodes.at(index);
+		double* pNodeLower= nodeLower.data() + 3 * index;
+		double* pNodeUpper= nodeUpper.data() + 3 * index;
+		const int last= node.m_FirstInstance + node.m_InstanceCount;
+		for (int i= node.m_FirstInstance; i < last; ++i)
+		{
+			const GLC_BoundingBox& box= boxes.at(keys.at(i).second);
+			const double* pLower= box.lowerCorner().data();
+			const double* pUpper= box.upperCorner().data();
+			setBounds(&m_InstanceBounds, keyCount, i, pLower, pUpper);
+			for (int axis= 0; axis < 3; ++axis)
+			{
+				pNodeLower[axis]= qMin(pNodeLower[axis], pLower[axis]);
+				pNodeUpper[axis]= qMax(pNodeUpper[axis], pUpper[axis]);
+			}
+		}
+		const int parent= nodeParents.at(index);
+		if (parent != -1)
+		{
+			for (int axis= 0; axis < 3; ++axis)
+			{
+				nodeLower[3 * parent + axis]= qMin(nodeLower.at(3 * parent + axis), pNodeLower[axis]);
+				nodeUpper[3 * parent + axis]= qMax(nodeUpper.at(3 * parent + axis), pNodeUpper[axis]);
+			}
+		}
+	}
+	m_NodeBounds.resize(6 * nodeCount);
+	for (int index= 0; index < nodeCount; ++index)
+	{
+		setBounds(&m_NodeBounds, nodeCount, index, nodeLower.constData() + 3 * index, nodeUpper.constData() + 3 * index);
+	}
+}
+
+void GLC_LinearOctree::clear()
+{
+	m_Nodes.clear();
+	m_NodeBounds.clear();
+	m_Instances.clear();
+	m_InstanceBounds.clear();
+	m_NodeLocalisation.clear();
+	m_InstanceLocalisation.clear();
+	m_IsPartitioned= false;
+}
+
+void GLC_LinearOctree::setDepth(int depth)
+{
+	m_Depth= qBound(0, depth, maxDepth);
+	if (m_IsPartitioned)
+	{
+		updateSpacePartitioning();
+	}
+}
+
+void GLC_LinearOctree::setDefaultDepth(int depth)
+{
+	m_DefaultDepth= qBound(0, depth, maxDepth);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+
+GLC_BoundingBox GLC_LinearOctree::nodeBoundingBox(int index) const
+{
+	const int stride= m_Nodes.size();
+	const float* pBounds= m_NodeBounds.constData() + index;
+	const GLC_Point3d center(pBounds[0], pBounds[stride], pBounds[2 * stride]);
+	const GLC_Vector3d extent(pBounds[3 * stride], pBounds[4 * stride], pBounds[5 * stride]);
+	return GLC_BoundingBox(center - extent, center + extent);
+}
+
+void GLC_LinearOctree::setBounds(QVector<float>* pBounds, int stride, int index, const double* pLower, const double* pUpper)
+{
+	float* pData= pBounds->data() + index;
+	for (int axis= 0; axis < 3; ++axis)
+	{
+		const double center= (pLower[axis] + pUpper[axis]) * 0.5;
+		const double extent= (pUpper[axis] - pLower[axis]) * 0.5;
+		// Enlarge the extent to be conservative after the conversion to float
+		const double error= (fabs(center) + extent) * static_cast<double>(std::numeric_limits<float>::epsilon());
+		pData[axis * stride]= static_cast<float>(center);
+		pData[(3 + axis) * stride]= static_cast<float>(extent + error);
+	}
+}
+
+void GLC_LinearOctree::localizeBoxes(const float* pBounds, int stride, int first, int last, const float* pPlanes, uchar* pLocalisation)
+{
+	const float* pCenterX= pBounds;
+	const float* pCenterY= pBounds + stride;
+	const float* pCenterZ= pBounds + 2 * stride;
+	const float* pExtentX= pBounds + 3 * stride;
+	const float* pExtentY= pBounds + 4 * stride;
+	const float* pExtentZ= pBounds + 5 * stride;
+
+	// A box is out if it is behind a plane and in if it is in front of all planes
+	int i= first;
+#ifdef GLC_LINEAROCTREE_SSE
+	__m128 coefs[6][4];
+	__m128 absCoefs[6][3];
+	for (int plane= 0; plane < 6; ++plane)
+	{
+		for (int coef= 0; coef < 4; ++coef)
+		{
+			coefs[plane][coef]= _mm_set1_ps(pPlanes[4 * plane + coef]);
+		}
+		for (int coef= 0; coef < 3; ++coef)
+		{
+			absCoefs[plane][coef]= _mm_set1_ps(fabsf(pPlanes[4 * plane + coef]));
+		}
+	}
+	const __m128 signMask= _mm_set1_ps(-0.0f);
+	for (; (i + 4) <= last; i+= 4)
+	{
+		const __m128 centerX= _mm_loadu_ps(pCenterX + i);
+		const __m128 centerY= _mm_loadu_ps(pCenterY + i);
+		const __m128 centerZ= _mm_loadu_ps(pCenterZ + i);
+		const __m128 extentX= _mm_loadu_ps(pExtentX + i);
+		const __m128 extentY= _mm_loadu_ps(pExtentY + i);
+		const __m128 extentZ= _mm_loadu_ps(pExtentZ + i);
+		__m128 out= _mm_setzero_ps();
+		__m128 intersect= _mm_setzero_ps();
+		for (int plane= 0; plane < 6; ++plane)
+		{
+			const __m128 distance= _mm_add_ps(_mm_add_ps(_mm_mul_ps(coefs[plane][0], centerX), _mm_mul_ps(coefs[plane][1], centerY))
+					, _mm_add_ps(_mm_mul_ps(coefs[plane][2], centerZ), coefs[plane][3]));
+			const __m128 radius= _mm_add_ps(_mm_add_ps(_mm_mul_ps(absCoefs[plane][0], extentX), _mm_mul_ps(absCoefs[plane][1], extentY))
+					, _mm_mul_ps(absCoefs[plane][2], extentZ));
+			out= _mm_or_ps(out, _mm_cmplt_ps(distance, _mm_xor_ps(radius, signMask)));
+			intersect= _mm_or_ps(intersect, _mm_cmple_ps(distance, radius));
+		}
+		const int outMask= _mm_movemask_ps(out);
+		const int intersectMask= _mm_movemask_ps(intersect);
+		for (int lane= 0; lane < 4; ++lane)
+		{
+			if (0 != (outMask & (1 << lane))) pLocalisation[i + lane]= GLC_Frustum::OutFrustum;
+			else if (0 != (intersectMask & (1 << lane))) pLocalisation[i + lane]= GLC_Frustum::IntersectFrustum;
+			else pLocalisation[i + lane]= GLC_Frustum::InFrustum;
+		}
+	}
+#endif
+	for (; i < last; ++i)
+	{
+		bool out= false;
+		bool intersect= false;
+		for (int plane= 0; plane < 6; ++plane)
+		{
+			const float* pPlane= pPlanes + 4 * plane;
+			const float distance= pPlane[0] * pCenterX[i] + pPlane[1] * pCenterY[i] + pPlane[2] * pCenterZ[i] + pPlane[3];
+			const float radius= fabsf(pPlane[0]) * pExtentX[i] + fabsf(pPlane[1]) * pExtentY[i] + fabsf(pPlane[2]) * pExtentZ[i];
+			out= out || (distance < -radius);
+			intersect= intersect || (distance <= radius);
+		}
+		if (out) pLocalisation[i]= GLC_Frustum::OutFrustum;
+		else if (intersect) pLocalisation[i]= GLC_Frustum::IntersectFrustum;
+		else pLocalisation[i]= GLC_Frustum::InFrustum;
+	}
+}
+
+void GLC_LinearOctree::setViewable(int first, int last, int flag)
+{
+	const GLC_3DViewInstance::Viewable viewable= static_cast<GLC_3DViewInstance::Viewable>(flag);
+	for (int i= first; i < last; ++i)
+	{
+		m_Instances.at(i)->setViewable(viewable);
+	}
+}
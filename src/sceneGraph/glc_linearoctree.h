@@ -0,0 +1,173 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_linearoctree.h interface for the GLC_LinearOctree class.
+
+#ifndef GLC_LINEAROCTREE_H_
+#define GLC_LINEAROCTREE_H_
+
+#include <QVector>
+
+#include "glc_spacepartitioning.h"
+#include "../glc_config.h"
+
+class GLC_3DViewInstance;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_LinearOctree
+/*! \brief GLC_LinearOctree : space partitioning implementation with a linear octree */
+
+/*! Each instance is stored in the smallest octree cell which contains its bounding box.
+ *  Cells are sorted by Morton code, nodes are stored in a contiguous array in depth first
+ *  order and the instances of a node subtree are contiguous.
+ *  Node and instance bounding boxes are stored in float in structure of arrays layout
+ *  and are classified against the frustum planes 4 at a time with SSE when available.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_LinearOctree : public GLC_SpacePartitioning
+{
+	//! A node of the linear octree
+	struct Node
+	{
+		//! Index of the first instance of this node
+		int m_FirstInstance;
+		//! Number of instances of this node
+		int m_InstanceCount;
+		//! End of the instances of this node subtree
+		int m_InstanceEnd;
+		//! Index of the node following this node subtree
+		int m_Skip;
+	};
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Create an empty linear octree of the given 3D view collection
+	GLC_LinearOctree(GLC_3DViewCollection*);
+
+	//! Create the linear octree from the given linear octree
+	GLC_LinearOctree(const GLC_LinearOctree&);
+
+	//! Destructor
+	virtual ~GLC_LinearOctree();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return the default linear octree depth
+	static int defaultDepth();
+
+	//! Return the maximum linear octree depth
+	static int maximumDepth();
+
+	//! Return this linear octree depth
+	inline int depth() const
+	{return m_Depth;}
+
+	//! Return the number of nodes of this linear octree
+	inline int nodeCount() const
+	{return m_Nodes.size();}
+
+	//! Return the list off instances inside or intersect the given bounding box
+	virtual QList<GLC_3DViewInstance*> listOfIntersectedInstances(const GLC_BoundingBox& bBox);
+
+	//! Return the list off instances whose bounding box is intersected by the given ray
+	virtual QList<GLC_3DViewInstance*> listOfIntersectedInstances(const GLC_Line3d& ray);
+
+//@}
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+
+	//! Update the viewable 3d view instance of this linear octree from the given frustum
+	virtual void updateViewableInstances(const GLC_Frustum&);
+
+	//! Update this linear octree space partionning
+	virtual void updateSpacePartitioning();
+
+	//! Clear the space partionning
+	virtual void clear();
+
+	//! Set this linear octree depth
+	/*! The depth is bounded by maximumDepth(). If space partitionning is already done, update it*/
+	void setDepth(int);
+
+	//! Set the default linear octree depth
+	static void setDefaultDepth(int depth);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services function
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Return the bounding box of the given node
+	GLC_BoundingBox nodeBoundingBox(int index) const;
+
+	//! Set the float bounds of the given box in the given structure of arrays
+	static void setBounds(QVector<float>* pBounds, int stride, int index, const double* pLower, const double* pUpper);
+
+	//! Localize the given range of boxes of the given structure of arrays against the given planes
+	/*! Planes contains the 4 coefficients of the 6 frustum planes, the result is a GLC_Frustum::Localisation*/
+	static void localizeBoxes(const float* pBounds, int stride, int first, int last, const float* pPlanes, uchar* pLocalisation);
+
+	//! Set the given viewable flag to the given range of instances
+	void setViewable(int first, int last, int flag);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	//! The nodes in depth first order
+	QVector<Node> m_Nodes;
+
+	//! The nodes bounds : center x, y, z then extent x, y, z arrays
+	QVector<float> m_NodeBounds;
+
+	//! The instances in node order
+	QVector<GLC_3DViewInstance*> m_Instances;
+
+	//! The instances bounds : center x, y, z then extent x, y, z arrays
+	QVector<float> m_InstanceBounds;
+
+	//! The frustum localisation of nodes
+	QVector<uchar> m_NodeLocalisation;
+
+	//! The frustum localisation of instances
+	QVector<uchar> m_InstanceLocalisation;
+
+	//! True if the space partitionning is done
+	bool m_IsPartitioned;
+
+	//! Linear octree depth
+	int m_Depth;
+
+	//! The default linear octree depth
+	static int m_DefaultDepth;
+};
+
+#endif /* GLC_LINEAROCTREE_H_ */
@@ -0,0 +1,443 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_occlusionculler.cpp implementation for the GLC_OcclusionCuller class.
+
+#include "glc_occlusionculler.h"
+#include "glc_frustumculler.h"
+#include "glc_3dviewinstance.h"
+
+#include <QAtomicInt>
+#include <QPair>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+#define GLC_OCCLUSIONCULLER_SSE
+#include <xmmintrin.h>
+#endif
+
+// Default depth buffer resolution
+static const int defaultWidth= 256;
+static const int defaultHeight= 128;
+
+// Default maximum number of occluders and of occluders triangles
+static const int defaultOccluderCount= 16;
+static const int defaultTriangleCount= 32768;
+
+// Number of rows of a rasterized band
+static const int bandHeight= 16;
+
+// Number of occludees of a tested chunk
+static const int chunkSize= 256;
+
+// Depth tolerance of the occlusion test, avoid occluders culling themselves
+static const float depthEpsilon= 1.0e-5f;
+
+// Runnable which processes chunks with a culler function
+class GLC_OcclusionCuller::ChunkRunner : public QRunnable
+{
+public:
+	inline ChunkRunner(GLC_OcclusionCuller* pCuller, ChunkFunction function, int chunkCount, QAtomicInt* pNextChunk, QSemaphore* pDoneSemaphore)
+	: QRunnable()
+	, m_pCuller(pCuller)
+	, m_Function(function)
+	, m_ChunkCount(chunkCount)
+	, m_pNextChunk(pNextChunk)
+	, m_pDoneSemaphore(pDoneSemaphore)
+	{}
+
+	//! Process the next chunks until all chunks are taken
+	virtual void run()
+	{
+		int chunkIndex= m_pNextChunk->fetchAndAddOrdered(1);
+		while (chunkIndex < m_ChunkCount)
+		{
+			(m_pCuller->*m_Function)(chunkIndex);
+			chunkIndex= m_pNextChunk->fetchAndAddOrdered(1);
+		}
+		if (NULL != m_pDoneSemaphore) m_pDoneSemaphore->release();
+	}
+
+private:
+	//! The culler which owns the chunks
+	GLC_OcclusionCuller* m_pCuller;
+	//! The function processing a chunk
+	ChunkFunction m_Function;
+	//! The number of chunks
+	int m_ChunkCount;
+	//! The index of the next chunk to process
+	QAtomicInt* m_pNextChunk;
+	//! The semaphore released when this runner is done
+	QSemaphore* m_pDoneSemaphore;
+};
+
+GLC_OcclusionCuller::GLC_OcclusionCuller()
+: m_Width(defaultWidth)
+, m_Height(defaultHeight)
+, m_MaximumOccluderCount(defaultOccluderCount)
+, m_MaximumTriangleCount(defaultTriangleCount)
+, m_OccluderCount(0)
+, m_DepthBuffer(defaultWidth * defaultHeight, std::numeric_limits<float>::max())
+, m_Triangles()
+, m_Occludees()
+, m_OccludeeIndexes()
+, m_IsOccluded()
+{
+	memset(m_CompositionMatrix, 0, sizeof(m_CompositionMatrix));
+}
+
+GLC_OcclusionCuller::~GLC_OcclusionCuller()
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_OcclusionCuller::setResolution(int width, int height)
+{
+	m_Width= (qMax(4, width) + 3) & ~3;
+	m_Height= qMax(1, height);
+	m_DepthBuffer.fill(std::numeric_limits<float>::max(), m_Width * m_Height);
+}
+
+int GLC_OcclusionCuller::cull(GLC_FrustumCuller* pFrustumCuller, const GLC_Matrix4x4& compositionMatrix, bool showState, bool parallel)
+{
+	memcpy(m_CompositionMatrix, compositionMatrix.getData(), sizeof(m_CompositionMatrix));
+	selectOccluders(pFrustumCuller, showState);
+
+	// The depth buffer is written by several threads, it must not be shared
+	m_DepthBuffer.detach();
+	runChunks(&GLC_OcclusionCuller::rasterizeBand, (m_Height + bandHeight - 1) / bandHeight, parallel);
+	if (m_Triangles.isEmpty()) return 0;
+
+	const int occludeeCount= m_Occludees.size();
+	m_IsOccluded.fill(0, occludeeCount);
+	runChunks(&GLC_OcclusionCuller::testChunk, (occludeeCount + chunkSize - 1) / chunkSize, parallel);
+
+	int culledCount= 0;
+	for (int i= 0; i < occludeeCount; ++i)
+	{
+		if (0 != m_IsOccluded.at(i))
+		{
+			pFrustumCuller->cullInstance(m_OccludeeIndexes.at(i));
+			++culledCount;
+		}
+	}
+
+	return culledCount;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_OcclusionCuller::selectOccluders(GLC_FrustumCuller* pFrustumCuller, bool showState)
+{
+	m_Occludees.resize(0);
+	m_OccludeeIndexes.resize(0);
+	m_Triangles.resize(0);
+	m_OccluderCount= 0;
+
+	const double* pMatrix= m_CompositionMatrix;
+	QVector<QPair<double, int> > candidates;
+	const GLC_BitSet& viewableBits= pFrustumCuller->viewableBits();
+	for (int i= viewableBits.nextSetBit(0); i != -1; i= viewableBits.nextSetBit(i + 1))
+	{
+		GLC_3DViewInstance* pInstance= pFrustumCuller->instanceAt(i);
+		if (pInstance->isVisible() != showState) continue;
+
+		m_Occludees.append(pInstance);
+		m_OccludeeIndexes.append(i);
+
+		// Opaque filled instances are occluder candidates, scored by their projected size
+		GLC_RenderProperties* pRenderProperties= pInstance->renderPropertiesHandle();
+		if ((pRenderProperties->renderingMode() == glc::NormalRenderMode) && (pRenderProperties->polygonMode() == GL_FILL)
+				&& !pInstance->hasTransparentMaterials())
+		{
+			const GLC_BoundingBox boundingBox(pInstance->boundingBox());
+			if (boundingBox.isEmpty()) continue;
+			const GLC_Point3d center(boundingBox.center());
+			const double clipW= pMatrix[3] * center.x() + pMatrix[7] * center.y() + pMatrix[11] * center.z() + pMatrix[15];
+			if (clipW > 0.0)
+			{
+				candidates.append(qMakePair(boundingBox.boundingSphereRadius() / clipW, m_Occludees.size() - 1));
+			}
+		}
+	}
+
+	const int candidateCount= qMin(candidates.size(), m_MaximumOccluderCount);
+	std::partial_sort(candidates.begin(), candidates.begin() + candidateCount, candidates.end(), std::greater<QPair<double, int> >());
+	for (int i= 0; (i < candidateCount) && (m_Triangles.size() < m_MaximumTriangleCount); ++i)
+	{
+		appendOccluder(m_Occludees.at(candidates.at(i).second));
+		++m_OccluderCount;
+	}
+}
+
+void GLC_OcclusionCuller::appendOccluder(GLC_3DViewInstance* pInstance)
+{
+	const GLC_Matrix4x4 matrix(GLC_Matrix4x4(m_CompositionMatrix) * pInstance->matrix());
+	const double* pData= matrix.getData();
+	float floatMatrix[16];
+	for (int i= 0; i < 16; ++i)
+	{
+		floatMatrix[i]= static_cast<float>(pData[i]);
+	}
+
+	const int bodyCount= pInstance->numberOfBody();
+	for (int body= 0; body < bodyCount; ++body)
+	{
+		if (!pInstance->isGeomViewable(body)) continue;
+		const QVector<GLfloat> vertices(pInstance->geomAt(body)->triangleVertices());
+		const int triangleCount= vertices.size() / 9;
+		const GLfloat* pVertex= vertices.constData();
+		for (int triangle= 0; triangle < triangleCount; ++triangle, pVertex+= 9)
+		{
+			if (m_Triangles.size() >= m_MaximumTriangleCount) return;
+
+			float clip[3][4];
+			for (int corner= 0; corner < 3; ++corner)
+			{
+				const GLfloat* pCorner= pVertex + 3 * corner;
+				for (int row= 0; row < 4; ++row)
+				{
+					clip[corner][row]= floatMatrix[row] * pCorner[0] + floatMatrix[4 + row] * pCorner[1]
+							+ floatMatrix[8 + row] * pCorner[2] + floatMatrix[12 + row];
+				}
+			}
+			appendTriangle(clip[0], clip[1], clip[2]);
+		}
+	}
+}
+
+void GLC_OcclusionCuller::appendTriangle(const float* pClip0, const float* pClip1, const float* pClip2)
+{
+	const float* pClips[3]= {pClip0, pClip1, pClip2};
+	float x[3], y[3], z[3];
+	for (int corner= 0; corner < 3; ++corner)
+	{
+		const float* pClip= pClips[corner];
+		// Triangles crossing the near plane are not occluders
+		if ((pClip[3] <= 0.0f) || (pClip[2] < -pClip[3])) return;
+		const float invW= 1.0f / pClip[3];
+		x[corner]= (pClip[0] * invW * 0.5f + 0.5f) * static_cast<float>(m_Width);
+		y[corner]= (pClip[1] * invW * 0.5f + 0.5f) * static_cast<float>(m_Height);
+		z[corner]= pClip[2] * invW;
+	}
+
+	const float area= (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if (fabs(area) < std::numeric_limits<float>::epsilon()) return;
+
+	// Pixels whose center can be inside the triangle
+	const float lowerX= qMax(0.0f, qMin(x[0], qMin(x[1], x[2])) - 0.5f);
+	const float upperX= qMin(static_cast<float>(m_Width - 1), qMax(x[0], qMax(x[1], x[2])) - 0.5f);
+	const float lowerY= qMax(0.0f, qMin(y[0], qMin(y[1], y[2])) - 0.5f);
+	const float upperY= qMin(static_cast<float>(m_Height - 1), qMax(y[0], qMax(y[1], y[2])) - 0.5f);
+	if ((lowerX > upperX) || (lowerY > upperY)) return;
+
+	Triangle triangle;
+	triangle.m_MinX= static_cast<int>(ceil(lowerX));
+	triangle.m_MaxX= static_cast<int>(floor(upperX));
+	triangle.m_MinY= static_cast<int>(ceil(lowerY));
+	triangle.m_MaxY= static_cast<int>(floor(upperY));
+	if ((triangle.m_MinX > triangle.m_MaxX) || (triangle.m_MinY > triangle.m_MaxY)) return;
+
+	// Edge functions are positive inside for both orientations
+	const float sign= (area > 0.0f) ? 1.0f : -1.0f;
+	for (int edge= 0; edge < 3; ++edge)
+	{
+		const int next= (edge + 1) % 3;
+		triangle.m_Edges[3 * edge]= sign * (y[edge] - y[next]);
+		triangle.m_Edges[3 * edge + 1]= sign * (x[next] - x[edge]);
+		triangle.m_Edges[3 * edge + 2]= sign * (x[edge] * y[next] - x[next] * y[edge]);
+	}
+
+	triangle.m_Depth[0]= ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+	triangle.m_Depth[1]= ((x[1] - x[0]) * (z[2] - z[0]) - (x[2] - x[0]) * (z[1] - z[0])) / area;
+	triangle.m_Depth[2]= z[0] - triangle.m_Depth[0] * x[0] - triangle.m_Depth[1] * y[0];
+
+	m_Triangles.append(triangle);
+}
+
+void GLC_OcclusionCuller::runChunks(ChunkFunction function, int chunkCount, bool parallel)
+{
+	const int threadCount= parallel ? qBound(1, QThread::idealThreadCount(), chunkCount) : 1;
+	QAtomicInt nextChunk(0);
+	QSemaphore doneSemaphore;
+	for (int i= 1; i < threadCount; ++i)
+	{
+		GLC_FrustumCuller::threadPool()->start(new ChunkRunner(this, function, chunkCount, &nextChunk, &doneSemaphore));
+	}
+
+	// The calling thread processes chunks too
+	ChunkRunner runner(this, function, chunkCount, &nextChunk, NULL);
+	runner.run();
+	doneSemaphore.acquire(threadCount - 1);
+}
+
+void GLC_OcclusionCuller::rasterizeBand(int bandIndex)
+{
+	const int firstRow= bandIndex * bandHeight;
+	const int lastRow= qMin(firstRow + bandHeight, m_Height) - 1;
+	float* pBuffer= m_DepthBuffer.data();
+	std::fill(pBuffer + firstRow * m_Width, pBuffer + (lastRow + 1) * m_Width, std::numeric_limits<float>::max());
+
+#ifdef GLC_OCCLUSIONCULLER_SSE
+	const __m128 offsets= _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+#endif
+
+	const int triangleCount= m_Triangles.size();
+	for (int i= 0; i < triangleCount; ++i)
+	{
+		const Triangle& triangle= m_Triangles.at(i);
+		if ((triangle.m_MaxY < firstRow) || (triangle.m_MinY > lastRow)) continue;
+
+		const float* pEdges= triangle.m_Edges;
+		const int rowBegin= qMax(firstRow, triangle.m_MinY);
+		const int rowEnd= qMin(lastRow, triangle.m_MaxY);
+		for (int row= rowBegin; row <= rowEnd; ++row)
+		{
+			const float centerY= static_cast<float>(row) + 0.5f;
+			const float rowEdge0= pEdges[1] * centerY + pEdges[2];
+			const float rowEdge1= pEdges[4] * centerY + pEdges[5];
+			const float rowEdge2= pEdges[7] * centerY + pEdges[8];
+			const float rowDepth= triangle.m_Depth[1] * centerY + triangle.m_Depth[2];
+			float* pRow= pBuffer + row * m_Width;
+
+#ifdef GLC_OCCLUSIONCULLER_SSE
+			// The width is a multiple of 4, 4 pixels are rasterized at a time
+			const __m128 zero= _mm_setzero_ps();
+			for (int x= triangle.m_MinX & ~3; x <= triangle.m_MaxX; x+= 4)
+			{
+				const __m128 centerX= _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+				const __m128 edge0= _mm_add_ps(_mm_mul_ps(_mm_set1_ps(pEdges[0]), centerX), _mm_set1_ps(rowEdge0));
+				const __m128 edge1= _mm_add_ps(_mm_mul_ps(_mm_set1_ps(pEdges[3]), centerX), _mm_set1_ps(rowEdge1));
+				const __m128 edge2= _mm_add_ps(_mm_mul_ps(_mm_set1_ps(pEdges[6]), centerX), _mm_set1_ps(rowEdge2));
+				const __m128 inside= _mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_and_ps(_mm_cmpge_ps(edge1, zero), _mm_cmpge_ps(edge2, zero)));
+				if (0 == _mm_movemask_ps(inside)) continue;
+
+				const __m128 depth= _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.m_Depth[0]), centerX), _mm_set1_ps(rowDepth));
+				const __m128 current= _mm_loadu_ps(pRow + x);
+				const __m128 nearest= _mm_min_ps(current, depth);
+				_mm_storeu_ps(pRow + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+			}
+#else
+			for (int x= triangle.m_MinX; x <= triangle.m_MaxX; ++x)
+			{
+				const float centerX= static_cast<float>(x) + 0.5f;
+				if (((pEdges[0] * centerX + rowEdge0) >= 0.0f) && ((pEdges[3] * centerX + rowEdge1) >= 0.0f)
+						&& ((pEdges[6] * centerX + rowEdge2) >= 0.0f))
+				{
+					pRow[x]= qMin(pRow[x], triangle.m_Depth[0] * centerX + rowDepth);
+				}
+			}
+#endif
+		}
+	}
+}
+
+void GLC_OcclusionCuller::testChunk(int chunkIndex)
+{
+	const int first= chunkIndex * chunkSize;
+	const int last= qMin(first + chunkSize, m_Occludees.size());
+	uchar* pIsOccluded= m_IsOccluded.data();
+	for (int i= first; i < last; ++i)
+	{
+		pIsOccluded[i]= isOccluded(m_Occludees.at(i)->boundingBox()) ? 1 : 0;
+	}
+}
+
+bool GLC_OcclusionCuller::isOccluded(const GLC_BoundingBox& boundingBox) const
+{
+	if (boundingBox.isEmpty()) return false;
+
+	// Project the box corners and compute the nearest depth
+	const double* pMatrix= m_CompositionMatrix;
+	const double lower[3]= {boundingBox.lowerCorner().x(), boundingBox.lowerCorner().y(), boundingBox.lowerCorner().z()};
+	const double upper[3]= {boundingBox.upperCorner().x(), boundingBox.upperCorner().y(), boundingBox.upperCorner().z()};
+	double minX= std::numeric_limits<double>::max();
+	double maxX= -minX;
+	double minY= minX;
+	double maxY= -minX;
+	double minDepth= minX;
+	for (int corner= 0; corner < 8; ++corner)
+	{
+		const double x= (corner & 1) ? upper[0] : lower[0];
+		const double y= (corner & 2) ? upper[1] : lower[1];
+		const double z= (corner & 4) ? upper[2] : lower[2];
+		const double clipW= pMatrix[3] * x + pMatrix[7] * y + pMatrix[11] * z + pMatrix[15];
+		const double clipZ= pMatrix[2] * x + pMatrix[6] * y + pMatrix[10] * z + pMatrix[14];
+
+		// A box crossing the near plane is not occluded
+		if ((clipW <= 0.0) || (clipZ < -clipW)) return false;
+
+		const double invW= 1.0 / clipW;
+		const double screenX= ((pMatrix[0] * x + pMatrix[4] * y + pMatrix[8] * z + pMatrix[12]) * invW * 0.5 + 0.5) * m_Width;
+		const double screenY= ((pMatrix[1] * x + pMatrix[5] * y + pMatrix[9] * z + pMatrix[13]) * invW * 0.5 + 0.5) * m_Height;
+		minX= qMin(minX, screenX);
+		maxX= qMax(maxX, screenX);
+		minY= qMin(minY, screenY);
+		maxY= qMax(maxY, screenY);
+		minDepth= qMin(minDepth, clipZ * invW);
+	}
+	if ((maxX < 0.0) || (minX >= m_Width) || (maxY < 0.0) || (minY >= m_Height)) return false;
+
+	// The box is occluded if occluders are nearer on every pixel touched by its rectangle
+	const int firstX= static_cast<int>(qMax(0.0, floor(minX)));
+	const int lastX= static_cast<int>(qMin(static_cast<double>(m_Width - 1), floor(maxX)));
+	const int firstY= static_cast<int>(qMax(0.0, floor(minY)));
+	const int lastY= static_cast<int>(qMin(static_cast<double>(m_Height - 1), floor(maxY)));
+	const float depth= static_cast<float>(minDepth) - depthEpsilon;
+	const float* pBuffer= m_DepthBuffer.constData();
+
+#ifdef GLC_OCCLUSIONCULLER_SSE
+	const __m128 depth4= _mm_set1_ps(depth);
+#endif
+
+	for (int row= firstY; row <= lastY; ++row)
+	{
+		const float* pRow= pBuffer + row * m_Width;
+		int x= firstX;
+#ifdef GLC_OCCLUSIONCULLER_SSE
+		for (; (x + 3) <= lastX; x+= 4)
+		{
+			if (0 != _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(pRow + x), depth4))) return false;
+		}
+#endif
+		for (; x <= lastX; ++x)
+		{
+			if (pRow[x] >= depth) return false;
+		}
+	}
+
+	return true;
+}
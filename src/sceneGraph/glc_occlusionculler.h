@@ -0,0 +1,203 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_occlusionculler.h interface for the GLC_OcclusionCuller class.
+
+#ifndef GLC_OCCLUSIONCULLER_H_
+#define GLC_OCCLUSIONCULLER_H_
+
+#include <QVector>
+
+#include "../glc_config.h"
+
+class GLC_FrustumCuller;
+class GLC_3DViewInstance;
+class GLC_BoundingBox;
+class GLC_Matrix4x4;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_OcclusionCuller
+/*! \brief GLC_OcclusionCuller : Occlusion culling of the instances viewable after frustum culling*/
+
+/*! The triangles of the largest viewable instances are rasterized in a low resolution
+ *  CPU depth buffer. The bounding box of each viewable instance is then projected on the
+ *  buffer and the instance is culled if the buffer is nearer on the whole box rectangle.
+ *  The buffer is rasterized by bands of rows and boxes are tested by chunks, in parallel
+ *  if requested, 4 pixels at a time with SSE when available.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_OcclusionCuller
+{
+	//! \class ChunkRunner
+	/*! \brief ChunkRunner : Runnable which processes chunks of the occlusion culling */
+	class ChunkRunner;
+	friend class ChunkRunner;
+
+	//! A function processing a chunk
+	typedef void (GLC_OcclusionCuller::*ChunkFunction)(int);
+
+	//! An occluder triangle in screen space
+	struct Triangle
+	{
+		//! The a, b and c coefficients of the 3 edge functions, positive inside
+		float m_Edges[9];
+		//! The a, b and c coefficients of the depth plane
+		float m_Depth[3];
+		//! The pixel bounds of the triangle
+		int m_MinX;
+		int m_MaxX;
+		int m_MinY;
+		int m_MaxY;
+	};
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Construct an occlusion culler with the default resolution
+	GLC_OcclusionCuller();
+
+	//! Destructor
+	~GLC_OcclusionCuller();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return the width of the depth buffer
+	inline int width() const
+	{return m_Width;}
+
+	//! Return the height of the depth buffer
+	inline int height() const
+	{return m_Height;}
+
+	//! Return the maximum number of occluders
+	inline int maximumOccluderCount() const
+	{return m_MaximumOccluderCount;}
+
+	//! Return the maximum number of occluders triangles
+	inline int maximumTriangleCount() const
+	{return m_MaximumTriangleCount;}
+
+	//! Return the number of occluders of the last culling
+	inline int occluderCount() const
+	{return m_OccluderCount;}
+
+	//! Return the depth buffer of the last culling, row by row from the bottom
+	/*! Depth are normalized device coordinates, pixels without occluder are set to the float maximum*/
+	inline const QVector<float>& depthBuffer() const
+	{return m_DepthBuffer;}
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Set the resolution of the depth buffer
+	/*! The width is rounded up to a multiple of 4*/
+	void setResolution(int width, int height);
+
+	//! Set the maximum number of occluders
+	inline void setMaximumOccluderCount(int count)
+	{m_MaximumOccluderCount= qMax(0, count);}
+
+	//! Set the maximum number of occluders triangles
+	inline void setMaximumTriangleCount(int count)
+	{m_MaximumTriangleCount= qMax(0, count);}
+
+	//! Cull the occluded instances of the given frustum culler and return the number of culled instances
+	/*! The given frustum culler must have been culled, the composition matrix is the
+	 *  projection matrix multiplied by the model view matrix. Only instances with the
+	 *  given visibility are occluders and occludees.*/
+	int cull(GLC_FrustumCuller* pFrustumCuller, const GLC_Matrix4x4& compositionMatrix, bool showState, bool parallel);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Select the occludees and the occluders of the given frustum culler and setup occluders triangles
+	void selectOccluders(GLC_FrustumCuller* pFrustumCuller, bool showState);
+
+	//! Setup the triangles of the viewable bodies of the given instance until the maximum number of triangles
+	void appendOccluder(GLC_3DViewInstance* pInstance);
+
+	//! Setup the given triangle in clip coordinates
+	void appendTriangle(const float* pClip0, const float* pClip1, const float* pClip2);
+
+	//! Process the given number of chunks with the given function
+	void runChunks(ChunkFunction function, int chunkCount, bool parallel);
+
+	//! Clear and rasterize occluders triangles in the given band of rows
+	void rasterizeBand(int bandIndex);
+
+	//! Test the occludees of the given chunk
+	void testChunk(int chunkIndex);
+
+	//! Return true if the given bounding box is occluded
+	bool isOccluded(const GLC_BoundingBox& boundingBox) const;
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	Q_DISABLE_COPY(GLC_OcclusionCuller)
+
+	//! The width of the depth buffer
+	int m_Width;
+
+	//! The height of the depth buffer
+	int m_Height;
+
+	//! The maximum number of occluders
+	int m_MaximumOccluderCount;
+
+	//! The maximum number of occluders triangles
+	int m_MaximumTriangleCount;
+
+	//! The number of occluders of the last culling
+	int m_OccluderCount;
+
+	//! The depth buffer
+	QVector<float> m_DepthBuffer;
+
+	//! The occluders triangles
+	QVector<Triangle> m_Triangles;
+
+	//! The occludees instances
+	QVector<GLC_3DViewInstance*> m_Occludees;
+
+	//! The frustum culler index of occludees
+	QVector<int> m_OccludeeIndexes;
+
+	//! The occlusion state of occludees
+	QVector<uchar> m_IsOccluded;
+
+	//! The composition matrix of the current culling
+	double m_CompositionMatrix[16];
+};
+
+#endif /* GLC_OCCLUSIONCULLER_H_ */
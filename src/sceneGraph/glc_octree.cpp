@@ -32,6 +32,7 @@ GLC_Octree::GLC_Octree(GLC_3DViewCollection* pCollection)
 : GLC_SpacePartitioning(pCollection)
 , m_pRootNode(NULL)
 , m_OctreeDepth(m_DefaultOctreeDepth)
+, m_InstanceBoundingBoxHash()
 {
 
 
@@ -41,6 +42,7 @@ GLC_Octree::GLC_Octree(const GLC_Octree& octree)
 : GLC_SpacePartitioning(octree)
 , m_pRootNode(NULL)
 , m_OctreeDepth(octree.m_OctreeDepth)
+, m_InstanceBoundingBoxHash(octree.m_InstanceBoundingBoxHash)
 {
 	if (NULL != octree.m_pRootNode)
 	{
@@ -67,6 +69,17 @@ QList<GLC_3DViewInstance*> GLC_Octree::listOfIntersectedInstances(const GLC_Boun
 	return m_pRootNode->setOfIntersectedInstances(bBox).toList();
 }
 
+QList<GLC_3DViewInstance*> GLC_Octree::listOfIntersectedInstances(const GLC_Line3d& ray)
+{
+	if (NULL == m_pRootNode)
+	{
+		updateSpacePartitioning();
+	}
+	QSet<GLC_3DViewInstance*> instanceSet;
+	m_pRootNode->intersectedInstances(ray, &instanceSet);
+	return instanceSet.toList();
+}
+
 void GLC_Octree::updateViewableInstances(const GLC_Frustum& frustum)
 {
 	if (NULL == m_pRootNode)
@@ -80,12 +93,15 @@ void GLC_Octree::updateSpacePartitioning()
 {
 	delete m_pRootNode;
 	m_pRootNode= new GLC_OctreeNode(m_pCollection->boundingBox(true));
+	m_InstanceBoundingBoxHash.clear();
 	// fill the octree
 	QList<GLC_3DViewInstance*> instanceList(m_pCollection->instancesHandle());
 	const int size= instanceList.size();
 	for (int i= 0; i < size; ++i)
 	{
-		m_pRootNode->addInstance(instanceList.at(i), m_OctreeDepth);
+		GLC_3DViewInstance* pInstance= instanceList.at(i);
+		m_pRootNode->addInstance(pInstance, m_OctreeDepth);
+		m_InstanceBoundingBoxHash.insert(pInstance, pInstance->boundingBox());
 	}
 	m_pRootNode->removeEmptyChildren();
 }
@@ -94,6 +110,60 @@ void GLC_Octree::clear()
 {
 	delete m_pRootNode;
 	m_pRootNode= NULL;
+	m_InstanceBoundingBoxHash.clear();
+}
+
+void GLC_Octree::insertInstance(GLC_3DViewInstance* pInstance)
+{
+	// The instance is viewable until the next update of viewable instances
+	pInstance->setViewable(GLC_3DViewInstance::FullViewable);
+
+	// The octree is created when needed
+	if (NULL == m_pRootNode) return;
+
+	const GLC_BoundingBox instanceBox(pInstance->boundingBox());
+	if (!instanceBox.isEmpty())
+	{
+		const GLC_BoundingBox& rootBox= m_pRootNode->boundingBox();
+		const bool isInside= (instanceBox.lowerCorner().x() >= rootBox.lowerCorner().x())
+				&& (instanceBox.lowerCorner().y() >= rootBox.lowerCorner().y())
+				&& (instanceBox.lowerCorner().z() >= rootBox.lowerCorner().z())
+				&& (instanceBox.upperCorner().x() <= rootBox.upperCorner().x())
+				&& (instanceBox.upperCorner().y() <= rootBox.upperCorner().y())
+				&& (instanceBox.upperCorner().z() <= rootBox.upperCorner().z());
+		if (isInside)
+		{
+			m_pRootNode->insertInstance(pInstance, instanceBox, m_OctreeDepth);
+		}
+		else
+		{
+			// The octree bounding box must be enlarged
+			clear();
+			return;
+		}
+	}
+	m_InstanceBoundingBoxHash.insert(pInstance, instanceBox);
+}
+
+void GLC_Octree::removeInstance(GLC_3DViewInstance* pInstance)
+{
+	if (NULL == m_pRootNode) return;
+
+	QHash<GLC_3DViewInstance*, GLC_BoundingBox>::iterator iInstance= m_InstanceBoundingBoxHash.find(pInstance);
+	if (m_InstanceBoundingBoxHash.end() != iInstance)
+	{
+		if (!iInstance.value().isEmpty())
+		{
+			m_pRootNode->removeInstance(pInstance, iInstance.value());
+		}
+		m_InstanceBoundingBoxHash.erase(iInstance);
+	}
+}
+
+void GLC_Octree::updateInstance(GLC_3DViewInstance* pInstance)
+{
+	removeInstance(pInstance);
+	insertInstance(pInstance);
 }
 
 void GLC_Octree::setDepth(int depth)
@@ -24,6 +24,8 @@
 #ifndef GLC_OCTREE_H_
 #define GLC_OCTREE_H_
 
+#include <QHash>
+
 #include "glc_spacepartitioning.h"
 #include "../glc_config.h"
 
@@ -64,6 +66,9 @@ public:
 	//! Return the list off instances inside or intersect the given bounding box
 	virtual QList<GLC_3DViewInstance*> listOfIntersectedInstances(const GLC_BoundingBox& bBox);
 
+	//! Return the list off instances whose bounding box is intersected by the given ray
+	virtual QList<GLC_3DViewInstance*> listOfIntersectedInstances(const GLC_Line3d& ray);
+
 //@}
 //////////////////////////////////////////////////////////////////////
 /*! \name Set Functions*/
@@ -80,6 +85,16 @@ public:
 	//! Clear the space partionning
 	virtual void clear();
 
+	//! Insert the given instance of the collection in this octree
+	/*! If the instance is outside of the octree, the octree is cleared and updated when needed*/
+	virtual void insertInstance(GLC_3DViewInstance*);
+
+	//! Remove the given instance of the collection from this octree
+	virtual void removeInstance(GLC_3DViewInstance*);
+
+	//! Move the given instance from the octree nodes it left to the octree nodes it entered
+	virtual void updateInstance(GLC_3DViewInstance*);
+
 	//! Set this octree depth
 	/*! If space partitionning is already done, update it*/
 	void setDepth(int);
@@ -111,6 +126,9 @@ private:
 	//! Octree depth
 	int m_OctreeDepth;
 
+	//! The bounding box of instances when they were added to the octree
+	QHash<GLC_3DViewInstance*, GLC_BoundingBox> m_InstanceBoundingBoxHash;
+
 	//! The default octree Depth
 	static int m_DefaultOctreeDepth;
 };
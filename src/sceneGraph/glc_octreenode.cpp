@@ -90,13 +90,33 @@ QSet<GLC_3DViewInstance*> GLC_OctreeNode::setOfIntersectedInstances(const GLC_Bo
 
 	return instanceSet;
 }
+
+void GLC_OctreeNode::intersectedInstances(const GLC_Line3d& ray, QSet<GLC_3DViewInstance*>* pInstanceSet)
+{
+	if (m_BoundingBox.intersect(ray))
+	{
+		QSet<GLC_3DViewInstance*>::iterator iInstance= m_3DViewInstanceSet.begin();
+		while (m_3DViewInstanceSet.constEnd() != iInstance)
+		{
+			if (!pInstanceSet->contains(*iInstance) && (*iInstance)->boundingBox().intersect(ray))
+			{
+				pInstanceSet->insert(*iInstance);
+			}
+			++iInstance;
+		}
+		const int childCount= m_Children.size();
+		for (int i= 0; i < childCount; ++i)
+		{
+			m_Children[i]->intersectedInstances(ray, pInstanceSet);
+		}
+	}
+}
 //////////////////////////////////////////////////////////////////////
 // Set Functions
 //////////////////////////////////////////////////////////////////////
 
 void GLC_OctreeNode::addChildren()
 {
-	Q_ASSERT(m_Children.isEmpty());
 	Q_ASSERT(!m_BoundingBox.isEmpty());
 
 	const double xLower=  m_BoundingBox.lowerCorner().x();
@@ -111,66 +131,49 @@ void GLC_OctreeNode::addChildren()
 	const double dZ= (zUpper - zLower) / 2.0;
 
 
-	// Add 8 Children
+	// Add the missing children among the 8 children
 	GLC_Point3d lower;
 	GLC_Point3d upper;
-	GLC_OctreeNode* pOctreeNode= NULL;
 
 	{ // Child 1
 		lower.setVect(xLower, yLower, zLower);
 		upper.setVect(xLower + dX, yLower + dY, zLower + dZ);
-		GLC_BoundingBox box(lower, upper);
-		pOctreeNode= new GLC_OctreeNode(box, this);
-		m_Children.append(pOctreeNode);
+		addChild(GLC_BoundingBox(lower, upper));
 	}
 	{ // Child 2
 		lower.setVect(xLower + dX, yLower, zLower);
 		upper.setVect(xUpper, yLower + dY, zLower + dZ);
-		GLC_BoundingBox box(lower, upper);
-		pOctreeNode= new GLC_OctreeNode(box, this);
-		m_Children.append(pOctreeNode);
+		addChild(GLC_BoundingBox(lower, upper));
 	}
 	{ // Child 3
 		lower.setVect(xLower + dX, yLower + dY, zLower);
 		upper.setVect(xUpper, yUpper, zLower + dZ);
-		GLC_BoundingBox box(lower, upper);
-		pOctreeNode= new GLC_OctreeNode(box, this);
-		m_Children.append(pOctreeNode);
+		addChild(GLC_BoundingBox(lower, upper));
 	}
 	{ // Child 4
 		lower.setVect(xLower, yLower + dY, zLower);
 		upper.setVect(xLower + dX, yUpper, zLower + dZ);
-		GLC_BoundingBox box(lower, upper);
-		pOctreeNode= new GLC_OctreeNode(box, this);
-		m_Children.append(pOctreeNode);
+		addChild(GLC_BoundingBox(lower, upper));
 	}
 	{ // Child 5
 		lower.setVect(xLower, yLower, zLower + dZ);
 		upper.setVect(xLower + dX, yLower + dY, zUpper);
-		GLC_BoundingBox box(lower, upper);
-		pOctreeNode= new GLC_OctreeNode(box, this);
-		m_Children.append(pOctreeNode);
+		addChild(GLC_BoundingBox(lower, upper));
 	}
 	{ // Child 6
 		lower.setVect(xLower + dX, yLower, zLower + dZ);
 		upper.setVect(xUpper, yLower + dY, zUpper);
-		GLC_BoundingBox box(lower, upper);
-		pOctreeNode= new GLC_OctreeNode(box, this);
-		m_Children.append(pOctreeNode);
+		addChild(GLC_BoundingBox(lower, upper));
 	}
 	{ // Child 7
 		lower.setVect(xLower + dX, yLower + dY, zLower + dZ);
 		upper.setVect(xUpper, yUpper, zUpper);
-		GLC_BoundingBox box(lower, upper);
-		pOctreeNode= new GLC_OctreeNode(box, this);
-		m_Children.append(pOctreeNode);
+		addChild(GLC_BoundingBox(lower, upper));
 	}
 	{ // Child 8
 		lower.setVect(xLower, yLower + dY, zLower + dZ);
 		upper.setVect(xLower + dX, yUpper, zUpper);
-		GLC_BoundingBox box(lower, upper);
-		pOctreeNode= new GLC_OctreeNode(box, this);
-		m_Children.append(pOctreeNode);
+		addChild(GLC_BoundingBox(lower, upper));
 	}
 }
 
@@ -222,6 +225,84 @@ void GLC_OctreeNode::addInstance(GLC_3DViewInstance* pInstance, int depth)
 }
 
 
+void GLC_OctreeNode::insertInstance(GLC_3DViewInstance* pInstance, const GLC_BoundingBox& instanceBox, int depth)
+{
+	Q_ASSERT(!instanceBox.isEmpty());
+	if (intersect(instanceBox))
+	{
+		m_Empty= false;
+		if (0 == depth)
+		{
+			m_3DViewInstanceSet.insert(pInstance);
+		}
+		else
+		{
+			// Create the children removed after the octree creation
+			const int childCount= m_Children.size();
+			if (childCount < 8)
+			{
+				addChildren();
+			}
+			QVector<bool> childIntersect(8);
+			bool allIntersect= true;
+			bool currentIntersect= false;
+			for (int i= 0; i < 8; ++i)
+			{
+				currentIntersect= m_Children.at(i)->intersect(instanceBox);
+				allIntersect= allIntersect && currentIntersect;
+				childIntersect[i]= currentIntersect;
+			}
+			if (allIntersect)
+			{
+				m_3DViewInstanceSet.insert(pInstance);
+			}
+			else
+			{
+				for (int i= 0; i < 8; ++i)
+				{
+					if (childIntersect[i])
+					{
+						m_Children[i]->insertInstance(pInstance, instanceBox, depth - 1);
+					}
+				}
+			}
+
+			// Remove the created children which are not used
+			NodeList::iterator iList= m_Children.begin() + childCount;
+			while(m_Children.constEnd() != iList)
+			{
+				if ((*iList)->isEmpty())
+				{
+					delete *iList;
+					iList= m_Children.erase(iList);
+				}
+				else ++iList;
+			}
+		}
+	}
+}
+
+void GLC_OctreeNode::removeInstance(GLC_3DViewInstance* pInstance, const GLC_BoundingBox& instanceBox)
+{
+	if (intersect(instanceBox))
+	{
+		m_3DViewInstanceSet.remove(pInstance);
+		NodeList::iterator iList= m_Children.begin();
+		while(m_Children.constEnd() != iList)
+		{
+			GLC_OctreeNode* pCurrentChild= *iList;
+			pCurrentChild->removeInstance(pInstance, instanceBox);
+			if (pCurrentChild->isEmpty())
+			{
+				delete pCurrentChild;
+				iList= m_Children.erase(iList);
+			}
+			else ++iList;
+		}
+		m_Empty= m_Children.isEmpty() && m_3DViewInstanceSet.isEmpty();
+	}
+}
+
 void GLC_OctreeNode::updateViewableInstances(const GLC_Frustum& frustum, QSet<GLC_3DViewInstance*>* pInstanceSet)
 {
 
@@ -269,18 +350,7 @@ void GLC_OctreeNode::updateViewableInstances(const GLC_Frustum& frustum, QSet<GL
 					pInstanceSet->insert(pCurrentInstance);
 					pCurrentInstance->setViewable(GLC_3DViewInstance::PartialViewable);
 					//Update the geometries viewable property of the instance
-					GLC_Matrix4x4 instanceMat= pCurrentInstance->matrix();
-					const int size= pCurrentInstance->numberOfBody();
-					for (int i= 0; i < size; ++i)
-					{
-						// Get the geometry bounding box
-						GLC_BoundingBox geomBox= pCurrentInstance->geomAt(i)->boundingBox();
-						GLC_Point3d center(instanceMat * geomBox.center());
-						double radius= geomBox.boundingSphereRadius() * instanceMat.scalingX();
-						GLC_Frustum::Localisation geomLocalisation= frustum.localizeSphere(center, radius);
-
-						pCurrentInstance->setGeomViewable(i, geomLocalisation != GLC_Frustum::OutFrustum);
-					}
+					pCurrentInstance->setGeomViewable(frustum);
 				}
 			}
 
@@ -373,3 +443,16 @@ void GLC_OctreeNode::disableViewFlag(QSet<GLC_3DViewInstance*>* pInstanceSet)
 	}
 }
 
+void GLC_OctreeNode::addChild(const GLC_BoundingBox& boundingBox)
+{
+	const int size= m_Children.size();
+	for (int i= 0; i < size; ++i)
+	{
+		const GLC_BoundingBox& childBox= m_Children.at(i)->m_BoundingBox;
+		if ((childBox.lowerCorner() == boundingBox.lowerCorner()) && (childBox.upperCorner() == boundingBox.upperCorner()))
+		{
+			return;
+		}
+	}
+	m_Children.append(new GLC_OctreeNode(boundingBox, this));
+}
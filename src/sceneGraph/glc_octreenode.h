@@ -99,6 +99,9 @@ public:
 	//! Return the list off instances inside or intersect the given bounding box
 	QSet<GLC_3DViewInstance*> setOfIntersectedInstances(const GLC_BoundingBox& bBox);
 
+	//! Insert instances whose bounding box is intersected by the given ray in the given set
+	void intersectedInstances(const GLC_Line3d& ray, QSet<GLC_3DViewInstance*>* pInstanceSet);
+
 
 //@}
 
@@ -109,11 +112,20 @@ public:
 public:
 
 	//! Add 8 octree node children to this octree node
+	/*! Only the children removed by removeEmptyChildren() are added to a node which has children*/
 	void addChildren();
 
 	//! Add 3d view instance in this octree node branch
 	void addInstance(GLC_3DViewInstance*, int);
 
+	//! Insert the 3d view instance with the given bounding box in this octree node branch
+	/*! Unlike addInstance(), only the needed children are created*/
+	void insertInstance(GLC_3DViewInstance*, const GLC_BoundingBox&, int);
+
+	//! Remove the 3d view instance with the given bounding box from this octree node branch
+	/*! The bounding box is the one of the instance when it was added, emptied children are removed*/
+	void removeInstance(GLC_3DViewInstance*, const GLC_BoundingBox&);
+
 	//! Update 3d view instances visibility of this octree node branch from the given frustum
 	/*! Viewable 3d view instance are inserted the the given set if exist also the set is created*/
 	void updateViewableInstances(const GLC_Frustum&, QSet<GLC_3DViewInstance*>* pInstanceSet= NULL);
@@ -129,6 +141,9 @@ public:
 // Private services function
 //////////////////////////////////////////////////////////////////////
 private:
+	//! Add a child with the given bounding box if this node hasn't already it
+	void addChild(const GLC_BoundingBox&);
+
 	//! Unable the node and sub node view flag
 	void unableViewFlag(QSet<GLC_3DViewInstance*>*);
 
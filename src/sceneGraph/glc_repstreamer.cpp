@@ -0,0 +1,377 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_repstreamer.cpp Implementation for the GLC_RepStreamer class.
+
+#include "glc_repstreamer.h"
+#include "glc_structoccurence.h"
+#include "glc_structreference.h"
+#include "../geometry/glc_3drep.h"
+#include "../viewport/glc_frustum.h"
+#include "../viewport/glc_viewport.h"
+#include "../glc_factory.h"
+#include "../glc_exception.h"
+#include "../glc_errorlog.h"
+
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+
+// The default memory budget of the loaded representations : 512 MB
+static const qint64 defaultMemoryBudget= Q_INT64_C(512) * 1024 * 1024;
+
+// The default minimum screen size in pixels of a loaded representation
+static const double defaultMinimumScreenSize= 2.0;
+
+// The priority of a representation which bounding box is unknown
+static const double unknownBoxPriority= 1.0e30;
+
+// Runnable which loads a representation from its file
+class GLC_RepStreamer::LoadTask : public QRunnable
+{
+public:
+	inline LoadTask(GLC_RepStreamer* pStreamer, GLC_StructReference* pReference, const QString& fileName)
+	: QRunnable()
+	, m_pStreamer(pStreamer)
+	, m_pReference(pReference)
+	, m_FileName(fileName)
+	{}
+
+	//! Load the representation and add it to the results of the streamer
+	/*! A result is always added, an empty representation if the loading has failed*/
+	virtual void run()
+	{
+		GLC_3DRep* pLoadedRep= new GLC_3DRep();
+		try
+		{
+			GLC_3DRep rep= GLC_Factory::instance()->create3DRepFromFile(m_FileName);
+			pLoadedRep->take(&rep);
+		}
+		catch (GLC_Exception& e)
+		{
+			delete pLoadedRep;
+			pLoadedRep= new GLC_3DRep();
+			QStringList errorList("GLC_RepStreamer::LoadTask");
+			errorList.append(QString(e.what()));
+			GLC_ErrorLog::addError(errorList);
+		}
+		catch (...)
+		{
+			delete pLoadedRep;
+			pLoadedRep= new GLC_3DRep();
+			QStringList errorList("GLC_RepStreamer::LoadTask");
+			errorList.append(QString("Unexpected error while loading ") + m_FileName);
+			GLC_ErrorLog::addError(errorList);
+		}
+		m_pStreamer->addLoadResult(m_pReference, pLoadedRep);
+	}
+
+private:
+	//! The streamer of the request
+	GLC_RepStreamer* m_pStreamer;
+	//! The reference to load
+	GLC_StructReference* m_pReference;
+	//! The file of the representation
+	QString m_FileName;
+};
+
+// Return true if the priority of the first reference state is lower
+static bool hasLowerPriority(const QPair<double, GLC_StructReference*>& state1, const QPair<double, GLC_StructReference*>& state2)
+{
+	return state1.first < state2.first;
+}
+
+GLC_RepStreamer::GLC_RepStreamer()
+: m_World()
+, m_StateHash()
+, m_MemoryBudget(defaultMemoryBudget)
+, m_LoadedMemory(0)
+, m_MaximumPendingLoadCount(qMax(1, QThread::idealThreadCount()))
+, m_MinimumScreenSize(defaultMinimumScreenSize)
+, m_PendingLoadCount(0)
+, m_LoadResults()
+, m_Mutex()
+, m_LoadedCondition()
+{
+	// The factory is used by the load requests, it must not be created by a worker thread
+	GLC_Factory::instance();
+}
+
+GLC_RepStreamer::~GLC_RepStreamer()
+{
+	discardLoadRequests();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+int GLC_RepStreamer::pendingLoadCount() const
+{
+	QMutexLocker locker(&m_Mutex);
+	return m_PendingLoadCount;
+}
+
+bool GLC_RepStreamer::isStreaming() const
+{
+	QMutexLocker locker(&m_Mutex);
+	return (0 != m_PendingLoadCount) || !m_LoadResults.isEmpty();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_RepStreamer::setWorld(const GLC_World& world)
+{
+	discardLoadRequests();
+	m_World= world;
+	m_StateHash.clear();
+	m_LoadedMemory= 0;
+
+	// The references which have a 3D representation with a file name are streamed
+	const QList<GLC_StructOccurence*> occurences(m_World.listOfOccurence());
+	const int occurenceCount= occurences.size();
+	for (int i= 0; i < occurenceCount; ++i)
+	{
+		GLC_StructOccurence* pOccurence= occurences.at(i);
+		if (!pOccurence->hasRepresentation()) continue;
+		GLC_StructReference* pReference= pOccurence->structReference();
+		GLC_3DRep* pRep= dynamic_cast<GLC_3DRep*>(pReference->representationHandle());
+		if ((NULL == pRep) || pRep->fileName().isEmpty()) continue;
+
+		QHash<GLC_StructReference*, ReferenceState>::iterator iState= m_StateHash.find(pReference);
+		if (m_StateHash.end() == iState)
+		{
+			ReferenceState state;
+			state.m_Memory= 0;
+			state.m_IsLoading= false;
+			state.m_HasFailed= false;
+			state.m_Priority= 0.0;
+			if (pRep->isLoaded())
+			{
+				state.m_BoundingBox= pRep->boundingBox();
+				state.m_Memory= representationMemory(*pRep);
+				m_LoadedMemory+= state.m_Memory;
+			}
+			iState= m_StateHash.insert(pReference, state);
+		}
+		iState.value().m_Occurences.append(pOccurence);
+	}
+}
+
+void GLC_RepStreamer::update(const GLC_Viewport& viewport)
+{
+	publishLoadResults();
+	m_World.updateAbsoluteMatrices();
+	computePriorities(viewport);
+
+	// Sort the loaded and the unloaded references by priority
+	QList<QPair<double, GLC_StructReference*> > loadedReferences;
+	QList<QPair<double, GLC_StructReference*> > candidates;
+	QHash<GLC_StructReference*, ReferenceState>::const_iterator iState= m_StateHash.constBegin();
+	while (m_StateHash.constEnd() != iState)
+	{
+		const ReferenceState& state= iState.value();
+		if (iState.key()->representationIsLoaded())
+		{
+			loadedReferences.append(qMakePair(state.m_Priority, iState.key()));
+		}
+		else if (!state.m_IsLoading && !state.m_HasFailed && (state.m_Priority > 0.0))
+		{
+			candidates.append(qMakePair(-state.m_Priority, iState.key()));
+		}
+		++iState;
+	}
+	std::sort(loadedReferences.begin(), loadedReferences.end(), hasLowerPriority);
+	std::sort(candidates.begin(), candidates.end(), hasLowerPriority);
+
+	// Unload the lowest priorities over the budget
+	int unloadIndex= 0;
+	while ((m_LoadedMemory > m_MemoryBudget) && (unloadIndex < loadedReferences.size()))
+	{
+		unload(loadedReferences.at(unloadIndex++).second);
+	}
+
+	// The memory of a representation never loaded is estimated with the average loaded memory
+	const int loadedCount= loadedReferences.size() - unloadIndex;
+	const qint64 averageMemory= (0 != loadedCount) ? (m_LoadedMemory / loadedCount) : 0;
+
+	// Request the loads of the highest priorities, a load can unload lower priorities
+	int pendingCount= pendingLoadCount();
+	const int candidateCount= candidates.size();
+	for (int i= 0; (i < candidateCount) && (pendingCount < m_MaximumPendingLoadCount); ++i)
+	{
+		const double priority= -candidates.at(i).first;
+		GLC_StructReference* pReference= candidates.at(i).second;
+		ReferenceState& state= m_StateHash[pReference];
+		const qint64 memory= (0 != state.m_Memory) ? state.m_Memory : averageMemory;
+		while (((m_LoadedMemory + memory) > m_MemoryBudget) && (unloadIndex < loadedReferences.size())
+				&& (loadedReferences.at(unloadIndex).first < priority))
+		{
+			unload(loadedReferences.at(unloadIndex++).second);
+		}
+		if ((m_LoadedMemory + memory) > m_MemoryBudget) break;
+
+		GLC_3DRep* pRep= dynamic_cast<GLC_3DRep*>(pReference->representationHandle());
+		state.m_IsLoading= true;
+		{
+			QMutexLocker locker(&m_Mutex);
+			++m_PendingLoadCount;
+		}
+		++pendingCount;
+		threadPool()->start(new LoadTask(this, pReference, pRep->fileName()));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+
+QThreadPool* GLC_RepStreamer::threadPool()
+{
+	static QThreadPool streamingThreadPool;
+	return &streamingThreadPool;
+}
+
+qint64 GLC_RepStreamer::representationMemory(const GLC_3DRep& rep)
+{
+	// Position, normal and texture coordinates of each vertex and the indexes of each triangle
+	const qint64 vertexMemory= static_cast<qint64>(rep.vertexCount()) * 8 * sizeof(GLfloat);
+	const qint64 indexMemory= static_cast<qint64>(rep.faceCount()) * 3 * sizeof(GLuint);
+	return vertexMemory + indexMemory;
+}
+
+void GLC_RepStreamer::addLoadResult(GLC_StructReference* pReference, GLC_3DRep* pLoadedRep)
+{
+	QMutexLocker locker(&m_Mutex);
+	m_LoadResults.append(qMakePair(pReference, pLoadedRep));
+	--m_PendingLoadCount;
+	m_LoadedCondition.wakeAll();
+}
+
+void GLC_RepStreamer::discardLoadRequests()
+{
+	QMutexLocker locker(&m_Mutex);
+	while (0 != m_PendingLoadCount)
+	{
+		m_LoadedCondition.wait(&m_Mutex);
+	}
+	const int size= m_LoadResults.size();
+	for (int i= 0; i < size; ++i)
+	{
+		delete m_LoadResults.at(i).second;
+	}
+	m_LoadResults.clear();
+}
+
+void GLC_RepStreamer::publishLoadResults()
+{
+	QList<LoadResult> loadResults;
+	{
+		QMutexLocker locker(&m_Mutex);
+		loadResults.swap(m_LoadResults);
+	}
+
+	const int size= loadResults.size();
+	for (int i= 0; i < size; ++i)
+	{
+		GLC_StructReference* pReference= loadResults.at(i).first;
+		GLC_3DRep* pLoadedRep= loadResults.at(i).second;
+		ReferenceState& state= m_StateHash[pReference];
+		state.m_IsLoading= false;
+		if (pReference->takeLoadedRepresentation(pLoadedRep))
+		{
+			GLC_3DRep* pRep= dynamic_cast<GLC_3DRep*>(pReference->representationHandle());
+			state.m_BoundingBox= pRep->boundingBox();
+			state.m_Memory= representationMemory(*pRep);
+			m_LoadedMemory+= state.m_Memory;
+		}
+		else
+		{
+			// An empty representation is the result of a failed loading
+			state.m_HasFailed= pLoadedRep->isEmpty();
+		}
+		delete pLoadedRep;
+	}
+}
+
+void GLC_RepStreamer::computePriorities(const GLC_Viewport& viewport)
+{
+	GLC_Frustum frustum;
+	frustum.update(viewport.compositionMatrix());
+
+	QHash<GLC_StructReference*, ReferenceState>::iterator iState= m_StateHash.begin();
+	while (m_StateHash.end() != iState)
+	{
+		ReferenceState& state= iState.value();
+		state.m_Priority= 0.0;
+		const int occurenceCount= state.m_Occurences.size();
+		for (int i= 0; i < occurenceCount; ++i)
+		{
+			GLC_StructOccurence* pOccurence= state.m_Occurences.at(i);
+			if (!pOccurence->isVisible()) continue;
+			if (state.m_BoundingBox.isEmpty())
+			{
+				state.m_Priority= unknownBoxPriority;
+				break;
+			}
+
+			GLC_BoundingBox box(state.m_BoundingBox);
+			box.transform(pOccurence->absoluteMatrix());
+			if (frustum.localizeBoundingBox(box) != GLC_Frustum::OutFrustum)
+			{
+				const double size= screenSize(box, viewport);
+				if (size >= m_MinimumScreenSize) state.m_Priority= qMax(state.m_Priority, size);
+			}
+		}
+		++iState;
+	}
+}
+
+double GLC_RepStreamer::screenSize(const GLC_BoundingBox& box, const GLC_Viewport& viewport) const
+{
+	const double radius= box.boundingSphereRadius();
+	double distance;
+	if (viewport.useOrtho())
+	{
+		distance= viewport.cameraHandle()->distEyeTarget();
+	}
+	else
+	{
+		distance= (box.center() - viewport.cameraHandle()->eye()).length() - radius;
+		if (distance <= 0.0) return unknownBoxPriority;
+	}
+	return (radius * static_cast<double>(viewport.viewVSize())) / (distance * viewport.viewTangent());
+}
+
+void GLC_RepStreamer::unload(GLC_StructReference* pReference)
+{
+	ReferenceState& state= m_StateHash[pReference];
+	if (pReference->unloadRepresentation())
+	{
+		m_LoadedMemory-= state.m_Memory;
+	}
+}
@@ -0,0 +1,224 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_repstreamer.h Interface for the GLC_RepStreamer class.
+
+#ifndef GLC_REPSTREAMER_H_
+#define GLC_REPSTREAMER_H_
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QWaitCondition>
+
+#include "glc_world.h"
+#include "../glc_boundingbox.h"
+
+#include "../glc_config.h"
+
+class GLC_3DRep;
+class GLC_StructOccurence;
+class GLC_StructReference;
+class GLC_Viewport;
+class QThreadPool;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_RepStreamer
+/*! \brief GLC_RepStreamer : Load and unload the representations of a world by priority*/
+
+/*! The streamer manages the references of a world which have a 3D representation
+ *  with a file name, typically a world loaded with structure only. Each update
+ *  gives a priority to these references from the screen size of the bounding boxes
+ *  of their occurences in the view frustum. Unknown bounding boxes have the highest
+ *  priority, a bounding box is known once the representation has been loaded.
+ *
+ *  The representations of the highest priorities are loaded on a thread pool and
+ *  the finished ones are published in the world collection by the next update, which
+ *  must be called between frames in the thread of the OpenGL context. The
+ *  representations of the lowest priorities are unloaded to keep the estimated
+ *  memory of the loaded representations under the memory budget.
+ *
+ *  setWorld() must be called again if the structure of the world is changed.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_RepStreamer
+{
+	//! Runnable which loads a representation from its file
+	class LoadTask;
+
+	//! The streaming state of a reference
+	struct ReferenceState
+	{
+		//! The occurences of the reference
+		QList<GLC_StructOccurence*> m_Occurences;
+		//! The bounding box of the representation, empty until it has been loaded
+		GLC_BoundingBox m_BoundingBox;
+		//! The estimated memory of the loaded representation
+		qint64 m_Memory;
+		//! True if a load request is pending
+		bool m_IsLoading;
+		//! True if the loading has failed
+		bool m_HasFailed;
+		//! The priority of the last update
+		double m_Priority;
+	};
+
+	//! A finished load request
+	typedef QPair<GLC_StructReference*, GLC_3DRep*> LoadResult;
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Construct a streamer without world
+	GLC_RepStreamer();
+
+	//! Destructor, wait for the pending load requests
+	~GLC_RepStreamer();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return the streamed world
+	inline GLC_World world() const
+	{return m_World;}
+
+	//! Return the memory budget of the loaded representations in bytes
+	inline qint64 memoryBudget() const
+	{return m_MemoryBudget;}
+
+	//! Return the estimated memory of the loaded representations in bytes
+	inline qint64 loadedMemory() const
+	{return m_LoadedMemory;}
+
+	//! Return the maximum number of pending load requests
+	inline int maximumPendingLoadCount() const
+	{return m_MaximumPendingLoadCount;}
+
+	//! Return the minimum screen size in pixels of a loaded representation
+	inline double minimumScreenSize() const
+	{return m_MinimumScreenSize;}
+
+	//! Return the number of pending load requests
+	int pendingLoadCount() const;
+
+	//! Return true if load requests are pending or finished but not published
+	bool isStreaming() const;
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Set the streamed world, pending load requests are discarded
+	void setWorld(const GLC_World& world);
+
+	//! Set the memory budget of the loaded representations in bytes
+	inline void setMemoryBudget(qint64 budget)
+	{m_MemoryBudget= qMax(Q_INT64_C(0), budget);}
+
+	//! Set the maximum number of pending load requests
+	inline void setMaximumPendingLoadCount(int count)
+	{m_MaximumPendingLoadCount= qMax(1, count);}
+
+	//! Set the minimum screen size in pixels of a loaded representation
+	inline void setMinimumScreenSize(double size)
+	{m_MinimumScreenSize= qMax(0.0, size);}
+
+	//! Publish the loaded representations and request loads and unloads for the given viewport
+	/*! Must be called between frames in the thread of the OpenGL context*/
+	void update(const GLC_Viewport& viewport);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Return the thread pool of the load requests
+	static QThreadPool* threadPool();
+
+	//! Return the estimated memory of the given representation
+	static qint64 representationMemory(const GLC_3DRep& rep);
+
+	//! Add the result of a load request
+	void addLoadResult(GLC_StructReference* pReference, GLC_3DRep* pLoadedRep);
+
+	//! Wait for the pending load requests and delete their results
+	void discardLoadRequests();
+
+	//! Publish the finished load requests in the world collection
+	void publishLoadResults();
+
+	//! Compute the priority of each reference for the given viewport
+	void computePriorities(const GLC_Viewport& viewport);
+
+	//! Return the screen size in pixels of the given bounding box
+	double screenSize(const GLC_BoundingBox& box, const GLC_Viewport& viewport) const;
+
+	//! Unload the representation of the given reference
+	void unload(GLC_StructReference* pReference);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	Q_DISABLE_COPY(GLC_RepStreamer)
+
+	//! The streamed world
+	GLC_World m_World;
+
+	//! The state of each streamed reference
+	QHash<GLC_StructReference*, ReferenceState> m_StateHash;
+
+	//! The memory budget of the loaded representations
+	qint64 m_MemoryBudget;
+
+	//! The estimated memory of the loaded representations
+	qint64 m_LoadedMemory;
+
+	//! The maximum number of pending load requests
+	int m_MaximumPendingLoadCount;
+
+	//! The minimum screen size in pixels of a loaded representation
+	double m_MinimumScreenSize;
+
+	//! The number of pending load requests
+	int m_PendingLoadCount;
+
+	//! The finished load requests
+	QList<LoadResult> m_LoadResults;
+
+	//! The mutex of the pending load count and of the load results
+	mutable QMutex m_Mutex;
+
+	//! The condition signaled when a load request is finished
+	QWaitCondition m_LoadedCondition;
+};
+
+#endif /* GLC_REPSTREAMER_H_ */
@@ -44,3 +44,22 @@ GLC_SpacePartitioning::~GLC_SpacePartitioning()
 {
 
 }
+
+void GLC_SpacePartitioning::insertInstance(GLC_3DViewInstance* pInstance)
+{
+	// The instance is viewable until the next update of viewable instances
+	pInstance->setViewable(GLC_3DViewInstance::FullViewable);
+	clear();
+}
+
+void GLC_SpacePartitioning::removeInstance(GLC_3DViewInstance*)
+{
+	clear();
+}
+
+void GLC_SpacePartitioning::updateInstance(GLC_3DViewInstance* pInstance)
+{
+	// The instance is viewable until the next update of viewable instances
+	pInstance->setViewable(GLC_3DViewInstance::FullViewable);
+	clear();
+}
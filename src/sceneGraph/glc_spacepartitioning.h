@@ -64,6 +64,9 @@ public:
 	//! Return the list off instances inside or intersect the given bounding box
 	virtual QList<GLC_3DViewInstance*> listOfIntersectedInstances(const GLC_BoundingBox&)= 0;
 
+	//! Return the list off instances whose bounding box is intersected by the given ray
+	virtual QList<GLC_3DViewInstance*> listOfIntersectedInstances(const GLC_Line3d& ray)= 0;
+
 
 //@}
 //////////////////////////////////////////////////////////////////////
@@ -81,6 +84,18 @@ public:
 	//! Clear the space partionning
 	virtual void clear()= 0;
 
+	//! Insert the given instance of the collection in the space partitioning
+	/*! The default implementation clears the space partitioning which is updated when needed*/
+	virtual void insertInstance(GLC_3DViewInstance*);
+
+	//! Remove the given instance of the collection from the space partitioning
+	/*! The default implementation clears the space partitioning which is updated when needed*/
+	virtual void removeInstance(GLC_3DViewInstance*);
+
+	//! Update the space partitioning after a move of the given instance
+	/*! The default implementation clears the space partitioning which is updated when needed*/
+	virtual void updateInstance(GLC_3DViewInstance*);
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
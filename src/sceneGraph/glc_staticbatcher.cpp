@@ -0,0 +1,450 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_staticbatcher.cpp Implementation for the GLC_StaticBatcher class.
+
+#include "glc_staticbatcher.h"
+#include "glc_3dviewinstance.h"
+#include "../geometry/glc_mesh.h"
+#include "../shading/glc_material.h"
+#include "../glc_state.h"
+#include "../glc_renderstatistics.h"
+#include "../glc_ext.h"
+
+#include <cmath>
+
+// The number of spatial cells along each axis of the batched instances bounding box
+static const int cellsPerAxis= 8;
+
+// The maximum number of vertices of a batch indexed with 16 bits
+static const int maximumBatchVertexCount= 0x10000;
+
+// The number of floats of an interleaved vertex
+static const int vertexStride= 6;
+
+GLC_StaticBatcher::GLC_StaticBatcher()
+: m_Batches()
+, m_OpenBatchHash()
+, m_Instances()
+, m_InstanceIndexHash()
+, m_MaximumTriangleCount(1000)
+{
+
+}
+
+GLC_StaticBatcher::~GLC_StaticBatcher()
+{
+	clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+bool GLC_StaticBatcher::isBatchable(GLC_3DViewInstance* pInstance) const
+{
+	if (pInstance->isEmpty() || pInstance->isSelected() || (pInstance->polygonMode() != GL_FILL)) return false;
+	if (pInstance->renderPropertiesHandle()->renderingMode() != glc::NormalRenderMode) return false;
+
+	const int bodyCount= pInstance->numberOfBody();
+	for (int i= 0; i < bodyCount; ++i)
+	{
+		GLC_Mesh* pMesh= dynamic_cast<GLC_Mesh*>(pInstance->geomAt(i));
+		if ((NULL == pMesh) || pMesh->typeIsWire() || !pMesh->wireDataIsEmpty() || pMesh->usedColorPerVertex()) return false;
+		if ((0 == pMesh->lodCount()) || (0 == pMesh->materialCount())) return false;
+		if ((pMesh->faceCount(0) > static_cast<unsigned int>(m_MaximumTriangleCount)) || (pMesh->VertexCount() > static_cast<unsigned int>(maximumBatchVertexCount))) return false;
+
+		QSet<GLC_Material*> materials(pMesh->materialSet());
+		QSet<GLC_Material*>::const_iterator iMaterial= materials.constBegin();
+		while (materials.constEnd() != iMaterial)
+		{
+			if ((*iMaterial)->hasTexture() || (*iMaterial)->isTransparent()) return false;
+			++iMaterial;
+		}
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+int GLC_StaticBatcher::build(const QList<GLC_3DViewInstance*>& instances)
+{
+	clear();
+
+	QList<GLC_3DViewInstance*> batchableInstances;
+	GLC_BoundingBox boundingBox;
+	const int size= instances.size();
+	for (int i= 0; i < size; ++i)
+	{
+		GLC_3DViewInstance* pInstance= instances.at(i);
+		if (isBatchable(pInstance))
+		{
+			batchableInstances.append(pInstance);
+			boundingBox.combine(pInstance->boundingBox());
+		}
+	}
+	if (batchableInstances.isEmpty()) return 0;
+
+	// The spatial cells are cubes which divide the largest side of the bounding box
+	const GLC_Point3d lowerCorner(boundingBox.lowerCorner());
+	double cellSize= qMax(boundingBox.xLength(), qMax(boundingBox.yLength(), boundingBox.zLength())) / static_cast<double>(cellsPerAxis);
+	if (cellSize <= 0.0) cellSize= 1.0;
+
+	const int batchableCount= batchableInstances.size();
+	m_Instances.reserve(batchableCount);
+	for (int i= 0; i < batchableCount; ++i)
+	{
+		GLC_3DViewInstance* pInstance= batchableInstances.at(i);
+		const GLC_Point3d center(pInstance->boundingBox().center());
+		int cell[3];
+		for (int axis= 0; axis < 3; ++axis)
+		{
+			const int coordinate= static_cast<int>(std::floor((center.data()[axis] - lowerCorner.data()[axis]) / cellSize));
+			cell[axis]= qBound(0, coordinate, cellsPerAxis - 1);
+		}
+		const int cellIndex= cell[0] + cellsPerAxis * (cell[1] + cellsPerAxis * cell[2]);
+
+		BatchedInstance batchedInstance;
+		batchedInstance.m_pInstance= pInstance;
+		batchedInstance.m_Matrix= pInstance->matrix();
+		const int instanceIndex= m_Instances.size();
+		m_Instances.append(batchedInstance);
+		m_InstanceIndexHash.insert(pInstance, instanceIndex);
+
+		const int bodyCount= pInstance->numberOfBody();
+		for (int body= 0; body < bodyCount; ++body)
+		{
+			appendMesh(dynamic_cast<GLC_Mesh*>(pInstance->geomAt(body)), instanceIndex, body, cellIndex);
+		}
+		pInstance->setBatched(true);
+	}
+	m_OpenBatchHash.clear();
+
+	return m_InstanceIndexHash.size();
+}
+
+void GLC_StaticBatcher::removeInstance(GLC_3DViewInstance* pInstance)
+{
+	QHash<GLC_3DViewInstance*, int>::iterator iInstance= m_InstanceIndexHash.find(pInstance);
+	if (m_InstanceIndexHash.end() != iInstance)
+	{
+		m_Instances[iInstance.value()].m_pInstance= NULL;
+		m_InstanceIndexHash.erase(iInstance);
+		pInstance->setBatched(false);
+	}
+}
+
+void GLC_StaticBatcher::clear()
+{
+	QHash<GLC_3DViewInstance*, int>::iterator iInstance= m_InstanceIndexHash.begin();
+	while (m_InstanceIndexHash.constEnd() != iInstance)
+	{
+		iInstance.key()->setBatched(false);
+		++iInstance;
+	}
+	m_InstanceIndexHash.clear();
+	m_Instances.clear();
+	m_OpenBatchHash.clear();
+
+	const int size= m_Batches.size();
+	for (int i= 0; i < size; ++i)
+	{
+		delete m_Batches.at(i);
+	}
+	m_Batches.clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+// OpenGL Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_StaticBatcher::glDraw(bool showState)
+{
+	if (m_Batches.isEmpty()) return;
+	removeChangedInstances();
+	if (m_InstanceIndexHash.isEmpty()) return;
+
+	const bool selectionMode= GLC_State::isInSelectionMode();
+	const bool vboIsUsed= GLC_State::vboUsed() && GLC_State::vboSupported();
+
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	if (!selectionMode)
+	{
+		glEnableClientState(GL_NORMAL_ARRAY);
+	}
+
+	const int batchCount= m_Batches.size();
+	for (int i= 0; i < batchCount; ++i)
+	{
+		Batch* pBatch= m_Batches.at(i);
+		const int rangeCount= pBatch->m_Ranges.size();
+
+		if (vboIsUsed)
+		{
+			if (!pBatch->m_VertexBuffer.isCreated())
+			{
+				pBatch->m_VertexBuffer.create();
+				pBatch->m_VertexBuffer.bind();
+				pBatch->m_VertexBuffer.allocate(pBatch->m_Vertices.constData(), pBatch->m_Vertices.size() * sizeof(GLfloat));
+				pBatch->m_IndexBuffer.create();
+				pBatch->m_IndexBuffer.bind();
+				pBatch->m_IndexBuffer.allocate(pBatch->m_Indexes.constData(), pBatch->m_Indexes.size() * sizeof(GLushort));
+			}
+			else
+			{
+				pBatch->m_VertexBuffer.bind();
+				pBatch->m_IndexBuffer.bind();
+			}
+			glVertexPointer(3, GL_FLOAT, vertexStride * sizeof(GLfloat), BUFFER_OFFSET(0));
+			if (!selectionMode) glNormalPointer(GL_FLOAT, vertexStride * sizeof(GLfloat), BUFFER_OFFSET(3 * sizeof(GLfloat)));
+		}
+		else
+		{
+			glVertexPointer(3, GL_FLOAT, vertexStride * sizeof(GLfloat), pBatch->m_Vertices.constData());
+			if (!selectionMode) glNormalPointer(GL_FLOAT, vertexStride * sizeof(GLfloat), pBatch->m_Vertices.constData() + 3);
+		}
+
+		if (selectionMode)
+		{
+			// One range by instance with the instance color id
+			int rangeIndex= 0;
+			while (rangeIndex < rangeCount)
+			{
+				const Range& range= pBatch->m_Ranges.at(rangeIndex);
+				const int instanceIndex= range.m_InstanceIndex;
+				int offset= range.m_Offset;
+				int count= 0;
+				if (isViewable(range, showState)) count= range.m_Count;
+				++rangeIndex;
+				while ((rangeIndex < rangeCount) && (pBatch->m_Ranges.at(rangeIndex).m_InstanceIndex == instanceIndex))
+				{
+					const Range& nextRange= pBatch->m_Ranges.at(rangeIndex);
+					if (isViewable(nextRange, showState))
+					{
+						if ((0 != count) && ((offset + count) != nextRange.m_Offset))
+						{
+							drawRange(pBatch, offset, count, vboIsUsed);
+							count= 0;
+						}
+						if (0 == count) offset= nextRange.m_Offset;
+						count+= nextRange.m_Count;
+					}
+					++rangeIndex;
+				}
+				if (0 != count)
+				{
+					GLubyte colorId[4];
+					glc::encodeRgbId(m_Instances.at(instanceIndex).m_pInstance->id(), colorId);
+					glColor3ubv(colorId);
+					drawRange(pBatch, offset, count, vboIsUsed);
+				}
+			}
+		}
+		else
+		{
+			// Contiguous viewable ranges are drawn with one call
+			bool materialIsExecuted= false;
+			int offset= 0;
+			int count= 0;
+			for (int rangeIndex= 0; rangeIndex < rangeCount; ++rangeIndex)
+			{
+				const Range& range= pBatch->m_Ranges.at(rangeIndex);
+				if (isViewable(range, showState))
+				{
+					// The material is only used by the viewable ranges which hold it
+					if (!materialIsExecuted)
+					{
+						pBatch->m_pMaterial->glExecute();
+						materialIsExecuted= true;
+					}
+					GLC_RenderStatistics::addBodies(1);
+					if ((0 != count) && ((offset + count) != range.m_Offset))
+					{
+						drawRange(pBatch, offset, count, vboIsUsed);
+						count= 0;
+					}
+					if (0 == count) offset= range.m_Offset;
+					count+= range.m_Count;
+				}
+			}
+			if (0 != count)
+			{
+				drawRange(pBatch, offset, count, vboIsUsed);
+			}
+		}
+	}
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_NORMAL_ARRAY);
+	if (vboIsUsed)
+	{
+		QGLBuffer::release(QGLBuffer::IndexBuffer);
+		QGLBuffer::release(QGLBuffer::VertexBuffer);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_StaticBatcher::appendMesh(GLC_Mesh* pMesh, int instanceIndex, int bodyIndex, int cellIndex)
+{
+	GLuintVector triangles;
+	QVector<GLC_uint> primitiveIds;
+	QVector<GLC_uint> materialIds;
+	pMesh->lodTriangles(0, &triangles, &primitiveIds, &materialIds);
+	const int triangleCount= materialIds.size();
+	if (0 == triangleCount) return;
+
+	const GLfloatVector positions(pMesh->positionVector());
+	const GLfloatVector normals(pMesh->normalVector());
+	const GLC_Matrix4x4& matrix= m_Instances.at(instanceIndex).m_Matrix;
+	const double* pMatrix= matrix.getData();
+	// The orientation of triangles is kept by indirect matrices
+	const bool isIndirect= (matrix.type() == GLC_Matrix4x4::Indirect);
+
+	QVector<int> batchIndex(positions.size() / 3, -1);
+	QList<GLC_uint> doneMaterialIds;
+	for (int first= 0; first < triangleCount; ++first)
+	{
+		const GLC_uint materialId= materialIds.at(first);
+		if (doneMaterialIds.contains(materialId)) continue;
+		doneMaterialIds.append(materialId);
+
+		// Count the vertices of the triangles of the material
+		batchIndex.fill(-1);
+		int vertexCount= 0;
+		for (int i= first; i < triangleCount; ++i)
+		{
+			if (materialIds.at(i) != materialId) continue;
+			for (int k= 0; k < 3; ++k)
+			{
+				const GLuint index= triangles.at(3 * i + k);
+				if (-1 == batchIndex.at(index))
+				{
+					batchIndex[index]= 0;
+					++vertexCount;
+				}
+			}
+		}
+
+		Batch* pBatch= batch(pMesh->material(materialId), cellIndex, vertexCount);
+		batchIndex.fill(-1);
+		Range range;
+		range.m_InstanceIndex= instanceIndex;
+		range.m_BodyIndex= bodyIndex;
+		range.m_Offset= pBatch->m_Indexes.size();
+		range.m_Count= 0;
+		for (int i= first; i < triangleCount; ++i)
+		{
+			if (materialIds.at(i) != materialId) continue;
+			GLushort triangle[3];
+			for (int k= 0; k < 3; ++k)
+			{
+				const GLuint index= triangles.at(3 * i + k);
+				if (-1 == batchIndex.at(index))
+				{
+					batchIndex[index]= pBatch->m_Vertices.size() / vertexStride;
+					const float* pPosition= positions.constData() + 3 * index;
+					const float* pNormal= normals.constData() + 3 * index;
+					GLfloat vertex[vertexStride];
+					for (int axis= 0; axis < 3; ++axis)
+					{
+						vertex[axis]= static_cast<GLfloat>(pMatrix[axis] * pPosition[0] + pMatrix[4 + axis] * pPosition[1]
+								+ pMatrix[8 + axis] * pPosition[2] + pMatrix[12 + axis]);
+						vertex[3 + axis]= static_cast<GLfloat>(pMatrix[axis] * pNormal[0] + pMatrix[4 + axis] * pNormal[1]
+								+ pMatrix[8 + axis] * pNormal[2]);
+					}
+					const float length= std::sqrt(vertex[3] * vertex[3] + vertex[4] * vertex[4] + vertex[5] * vertex[5]);
+					if (length > 0.0f)
+					{
+						for (int axis= 3; axis < vertexStride; ++axis) vertex[axis]/= length;
+					}
+					for (int j= 0; j < vertexStride; ++j) pBatch->m_Vertices.append(vertex[j]);
+				}
+				triangle[k]= static_cast<GLushort>(batchIndex.at(index));
+			}
+			if (isIndirect) qSwap(triangle[1], triangle[2]);
+			pBatch->m_Indexes << triangle[0] << triangle[1] << triangle[2];
+			range.m_Count+= 3;
+		}
+		pBatch->m_Ranges.append(range);
+	}
+}
+
+GLC_StaticBatcher::Batch* GLC_StaticBatcher::batch(GLC_Material* pMaterial, int cellIndex, int vertexCount)
+{
+	Q_ASSERT(vertexCount <= maximumBatchVertexCount);
+	const QPair<GLC_uint, int> key(pMaterial->id(), cellIndex);
+	Batch* pBatch= m_OpenBatchHash.value(key, NULL);
+	if ((NULL == pBatch) || (((pBatch->m_Vertices.size() / vertexStride) + vertexCount) > maximumBatchVertexCount))
+	{
+		// A full batch is closed and a new batch is opened
+		pBatch= new Batch;
+		pBatch->m_pMaterial= pMaterial;
+		pBatch->m_IndexBuffer= QGLBuffer(QGLBuffer::IndexBuffer);
+		m_Batches.append(pBatch);
+		m_OpenBatchHash.insert(key, pBatch);
+	}
+	return pBatch;
+}
+
+void GLC_StaticBatcher::removeChangedInstances()
+{
+	const int size= m_Instances.size();
+	for (int i= 0; i < size; ++i)
+	{
+		GLC_3DViewInstance* pInstance= m_Instances.at(i).m_pInstance;
+		if ((NULL != pInstance) && ((pInstance->matrix() != m_Instances.at(i).m_Matrix) || (pInstance->polygonMode() != GL_FILL)
+				|| (pInstance->renderPropertiesHandle()->renderingMode() != glc::NormalRenderMode)))
+		{
+			removeInstance(pInstance);
+		}
+	}
+}
+
+bool GLC_StaticBatcher::isViewable(const Range& range, bool showState) const
+{
+	GLC_3DViewInstance* pInstance= m_Instances.at(range.m_InstanceIndex).m_pInstance;
+	if ((NULL == pInstance) || (pInstance->isVisible() != showState)) return false;
+
+	const GLC_3DViewInstance::Viewable viewable= pInstance->viewableFlag();
+	if (viewable == GLC_3DViewInstance::NoViewable) return false;
+	return (viewable == GLC_3DViewInstance::FullViewable) || pInstance->isGeomViewable(range.m_BodyIndex);
+}
+
+void GLC_StaticBatcher::drawRange(const Batch* pBatch, int offset, int count, bool vboIsUsed)
+{
+	if (vboIsUsed)
+	{
+		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_SHORT, BUFFER_OFFSET(offset * sizeof(GLushort)));
+	}
+	else
+	{
+		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_SHORT, pBatch->m_Indexes.constData() + offset);
+	}
+	GLC_RenderStatistics::addDrawCalls(1);
+	GLC_RenderStatistics::addTriangles(count / 3);
+}
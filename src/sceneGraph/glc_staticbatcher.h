@@ -0,0 +1,208 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_staticbatcher.h Interface for the GLC_StaticBatcher class.
+
+#ifndef GLC_STATICBATCHER_H_
+#define GLC_STATICBATCHER_H_
+
+#include <QGLBuffer>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QVector>
+
+#include "../glc_global.h"
+#include "../maths/glc_matrix4x4.h"
+
+#include "../glc_config.h"
+
+class GLC_3DViewInstance;
+class GLC_Material;
+class GLC_Mesh;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_StaticBatcher
+/*! \brief GLC_StaticBatcher : Merge small static instances sharing a material in shared buffers*/
+
+/*! The triangles of small opaque and untextured meshes are transformed by the matrix
+ *  of their instance and merged in batches of the same material and the same spatial
+ *  cell. Each batch has its own vertex and 16 bits index buffers and the contiguous
+ *  ranges of its viewable instances are drawn with one call.
+ *  A batched instance which is moved, selected or rendered with another mode is removed
+ *  from its batches and must be rendered by the collection.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_StaticBatcher
+{
+	//! The triangles of a body of an instance in a batch
+	struct Range
+	{
+		//! The index of the batched instance
+		int m_InstanceIndex;
+		//! The body index in the instance
+		int m_BodyIndex;
+		//! The offset of the first index
+		int m_Offset;
+		//! The number of indexes
+		int m_Count;
+	};
+
+	//! A batched instance with its matrix at batch time
+	struct BatchedInstance
+	{
+		//! The instance, NULL if it has been removed from batches
+		GLC_3DViewInstance* m_pInstance;
+		//! The matrix used to transform the vertices
+		GLC_Matrix4x4 m_Matrix;
+	};
+
+	//! Triangles of the same material in the same spatial cell
+	struct Batch
+	{
+		//! The material of the batch
+		GLC_Material* m_pMaterial;
+		//! Interleaved positions and normals
+		QVector<GLfloat> m_Vertices;
+		//! Triangles index
+		QVector<GLushort> m_Indexes;
+		//! The ranges of the batched bodies
+		QVector<Range> m_Ranges;
+		//! The vertex buffer
+		QGLBuffer m_VertexBuffer;
+		//! The index buffer
+		QGLBuffer m_IndexBuffer;
+	};
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Construct an empty static batcher
+	GLC_StaticBatcher();
+
+	//! Destructor
+	~GLC_StaticBatcher();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return true if there is no batch
+	inline bool isEmpty() const
+	{return m_Batches.isEmpty();}
+
+	//! Return the number of batches
+	inline int batchCount() const
+	{return m_Batches.size();}
+
+	//! Return the number of instances currently batched
+	inline int batchedInstanceCount() const
+	{return m_InstanceIndexHash.size();}
+
+	//! Return the maximum number of triangles of a batched mesh
+	inline int maximumTriangleCount() const
+	{return m_MaximumTriangleCount;}
+
+	//! Return true if the given instance can be batched
+	bool isBatchable(GLC_3DViewInstance* pInstance) const;
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Set the maximum number of triangles of a batched mesh
+	inline void setMaximumTriangleCount(int count)
+	{m_MaximumTriangleCount= qMax(0, count);}
+
+	//! Clear the batches and build them with the batchable instances of the given list
+	/*! Return the number of batched instances. Meshes must be finished, if their data are
+	 *  stored in VBO the OpenGL context must be current*/
+	int build(const QList<GLC_3DViewInstance*>& instances);
+
+	//! Remove the given instance from the batches
+	void removeInstance(GLC_3DViewInstance* pInstance);
+
+	//! Remove all instances and delete the batches
+	void clear();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name OpenGL Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Draw the viewable batched instances with the given show state
+	/*! Instances which have been moved, or which are no longer rendered in
+	 *  normal mode, are removed from the batches before drawing*/
+	void glDraw(bool showState);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Append the triangles of the given mesh of the batched instance at the given index
+	void appendMesh(GLC_Mesh* pMesh, int instanceIndex, int bodyIndex, int cellIndex);
+
+	//! Return the batch of the given material and cell which can receive the given number of vertices
+	Batch* batch(GLC_Material* pMaterial, int cellIndex, int vertexCount);
+
+	//! Remove the moved instances and the instances which are not rendered in normal mode
+	void removeChangedInstances();
+
+	//! Return true if the given range is viewable with the given show state
+	bool isViewable(const Range& range, bool showState) const;
+
+	//! Draw the given count of indexes of the given batch from the given offset
+	void drawRange(const Batch* pBatch, int offset, int count, bool vboIsUsed);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	Q_DISABLE_COPY(GLC_StaticBatcher)
+
+	//! The batches
+	QList<Batch*> m_Batches;
+
+	//! The batch which receives triangles of each material and cell
+	QHash<QPair<GLC_uint, int>, Batch*> m_OpenBatchHash;
+
+	//! The batched instances
+	QVector<BatchedInstance> m_Instances;
+
+	//! The index of each batched instance
+	QHash<GLC_3DViewInstance*, int> m_InstanceIndexHash;
+
+	//! The maximum number of triangles of a batched mesh
+	int m_MaximumTriangleCount;
+};
+
+#endif /* GLC_STATICBATCHER_H_ */
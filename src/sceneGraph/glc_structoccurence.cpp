@@ -28,6 +28,57 @@
 #include "glc_worldhandle.h"
 #include "../glc_errorlog.h"
 
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+
+// Number of absolute matrices of a chunk, a level is computed in parallel if it has more than one chunk
+static const int matrixChunkSize= 1024;
+
+// Runnable which computes chunks of a level of absolute matrices
+class GLC_StructOccurence::MatrixRunner : public QRunnable
+{
+public:
+	inline MatrixRunner(GLC_StructOccurence* const* ppOccurences, int count, QAtomicInt* pNextChunk, QSemaphore* pDoneSemaphore)
+	: QRunnable()
+	, m_ppOccurences(ppOccurences)
+	, m_Count(count)
+	, m_pNextChunk(pNextChunk)
+	, m_pDoneSemaphore(pDoneSemaphore)
+	{}
+
+	//! Compute the next chunks until all chunks are taken
+	virtual void run()
+	{
+		const int chunkCount= (m_Count + matrixChunkSize - 1) / matrixChunkSize;
+		int chunkIndex= m_pNextChunk->fetchAndAddOrdered(1);
+		while (chunkIndex < chunkCount)
+		{
+			const int first= chunkIndex * matrixChunkSize;
+			const int last= qMin(first + matrixChunkSize, m_Count);
+			for (int i= first; i < last; ++i)
+			{
+				m_ppOccurences[i]->computeAbsoluteMatrix();
+			}
+			chunkIndex= m_pNextChunk->fetchAndAddOrdered(1);
+		}
+		if (NULL != m_pDoneSemaphore) m_pDoneSemaphore->release();
+	}
+
+private:
+	//! The occurences of the level
+	GLC_StructOccurence* const* m_ppOccurences;
+	//! The number of occurences of the level
+	int m_Count;
+	//! The index of the next chunk to compute
+	QAtomicInt* m_pNextChunk;
+	//! The semaphore released when this runner is done
+	QSemaphore* m_pDoneSemaphore;
+};
+
 GLC_StructOccurence::GLC_StructOccurence()
 : m_Uid(glc::GLC_GenID())
 , m_pWorldHandle(NULL)
@@ -41,6 +92,9 @@ GLC_StructOccurence::GLC_StructOccurence()
 , m_pRenderProperties(NULL)
 , m_AutomaticCreationOf3DViewInstance(true)
 , m_pRelativeMatrix(NULL)
+, m_AbsoluteMatrixIsDirty(false)
+, m_BoundingBox()
+, m_BoundingBoxIsValid(false)
 {
 	// Update instance
 	m_pStructInstance->structOccurenceCreated(this);
@@ -59,6 +113,9 @@ GLC_StructOccurence::GLC_StructOccurence(GLC_StructInstance* pStructInstance, GL
 , m_pRenderProperties(NULL)
 , m_AutomaticCreationOf3DViewInstance(true)
 , m_pRelativeMatrix(NULL)
+, m_AbsoluteMatrixIsDirty(false)
+, m_BoundingBox()
+, m_BoundingBoxIsValid(false)
 {
 	doCreateOccurrenceFromInstance(shaderId);
 }
@@ -76,6 +133,9 @@ GLC_StructOccurence::GLC_StructOccurence(GLC_StructInstance* pStructInstance, GL
 , m_pRenderProperties(NULL)
 , m_AutomaticCreationOf3DViewInstance(true)
 , m_pRelativeMatrix(NULL)
+, m_AbsoluteMatrixIsDirty(false)
+, m_BoundingBox()
+, m_BoundingBoxIsValid(false)
 {
 	doCreateOccurrenceFromInstance(shaderId);
 }
@@ -93,6 +153,9 @@ GLC_StructOccurence::GLC_StructOccurence(GLC_3DRep* pRep)
 , m_pRenderProperties(NULL)
 , m_AutomaticCreationOf3DViewInstance(true)
 , m_pRelativeMatrix(NULL)
+, m_AbsoluteMatrixIsDirty(false)
+, m_BoundingBox()
+, m_BoundingBoxIsValid(false)
 {
 	m_pStructInstance= new GLC_StructInstance(pRep);
 
@@ -113,6 +176,9 @@ GLC_StructOccurence::GLC_StructOccurence(GLC_3DRep* pRep, GLC_uint id)
 , m_pRenderProperties(NULL)
 , m_AutomaticCreationOf3DViewInstance(true)
 , m_pRelativeMatrix(NULL)
+, m_AbsoluteMatrixIsDirty(false)
+, m_BoundingBox()
+, m_BoundingBoxIsValid(false)
 {
 	m_pStructInstance= new GLC_StructInstance(pRep);
 
@@ -133,6 +199,9 @@ GLC_StructOccurence::GLC_StructOccurence(GLC_WorldHandle* pWorldHandle, const GL
 , m_pRenderProperties(NULL)
 , m_AutomaticCreationOf3DViewInstance(structOccurence.m_AutomaticCreationOf3DViewInstance)
 , m_pRelativeMatrix(NULL)
+, m_AbsoluteMatrixIsDirty(false)
+, m_BoundingBox()
+, m_BoundingBoxIsValid(false)
 {
 	if (shareInstance)
 	{
@@ -428,29 +497,41 @@ bool GLC_StructOccurence::isVisible() const
 	return !isHidden;
 }
 
+GLC_Matrix4x4 GLC_StructOccurence::absoluteMatrix() const
+{
+	if (NULL != m_pWorldHandle)
+	{
+		m_pWorldHandle->updateAbsoluteMatrices();
+	}
+	return m_AbsoluteMatrix;
+}
+
 GLC_BoundingBox GLC_StructOccurence::boundingBox() const
 {
 	GLC_BoundingBox boundingBox;
 
 	if (NULL != m_pWorldHandle)
 	{
+		// The bounding boxes depend on the absolute matrices
+		m_pWorldHandle->updateAbsoluteMatrices();
 		if (has3DViewInstance())
 		{
 			Q_ASSERT(m_pWorldHandle->collection()->contains(id()));
 			boundingBox= m_pWorldHandle->collection()->instanceHandle(id())->boundingBox();
 		}
+		else if (m_BoundingBoxIsValid)
+		{
+			boundingBox= m_BoundingBox;
+		}
 		else
 		{
-			if (hasChild())
+			const int size= m_Childs.size();
+			for (int i= 0; i < size; ++i)
 			{
-				QList<GLC_StructOccurence*> childrenList= children();
-				const int size= childrenList.size();
-
-				for (int i= 0; i < size; ++i)
-				{
-					boundingBox.combine(childrenList.at(i)->boundingBox());
-				}
+				boundingBox.combine(m_Childs.at(i)->boundingBox());
 			}
+			m_BoundingBox= boundingBox;
+			m_BoundingBoxIsValid= true;
 		}
 	}
 
@@ -528,42 +609,74 @@ bool GLC_StructOccurence::containsChild(const GLC_StructOccurence* pOcc) const
 
 GLC_StructOccurence* GLC_StructOccurence::updateAbsoluteMatrix()
 {
-	GLC_Matrix4x4 relativeMatrix;
-	if (NULL == m_pRelativeMatrix)
-	{
-		relativeMatrix= m_pStructInstance->relativeMatrix();
-	}
-	else
-	{
-		relativeMatrix= *m_pRelativeMatrix;
-	}
+	setAbsoluteMatrixDirty();
+	return this;
+}
 
-	if (NULL != m_pParent)
+GLC_StructOccurence* GLC_StructOccurence::updateChildrenAbsoluteMatrix()
+{
+	setAbsoluteMatrixDirty();
+	return this;
+}
+
+void GLC_StructOccurence::updateAbsoluteMatrices(const QList<GLC_StructOccurence*>& occurences)
+{
+	// The branches are updated from their highest dirty occurence
+	QVector<GLC_StructOccurence*> branches;
+	QSet<GLC_StructOccurence*> rootSet;
+	const int occurenceCount= occurences.size();
+	for (int i= 0; i < occurenceCount; ++i)
 	{
-		m_AbsoluteMatrix= m_pParent->absoluteMatrix() * relativeMatrix;
+		GLC_StructOccurence* pRoot= occurences.at(i)->highestDirtyOccurence();
+		if ((NULL != pRoot) && !rootSet.contains(pRoot))
+		{
+			rootSet.insert(pRoot);
+			branches.append(pRoot);
+			// An ancestor box may have been cached since the branch has been marked
+			if (NULL != pRoot->m_pParent) pRoot->m_pParent->invalidateBoundingBox();
+		}
 	}
-	else
+
+	// Flattened breadth first pass, the matrices of a level only depend on the previous level
+	int levelBegin= 0;
+	while (levelBegin < branches.size())
 	{
-		m_AbsoluteMatrix= relativeMatrix;
+		const int levelEnd= branches.size();
+		computeAbsoluteMatrices(branches.constData() + levelBegin, levelEnd - levelBegin);
+		for (int i= levelBegin; i < levelEnd; ++i)
+		{
+			GLC_StructOccurence* pOccurence= branches.at(i);
+			pOccurence->m_AbsoluteMatrixIsDirty= false;
+			pOccurence->m_BoundingBoxIsValid= false;
+			const int childCount= pOccurence->m_Childs.size();
+			for (int j= 0; j < childCount; ++j)
+			{
+				branches.append(pOccurence->m_Childs.at(j));
+			}
+		}
+		levelBegin= levelEnd;
 	}
-	// If the occurence have a representation, update it.
 
-	if ((NULL != m_pWorldHandle) && m_pWorldHandle->collection()->contains(m_Uid))
+	// The collection is not thread safe, the instances are updated by the calling thread
+	const int branchesSize= branches.size();
+	for (int i= 0; i < branchesSize; ++i)
 	{
-		m_pWorldHandle->collection()->instanceHandle(m_Uid)->setMatrix(m_AbsoluteMatrix);
+		GLC_StructOccurence* pOccurence= branches.at(i);
+		if ((NULL != pOccurence->m_pWorldHandle) && pOccurence->m_pWorldHandle->collection()->contains(pOccurence->m_Uid))
+		{
+			pOccurence->m_pWorldHandle->collection()->instanceHandle(pOccurence->m_Uid)->setMatrix(pOccurence->m_AbsoluteMatrix);
+		}
 	}
-	return this;
 }
 
-GLC_StructOccurence* GLC_StructOccurence::updateChildrenAbsoluteMatrix()
+void GLC_StructOccurence::invalidateBoundingBox()
 {
-	updateAbsoluteMatrix();
-	const int size= m_Childs.size();
-	for (int i= 0; i < size; ++i)
+	GLC_StructOccurence* pOccurence= this;
+	while (NULL != pOccurence)
 	{
-		m_Childs[i]->updateChildrenAbsoluteMatrix();
+		pOccurence->m_BoundingBoxIsValid= false;
+		pOccurence= pOccurence->m_pParent;
 	}
-	return this;
 }
 
 void GLC_StructOccurence::addChild(GLC_StructOccurence* pChild)
@@ -638,6 +751,7 @@ bool GLC_StructOccurence::removeChild(GLC_StructOccurence* pChild)
 	Q_ASSERT(pChild->m_pParent == this);
 	pChild->m_pParent= NULL;
 	pChild->detach();
+	invalidateBoundingBox();
 
 	return m_Childs.removeOne(pChild);
 }
@@ -661,6 +775,7 @@ bool GLC_StructOccurence::create3DViewInstance(GLuint shaderId)
 		{
 			GLC_3DViewInstance instance(*p3DRep, m_Uid);
 			instance.setName(name());
+			instance.setMatrix(absoluteMatrix());
 
 			if (NULL != m_pRenderProperties)
 			{
@@ -678,6 +793,7 @@ bool GLC_StructOccurence::create3DViewInstance(GLuint shaderId)
 			}
 		}
 	}
+	if (subject) invalidateBoundingBox();
 	return subject;
 }
 
@@ -685,6 +801,7 @@ bool GLC_StructOccurence::remove3DViewInstance()
 {
 	if (NULL != m_pWorldHandle)
 	{
+		invalidateBoundingBox();
 		return m_pWorldHandle->collection()->remove(m_Uid);
 	}
 	else return false;
@@ -702,6 +819,7 @@ void GLC_StructOccurence::setWorldHandle(GLC_WorldHandle* pWorldHandle)
 	}
 
 	m_pWorldHandle= pWorldHandle;
+	m_BoundingBoxIsValid= false;
 
 	if (NULL != m_pWorldHandle)
 	{
@@ -753,6 +871,7 @@ bool GLC_StructOccurence::unloadRepresentation()
 		{
 			if (this->has3DViewInstance())
 			{
+				invalidateBoundingBox();
 				unloadResult= m_pWorldHandle->collection()->remove(m_Uid);
 				QSet<GLC_StructOccurence*> occurenceSet= pRef->setOfStructOccurence();
 				QSet<GLC_StructOccurence*>::const_iterator iOcc= occurenceSet.constBegin();
@@ -977,3 +1096,69 @@ void GLC_StructOccurence::doCreateOccurrenceFromInstance(GLuint shaderId)
 	// Update instance
 	m_pStructInstance->structOccurenceCreated(this);
 }
+
+QThreadPool* GLC_StructOccurence::threadPool()
+{
+	static QThreadPool matrixThreadPool;
+	return &matrixThreadPool;
+}
+
+void GLC_StructOccurence::setAbsoluteMatrixDirty()
+{
+	if (!m_AbsoluteMatrixIsDirty)
+	{
+		m_AbsoluteMatrixIsDirty= true;
+		if (NULL != m_pWorldHandle)
+		{
+			m_pWorldHandle->addDirtyOccurence(this);
+		}
+		else
+		{
+			// An occurence without world is not shared, its branch is updated now
+			updateAbsoluteMatrices(QList<GLC_StructOccurence*>() << this);
+		}
+	}
+	invalidateBoundingBox();
+}
+
+GLC_StructOccurence* GLC_StructOccurence::highestDirtyOccurence() const
+{
+	GLC_StructOccurence* pDirtyOccurence= NULL;
+	GLC_StructOccurence* pOccurence= const_cast<GLC_StructOccurence*>(this);
+	while (NULL != pOccurence)
+	{
+		if (pOccurence->m_AbsoluteMatrixIsDirty) pDirtyOccurence= pOccurence;
+		pOccurence= pOccurence->m_pParent;
+	}
+	return pDirtyOccurence;
+}
+
+void GLC_StructOccurence::computeAbsoluteMatrices(GLC_StructOccurence* const* ppOccurences, int count)
+{
+	const int chunkCount= (count + matrixChunkSize - 1) / matrixChunkSize;
+	const int threadCount= qBound(1, QThread::idealThreadCount(), chunkCount);
+	QAtomicInt nextChunk(0);
+	QSemaphore doneSemaphore;
+	for (int i= 1; i < threadCount; ++i)
+	{
+		threadPool()->start(new MatrixRunner(ppOccurences, count, &nextChunk, &doneSemaphore));
+	}
+
+	// The calling thread computes chunks too
+	MatrixRunner runner(ppOccurences, count, &nextChunk, NULL);
+	runner.run();
+	doneSemaphore.acquire(threadCount - 1);
+}
+
+void GLC_StructOccurence::computeAbsoluteMatrix()
+{
+	const GLC_Matrix4x4 relativeMatrix= (NULL == m_pRelativeMatrix) ? m_pStructInstance->relativeMatrix() : *m_pRelativeMatrix;
+	if (NULL != m_pParent)
+	{
+		m_AbsoluteMatrix= m_pParent->m_AbsoluteMatrix * relativeMatrix;
+	}
+	else
+	{
+		m_AbsoluteMatrix= relativeMatrix;
+	}
+}
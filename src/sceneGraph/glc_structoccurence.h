@@ -35,13 +35,29 @@
 class GLC_WorldHandle;
 class GLC_Material;
 class GLC_RenderProperties;
+class QThreadPool;
 
 //////////////////////////////////////////////////////////////////////
 //! \class GLC_StructOccurence
 /*! \brief GLC_StructOccurence : A scene graph occurence node */
+
+/*! The absolute matrices of the occurences of a world are updated lazily : a change
+ *  of a relative matrix only marks the occurence as dirty. The branches of the dirty
+ *  occurences are updated by a breadth first pass when an absolute matrix or a bounding
+ *  box is asked, when the world collection is rendered or culled, or when
+ *  GLC_World::updateAbsoluteMatrices() is called. The update is serialized by the world
+ *  handle. The absolute matrices of an occurence without world are updated immediately.
+ *
+ *  The bounding box of an occurence without 3DViewInstance is cached until an
+ *  occurence of its branch is changed.*/
 //////////////////////////////////////////////////////////////////////
 class GLC_LIB_EXPORT GLC_StructOccurence
 {
+	//! \class MatrixRunner
+	/*! \brief MatrixRunner : Runnable which computes chunks of absolute matrices */
+	class MatrixRunner;
+	friend class MatrixRunner;
+
 //////////////////////////////////////////////////////////////////////
 /*! @name Constructor / Destructor */
 //@{
@@ -83,8 +99,15 @@ public:
 	{return m_pStructInstance->name();}
 
 	//! Return the absolute matrix of this occurence
-	inline GLC_Matrix4x4 absoluteMatrix() const
-	{ return m_AbsoluteMatrix;}
+	/*! The dirty absolute matrices of the world are updated before*/
+	GLC_Matrix4x4 absoluteMatrix() const;
+
+	//! Return true if the absolute matrix of this occurence branch has to be updated
+	inline bool absoluteMatrixIsDirty() const
+	{return m_AbsoluteMatrixIsDirty;}
+
+	//! Return the highest dirty occurence of the branch of this occurence, NULL if there is none
+	GLC_StructOccurence* highestDirtyOccurence() const;
 
 	//! Return the surcharged relative matrix
 	GLC_Matrix4x4 occurrenceRelativeMatrix() const;
@@ -163,6 +186,7 @@ public:
 	bool isVisible() const;
 
 	//! Return the occurence Bounding Box
+	/*! The dirty absolute matrices of the world are updated before*/
 	GLC_BoundingBox boundingBox() const;
 
 	//! Return the occurence number of this occurence
@@ -210,12 +234,20 @@ public:
 	//! Set Occurence instance Name
 	inline void setName(const QString name) {m_pStructInstance->setName(name);}
 
-	//! Update the absolute matrix
+	//! Mark the absolute matrix of this occurence and of its children to be updated
 	GLC_StructOccurence* updateAbsoluteMatrix();
 
-	//! Update children obsolute Matrix
+	//! Mark the absolute matrix of this occurence and of its children to be updated
 	GLC_StructOccurence* updateChildrenAbsoluteMatrix();
 
+	//! Update the absolute matrices of the dirty branches of the given occurences
+	/*! The branches are flattened in breadth first order and each level is computed in parallel*/
+	static void updateAbsoluteMatrices(const QList<GLC_StructOccurence*>& occurences);
+
+	//! Invalidate the cached bounding box of this occurence and of its parents
+	/*! Must be called if a geometry of the branch is changed outside of the structure*/
+	void invalidateBoundingBox();
+
 	//! Add Child
 	/*! The new child must be orphan*/
 	void addChild(GLC_StructOccurence*);
@@ -299,6 +331,18 @@ private:
 	//! Create occurrence from instance and given shader id
 	void doCreateOccurrenceFromInstance(GLuint shaderId);
 
+	//! Return the thread pool of the absolute matrices computation
+	static QThreadPool* threadPool();
+
+	//! Mark this occurence branch as dirty
+	void setAbsoluteMatrixDirty();
+
+	//! Compute the absolute matrices of the given occurences, their parents must be up to date
+	static void computeAbsoluteMatrices(GLC_StructOccurence* const* ppOccurences, int count);
+
+	//! Compute the absolute matrix from the parent absolute matrix
+	void computeAbsoluteMatrix();
+
 //////////////////////////////////////////////////////////////////////
 // Private members
 //////////////////////////////////////////////////////////////////////
@@ -339,6 +383,15 @@ private:
 	//! The relative matrix of this occurence if this occurence is flexible
 	GLC_Matrix4x4* m_pRelativeMatrix;
 
+	//! Flag to know if the absolute matrices of this occurence branch have to be updated
+	bool m_AbsoluteMatrixIsDirty;
+
+	//! The cached bounding box of this occurence
+	mutable GLC_BoundingBox m_BoundingBox;
+
+	//! Flag to know if the cached bounding box is valid
+	mutable bool m_BoundingBoxIsValid;
+
 };
 
 #endif /* GLC_STRUCTOCCURENCE_H_ */
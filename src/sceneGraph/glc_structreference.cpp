@@ -207,18 +207,20 @@ bool GLC_StructReference::loadRepresentation()
 	Q_ASSERT(NULL != m_pRepresentation);
 	if (m_pRepresentation->load())
 	{
-		QSet<GLC_StructOccurence*> structOccurenceSet= this->setOfStructOccurence();
-		QSet<GLC_StructOccurence*>::iterator iOcc= structOccurenceSet.begin();
-		while (structOccurenceSet.constEnd() != iOcc)
-		{
-			GLC_StructOccurence* pOccurence= *iOcc;
-			Q_ASSERT(!pOccurence->has3DViewInstance());
-			if (pOccurence->useAutomatic3DViewInstanceCreation())
-			{
-				pOccurence->create3DViewInstance();
-			}
-			++iOcc;
-		}
+		create3DViewInstancesOfOccurences();
+		return true;
+	}
+	else return false;
+}
+
+bool GLC_StructReference::takeLoadedRepresentation(GLC_3DRep* pLoadedRep)
+{
+	GLC_3DRep* pRep= dynamic_cast<GLC_3DRep*>(m_pRepresentation);
+	Q_ASSERT(NULL != pRep);
+	if (!pRep->isLoaded() && !pLoadedRep->isEmpty())
+	{
+		pRep->take(pLoadedRep);
+		create3DViewInstancesOfOccurences();
 		return true;
 	}
 	else return false;
@@ -270,3 +272,22 @@ QList<GLC_StructOccurence*> GLC_StructReference::addChild(GLC_StructOccurence* p
 	return subject;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_StructReference::create3DViewInstancesOfOccurences()
+{
+	QSet<GLC_StructOccurence*> structOccurenceSet= this->setOfStructOccurence();
+	QSet<GLC_StructOccurence*>::iterator iOcc= structOccurenceSet.begin();
+	while (structOccurenceSet.constEnd() != iOcc)
+	{
+		GLC_StructOccurence* pOccurence= *iOcc;
+		Q_ASSERT(!pOccurence->has3DViewInstance());
+		if (pOccurence->useAutomatic3DViewInstanceCreation())
+		{
+			pOccurence->create3DViewInstance();
+		}
+		++iOcc;
+	}
+}
@@ -206,6 +206,11 @@ public:
 	/*! The representation must exists*/
 	bool loadRepresentation();
 
+	//! Take the geometries of the given loaded representation as the representation
+	/*! The representation must be an unloaded 3DRep. The given representation is left empty.
+	 *  Return true if the representation has been loaded*/
+	bool takeLoadedRepresentation(GLC_3DRep* pLoadedRep);
+
 	//! Unload the representation
 	/*! The representation must exists*/
 	bool unloadRepresentation();
@@ -217,6 +222,13 @@ public:
 
 //@}
 
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Create the 3D view instances of the occurences which use automatic creation
+	void create3DViewInstancesOfOccurences();
+
 //////////////////////////////////////////////////////////////////////
 // Private members
 //////////////////////////////////////////////////////////////////////
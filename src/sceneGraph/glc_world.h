@@ -69,6 +69,7 @@ public:
 //////////////////////////////////////////////////////////////////////
 public:
 	//! Return the entire world Bounding Box
+	/*! The dirty absolute matrices are updated before*/
 	inline GLC_BoundingBox boundingBox()
 	{ return m_pWorldHandle->collection()->boundingBox();}
 
@@ -214,6 +215,11 @@ public:
 	inline void setAttachedViewport(GLC_Viewport* pViewport)
 	{m_pWorldHandle->setAttachedViewport(pViewport);}
 
+	//! Update the absolute matrices of the occurences moved since the last update
+	/*! The occurences get functions and the world collection rendering and culling do it*/
+	inline void updateAbsoluteMatrices()
+	{m_pWorldHandle->updateAbsoluteMatrices();}
+
 	//! Select the given occurence
 	/*! The given occurence must belong to the world handle of this world*/
 	inline void select(const GLC_StructOccurence* pOccurence)
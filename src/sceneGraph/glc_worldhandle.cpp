@@ -23,6 +23,7 @@
 #include "glc_worldhandle.h"
 #include "glc_structreference.h"
 #include <QSet>
+#include <QMutexLocker>
 
 GLC_WorldHandle::GLC_WorldHandle()
 : m_Collection()
@@ -30,8 +31,10 @@ GLC_WorldHandle::GLC_WorldHandle()
 , m_OccurenceHash()
 , m_UpVector(glc::Z_AXIS)
 , m_SelectionSet(this)
+, m_DirtyOccurences()
+, m_MatrixMutex(QMutex::Recursive)
 {
-
+	m_Collection.setWorldHandle(this);
 }
 
 GLC_WorldHandle::~GLC_WorldHandle()
@@ -96,6 +99,10 @@ void GLC_WorldHandle::addOccurence(GLC_StructOccurence* pOccurence, bool isSelec
 {
 	Q_ASSERT(!m_OccurenceHash.contains(pOccurence->id()));
 	m_OccurenceHash.insert(pOccurence->id(), pOccurence);
+	if (pOccurence->absoluteMatrixIsDirty())
+	{
+		addDirtyOccurence(pOccurence);
+	}
 	GLC_StructReference* pRef= pOccurence->structReference();
 	Q_ASSERT(NULL != pRef);
 
@@ -111,14 +118,44 @@ void GLC_WorldHandle::addOccurence(GLC_StructOccurence* pOccurence, bool isSelec
 void GLC_WorldHandle::removeOccurence(GLC_StructOccurence* pOccurence)
 {
 	Q_ASSERT(m_OccurenceHash.contains(pOccurence->id()));
+	// The removed occurence must leave with an up to date absolute matrix
+	if (NULL != pOccurence->highestDirtyOccurence()) updateAbsoluteMatrices();
 	// Remove the occurence from the selection set
 	m_SelectionSet.remove(pOccurence);
 	// Remove the occurence from the main occurence hash table
 	m_OccurenceHash.remove(pOccurence->id());
+	{
+		QMutexLocker locker(&m_MatrixMutex);
+		m_DirtyOccurences.remove(pOccurence);
+	}
 	// Remove instance representation from the collection
 	m_Collection.remove(pOccurence->id());
 }
 
+void GLC_WorldHandle::addDirtyOccurence(GLC_StructOccurence* pOccurence)
+{
+	QMutexLocker locker(&m_MatrixMutex);
+	m_DirtyOccurences.insert(pOccurence);
+}
+
+void GLC_WorldHandle::updateAbsoluteMatrices()
+{
+	QMutexLocker locker(&m_MatrixMutex);
+	if (m_DirtyOccurences.isEmpty()) return;
+
+	// The set is cleared first, an update requested during this one has nothing to do
+	const QList<GLC_StructOccurence*> dirtyOccurences(m_DirtyOccurences.toList());
+	m_DirtyOccurences.clear();
+	GLC_StructOccurence::updateAbsoluteMatrices(dirtyOccurences);
+}
+
+void GLC_WorldHandle::removeAllOccurences()
+{
+	m_OccurenceHash.clear();
+	QMutexLocker locker(&m_MatrixMutex);
+	m_DirtyOccurences.clear();
+}
+
 void GLC_WorldHandle::select(GLC_uint occurenceId)
 {
 	Q_ASSERT(m_OccurenceHash.contains(occurenceId));
@@ -163,12 +200,11 @@ void GLC_WorldHandle::unselect(GLC_uint occurenceId, bool propagate)
 void GLC_WorldHandle::selectAllWith3DViewInstance(bool allShowState)
 {
 	m_Collection.selectAll(allShowState);
-	QList<GLC_uint> selectedId= m_Collection.selection()->keys();
 	m_SelectionSet.clear();
-	const int selectionCount= selectedId.count();
-	for (int i= 0; i < selectionCount; ++i)
+	const GLC_BitSet& selectedBits= m_Collection.selectedBits();
+	for (int i= selectedBits.nextSetBit(0); i != -1; i= selectedBits.nextSetBit(i + 1))
 	{
-		m_SelectionSet.insert(selectedId.at(i));
+		m_SelectionSet.insert(m_Collection.instanceHandleAt(i)->id());
 	}
 }
 
@@ -180,23 +216,11 @@ void GLC_WorldHandle::unselectAll()
 
 void GLC_WorldHandle::showHideSelected3DViewInstance()
 {
-	QList<GLC_3DViewInstance*> selected3dviewInstance= m_Collection.selection()->values();
-	const int instanceCount= selected3dviewInstance.count();
-	for(int i= 0; i < instanceCount; ++i)
-	{
-		GLC_3DViewInstance* pCurrentInstance= selected3dviewInstance.at(i);
-		pCurrentInstance->setVisibility(!pCurrentInstance->isVisible());
-	}
+	m_Collection.swapSelectedVisibility();
 }
 
 void GLC_WorldHandle::setSelected3DViewInstanceVisibility(bool isVisible)
 {
-	QList<GLC_3DViewInstance*> selected3dviewInstance= m_Collection.selection()->values();
-	const int instanceCount= selected3dviewInstance.count();
-	for(int i= 0; i < instanceCount; ++i)
-	{
-		GLC_3DViewInstance* pCurrentInstance= selected3dviewInstance.at(i);
-		pCurrentInstance->setVisibility(isVisible);
-    }
+	m_Collection.setSelectedVisibility(isVisible);
 }
 
@@ -28,6 +28,8 @@
 #include "glc_selectionset.h"
 
 #include <QHash>
+#include <QSet>
+#include <QMutex>
 
 #include "../glc_config.h"
 
@@ -106,6 +108,10 @@ public:
 	inline GLC_SelectionSet* selectionSetHandle()
 	{return &m_SelectionSet;}
 
+	//! Return true if an absolute matrix of this world has to be updated
+	inline bool hasDirtyOccurence() const
+	{return !m_DirtyOccurences.isEmpty();}
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -127,9 +133,16 @@ public:
 	//! An Occurence has been removed
 	void removeOccurence(GLC_StructOccurence* pOccurence);
 
+	//! The absolute matrix of the given occurence branch has to be updated
+	void addDirtyOccurence(GLC_StructOccurence* pOccurence);
+
+	//! Update the absolute matrices of the dirty occurences branches
+	/*! Called by the collection before rendering and culling, and by the get functions
+	 *  of the occurences. Concurrent calls are serialized*/
+	void updateAbsoluteMatrices();
+
 	//! All Occurence has been removed
-	inline void removeAllOccurences()
-	{m_OccurenceHash.clear();}
+	void removeAllOccurences();
 
 	//! Set the world Up Vector
 	inline void setUpVector(const GLC_Vector3d& vect)
@@ -180,6 +193,12 @@ private:
 	//! This world selectionSet
 	GLC_SelectionSet m_SelectionSet;
 
+	//! The occurences whose branch absolute matrices have to be updated
+	QSet<GLC_StructOccurence*> m_DirtyOccurences;
+
+	//! Mutex of the dirty occurences and of the absolute matrices update
+	QMutex m_MatrixMutex;
+
 private:
     Q_DISABLE_COPY(GLC_WorldHandle)
 };
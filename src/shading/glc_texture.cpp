@@ -24,6 +24,7 @@
 
 
 #include "glc_texture.h"
+#include "glc_texturecache.h"
 #include "../glc_exception.h"
 #include "../glc_global.h"
 
@@ -39,8 +40,6 @@ QSize GLC_Texture::m_MaxTextureSize(676, 676);
 // The Minimum texture size
 const QSize GLC_Texture::m_MinTextureSize(10, 10);
 
-QHash<GLuint, int> GLC_Texture::m_TextureIdUsage;
-
 //////////////////////////////////////////////////////////////////////
 // Constructor Destructor
 //////////////////////////////////////////////////////////////////////
@@ -49,10 +48,8 @@ QHash<GLuint, int> GLC_Texture::m_TextureIdUsage;
 GLC_Texture::GLC_Texture()
 : m_pQGLContext(NULL)
 , m_FileName()
-, m_GlTextureID(0)
 , m_textureImage()
-, m_TextureSize()
-, m_HasAlphaChannel(false)
+, m_Key()
 {
 
 }
@@ -61,37 +58,40 @@ GLC_Texture::GLC_Texture()
 GLC_Texture::GLC_Texture(const QString &Filename)
 : m_pQGLContext(NULL)
 , m_FileName(Filename)
-, m_GlTextureID(0)
-, m_textureImage(loadFromFile(m_FileName))
-, m_TextureSize()
-, m_HasAlphaChannel(m_textureImage.hasAlphaChannel())
+, m_textureImage()
+, m_Key()
 {
-	if (m_textureImage.isNull())
+	GLC_TextureCache* pCache= GLC_TextureCache::instance();
+	const QString fileToCheck(glc::isArchiveString(m_FileName) ? glc::archiveFileName(m_FileName) : m_FileName);
+	if (pCache->asynchronousLoadingIsUsed() && QFileInfo(fileToCheck).exists())
 	{
-		QString ErrorMess("GLC_Texture::GLC_Texture open image : ");
-		ErrorMess.append(m_FileName).append(" Failed");
-		qDebug() << ErrorMess;
-		GLC_Exception e(ErrorMess);
-		throw(e);
+		// The image is decoded in background by the texture cache
+		m_Key= pCache->acquireFile(m_FileName);
+	}
+	else
+	{
+		// The image is loaded only if it is not already cached
+		m_Key= pCache->acquire(m_FileName, &m_textureImage);
+		if (m_Key.isEmpty())
+		{
+			m_textureImage= loadFromFile(m_FileName);
+			checkImage();
+			m_Key= pCache->acquire(&m_textureImage, m_FileName);
+		}
 	}
 }
 // Constructor with QFile
 GLC_Texture::GLC_Texture(const QFile &file)
 : m_pQGLContext(NULL)
 , m_FileName(file.fileName())
-, m_GlTextureID(0)
 , m_textureImage()
-, m_TextureSize()
-, m_HasAlphaChannel(m_textureImage.hasAlphaChannel())
+, m_Key(GLC_TextureCache::instance()->acquire(m_FileName, &m_textureImage))
 {
-	m_textureImage.load(const_cast<QFile*>(&file), QFileInfo(m_FileName).suffix().toLocal8Bit());
-	if (m_textureImage.isNull())
+	if (m_Key.isEmpty())
 	{
-		QString ErrorMess("GLC_Texture::GLC_Texture open image : ");
-		ErrorMess.append(m_FileName).append(" Failed");
-		qDebug() << ErrorMess;
-		GLC_Exception e(ErrorMess);
-		throw(e);
+		m_textureImage.load(const_cast<QFile*>(&file), QFileInfo(m_FileName).suffix().toLocal8Bit());
+		checkImage();
+		m_Key= GLC_TextureCache::instance()->acquire(&m_textureImage, m_FileName);
 	}
 }
 
@@ -99,32 +99,21 @@ GLC_Texture::GLC_Texture(const QFile &file)
 GLC_Texture::GLC_Texture(const QImage& image, const QString& fileName)
 : m_pQGLContext(NULL)
 , m_FileName(fileName)
-, m_GlTextureID(0)
 , m_textureImage(image)
-, m_TextureSize()
-, m_HasAlphaChannel(m_textureImage.hasAlphaChannel())
+, m_Key()
 {
 	Q_ASSERT(!m_textureImage.isNull());
+	m_Key= GLC_TextureCache::instance()->acquire(&m_textureImage, m_FileName);
 }
 
 GLC_Texture::GLC_Texture(const GLC_Texture &TextureToCopy)
 : m_pQGLContext(TextureToCopy.m_pQGLContext)
 , m_FileName(TextureToCopy.m_FileName)
-, m_GlTextureID(TextureToCopy.m_GlTextureID)
 , m_textureImage(TextureToCopy.m_textureImage)
-, m_TextureSize(TextureToCopy.m_TextureSize)
-, m_HasAlphaChannel(m_textureImage.hasAlphaChannel())
+, m_Key(TextureToCopy.m_Key)
 {
-	if (m_textureImage.isNull())
-	{
-		QString ErrorMess("GLC_Texture::GLC_Texture open image : ");
-		ErrorMess.append(m_FileName).append(" Failed");
-		qDebug() << ErrorMess;
-		GLC_Exception e(ErrorMess);
-		throw(e);
-	}
-	addThisOpenGLTextureId();
-
+	if (m_Key.isEmpty()) checkImage();
+	GLC_TextureCache::instance()->acquire(m_Key);
 }
 
 // Overload "=" operator
@@ -132,14 +121,12 @@ GLC_Texture& GLC_Texture::operator=(const GLC_Texture& texture)
 {
 	if (!(*this == texture))
 	{
-		removeThisOpenGLTextureId();
+		if (!texture.m_Key.isEmpty()) GLC_TextureCache::instance()->acquire(texture.m_Key);
+		if (!m_Key.isEmpty()) GLC_TextureCache::instance()->release(m_Key);
 		m_pQGLContext= texture.m_pQGLContext;
 		m_FileName= texture.m_FileName;
-		m_GlTextureID= texture.m_GlTextureID;
-		addThisOpenGLTextureId();
 		m_textureImage= texture.m_textureImage;
-		m_TextureSize= texture.m_TextureSize;
-		m_HasAlphaChannel= m_textureImage.hasAlphaChannel();
+		m_Key= texture.m_Key;
 	}
 
 	return *this;
@@ -147,13 +134,33 @@ GLC_Texture& GLC_Texture::operator=(const GLC_Texture& texture)
 
 GLC_Texture::~GLC_Texture()
 {
-	//qDebug() << "GLC_Texture::~GLC_Texture Texture ID : " << m_GlTextureID;
-	removeThisOpenGLTextureId();
+	if (!m_Key.isEmpty()) GLC_TextureCache::instance()->release(m_Key);
 }
 //////////////////////////////////////////////////////////////////////
 // Get Functions
 //////////////////////////////////////////////////////////////////////
 
+// Return OpenGL Texture Id
+GLuint GLC_Texture::GL_ID() const
+{
+	if (m_Key.isEmpty()) return 0;
+	else return GLC_TextureCache::instance()->textureId(m_Key);
+}
+
+// Return the an image of the texture
+QImage GLC_Texture::imageOfTexture() const
+{
+	if (m_textureImage.isNull() && !m_Key.isEmpty()) return GLC_TextureCache::instance()->image(m_Key);
+	else return m_textureImage;
+}
+
+// Return the texture size
+QSize GLC_Texture::size() const
+{
+	if (m_Key.isEmpty()) return QSize();
+	else return GLC_TextureCache::instance()->textureSize(m_Key);
+}
+
 // Return true if texture are the same
 bool GLC_Texture::operator==(const GLC_Texture& texture) const
 {
@@ -164,7 +171,8 @@ bool GLC_Texture::operator==(const GLC_Texture& texture) const
 	}
 	else
 	{
-		result= (m_FileName == texture.m_FileName) && (m_textureImage == texture.m_textureImage);
+		// Textures of the same content have the same key
+		result= (m_FileName == texture.m_FileName) && (m_Key == texture.m_Key);
 	}
 	return result;
 }
@@ -193,52 +201,25 @@ void GLC_Texture::setMaxTextureSize(const QSize& size)
 // Load the texture
 void GLC_Texture::glLoadTexture(QGLContext* pContext)
 {
-	if (m_GlTextureID == 0)
+	if (NULL == pContext)
 	{
-		if (NULL == pContext)
-		{
-			m_pQGLContext= const_cast<QGLContext*>(QGLContext::currentContext());
-		}
-		else
-		{
-			m_pQGLContext= pContext;
-		}
-
-		// Test image size
-		if ((m_textureImage.height() > m_MaxTextureSize.height())
-				|| (m_textureImage.width() > m_MaxTextureSize.width()))
-		{
-			QImage rescaledImage;
-			if(m_textureImage.height() > m_textureImage.width())
-			{
-				rescaledImage= m_textureImage.scaledToHeight(m_MaxTextureSize.height(), Qt::SmoothTransformation);
-			}
-			else
-			{
-				rescaledImage= m_textureImage.scaledToWidth(m_MaxTextureSize.width(), Qt::SmoothTransformation);
-			}
-			m_textureImage= rescaledImage;
-			m_TextureSize= m_textureImage.size();
-		}
-		else
-		{
-			m_TextureSize= m_textureImage.size();
-		}
-		m_GlTextureID= m_pQGLContext->bindTexture(m_textureImage);
-		addThisOpenGLTextureId();
-
-		//qDebug() << "GLC_Texture::glcBindTexture Texture ID = " << m_GlTextureID;
+		m_pQGLContext= const_cast<QGLContext*>(QGLContext::currentContext());
 	}
+	else
+	{
+		m_pQGLContext= pContext;
+	}
+	GLC_TextureCache::instance()->glLoadTexture(m_Key, m_pQGLContext);
 }
 
 // Bind texture in 2D mode
 void GLC_Texture::glcBindTexture(void)
 {
-	if (m_GlTextureID == 0)
+	if (NULL == m_pQGLContext)
 	{
-		glLoadTexture();
+		m_pQGLContext= const_cast<QGLContext*>(QGLContext::currentContext());
 	}
-	glBindTexture(GL_TEXTURE_2D, m_GlTextureID);
+	GLC_TextureCache::instance()->glBindTexture(m_Key, m_pQGLContext);
 }
 
 QImage GLC_Texture::loadFromFile(const QString& fileName)
@@ -293,33 +274,15 @@ QImage GLC_Texture::loadFromFile(const QString& fileName)
 	return resultImage;
 }
 
-void GLC_Texture::removeThisOpenGLTextureId()
+void GLC_Texture::checkImage() const
 {
-	if ( 0 != m_GlTextureID)
-	{
-		Q_ASSERT(m_TextureIdUsage.contains(m_GlTextureID));
-		--m_TextureIdUsage[m_GlTextureID];
-		if (m_TextureIdUsage.value(m_GlTextureID) == 0)
-		{
-			m_pQGLContext->deleteTexture(m_GlTextureID);
-			m_TextureIdUsage.remove(m_GlTextureID);
-			m_GlTextureID= 0;
-		}
-	}
-}
-
-void GLC_Texture::addThisOpenGLTextureId()
-{
-	if (0 != m_GlTextureID)
+	if (m_textureImage.isNull())
 	{
-		if (m_TextureIdUsage.contains(m_GlTextureID))
-		{
-			++m_TextureIdUsage[m_GlTextureID];
-		}
-		else
-		{
-			m_TextureIdUsage.insert(m_GlTextureID, 1);
-		}
+		QString ErrorMess("GLC_Texture::GLC_Texture open image : ");
+		ErrorMess.append(m_FileName).append(" Failed");
+		qDebug() << ErrorMess;
+		GLC_Exception e(ErrorMess);
+		throw(e);
 	}
 }
 
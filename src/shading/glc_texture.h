@@ -34,7 +34,9 @@
 //! \class GLC_Texture
 /*! \brief GLC_Texture : Image texture */
 
-/*! Image texture define a texture map in 2 D coordinate system*/
+/*! Image texture define a texture map in 2 D coordinate system
+ *  The image and the OpenGL texture are shared by all textures
+ *  of the same content through GLC_TextureCache*/
 //////////////////////////////////////////////////////////////////////
 
 
@@ -82,16 +84,18 @@ public:
 	{return m_FileName;}
 
 	//! Return OpenGL Texture Id
-	inline GLuint GL_ID() const
-	{return m_GlTextureID;}
+	GLuint GL_ID() const;
 
 	//! Return true if the texture is loaded
 	inline bool isLoaded() const
-	{return (m_GlTextureID != 0);}
+	{return (GL_ID() != 0);}
 
 	//! Return the texture size
-	inline QSize size() const
-	{return m_TextureSize;}
+	QSize size() const;
+
+	//! Return the content key of the texture in the texture cache
+	inline QByteArray key() const
+	{return m_Key;}
 
 	//! Return the maximum texture size
 	static QSize maxSize()
@@ -102,12 +106,14 @@ public:
 
 	//! Return true if the texture has alpha channel
 	inline bool hasAlphaChannel() const
-	{ return m_HasAlphaChannel;}
+	{ return imageOfTexture().hasAlphaChannel();}
 
 	//! Return the an image of the texture
-	inline QImage imageOfTexture() const
-	{ return m_textureImage;}
+	/*! If the image is decoded in background, wait until it is decoded*/
+	QImage imageOfTexture() const;
 
+	//! Load the image from the given fileName, which can be in an archive, and return resulting image
+	static QImage loadFromFile(const QString& fileName);
 
 //@}
 
@@ -136,14 +142,8 @@ public:
 //@{
 //////////////////////////////////////////////////////////////////////
 private:
-	//! Load the image of this texture from the given fileName and return resutling image
-	QImage loadFromFile(const QString& fileName);
-
-	//! Remove this Opengl texture id
-	void removeThisOpenGLTextureId();
-
-	//! Add this Opengl texture id
-	void addThisOpenGLTextureId();
+	//! Throw an exception if the image of this texture is null
+	void checkImage() const;
 
 //@}
 
@@ -158,24 +158,15 @@ private:
 	//! Texture Name
 	QString m_FileName;
 
-	//! OpenGL Texture ID
-	GLuint	m_GlTextureID;
-
 	//! QImage off the texture
 	QImage m_textureImage;
 
-	//! Size of the texture
-	QSize m_TextureSize;
-
-	//! Flag to know if the texture has alpha channel
-	bool m_HasAlphaChannel;
+	//! The content key of the texture in the texture cache
+	QByteArray m_Key;
 
 	//! Static member used to check texture size
 	static QSize m_MaxTextureSize;
 	static const QSize m_MinTextureSize;
-
-	//! Static hash table to manage OpenGL testure ID
-	static QHash<GLuint, int> m_TextureIdUsage;
 };
 
 //! Non-member stream operator
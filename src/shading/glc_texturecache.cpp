@@ -0,0 +1,718 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_texturecache.cpp implementation of the GLC_TextureCache class.
+
+#include "glc_texturecache.h"
+#include "glc_texture.h"
+#include "../glc_errorlog.h"
+#include "../glc_ext.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
+
+// The default memory budget of the OpenGL textures : 256 MB
+static const qint64 defaultMemoryBudget= Q_INT64_C(256) * 1024 * 1024;
+
+// The default number of bytes uploaded per frame : 4 MB
+static const qint64 defaultFrameUploadBudget= Q_INT64_C(4) * 1024 * 1024;
+
+// The maximum number of mipmap levels removed from a texture
+static const int maximumDownscaleLevel= 4;
+
+// The minimum size of a downscaled texture
+static const int minimumDownscaledSize= 16;
+
+// Return the smallest power of two greater or equal to the given value and lower or equal to the given maximum
+static int powerOfTwo(int value, int maximum)
+{
+	int result= 1;
+	while (result < value) result*= 2;
+	while ((result > maximum) && (result > 1)) result/= 2;
+	return result;
+}
+
+// Runnable which decodes an image and builds its mipmap chain
+class GLC_TextureCache::PrepareTask : public QRunnable
+{
+public:
+	inline PrepareTask(GLC_TextureCache* pCache, const QByteArray& key, int serial, const QImage& image
+			, const QString& fileName, int downscaleLevel)
+	: QRunnable()
+	, m_pCache(pCache)
+	, m_Key(key)
+	, m_Serial(serial)
+	, m_Image(image)
+	, m_FileName(fileName)
+	, m_MaxSize(GLC_Texture::maxSize())
+	, m_DownscaleLevel(downscaleLevel)
+	{}
+
+	//! Decode the image if needed and build its mipmap chain
+	virtual void run()
+	{
+		// The content of a decoded image is hashed to share it with the same images
+		QByteArray contentKey;
+		if (m_Image.isNull())
+		{
+			m_Image= GLC_Texture::loadFromFile(m_FileName);
+			if (!m_Image.isNull()) contentKey= GLC_TextureCache::imageKey(m_Image);
+		}
+		QList<QImage> levels;
+		if (!m_Image.isNull()) levels= GLC_TextureCache::mipmapLevels(m_Image, m_MaxSize, m_DownscaleLevel);
+		m_pCache->setPreparedLevels(m_Key, m_Serial, m_Image, levels, contentKey);
+	}
+
+private:
+	//! The texture cache
+	GLC_TextureCache* m_pCache;
+	//! The key of the entry
+	QByteArray m_Key;
+	//! The serial of the preparation
+	int m_Serial;
+	//! The image, null if it must be decoded
+	QImage m_Image;
+	//! The file of the image
+	QString m_FileName;
+	//! The maximum texture size
+	QSize m_MaxSize;
+	//! The number of mipmap levels to remove
+	int m_DownscaleLevel;
+};
+
+GLC_TextureCache* GLC_TextureCache::m_pTextureCache= NULL;
+
+// The mutex of the creation of the texture cache, textures can be created by loading threads
+Q_GLOBAL_STATIC(QMutex, textureCacheMutex)
+
+GLC_TextureCache::GLC_TextureCache()
+: QObject()
+, m_EntryHash()
+, m_FileKeyHash()
+, m_AliasHash()
+, m_ReleasedTextureHash()
+, m_MemoryBudget(defaultMemoryBudget)
+, m_UsedMemory(0)
+, m_UseCounter(0)
+, m_AsynchronousLoading(false)
+, m_FrameUploadBudget(defaultFrameUploadBudget)
+, m_FrameUploadedBytes(0)
+, m_PlaceholderColor(200, 200, 200)
+, m_PlaceholderTextureId(0)
+, m_pPlaceholderContext(NULL)
+, m_PlaceholderIsValid(false)
+, m_Mutex()
+, m_PreparedCondition()
+, m_TextureReadyIsPosted(false)
+{
+
+}
+
+GLC_TextureCache::~GLC_TextureCache()
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+GLC_TextureCache* GLC_TextureCache::instance()
+{
+	QMutexLocker locker(textureCacheMutex());
+	if (NULL == m_pTextureCache)
+	{
+		m_pTextureCache= new GLC_TextureCache();
+
+		// The queued signals of the cache are delivered in the thread of the application
+		if (NULL != QCoreApplication::instance())
+		{
+			m_pTextureCache->moveToThread(QCoreApplication::instance()->thread());
+		}
+	}
+	return m_pTextureCache;
+}
+
+QByteArray GLC_TextureCache::imageKey(const QImage& image)
+{
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	const qint32 header[3]= {image.width(), image.height(), static_cast<qint32>(image.format())};
+	hash.addData(reinterpret_cast<const char*>(header), sizeof(header));
+	hash.addData(reinterpret_cast<const char*>(image.constBits()), image.byteCount());
+
+	return hash.result();
+}
+
+int GLC_TextureCache::entryCount() const
+{
+	QMutexLocker locker(&m_Mutex);
+	return m_EntryHash.size();
+}
+
+qint64 GLC_TextureCache::usedMemory() const
+{
+	QMutexLocker locker(&m_Mutex);
+	return m_UsedMemory;
+}
+
+bool GLC_TextureCache::isLoadingTextures() const
+{
+	QMutexLocker locker(&m_Mutex);
+	QHash<QByteArray, Entry>::const_iterator iEntry= m_EntryHash.constBegin();
+	while (m_EntryHash.constEnd() != iEntry)
+	{
+		const Entry& entry= iEntry.value();
+		if ((Preparing == entry.m_State) || ((Prepared == entry.m_State) && !entry.m_Levels.isEmpty())) return true;
+		++iEntry;
+	}
+	return false;
+}
+
+QImage GLC_TextureCache::image(const QByteArray& key)
+{
+	QMutexLocker locker(&m_Mutex);
+	forever
+	{
+		// The key of a file entry can become an alias while it is decoded
+		QHash<QByteArray, Entry>::const_iterator iEntry= m_EntryHash.constFind(resolvedKey(key));
+		if (m_EntryHash.constEnd() == iEntry) return QImage();
+		const Entry& entry= iEntry.value();
+		if (!entry.m_Image.isNull() || entry.m_DecodingHasFailed || (Preparing != entry.m_State)) return entry.m_Image;
+
+		// The file is being decoded
+		m_PreparedCondition.wait(&m_Mutex);
+	}
+	return QImage();
+}
+
+GLuint GLC_TextureCache::textureId(const QByteArray& key) const
+{
+	QMutexLocker locker(&m_Mutex);
+	QHash<QByteArray, Entry>::const_iterator iEntry= m_EntryHash.constFind(resolvedKey(key));
+	if (m_EntryHash.constEnd() != iEntry) return iEntry.value().m_TextureId;
+	else return 0;
+}
+
+QSize GLC_TextureCache::textureSize(const QByteArray& key) const
+{
+	QMutexLocker locker(&m_Mutex);
+	QHash<QByteArray, Entry>::const_iterator iEntry= m_EntryHash.constFind(resolvedKey(key));
+	if (m_EntryHash.constEnd() != iEntry) return iEntry.value().m_TextureSize;
+	else return QSize();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_TextureCache::setMemoryBudget(qint64 budget)
+{
+	QMutexLocker locker(&m_Mutex);
+	m_MemoryBudget= qMax(Q_INT64_C(0), budget);
+}
+
+void GLC_TextureCache::setAsynchronousLoading(bool asynchronous)
+{
+	QMutexLocker locker(&m_Mutex);
+	m_AsynchronousLoading= asynchronous;
+}
+
+void GLC_TextureCache::setFrameUploadBudget(qint64 budget)
+{
+	QMutexLocker locker(&m_Mutex);
+	m_FrameUploadBudget= qMax(Q_INT64_C(0), budget);
+}
+
+void GLC_TextureCache::setPlaceholderColor(const QColor& color)
+{
+	QMutexLocker locker(&m_Mutex);
+	m_PlaceholderColor= color;
+	m_PlaceholderIsValid= false;
+}
+
+void GLC_TextureCache::newFrame()
+{
+	QMutexLocker locker(&m_Mutex);
+	m_FrameUploadedBytes= 0;
+	glDeleteReleasedTextures(QGLContext::currentContext());
+}
+
+QByteArray GLC_TextureCache::acquire(const QString& fileName, QImage* pImage)
+{
+	QMutexLocker locker(&m_Mutex);
+	const QByteArray key(m_FileKeyHash.value(fileName));
+	if (!key.isEmpty())
+	{
+		Entry& entry= m_EntryHash[key];
+		++entry.m_RefCount;
+		*pImage= entry.m_Image;
+	}
+	return key;
+}
+
+QByteArray GLC_TextureCache::acquire(QImage* pImage, const QString& fileName)
+{
+	Q_ASSERT(!pImage->isNull());
+	const QByteArray key(imageKey(*pImage));
+
+	QMutexLocker locker(&m_Mutex);
+	QHash<QByteArray, Entry>::iterator iEntry= m_EntryHash.find(key);
+	if (m_EntryHash.end() != iEntry)
+	{
+		++iEntry.value().m_RefCount;
+		*pImage= iEntry.value().m_Image;
+	}
+	else
+	{
+		Entry entry;
+		entry.m_Image= *pImage;
+		entry.m_DecodingHasFailed= false;
+		entry.m_RefCount= 1;
+		entry.m_State= Unprepared;
+		entry.m_Serial= 0;
+		entry.m_UploadedLevelCount= 0;
+		entry.m_TextureId= 0;
+		entry.m_pContext= NULL;
+		entry.m_MemorySize= 0;
+		entry.m_DownscaleLevel= 0;
+		entry.m_LastUse= 0;
+		iEntry= m_EntryHash.insert(key, entry);
+	}
+
+	if (!fileName.isEmpty() && !m_FileKeyHash.contains(fileName))
+	{
+		m_FileKeyHash.insert(fileName, key);
+		iEntry.value().m_FileNames.append(fileName);
+	}
+	return key;
+}
+
+void GLC_TextureCache::acquire(const QByteArray& key)
+{
+	QMutexLocker locker(&m_Mutex);
+	const QByteArray entryKey(resolvedKey(key));
+	Q_ASSERT(m_EntryHash.contains(entryKey));
+	++m_EntryHash[entryKey].m_RefCount;
+}
+
+QByteArray GLC_TextureCache::acquireFile(const QString& fileName)
+{
+	QMutexLocker locker(&m_Mutex);
+	QByteArray key(m_FileKeyHash.value(fileName));
+	if (!key.isEmpty())
+	{
+		++m_EntryHash[key].m_RefCount;
+	}
+	else
+	{
+		// Entries decoded in background are identified by their file name
+		key= QByteArray("file:") + fileName.toUtf8();
+		Entry entry;
+		entry.m_SourceFileName= fileName;
+		entry.m_DecodingHasFailed= false;
+		entry.m_FileNames.append(fileName);
+		entry.m_RefCount= 1;
+		entry.m_State= Preparing;
+		entry.m_Serial= 1;
+		entry.m_UploadedLevelCount= 0;
+		entry.m_TextureId= 0;
+		entry.m_pContext= NULL;
+		entry.m_MemorySize= 0;
+		entry.m_DownscaleLevel= 0;
+		entry.m_LastUse= 0;
+		m_EntryHash.insert(key, entry);
+		m_FileKeyHash.insert(fileName, key);
+
+		threadPool()->start(new PrepareTask(this, key, entry.m_Serial, QImage(), fileName, 0));
+	}
+	return key;
+}
+
+void GLC_TextureCache::release(const QByteArray& key)
+{
+	QMutexLocker locker(&m_Mutex);
+	QHash<QByteArray, Entry>::iterator iEntry= m_EntryHash.find(resolvedKey(key));
+	Q_ASSERT(m_EntryHash.end() != iEntry);
+	Entry& entry= iEntry.value();
+	if (0 == --entry.m_RefCount)
+	{
+		deleteTexture(entry);
+		const int size= entry.m_FileNames.size();
+		for (int i= 0; i < size; ++i)
+		{
+			m_FileKeyHash.remove(entry.m_FileNames.at(i));
+		}
+		const int aliasCount= entry.m_Aliases.size();
+		for (int i= 0; i < aliasCount; ++i)
+		{
+			m_AliasHash.remove(entry.m_Aliases.at(i));
+		}
+		m_EntryHash.erase(iEntry);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// OpenGL Functions
+//////////////////////////////////////////////////////////////////////
+
+GLuint GLC_TextureCache::glLoadTexture(const QByteArray& key, QGLContext* pContext)
+{
+	if (NULL == pContext)
+	{
+		pContext= const_cast<QGLContext*>(QGLContext::currentContext());
+	}
+
+	QMutexLocker locker(&m_Mutex);
+	const QByteArray entryKey(resolvedKey(key));
+	Q_ASSERT(m_EntryHash.contains(entryKey));
+	glDeleteReleasedTextures(pContext);
+	Entry& entry= m_EntryHash[entryKey];
+	glUpload(entryKey, entry, pContext);
+
+	return entry.m_TextureId;
+}
+
+void GLC_TextureCache::glBindTexture(const QByteArray& key, QGLContext* pContext)
+{
+	if (NULL == pContext)
+	{
+		pContext= const_cast<QGLContext*>(QGLContext::currentContext());
+	}
+
+	QMutexLocker locker(&m_Mutex);
+	const QByteArray entryKey(resolvedKey(key));
+	Q_ASSERT(m_EntryHash.contains(entryKey));
+	glDeleteReleasedTextures(pContext);
+	Entry& entry= m_EntryHash[entryKey];
+	entry.m_LastUse= ++m_UseCounter;
+	glUpload(entryKey, entry, pContext);
+
+	if (0 != entry.m_UploadedLevelCount)
+	{
+		::glBindTexture(GL_TEXTURE_2D, entry.m_TextureId);
+	}
+	else
+	{
+		glBindPlaceholder(pContext);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private slots
+//////////////////////////////////////////////////////////////////////
+
+void GLC_TextureCache::emitTextureReady()
+{
+	m_Mutex.lock();
+	m_TextureReadyIsPosted= false;
+	m_Mutex.unlock();
+
+	emit textureReady();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_TextureCache::postTextureReady()
+{
+	if (!m_TextureReadyIsPosted)
+	{
+		m_TextureReadyIsPosted= true;
+		QMetaObject::invokeMethod(this, "emitTextureReady", Qt::QueuedConnection);
+	}
+}
+
+QThreadPool* GLC_TextureCache::threadPool()
+{
+	static QThreadPool textureThreadPool;
+	return &textureThreadPool;
+}
+
+QList<QImage> GLC_TextureCache::mipmapLevels(const QImage& image, const QSize& maxSize, int downscaleLevel)
+{
+	// The finest level is a power of two size within the maximum texture size
+	QSize size(powerOfTwo(image.width(), maxSize.width()), powerOfTwo(image.height(), maxSize.height()));
+	for (int i= 0; (i < downscaleLevel) && (qMin(size.width(), size.height()) >= (2 * minimumDownscaledSize)); ++i)
+	{
+		size/= 2;
+	}
+
+	QList<QImage> levels;
+	QImage level(image.size() == size ? image : image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+	forever
+	{
+		levels.append(QGLWidget::convertToGLFormat(level));
+		if ((1 == level.width()) && (1 == level.height())) break;
+		const QSize levelSize(qMax(1, level.width() / 2), qMax(1, level.height() / 2));
+		level= level.scaled(levelSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+	}
+	return levels;
+}
+
+void GLC_TextureCache::glUpload(const QByteArray& key, Entry& entry, const QGLContext* pContext)
+{
+	if ((Unprepared == entry.m_State) && !entry.m_DecodingHasFailed)
+	{
+		++entry.m_Serial;
+		if (m_AsynchronousLoading)
+		{
+			entry.m_State= Preparing;
+			threadPool()->start(new PrepareTask(this, key, entry.m_Serial, entry.m_Image, entry.m_SourceFileName, entry.m_DownscaleLevel));
+			return;
+		}
+		else
+		{
+			if (entry.m_Image.isNull())
+			{
+				entry.m_Image= GLC_Texture::loadFromFile(entry.m_SourceFileName);
+				entry.m_DecodingHasFailed= entry.m_Image.isNull();
+				if (entry.m_DecodingHasFailed) logDecodingFailure(entry);
+			}
+			if (!entry.m_Image.isNull()) entry.m_Levels= mipmapLevels(entry.m_Image, GLC_Texture::maxSize(), entry.m_DownscaleLevel);
+			entry.m_State= Prepared;
+		}
+	}
+	if ((Prepared != entry.m_State) || entry.m_Levels.isEmpty()) return;
+
+	if (0 == entry.m_TextureId)
+	{
+		qint64 memory= levelsMemory(entry.m_Levels);
+		if (0 != m_MemoryBudget)
+		{
+			evict(key, memory);
+
+			// The finest levels which do not fit are not uploaded
+			while (((m_UsedMemory + memory) > m_MemoryBudget) && (entry.m_Levels.size() > 1)
+					&& (qMin(entry.m_Levels.at(1).width(), entry.m_Levels.at(1).height()) >= minimumDownscaledSize))
+			{
+				entry.m_Levels.removeFirst();
+				memory= levelsMemory(entry.m_Levels);
+				entry.m_DownscaleLevel= qMin(entry.m_DownscaleLevel + 1, maximumDownscaleLevel);
+			}
+		}
+
+		glGenTextures(1, &(entry.m_TextureId));
+		entry.m_pContext= pContext;
+		::glBindTexture(GL_TEXTURE_2D, entry.m_TextureId);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, entry.m_Levels.size() - 1);
+		entry.m_UploadedLevelCount= 0;
+		entry.m_MemorySize= memory;
+		m_UsedMemory+= memory;
+	}
+	else
+	{
+		::glBindTexture(GL_TEXTURE_2D, entry.m_TextureId);
+	}
+
+	// Upload the levels from the coarsest one, the base level is the finest uploaded level
+	const int levelCount= entry.m_Levels.size();
+	while (entry.m_UploadedLevelCount < levelCount)
+	{
+		const int level= levelCount - 1 - entry.m_UploadedLevelCount;
+		const QImage& levelImage= entry.m_Levels.at(level);
+		const qint64 levelMemory= levelImage.byteCount();
+		const bool isOverBudget= (0 != m_FrameUploadBudget) && (0 != m_FrameUploadedBytes) && ((m_FrameUploadedBytes + levelMemory) > m_FrameUploadBudget);
+		if (m_AsynchronousLoading && isOverBudget)
+		{
+			// The remaining levels are uploaded in the next frames
+			postTextureReady();
+			break;
+		}
+
+		glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, levelImage.width(), levelImage.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, levelImage.constBits());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+		entry.m_TextureSize= levelImage.size();
+		m_FrameUploadedBytes+= levelMemory;
+		++entry.m_UploadedLevelCount;
+	}
+
+	// The levels of an uploaded texture are prepared again after its eviction
+	if (levelCount == entry.m_UploadedLevelCount) entry.m_Levels.clear();
+}
+
+void GLC_TextureCache::setPreparedLevels(const QByteArray& key, int serial, const QImage& image, const QList<QImage>& levels
+		, const QByteArray& contentKey)
+{
+	QMutexLocker locker(&m_Mutex);
+	QHash<QByteArray, Entry>::iterator iEntry= m_EntryHash.find(key);
+	if ((m_EntryHash.end() != iEntry) && (serial == iEntry.value().m_Serial))
+	{
+		Entry& entry= iEntry.value();
+		const bool isDecoded= entry.m_Image.isNull() && !image.isNull();
+		if (entry.m_Image.isNull())
+		{
+			entry.m_Image= image;
+			entry.m_DecodingHasFailed= image.isNull();
+			if (entry.m_DecodingHasFailed) logDecodingFailure(entry);
+		}
+		entry.m_Levels= levels;
+		entry.m_State= Prepared;
+		if (isDecoded && !contentKey.isEmpty() && (contentKey != key))
+		{
+			setContentKey(iEntry, contentKey);
+		}
+		postTextureReady();
+	}
+	m_PreparedCondition.wakeAll();
+}
+
+void GLC_TextureCache::setContentKey(QHash<QByteArray, Entry>::iterator iEntry, const QByteArray& contentKey)
+{
+	const QByteArray fileKey(iEntry.key());
+	const Entry entry(iEntry.value());
+	m_EntryHash.erase(iEntry);
+
+	QHash<QByteArray, Entry>::iterator iContentEntry= m_EntryHash.find(contentKey);
+	if (m_EntryHash.end() != iContentEntry)
+	{
+		// An image with the same content is cached, its image and texture are shared
+		Entry& contentEntry= iContentEntry.value();
+		contentEntry.m_RefCount+= entry.m_RefCount;
+		contentEntry.m_FileNames+= entry.m_FileNames;
+		contentEntry.m_Aliases+= entry.m_Aliases;
+	}
+	else
+	{
+		iContentEntry= m_EntryHash.insert(contentKey, entry);
+	}
+
+	Entry& contentEntry= iContentEntry.value();
+	contentEntry.m_Aliases.append(fileKey);
+	const int aliasCount= contentEntry.m_Aliases.size();
+	for (int i= 0; i < aliasCount; ++i)
+	{
+		m_AliasHash.insert(contentEntry.m_Aliases.at(i), contentKey);
+	}
+	const int size= entry.m_FileNames.size();
+	for (int i= 0; i < size; ++i)
+	{
+		m_FileKeyHash.insert(entry.m_FileNames.at(i), contentKey);
+	}
+}
+
+void GLC_TextureCache::logDecodingFailure(const Entry& entry) const
+{
+	QStringList stringList("GLC_TextureCache");
+	stringList.append(QString("Open image : ") + entry.m_SourceFileName + QString(" Failed"));
+	GLC_ErrorLog::addError(stringList);
+}
+
+void GLC_TextureCache::glBindPlaceholder(QGLContext* pContext)
+{
+	if ((0 == m_PlaceholderTextureId) || (m_pPlaceholderContext != pContext))
+	{
+		glGenTextures(1, &m_PlaceholderTextureId);
+		m_pPlaceholderContext= pContext;
+		m_PlaceholderIsValid= false;
+	}
+	::glBindTexture(GL_TEXTURE_2D, m_PlaceholderTextureId);
+	if (!m_PlaceholderIsValid)
+	{
+		const GLubyte color[4]= {static_cast<GLubyte>(m_PlaceholderColor.red()), static_cast<GLubyte>(m_PlaceholderColor.green())
+				, static_cast<GLubyte>(m_PlaceholderColor.blue()), static_cast<GLubyte>(m_PlaceholderColor.alpha())};
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, color);
+		m_PlaceholderIsValid= true;
+	}
+}
+
+void GLC_TextureCache::evict(const QByteArray& key, qint64 memory)
+{
+	while ((m_UsedMemory + memory) > m_MemoryBudget)
+	{
+		// Find the least recently used texture
+		QHash<QByteArray, Entry>::iterator iLeastUsed= m_EntryHash.end();
+		QHash<QByteArray, Entry>::iterator iEntry= m_EntryHash.begin();
+		while (m_EntryHash.end() != iEntry)
+		{
+			const Entry& entry= iEntry.value();
+			if ((0 != entry.m_TextureId) && (iEntry.key() != key))
+			{
+				if ((m_EntryHash.end() == iLeastUsed) || (entry.m_LastUse < iLeastUsed.value().m_LastUse))
+				{
+					iLeastUsed= iEntry;
+				}
+			}
+			++iEntry;
+		}
+		if (m_EntryHash.end() == iLeastUsed) return;
+
+		Entry& leastUsed= iLeastUsed.value();
+		deleteTexture(leastUsed);
+		leastUsed.m_DownscaleLevel= qMin(leastUsed.m_DownscaleLevel + 1, maximumDownscaleLevel);
+	}
+}
+
+void GLC_TextureCache::deleteTexture(Entry& entry)
+{
+	if (0 != entry.m_TextureId)
+	{
+		// The texture can be released by a loading thread or while another context is current
+		if ((NULL != entry.m_pContext) && (QGLContext::currentContext() == entry.m_pContext))
+		{
+			glDeleteTextures(1, &(entry.m_TextureId));
+		}
+		else
+		{
+			m_ReleasedTextureHash[entry.m_pContext].append(entry.m_TextureId);
+		}
+		entry.m_TextureId= 0;
+		entry.m_pContext= NULL;
+		entry.m_TextureSize= QSize();
+		entry.m_UploadedLevelCount= 0;
+		entry.m_Levels.clear();
+		entry.m_State= Unprepared;
+		m_UsedMemory-= entry.m_MemorySize;
+		entry.m_MemorySize= 0;
+	}
+}
+
+void GLC_TextureCache::glDeleteReleasedTextures(const QGLContext* pContext)
+{
+	if ((NULL == pContext) || m_ReleasedTextureHash.isEmpty()) return;
+
+	QHash<const QGLContext*, QList<GLuint> >::iterator iReleased= m_ReleasedTextureHash.find(pContext);
+	if (m_ReleasedTextureHash.end() != iReleased)
+	{
+		const QVector<GLuint> textureIds(iReleased.value().toVector());
+		glDeleteTextures(textureIds.size(), textureIds.constData());
+		m_ReleasedTextureHash.erase(iReleased);
+	}
+}
+
+qint64 GLC_TextureCache::levelsMemory(const QList<QImage>& levels)
+{
+	qint64 memory= 0;
+	const int size= levels.size();
+	for (int i= 0; i < size; ++i)
+	{
+		memory+= levels.at(i).byteCount();
+	}
+	return memory;
+}
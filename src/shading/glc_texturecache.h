@@ -0,0 +1,363 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_texturecache.h interface for the GLC_TextureCache class.
+
+#ifndef GLC_TEXTURECACHE_H_
+#define GLC_TEXTURECACHE_H_
+
+#include <QByteArray>
+#include <QColor>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QWaitCondition>
+#include <QtOpenGL>
+
+#include "../glc_config.h"
+
+class QThreadPool;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_TextureCache
+/*! \brief GLC_TextureCache : Process wide cache of texture images and OpenGL textures */
+
+/*! Texture images are identified by a hash of their content. An image file decoded
+ *  in background is identified by its file name until it is decoded, then by its content
+ *  and the file name key becomes an alias. All GLC_Texture which have the same
+ *  image share the same image data and the same OpenGL texture object, and an
+ *  image already loaded from a file is not loaded again.
+ *  Entries are reference counted by the textures and removed with their last texture.
+ *
+ *  With asynchronous loading, which is not used by default, images files are decoded,
+ *  resized and converted to a mipmap chain on a thread pool. The levels are uploaded
+ *  from the coarsest one within an upload budget per frame, and a placeholder colour
+ *  is bound until the first level is uploaded. newFrame() must be called once per frame,
+ *  it is called by GLC_Viewport::glExecuteCam(). textureReady() is emitted when a
+ *  texture has to be uploaded, views must be repainted to upload it.
+ *
+ *  The memory used by the OpenGL textures is bounded by a budget. When a
+ *  texture is uploaded over the budget, the least recently bound textures are
+ *  deleted and will be uploaded again one mipmap level smaller when they are bound.
+ *  The finest levels of a texture which still does not fit are not uploaded.
+ *
+ *  The OpenGL textures released while their context is not current are deleted
+ *  when their context is current again.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_TextureCache : public QObject
+{
+	Q_OBJECT
+
+	//! Runnable which decodes an image and builds its mipmap chain
+	class PrepareTask;
+
+	//! The preparation state of the mipmap chain of an entry
+	enum PreparationState
+	{
+		Unprepared,
+		Preparing,
+		Prepared
+	};
+
+	//! A cached texture image
+	struct Entry
+	{
+		//! The image of the texture, null until its file is decoded
+		QImage m_Image;
+		//! The file decoded in background, empty if the image is given
+		QString m_SourceFileName;
+		//! True if the decoding of the file has failed
+		bool m_DecodingHasFailed;
+		//! The file names of the image
+		QStringList m_FileNames;
+		//! The file name keys of the entry once its image is decoded
+		QList<QByteArray> m_Aliases;
+		//! The number of textures using this entry
+		int m_RefCount;
+		//! The preparation state of the mipmap chain
+		PreparationState m_State;
+		//! The serial of the last preparation, used to ignore outdated results
+		int m_Serial;
+		//! The mipmap levels in OpenGL format from the finest one, released once uploaded
+		QList<QImage> m_Levels;
+		//! The number of levels uploaded from the coarsest one
+		int m_UploadedLevelCount;
+		//! The OpenGL texture id, 0 if the texture is not uploaded
+		GLuint m_TextureId;
+		//! The context of the OpenGL texture
+		const QGLContext* m_pContext;
+		//! The size of the finest uploaded level
+		QSize m_TextureSize;
+		//! The memory used by the uploaded texture
+		qint64 m_MemorySize;
+		//! The number of mipmap levels removed at upload
+		int m_DownscaleLevel;
+		//! The last bind of the texture
+		quint64 m_LastUse;
+	};
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Private constructor
+	GLC_TextureCache();
+
+public:
+	//! Destructor
+	~GLC_TextureCache();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return the unique instance of the texture cache
+	static GLC_TextureCache* instance();
+
+	//! Return the content key of the given image
+	static QByteArray imageKey(const QImage& image);
+
+	//! Return the number of cached images
+	int entryCount() const;
+
+	//! Return the memory budget of the OpenGL textures in bytes
+	inline qint64 memoryBudget() const
+	{return m_MemoryBudget;}
+
+	//! Return the memory used by the OpenGL textures in bytes
+	qint64 usedMemory() const;
+
+	//! Return true if images files are decoded and textures uploaded asynchronously
+	inline bool asynchronousLoadingIsUsed() const
+	{return m_AsynchronousLoading;}
+
+	//! Return the maximum number of bytes uploaded per frame with asynchronous loading
+	inline qint64 frameUploadBudget() const
+	{return m_FrameUploadBudget;}
+
+	//! Return the colour bound while a texture is not uploaded
+	inline QColor placeholderColor() const
+	{return m_PlaceholderColor;}
+
+	//! Return true if a texture is being prepared or uploaded
+	bool isLoadingTextures() const;
+
+	//! Return the image of the given key, wait until it is decoded if needed
+	/*! Return a null image if the decoding has failed*/
+	QImage image(const QByteArray& key);
+
+	//! Return the OpenGL texture id of the given key, 0 if the texture is not uploaded
+	GLuint textureId(const QByteArray& key) const;
+
+	//! Return the size of the finest uploaded level of the texture of the given key
+	QSize textureSize(const QByteArray& key) const;
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Set the memory budget of the OpenGL textures in bytes
+	/*! A budget of 0 disables the eviction of textures*/
+	void setMemoryBudget(qint64 budget);
+
+	//! Set asynchronous loading usage
+	/*! Not used by default, textures created after this call are loaded asynchronously*/
+	void setAsynchronousLoading(bool asynchronous);
+
+	//! Set the maximum number of bytes uploaded per frame, 0 for no limit
+	/*! At least one mipmap level is uploaded per frame*/
+	void setFrameUploadBudget(qint64 budget);
+
+	//! Set the colour bound while a texture is not uploaded
+	void setPlaceholderColor(const QColor& color);
+
+	//! Reset the upload budget of the frame and delete the released textures of the current context
+	void newFrame();
+
+	//! Acquire the cached image of the given file name and return its key
+	/*! If the file name is not cached an empty key is returned, else the given image
+	 *  is set to the cached image, which is null if it is decoded in background*/
+	QByteArray acquire(const QString& fileName, QImage* pImage);
+
+	//! Acquire the entry of the given image and return its key
+	/*! If an image with the same content is cached, the given image is set to the cached image*/
+	QByteArray acquire(QImage* pImage, const QString& fileName= QString());
+
+	//! Acquire the entry of the given key
+	void acquire(const QByteArray& key);
+
+	//! Acquire the entry of the given file name, decoded in background if it is not cached, and return its key
+	QByteArray acquireFile(const QString& fileName);
+
+	//! Release the entry of the given key and remove it if it is no more used
+	void release(const QByteArray& key);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name OpenGL Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Upload the texture of the given key in the given context if needed and return its id
+	/*! With asynchronous loading, the returned id is 0 until the first level is uploaded*/
+	GLuint glLoadTexture(const QByteArray& key, QGLContext* pContext);
+
+	//! Upload if needed and bind the texture of the given key in the given context
+	/*! The placeholder is bound while the texture is not uploaded*/
+	void glBindTexture(const QByteArray& key, QGLContext* pContext);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Qt Signals
+//////////////////////////////////////////////////////////////////////
+	signals:
+	//! Emitted when a texture prepared in background or partially uploaded has to be uploaded
+	/*! The signal is queued to the thread of the application*/
+	void textureReady();
+
+//////////////////////////////////////////////////////////////////////
+// Private slots
+//////////////////////////////////////////////////////////////////////
+private slots:
+	//! Emit the queued texture ready signal
+	void emitTextureReady();
+
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Return the key of the entry of the given key or alias
+	inline QByteArray resolvedKey(const QByteArray& key) const
+	{return m_AliasHash.value(key, key);}
+
+	//! Queue the texture ready signal if it is not already queued
+	void postTextureReady();
+
+	//! Return the thread pool of the preparation tasks
+	static QThreadPool* threadPool();
+
+	//! Return the mipmap chain of the given image in OpenGL format
+	static QList<QImage> mipmapLevels(const QImage& image, const QSize& maxSize, int downscaleLevel);
+
+	//! Prepare the given entry and upload its levels within the frame budget in the given current context
+	void glUpload(const QByteArray& key, Entry& entry, const QGLContext* pContext);
+
+	//! Set the result of a preparation task
+	/*! The given content key is not empty if the image has been decoded by the task*/
+	void setPreparedLevels(const QByteArray& key, int serial, const QImage& image, const QList<QImage>& levels
+			, const QByteArray& contentKey);
+
+	//! Identify the entry of the given iterator by the given content key of its decoded image
+	/*! The entry is merged with the cached entry of the same content*/
+	void setContentKey(QHash<QByteArray, Entry>::iterator iEntry, const QByteArray& contentKey);
+
+	//! Log the decoding failure of the given entry
+	void logDecodingFailure(const Entry& entry) const;
+
+	//! Bind the placeholder texture in the given context
+	void glBindPlaceholder(QGLContext* pContext);
+
+	//! Delete the least recently used textures, except the given key, until the given memory is available
+	void evict(const QByteArray& key, qint64 memory);
+
+	//! Delete the OpenGL texture of the given entry, or queue it if its context is not current
+	void deleteTexture(Entry& entry);
+
+	//! Delete the queued textures of the given current context
+	void glDeleteReleasedTextures(const QGLContext* pContext);
+
+	//! Return the memory used by the given levels
+	static qint64 levelsMemory(const QList<QImage>& levels);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	Q_DISABLE_COPY(GLC_TextureCache)
+
+	//! The unique instance of the texture cache
+	static GLC_TextureCache* m_pTextureCache;
+
+	//! The entries of each key
+	QHash<QByteArray, Entry> m_EntryHash;
+
+	//! The key of each cached file name
+	QHash<QString, QByteArray> m_FileKeyHash;
+
+	//! The entry key of each file name key of a decoded image
+	QHash<QByteArray, QByteArray> m_AliasHash;
+
+	//! The released textures ids of each context to delete when the context is current
+	QHash<const QGLContext*, QList<GLuint> > m_ReleasedTextureHash;
+
+	//! The memory budget of the OpenGL textures
+	qint64 m_MemoryBudget;
+
+	//! The memory used by the OpenGL textures
+	qint64 m_UsedMemory;
+
+	//! The bind counter used to find the least recently used textures
+	quint64 m_UseCounter;
+
+	//! Asynchronous loading usage
+	bool m_AsynchronousLoading;
+
+	//! The maximum number of bytes uploaded per frame
+	qint64 m_FrameUploadBudget;
+
+	//! The number of bytes uploaded in the current frame
+	qint64 m_FrameUploadedBytes;
+
+	//! The colour of the placeholder texture
+	QColor m_PlaceholderColor;
+
+	//! The placeholder texture id
+	GLuint m_PlaceholderTextureId;
+
+	//! The context of the placeholder texture
+	QGLContext* m_pPlaceholderContext;
+
+	//! True if the placeholder texture has the placeholder colour
+	bool m_PlaceholderIsValid;
+
+	//! The mutex of the cache, textures can be created by loading threads
+	mutable QMutex m_Mutex;
+
+	//! The condition signaled when a preparation task is done
+	QWaitCondition m_PreparedCondition;
+
+	//! True if the texture ready signal is queued
+	bool m_TextureReadyIsPosted;
+};
+
+#endif //GLC_TEXTURECACHE_H_
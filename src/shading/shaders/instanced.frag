@@ -0,0 +1,8 @@
+#version 120
+
+// Colors are computed by the instanced vertex shader
+
+void main()
+{
+	gl_FragColor= gl_Color;
+}
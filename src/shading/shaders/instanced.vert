@@ -0,0 +1,83 @@
+#version 120
+
+// Fixed pipeline transformation and lighting of instances drawn with one instanced draw call
+
+uniform bool u_SelectionMode;
+uniform bool u_LightingEnabled;
+uniform bool u_LightEnabled[8];
+
+// The columns of the instance matrix and the instance color id
+attribute vec4 a_InstanceMatrix0;
+attribute vec4 a_InstanceMatrix1;
+attribute vec4 a_InstanceMatrix2;
+attribute vec4 a_InstanceMatrix3;
+attribute vec4 a_InstanceColorId;
+
+// Return the color of the given side lit by the enabled lights
+vec4 lightColor(vec3 position, vec3 normal, bool front)
+{
+	vec4 color= front ? gl_FrontLightModelProduct.sceneColor : gl_BackLightModelProduct.sceneColor;
+	float shininess= front ? gl_FrontMaterial.shininess : gl_BackMaterial.shininess;
+	vec3 eye= -normalize(position);
+	for (int i= 0; i < 8; ++i)
+	{
+		if (!u_LightEnabled[i]) continue;
+
+		vec3 lightDirection;
+		float attenuation= 1.0;
+		if (gl_LightSource[i].position.w == 0.0)
+		{
+			lightDirection= normalize(gl_LightSource[i].position.xyz);
+		}
+		else
+		{
+			vec3 toLight= gl_LightSource[i].position.xyz - position;
+			float distance= length(toLight);
+			lightDirection= toLight / distance;
+			attenuation= 1.0 / (gl_LightSource[i].constantAttenuation + gl_LightSource[i].linearAttenuation * distance
+					+ gl_LightSource[i].quadraticAttenuation * distance * distance);
+			if (gl_LightSource[i].spotCutoff <= 90.0)
+			{
+				float spot= dot(-lightDirection, normalize(gl_LightSource[i].spotDirection));
+				attenuation*= (spot < gl_LightSource[i].spotCosCutoff) ? 0.0 : pow(spot, gl_LightSource[i].spotExponent);
+			}
+		}
+
+		vec4 ambient= front ? gl_FrontLightProduct[i].ambient : gl_BackLightProduct[i].ambient;
+		vec4 diffuse= front ? gl_FrontLightProduct[i].diffuse : gl_BackLightProduct[i].diffuse;
+		vec4 specular= front ? gl_FrontLightProduct[i].specular : gl_BackLightProduct[i].specular;
+		float diffuseFactor= max(dot(normal, lightDirection), 0.0);
+		float specularFactor= 0.0;
+		if (diffuseFactor > 0.0)
+		{
+			specularFactor= pow(max(dot(normal, normalize(lightDirection + eye)), 0.0), shininess);
+		}
+		color+= attenuation * (ambient + diffuseFactor * diffuse + specularFactor * specular);
+	}
+	return clamp(color, 0.0, 1.0);
+}
+
+void main()
+{
+	mat4 instanceMatrix= mat4(a_InstanceMatrix0, a_InstanceMatrix1, a_InstanceMatrix2, a_InstanceMatrix3);
+	vec4 position= gl_ModelViewMatrix * (instanceMatrix * gl_Vertex);
+	gl_Position= gl_ProjectionMatrix * position;
+	gl_ClipVertex= position;
+
+	if (u_SelectionMode)
+	{
+		gl_FrontColor= vec4(a_InstanceColorId.rgb, 1.0);
+		gl_BackColor= gl_FrontColor;
+	}
+	else if (u_LightingEnabled)
+	{
+		vec3 normal= normalize(gl_NormalMatrix * (mat3(instanceMatrix) * gl_Normal));
+		gl_FrontColor= lightColor(position.xyz, normal, true);
+		gl_BackColor= lightColor(position.xyz, -normal, false);
+	}
+	else
+	{
+		gl_FrontColor= gl_Color;
+		gl_BackColor= gl_Color;
+	}
+}
@@ -80,7 +80,8 @@ HEADERS_GLC_MATHS += 	maths/glc_utils_maths.h \
                         maths/glc_interpolator.h \
                         maths/glc_plane.h \
                         maths/glc_geomtools.h \
-                        maths/glc_line3d.h
+                        maths/glc_line3d.h \
+                        maths/glc_batchtransform.h
 						
 HEADERS_GLC_IO +=   io/glc_objmtlloader.h \
                     io/glc_objtoworld.h \
@@ -93,7 +94,9 @@ HEADERS_GLC_IO +=   io/glc_objmtlloader.h \
                     io/glc_worldto3ds.h \
                     io/glc_bsreptoworld.h \
                     io/glc_xmlutil.h \
+                    io/glc_numberparser.h \
                     io/glc_fileloader.h \
+                    io/glc_worldloader.h \
                     io/glc_worldreaderplugin.h \
                     io/glc_worldreaderhandler.h
 
@@ -108,6 +111,13 @@ HEADERS_GLC_SCENEGRAPH +=   sceneGraph/glc_3dviewcollection.h \
                             sceneGraph/glc_spacepartitioning.h \
                             sceneGraph/glc_octree.h \
                             sceneGraph/glc_octreenode.h \
+                            sceneGraph/glc_linearoctree.h \
+                            sceneGraph/glc_bitset.h \
+                            sceneGraph/glc_frustumculler.h \
+                            sceneGraph/glc_occlusionculler.h \
+                            sceneGraph/glc_staticbatcher.h \
+                            sceneGraph/glc_instancedrenderer.h \
+                            sceneGraph/glc_repstreamer.h \
                             sceneGraph/glc_selectionset.h
 							
 HEADERS_GLC_GEOMETRY += geometry/glc_geometry.h \
@@ -119,6 +129,11 @@ HEADERS_GLC_GEOMETRY += geometry/glc_geometry.h \
                         geometry/glc_primitivegroup.h \
                         geometry/glc_mesh.h \
                         geometry/glc_lod.h \
+                        geometry/glc_mappedbuffer.h \
+                        geometry/glc_packedvertices.h \
+                        geometry/glc_meshbvh.h \
+                        geometry/glc_meshsimplifier.h \
+                        geometry/glc_vertexcacheoptimizer.h \
                         geometry/glc_rectangle.h \
                         geometry/glc_line.h \
                         geometry/glc_rep.h \
@@ -136,6 +151,7 @@ HEADERS_GLC_GEOMETRY += geometry/glc_geometry.h \
 
 HEADERS_GLC_SHADING +=  shading/glc_material.h \
                         shading/glc_texture.h \
+                        shading/glc_texturecache.h \
                         shading/glc_shader.h \
                         shading/glc_selectionmaterial.h \
                         shading/glc_light.h \
@@ -159,7 +175,8 @@ HEADERS_GLC_VIEWPORT +=	viewport/glc_camera.h \
                         viewport/glc_flymover.h \
                         viewport/glc_repflymover.h \
                         viewport/glc_userinput.h \
-                        viewport/glc_tsrmover.h
+                        viewport/glc_tsrmover.h \
+                        viewport/glc_pickinghit.h
 
 HEADERS_GLC += glc_global.h \
                glc_object.h \
@@ -246,7 +263,8 @@ SOURCES +=	maths/glc_matrix4x4.cpp \
                 maths/glc_interpolator.cpp \
                 maths/glc_plane.cpp \
                 maths/glc_geomtools.cpp \
-                maths/glc_line3d.cpp
+                maths/glc_line3d.cpp \
+                maths/glc_batchtransform.cpp
 
 SOURCES +=	io/glc_objmtlloader.cpp \
                 io/glc_objtoworld.cpp \
@@ -258,7 +276,8 @@ SOURCES +=	io/glc_objmtlloader.cpp \
                 io/glc_worldto3dxml.cpp \
                 io/glc_worldto3ds.cpp \
                 io/glc_bsreptoworld.cpp \
-                io/glc_fileloader.cpp
+                io/glc_fileloader.cpp \
+                io/glc_worldloader.cpp
 
 SOURCES +=	sceneGraph/glc_3dviewcollection.cpp \
                 sceneGraph/glc_3dviewinstance.cpp \
@@ -271,6 +290,13 @@ SOURCES +=	sceneGraph/glc_3dviewcollection.cpp \
                 sceneGraph/glc_spacepartitioning.cpp \
                 sceneGraph/glc_octree.cpp \
                 sceneGraph/glc_octreenode.cpp \
+                sceneGraph/glc_linearoctree.cpp \
+                sceneGraph/glc_bitset.cpp \
+                sceneGraph/glc_frustumculler.cpp \
+                sceneGraph/glc_occlusionculler.cpp \
+                sceneGraph/glc_staticbatcher.cpp \
+                sceneGraph/glc_instancedrenderer.cpp \
+                sceneGraph/glc_repstreamer.cpp \
                 sceneGraph/glc_selectionset.cpp
 
 SOURCES +=	geometry/glc_geometry.cpp \
@@ -282,6 +308,11 @@ SOURCES +=	geometry/glc_geometry.cpp \
                 geometry/glc_primitivegroup.cpp \
                 geometry/glc_mesh.cpp \
                 geometry/glc_lod.cpp \
+                geometry/glc_mappedbuffer.cpp \
+                geometry/glc_packedvertices.cpp \
+                geometry/glc_meshbvh.cpp \
+                geometry/glc_meshsimplifier.cpp \
+                geometry/glc_vertexcacheoptimizer.cpp \
                 geometry/glc_rectangle.cpp \
                 geometry/glc_line.cpp \
                 geometry/glc_rep.cpp \
@@ -300,6 +331,7 @@ SOURCES +=	geometry/glc_geometry.cpp \
 
 SOURCES +=	shading/glc_material.cpp \
                 shading/glc_texture.cpp \
+                shading/glc_texturecache.cpp \
                 shading/glc_light.cpp \
                 shading/glc_selectionmaterial.cpp \
                 shading/glc_shader.cpp \
@@ -364,6 +396,7 @@ HEADERS_INST = GLC_BoundingBox \
                GLC_Camera \
                GLC_Circle \
                GLC_3DViewCollection \
+               GLC_BitSet \
                GLC_Cylinder \
                GLC_Exception \
                GLC_Factory \
@@ -384,6 +417,7 @@ HEADERS_INST = GLC_BoundingBox \
                GLC_Point3d \
                GLC_Point3df \
                GLC_Texture \
+               GLC_TextureCache \
                GLC_Vector2d \
                GLC_Vector2df \
                GLC_Vector3d \
@@ -406,6 +440,7 @@ HEADERS_INST = GLC_BoundingBox \
                GLC_Attributes \
                GLC_Rectangle \
                GLC_Mesh \
+               GLC_MeshSimplifier \
                GLC_StructOccurence \
                GLC_StructInstance \
                GLC_StructReference \
@@ -419,10 +454,12 @@ HEADERS_INST = GLC_BoundingBox \
                GLC_Global \
                GLC_SpacePartitioning \
                GLC_Octree \
+               GLC_LinearOctree \
                GLC_OctreeNode \
                GLC_Plane \
                GLC_Frustum \
                GLC_GeomTools \
+               GLC_BatchTransform \
                GLC_Line3d \
                GLC_3DWidget \
                GLC_CuttingPlane \
@@ -449,6 +486,7 @@ HEADERS_INST = GLC_BoundingBox \
                glcXmlUtil \
                GLC_RenderState \
                GLC_FileLoader \
+               GLC_WorldLoader \
                GLC_WorldReaderPlugin \
                GLC_WorldReaderHandler \
                GLC_PointCloud \
@@ -459,7 +497,9 @@ HEADERS_INST = GLC_BoundingBox \
                GLC_Context \
                GLC_ContextManager \
                GLC_Renderer \
-               GLC_ExtrudedMesh
+               GLC_ExtrudedMesh \
+               GLC_PickingHit \
+               GLC_RepStreamer
 
 include (../install.pri)
 
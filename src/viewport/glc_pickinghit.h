@@ -0,0 +1,144 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_pickinghit.h interface for the GLC_PickingHit class.
+
+#ifndef GLC_PICKINGHIT_H_
+#define GLC_PICKINGHIT_H_
+
+#include "../maths/glc_vector3d.h"
+#include "../glc_global.h"
+
+#include "../glc_config.h"
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_PickingHit
+/*! \brief GLC_PickingHit : The result of a ray cast picking*/
+
+/*! A GLC_PickingHit is returned by GLC_Viewport ray cast picking functions.
+ *  It contains the ids of the picked instance, body and primitive and
+ *  the exact 3D point of the hit. An invalid hit has a null instance id.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_PickingHit
+{
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Construct an invalid hit
+	inline GLC_PickingHit()
+	: m_InstanceId(0)
+	, m_BodyId(0)
+	, m_BodyIndex(-1)
+	, m_PrimitiveId(0)
+	, m_Point()
+	, m_Parameter(0.0)
+	{}
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return true if this hit is valid
+	inline bool isValid() const
+	{return m_InstanceId != 0;}
+
+	//! Return the id of the picked 3D view instance
+	inline GLC_uint instanceId() const
+	{return m_InstanceId;}
+
+	//! Return the id of the picked body
+	inline GLC_uint bodyId() const
+	{return m_BodyId;}
+
+	//! Return the index of the picked body in its instance
+	inline int bodyIndex() const
+	{return m_BodyIndex;}
+
+	//! Return the id of the picked primitive
+	inline GLC_uint primitiveId() const
+	{return m_PrimitiveId;}
+
+	//! Return the picked 3D point in world coordinates
+	inline const GLC_Point3d& point() const
+	{return m_Point;}
+
+	//! Return the parameter of the picked point on the picking ray
+	inline double parameter() const
+	{return m_Parameter;}
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Set the id of the picked 3D view instance
+	inline void setInstanceId(GLC_uint id)
+	{m_InstanceId= id;}
+
+	//! Set the id and the index of the picked body
+	inline void setBody(GLC_uint id, int index)
+	{
+		m_BodyId= id;
+		m_BodyIndex= index;
+	}
+
+	//! Set the id of the picked primitive
+	inline void setPrimitiveId(GLC_uint id)
+	{m_PrimitiveId= id;}
+
+	//! Set the picked point and its parameter on the picking ray
+	inline void setPoint(const GLC_Point3d& point, double parameter)
+	{
+		m_Point= point;
+		m_Parameter= parameter;
+	}
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+	//! The picked instance id
+	GLC_uint m_InstanceId;
+
+	//! The picked body id
+	GLC_uint m_BodyId;
+
+	//! The picked body index
+	int m_BodyIndex;
+
+	//! The picked primitive id
+	GLC_uint m_PrimitiveId;
+
+	//! The picked point
+	GLC_Point3d m_Point;
+
+	//! The parameter of the picked point on the picking ray
+	double m_Parameter;
+};
+
+#endif /* GLC_PICKINGHIT_H_ */
@@ -29,8 +29,10 @@
 #include "../glc_openglexception.h"
 #include "../glc_ext.h"
 #include "../shading/glc_selectionmaterial.h"
+#include "../shading/glc_texturecache.h"
 #include "../glc_state.h"
 #include "../sceneGraph/glc_3dviewinstance.h"
+#include "../sceneGraph/glc_spacepartitioning.h"
 
 #include <QtDebug>
 
@@ -151,6 +153,106 @@ GLC_Vector3d GLC_Viewport::mapNormalyzePosMouse(double Posx, double Posy) const
 	return mapPosMouse(screenX, screenY);
 }
 
+GLC_Line3d GLC_Viewport::pickingRay(int x, int y) const
+{
+	GLC_Vector3d forward(m_pViewCam->forward());
+	forward.normalize();
+	const GLC_Vector3d side(m_pViewCam->sideVector());
+	const GLC_Vector3d up(side ^ forward);
+
+	if (m_UseParallelProjection)
+	{
+		// Parallel ray through the mouse position on the image plane
+		const GLC_Vector3d mousePos(mapPosMouse(x, y));
+		const GLC_Point3d origin(m_pViewCam->eye() + side * mousePos.x() + up * mousePos.y());
+		return GLC_Line3d(origin, forward);
+	}
+	else
+	{
+		// Same frustum than updateProjectionMat at unit distance of the eye
+		const double yMax= tan(m_ViewAngle * glc::PI / 360.0);
+		const double xMax= yMax * m_AspectRatio;
+		double nX= 0.0;
+		double nY= 0.0;
+		if ((m_Width != 0) && (m_Height != 0))
+		{
+			nX= 2.0 * static_cast<double>(x) / static_cast<double>(m_Width) - 1.0;
+			nY= 1.0 - 2.0 * static_cast<double>(y) / static_cast<double>(m_Height);
+		}
+		const GLC_Vector3d direction(forward + side * (nX * xMax) + up * (nY * yMax));
+		return GLC_Line3d(m_pViewCam->eye(), direction);
+	}
+}
+
+GLC_PickingHit GLC_Viewport::pick(GLC_3DViewCollection* pCollection, int x, int y) const
+{
+	GLC_PickingHit hit;
+	const GLC_Line3d ray(pickingRay(x, y));
+
+	QList<GLC_3DViewInstance*> instances;
+	if (pCollection->spacePartitioningIsUsed() && (NULL != pCollection->spacePartitioningHandle()))
+	{
+		instances= pCollection->spacePartitioningHandle()->listOfIntersectedInstances(ray);
+	}
+	else
+	{
+		instances= pCollection->instancesHandle();
+	}
+
+	// Sort shown instances by ray entry in their bounding box
+	QList<QPair<double, GLC_3DViewInstance*> > candidates;
+	const int instanceCount= instances.size();
+	for (int i= 0; i < instanceCount; ++i)
+	{
+		GLC_3DViewInstance* pInstance= instances.at(i);
+		double entry;
+		if ((pInstance->isVisible() == pCollection->showState()) && pInstance->boundingBox().intersect(ray, &entry))
+		{
+			candidates.append(qMakePair(entry, pInstance));
+		}
+	}
+	qSort(candidates);
+
+	// Instances behind the nearest hit are not tested
+	const int candidateCount= candidates.size();
+	for (int i= 0; (i < candidateCount) && (!hit.isValid() || (candidates.at(i).first < hit.parameter())); ++i)
+	{
+		candidates.at(i).second->intersect(ray, &hit);
+	}
+
+	return hit;
+}
+
+GLC_PickingHit GLC_Viewport::pick(GLC_3DViewInstance* pInstance, int x, int y) const
+{
+	GLC_PickingHit hit;
+	pInstance->intersect(pickingRay(x, y), &hit);
+
+	return hit;
+}
+
+GLC_uint GLC_Viewport::pickBody(GLC_3DViewInstance* pInstance, int x, int y) const
+{
+	return pick(pInstance, x, y).bodyId();
+}
+
+QPair<int, GLC_uint> GLC_Viewport::pickPrimitive(GLC_3DViewInstance* pInstance, int x, int y) const
+{
+	const GLC_PickingHit hit(pick(pInstance, x, y));
+	QPair<int, GLC_uint> result;
+	if (hit.isValid())
+	{
+		result.first= hit.bodyIndex();
+		result.second= hit.primitiveId();
+	}
+	else
+	{
+		result.first= -1;
+		result.second= 0;
+	}
+	return result;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Public OpenGL Functions
 //////////////////////////////////////////////////////////////////////
@@ -170,6 +272,8 @@ void GLC_Viewport::initGl()
 
 void GLC_Viewport::glExecuteCam(void)
 {
+	// A new frame begins, textures can be uploaded again
+	GLC_TextureCache::instance()->newFrame();
 	renderImagePlane();
 	m_pViewCam->glExecute();
 }
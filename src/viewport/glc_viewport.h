@@ -35,6 +35,8 @@
 #include "glc_frustum.h"
 #include "../maths/glc_plane.h"
 #include "../sceneGraph/glc_3dviewcollection.h"
+#include "../maths/glc_line3d.h"
+#include "glc_pickinghit.h"
 
 #include "../glc_config.h"
 
@@ -204,6 +206,26 @@ public:
 	/*! The size of the given list must be a multiple of 2*/
     QList<GLC_Point3d> unproject(const QList<int>& list, GLenum buffer= GL_FRONT)const;
 
+	//! Return the picking ray in world coordinates of the given screen coordinate
+	/*! The ray starts at the camera eye and passes through the given pixel*/
+	GLC_Line3d pickingRay(int x, int y) const;
+
+	//! Cast a ray through the given screen coordinate and return the nearest hit in the given collection
+	/*! Doesn't need OpenGL context once the meshes BVH are built (See GLC_Mesh::intersect()).
+	 *  If the collection use space partitioning, only instances given by the space partitioning are tested*/
+	GLC_PickingHit pick(GLC_3DViewCollection* pCollection, int x, int y) const;
+
+	//! Cast a ray through the given screen coordinate and return the nearest hit in the given 3DViewInstance
+	GLC_PickingHit pick(GLC_3DViewInstance* pInstance, int x, int y) const;
+
+	//! Pick a body inside a 3DViewInstance with a ray and return its UID
+	/*! Return UID of the nearest picked body, ray cast equivalent of selectBody()*/
+	GLC_uint pickBody(GLC_3DViewInstance* pInstance, int x, int y) const;
+
+	//! Pick a primitive inside a 3DViewInstance with a ray and return its UID and its body index
+	/*! Return UID of the nearest picked primitive, ray cast equivalent of selectPrimitive()*/
+	QPair<int, GLC_uint> pickPrimitive(GLC_3DViewInstance* pInstance, int x, int y) const;
+
 //@}
 
 //////////////////////////////////////////////////////////////////////